@@ -1713,6 +1713,9 @@ void Application::destruct()
 
 void Application::destructObserver()
 {
+    // deliver pending messages before the observers go away
+    Base::Console().Flush();
+
     if ( _pConsoleObserverFile ) {
         Base::Console().DetachObserver(_pConsoleObserverFile);
         delete _pConsoleObserverFile;
@@ -1802,6 +1805,9 @@ void segmentation_fault_handler(int sig)
 {
 #if defined(FC_OS_LINUX)
     (void)sig;
+    // best effort to not lose the messages leading to the crash, this
+    // isn't async-signal-safe but the process is going down anyway
+    Base::Console().Flush(false);
     std::cerr << "Program received signal SIGSEGV, Segmentation fault.\n";
     printBacktrace(2);
 #if defined(FC_DEBUG)
@@ -1832,6 +1838,7 @@ void segmentation_fault_handler(int sig)
 
 void unhandled_exception_handler()
 {
+    Base::Console().Flush(false);
     std::cerr << "Terminating..." << std::endl;
 }
 
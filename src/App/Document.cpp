@@ -596,6 +596,7 @@ void Document::clearDocument()
 
     d->clearRecomputeLog();
     d->objectArray.clear();
+    d->objectTypeMap.clear();
     d->objectMap.clear();
     d->objectIdMap.clear();
     d->lastObjectId = 0;
@@ -1979,6 +1980,7 @@ void Document::restore (const char *filename,
 
     d->clearRecomputeLog();
     d->objectArray.clear();
+    d->objectTypeMap.clear();
     d->objectMap.clear();
     d->objectIdMap.clear();
     d->lastObjectId = 0;
@@ -3165,6 +3167,7 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName,
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->addToTypeMap(pcObject);
 
     // If we are restoring, don't set the Label object now; it will be restored later. This is to avoid potential duplicate
     // label conflicts later.
@@ -3269,6 +3272,7 @@ std::vector<DocumentObject *> Document::addObjects(const char* sType, const std:
         pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
         // insert in the vector
         d->objectArray.push_back(pcObject);
+        d->addToTypeMap(pcObject);
 
         pcObject->Label.setValue(ObjectName);
 
@@ -3333,6 +3337,7 @@ void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->addToTypeMap(pcObject);
 
     pcObject->Label.setValue( ObjectName );
 
@@ -3360,6 +3365,7 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     if(!pcObject->_Id) pcObject->_Id = ++d->lastObjectId;
     d->objectIdMap[pcObject->_Id] = pcObject;
     d->objectArray.push_back(pcObject);
+    d->addToTypeMap(pcObject);
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
 
@@ -3472,6 +3478,7 @@ void Document::removeObject(const char* sName)
     for (std::vector<DocumentObject*>::iterator obj = d->objectArray.begin(); obj != d->objectArray.end(); ++obj) {
         if (*obj == pos->second) {
             d->objectArray.erase(obj);
+            d->removeFromTypeMap(pos->second);
             break;
         }
     }
@@ -3549,6 +3556,7 @@ void Document::_removeObject(DocumentObject* pcObject)
     for (std::vector<DocumentObject*>::iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
         if (*it == pcObject) {
             d->objectArray.erase(it);
+            d->removeFromTypeMap(pcObject);
             break;
         }
     }
@@ -3855,6 +3863,15 @@ const std::vector<DocumentObject*> &Document::getObjects() const
 std::vector<DocumentObject*> Document::getObjectsOfType(const Base::Type& typeId) const
 {
     std::vector<DocumentObject*> Objects;
+    const std::vector<DocumentObject*>* typeObjects;
+    std::size_t count = d->findObjectsOfType(typeId, typeObjects);
+    if (count == 0)
+        return Objects;
+    // Objects of a single type are already in creation order
+    if (typeObjects)
+        return *typeObjects;
+
+    Objects.reserve(count);
     for (auto it : d->objectArray) {
         if (it->getTypeId().isDerivedFrom(typeId))
             Objects.push_back(it);
@@ -3885,8 +3902,12 @@ std::vector<DocumentObject*> Document::findObjects(const Base::Type& typeId, con
         rx_label.set_expression(label);
 
     std::vector<DocumentObject*> Objects;
+    const std::vector<DocumentObject*>* typeObjects;
+    if (d->findObjectsOfType(typeId, typeObjects) == 0)
+        return Objects;
+
     DocumentObject* found = nullptr;
-    for (auto it : d->objectArray) {
+    for (auto it : typeObjects ? *typeObjects : d->objectArray) {
         if (it->getTypeId().isDerivedFrom(typeId)) {
             found = it;
 
@@ -3905,13 +3926,8 @@ std::vector<DocumentObject*> Document::findObjects(const Base::Type& typeId, con
 
 int Document::countObjectsOfType(const Base::Type& typeId) const
 {
-    int ct=0;
-    for (const auto & it : d->objectMap) {
-        if (it.second->getTypeId().isDerivedFrom(typeId))
-            ct++;
-    }
-
-    return ct;
+    const std::vector<DocumentObject*>* typeObjects;
+    return static_cast<int>(d->findObjectsOfType(typeId, typeObjects));
 }
 
 PyObject * Document::getPyObject()
@@ -1106,7 +1106,419 @@ ExpressionPtr Expression::replaceObject(const DocumentObject *parent,
     return ExpressionPtr(expr);
 }
 
+/* The native evaluator
+ *
+ * Most expressions bound to properties are plain arithmetic on numbers,
+ * quantities and numeric properties. Evaluating those through Python costs
+ * a Python object per node, so such expression trees are compiled into a
+ * flat postfix program run directly on Base::Quantity. Any node type that
+ * is not understood makes the whole tree fall back to Python.
+ *
+ * The values mirror the Python int, float and Base.Quantity objects that the
+ * Python path would produce, and follow their arithmetic rules exactly. A
+ * case those rules cannot reproduce (integer overflow, division by zero,
+ * complex results, unit errors, ...) aborts the native run, and the
+ * expression is then evaluated again through Python, so that results and
+ * error messages stay identical.
+ */
+
+namespace {
+
+struct NativeValue {
+    enum Kind {
+        Int,
+        Float,
+        Qty,
+    };
+    Kind kind{Int};
+    long l{0};
+    double d{0.0};
+    Quantity q;
+
+    static NativeValue fromLong(long v) {
+        NativeValue res;
+        res.l = v;
+        return res;
+    }
+    static NativeValue fromDouble(double v) {
+        NativeValue res;
+        res.kind = Float;
+        res.d = v;
+        return res;
+    }
+    static NativeValue fromQuantity(const Quantity &v) {
+        NativeValue res;
+        res.kind = Qty;
+        res.q = v;
+        return res;
+    }
+
+    double toDouble() const {
+        return kind == Int ? static_cast<double>(l) : d;
+    }
+
+    Quantity toQuantity() const {
+        switch(kind) {
+        case Int:
+            return Quantity(l);
+        case Float:
+            return Quantity(d);
+        default:
+            return q;
+        }
+    }
+};
+
+// Thrown when the native evaluator cannot reproduce the Python result
+struct NativeFallback {};
+
+long nativeAdd(long a, long b) {
+    if((b > 0 && a > LONG_MAX - b) || (b < 0 && a < LONG_MIN - b))
+        throw NativeFallback();
+    return a + b;
+}
+
+long nativeSub(long a, long b) {
+    if((b < 0 && a > LONG_MAX + b) || (b > 0 && a < LONG_MIN + b))
+        throw NativeFallback();
+    return a - b;
+}
+
+long nativeMul(long a, long b) {
+    if(a > 0) {
+        if(b > 0 ? a > LONG_MAX / b : b < LONG_MIN / a)
+            throw NativeFallback();
+    }
+    else if(a < 0) {
+        if(b > 0 ? a < LONG_MIN / b : b < LONG_MAX / a)
+            throw NativeFallback();
+    }
+    return a * b;
+}
+
+// Python true division of two ints is correctly rounded, which a double
+// division only guarantees while both operands are exactly representable.
+bool nativeExactDouble(long v) {
+    const long long limit = 1LL << 53;
+    return v >= -limit && v <= limit;
+}
+
+double nativePow(double x, double y) {
+    // Python raises ZeroDivisionError, returns a complex number or raises
+    // OverflowError in these cases
+    if(x == 0.0 && y < 0.0)
+        throw NativeFallback();
+    if(x < 0.0 && std::isfinite(y) && y != std::floor(y))
+        throw NativeFallback();
+    double res = std::pow(x, y);
+    if(std::isinf(res) && std::isfinite(x) && std::isfinite(y))
+        throw NativeFallback();
+    return res;
+}
+
+NativeValue nativeUnary(int op, const NativeValue &v) {
+    if(op == OperatorExpression::POS)
+        return v;
+    switch(v.kind) {
+    case NativeValue::Int:
+        if(v.l == LONG_MIN)
+            throw NativeFallback();
+        return NativeValue::fromLong(-v.l);
+    case NativeValue::Float:
+        return NativeValue::fromDouble(-v.d);
+    default:
+        return NativeValue::fromQuantity(v.q * -1.0);
+    }
+}
+
+NativeValue nativeBinary(int op, const NativeValue &a, const NativeValue &b) {
+    if(a.kind == NativeValue::Qty || b.kind == NativeValue::Qty) {
+        switch(op) {
+        case OperatorExpression::ADD:
+            return NativeValue::fromQuantity(a.toQuantity() + b.toQuantity());
+        case OperatorExpression::SUB:
+            return NativeValue::fromQuantity(a.toQuantity() - b.toQuantity());
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            return NativeValue::fromQuantity(a.toQuantity() * b.toQuantity());
+        case OperatorExpression::DIV:
+            return NativeValue::fromQuantity(a.toQuantity() / b.toQuantity());
+        default:
+            // Base.Quantity only supports power with a quantity as base
+            if(a.kind != NativeValue::Qty)
+                throw NativeFallback();
+            if(b.kind == NativeValue::Qty)
+                return NativeValue::fromQuantity(a.q.pow(b.q));
+            return NativeValue::fromQuantity(a.q.pow(b.toDouble()));
+        }
+    }
+
+    if(a.kind == NativeValue::Float || b.kind == NativeValue::Float) {
+        double x = a.toDouble();
+        double y = b.toDouble();
+        switch(op) {
+        case OperatorExpression::ADD:
+            return NativeValue::fromDouble(x + y);
+        case OperatorExpression::SUB:
+            return NativeValue::fromDouble(x - y);
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            return NativeValue::fromDouble(x * y);
+        case OperatorExpression::DIV:
+            if(y == 0.0)
+                throw NativeFallback();
+            return NativeValue::fromDouble(x / y);
+        default:
+            return NativeValue::fromDouble(nativePow(x, y));
+        }
+    }
+
+    switch(op) {
+    case OperatorExpression::ADD:
+        return NativeValue::fromLong(nativeAdd(a.l, b.l));
+    case OperatorExpression::SUB:
+        return NativeValue::fromLong(nativeSub(a.l, b.l));
+    case OperatorExpression::MUL:
+    case OperatorExpression::UNIT:
+        return NativeValue::fromLong(nativeMul(a.l, b.l));
+    case OperatorExpression::DIV:
+        if(b.l == 0 || !nativeExactDouble(a.l) || !nativeExactDouble(b.l))
+            throw NativeFallback();
+        return NativeValue::fromDouble(static_cast<double>(a.l) / static_cast<double>(b.l));
+    default:
+        break;
+    }
+
+    // Power of ints, which yields a float for negative exponents
+    if(b.l < 0)
+        return NativeValue::fromDouble(nativePow(a.toDouble(), b.toDouble()));
+    long res = 1;
+    long base = a.l;
+    for(long e = b.l; e; ) {
+        if(e & 1)
+            res = nativeMul(res, base);
+        e >>= 1;
+        if(e)
+            base = nativeMul(base, base);
+    }
+    return NativeValue::fromLong(res);
+}
+
+} // anonymous namespace
+
+struct Expression::NativeProgram {
+    enum OpCode {
+        PushNumber,
+        PushVariable,
+        Unary,
+        Binary,
+        Call,
+    };
+
+    struct Instruction {
+        OpCode code;
+        const Expression *expr;
+        int arg;
+        // property of a variable, valid until the resolve revision changes
+        mutable const Property *prop;
+        mutable unsigned long revision;
+    };
+
+    std::vector<Instruction> code;
+    std::size_t depth{0};
+
+    bool compile(const Expression *expr, std::size_t level);
+    bool run(App::any &value) const;
+};
+
+bool Expression::NativeProgram::compile(const Expression *expr, std::size_t level)
+{
+    if(expr->hasComponent())
+        return false;
+
+    depth = std::max(depth, level + 1);
+
+    // Exact type checks, as the more elaborate expressions all derive from
+    // UnitExpression
+    Base::Type type = expr->getTypeId();
+    if(type == NumberExpression::getClassTypeId()
+            || type == UnitExpression::getClassTypeId())
+    {
+        code.push_back({PushNumber, expr, 0, nullptr, 0});
+        return true;
+    }
+
+    if(type == ConstantExpression::getClassTypeId()) {
+        auto constant = static_cast<const ConstantExpression*>(expr);
+        std::string name = constant->getName();
+        if(!constant->isNumber() || name == "True" || name == "False")
+            return false;
+        code.push_back({PushNumber, expr, 0, nullptr, 0});
+        return true;
+    }
+
+    if(type == VariableExpression::getClassTypeId()) {
+        code.push_back({PushVariable, expr, 0, nullptr, 0});
+        return true;
+    }
+
+    if(type == OperatorExpression::getClassTypeId()) {
+        auto opExpr = static_cast<const OperatorExpression*>(expr);
+        int op = opExpr->getOperator();
+        switch(op) {
+        case OperatorExpression::NEG:
+        case OperatorExpression::POS:
+            if(!compile(opExpr->getLeft(), level))
+                return false;
+            code.push_back({Unary, expr, op, nullptr, 0});
+            return true;
+        case OperatorExpression::ADD:
+        case OperatorExpression::SUB:
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+        case OperatorExpression::DIV:
+        case OperatorExpression::POW:
+            if(!compile(opExpr->getLeft(), level)
+                    || !compile(opExpr->getRight(), level + 1))
+                return false;
+            code.push_back({Binary, expr, op, nullptr, 0});
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    if(type == FunctionExpression::getClassTypeId()) {
+        auto func = static_cast<const FunctionExpression*>(expr);
+        int f = func->getFunction();
+        const auto &args = func->getArgs();
+        if(f < FunctionExpression::ABS || f > FunctionExpression::TRUNC
+                || !expr->getOwner() || args.empty() || args.size() > 3)
+            return false;
+        for(std::size_t i = 0; i < args.size(); ++i) {
+            if(!compile(args[i], level + i))
+                return false;
+        }
+        code.push_back({Call, expr, static_cast<int>(args.size()), nullptr, 0});
+        return true;
+    }
+
+    return false;
+}
+
+bool Expression::NativeProgram::run(App::any &value) const
+{
+    std::vector<NativeValue> stack;
+    stack.reserve(depth);
+
+    try {
+        for(const auto &ins : code) {
+            switch(ins.code) {
+            case PushNumber: {
+                // Same conversion as pyFromQuantity()
+                const Quantity &q = static_cast<const UnitExpression*>(ins.expr)->getQuantity();
+                long l;
+                int i;
+                if(!q.getUnit().isEmpty())
+                    stack.push_back(NativeValue::fromQuantity(q));
+                else if(essentiallyInteger(q.getValue(), l, i))
+                    stack.push_back(NativeValue::fromLong(l));
+                else
+                    stack.push_back(NativeValue::fromDouble(q.getValue()));
+                break;
+            }
+            case PushVariable: {
+                // Resolving the path is the expensive part, so the property
+                // is kept until a document, object or property changes
+                unsigned long revision = ObjectIdentifier::getResolveRevision();
+                if(!ins.prop || ins.revision != revision) {
+                    ins.prop = static_cast<const VariableExpression*>(ins.expr)->getDirectProperty();
+                    ins.revision = revision;
+                }
+                auto prop = ins.prop;
+                if(!prop)
+                    return false;
+                if(prop->isDerivedFrom(PropertyQuantity::getClassTypeId())) {
+                    auto qprop = static_cast<const PropertyQuantity*>(prop);
+                    stack.push_back(NativeValue::fromQuantity(
+                                Quantity(qprop->getValue(), qprop->getUnit())));
+                }
+                else if(prop->isDerivedFrom(PropertyFloat::getClassTypeId()))
+                    stack.push_back(NativeValue::fromDouble(
+                                static_cast<const PropertyFloat*>(prop)->getValue()));
+                else if(prop->isDerivedFrom(PropertyInteger::getClassTypeId()))
+                    stack.push_back(NativeValue::fromLong(
+                                static_cast<const PropertyInteger*>(prop)->getValue()));
+                else
+                    return false;
+                break;
+            }
+            case Unary:
+                stack.back() = nativeUnary(ins.arg, stack.back());
+                break;
+            case Binary: {
+                NativeValue res = nativeBinary(ins.arg, stack[stack.size()-2], stack.back());
+                stack.pop_back();
+                stack.back() = std::move(res);
+                break;
+            }
+            case Call: {
+                std::size_t argc = ins.arg;
+                std::size_t first = stack.size() - argc;
+                Quantity args[3];
+                for(std::size_t i = 0; i < argc; ++i)
+                    args[i] = stack[first + i].toQuantity();
+                auto func = static_cast<const FunctionExpression*>(ins.expr);
+                Quantity res = FunctionExpression::evaluateScalar(func,
+                        func->getFunction(), argc, args[0], args[1], args[2]);
+                stack.resize(first + 1);
+                stack.back() = NativeValue::fromQuantity(res);
+                break;
+            }
+            }
+        }
+    }
+    catch(...) {
+        // Whatever went wrong, let the Python path reproduce it
+        return false;
+    }
+
+    assert(stack.size() == 1);
+    const NativeValue &res = stack.back();
+    switch(res.kind) {
+    case NativeValue::Int:
+        value = res.l;
+        break;
+    case NativeValue::Float:
+        value = res.d;
+        break;
+    default:
+        value = res.q;
+        break;
+    }
+    return true;
+}
+
+void Expression::markModified() {
+    ++revision;
+    nativeProgram.reset();
+    nativeCompiled = false;
+}
+
+bool Expression::getNativeValue(App::any &value) const {
+    if(!nativeCompiled) {
+        nativeCompiled = true;
+        auto program = std::make_shared<NativeProgram>();
+        if(program->compile(this, 0))
+            nativeProgram = std::move(program);
+    }
+    return nativeProgram && nativeProgram->run(value);
+}
+
 App::any Expression::getValueAsAny() const {
+    App::any value;
+    if(getNativeValue(value))
+        return value;
     Base::PyGILStateLocker lock;
     return pyObjectToAny(getPyValue());
 }
@@ -1128,6 +1540,7 @@ Py::Object Expression::getPyValue() const {
 void Expression::addComponent(Component *component) {
     assert(component);
     components.push_back(component);
+    markModified();
 }
 
 void Expression::visit(ExpressionVisitor &v) {
@@ -1135,9 +1548,19 @@ void Expression::visit(ExpressionVisitor &v) {
     for(auto &c : components)
         c->visit(v);
     v.visit(*this);
+    if(v.changed())
+        markModified();
 }
 
 Expression* Expression::eval() const {
+    App::any value;
+    if(getNativeValue(value)) {
+        if(is_type(value,typeid(Quantity)))
+            return new NumberExpression(owner,cast<Quantity>(value));
+        if(is_type(value,typeid(double)))
+            return new NumberExpression(owner,Quantity(cast<double>(value)));
+        return new NumberExpression(owner,Quantity(cast<long>(value)));
+    }
     Base::PyGILStateLocker lock;
     return expressionFromPy(owner,getPyValue());
 }
@@ -2401,6 +2824,48 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         v3 = pyToQuantity(e3,expr,"Invalid third argument.");
     }
 
+    switch (f) {
+    case ROTATIONX:
+    case ROTATIONY:
+    case ROTATIONZ: {
+        if (!(v1.isDimensionlessOrUnit(Unit::Angle)))
+            _EXPR_THROW("Unit must be either empty or an angle.", expr);
+
+        // Convert value to radians
+        double value = v1.getValue();
+        value *= M_PI / 180.0;
+        return Py::asObject(new Base::RotationPy(Base::Rotation(
+            Vector3d(static_cast<double>(f == ROTATIONX), static_cast<double>(f == ROTATIONY), static_cast<double>(f == ROTATIONZ)),
+            value)));
+    }
+    case TRANSLATIONM:
+        if (v1.isDimensionlessOrUnit(Unit::Length) && v2.isDimensionlessOrUnit(Unit::Length) && v3.isDimensionlessOrUnit(Unit::Length))
+            return translationMatrix(v1.getValue(), v2.getValue(), v3.getValue());
+        _EXPR_THROW("Translation units must be a length or dimensionless.", expr);
+    default:
+        break;
+    }
+
+    return Py::asObject(new QuantityPy(new Quantity(evaluateScalar(expr, f, args.size(), v1, v2, v3))));
+}
+
+/**
+  * Evaluate a function taking one to three numbers and returning a quantity.
+  * This part does not need Python and is shared with the native evaluator.
+  *
+  * @param expr Expression used for error reporting.
+  * @param f Function type.
+  * @param argc Number of arguments given to the function.
+  * @param v1 First argument.
+  * @param v2 Second argument, ignored if \a argc is less than 2.
+  * @param v3 Third argument, ignored if \a argc is less than 3.
+  *
+  * @returns The function result.
+  */
+
+Quantity FunctionExpression::evaluateScalar(const Expression *expr, int f, std::size_t argc,
+        const Quantity &v1, const Quantity &v2, const Quantity &v3)
+{
     double output;
     Unit unit;
     double scaler = 1;
@@ -2412,9 +2877,6 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     case COS:
     case SIN:
     case TAN:
-    case ROTATIONX:
-    case ROTATIONY:
-    case ROTATIONZ:
         if (!(v1.isDimensionlessOrUnit(Unit::Angle)))
             _EXPR_THROW("Unit must be either empty or an angle.", expr);
 
@@ -2498,7 +2960,7 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         break;
     }
     case ATAN2:
-        if (e2.isNone())
+        if (argc < 2)
             _EXPR_THROW("Invalid second argument.",expr);
 
         if (v1.getUnit() != v2.getUnit())
@@ -2507,12 +2969,12 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         scaler = 180.0 / M_PI;
         break;
     case MOD:
-        if (e2.isNone())
+        if (argc < 2)
             _EXPR_THROW("Invalid second argument.",expr);
         unit = v1.getUnit() / v2.getUnit();
         break;
     case POW: {
-        if (e2.isNone())
+        if (argc < 2)
             _EXPR_THROW("Invalid second argument.",expr);
 
         if (!v2.isDimensionless())
@@ -2530,23 +2992,17 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     }
     case HYPOT:
     case CATH:
-        if (e2.isNone())
+        if (argc < 2)
             _EXPR_THROW("Invalid second argument.",expr);
         if (v1.getUnit() != v2.getUnit())
             _EXPR_THROW("Units must be equal.",expr);
 
-        if (args.size() > 2) {
-            if (e3.isNone())
-                _EXPR_THROW("Invalid second argument.",expr);
+        if (argc > 2) {
             if (v2.getUnit() != v3.getUnit())
                 _EXPR_THROW("Units must be equal.",expr);
         }
         unit = v1.getUnit();
         break;
-    case TRANSLATIONM:
-        if (v1.isDimensionlessOrUnit(Unit::Length) && v2.isDimensionlessOrUnit(Unit::Length) && v3.isDimensionlessOrUnit(Unit::Length))
-            break;
-        _EXPR_THROW("Translation units must be a length or dimensionless.", expr);
     default:
         _EXPR_THROW("Unknown function: " << f,0);
     }
@@ -2611,11 +3067,11 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         break;
     }
     case HYPOT: {
-        output = sqrt(pow(v1.getValue(), 2) + pow(v2.getValue(), 2) + (!e3.isNone() ? pow(v3.getValue(), 2) : 0));
+        output = sqrt(pow(v1.getValue(), 2) + pow(v2.getValue(), 2) + (argc > 2 ? pow(v3.getValue(), 2) : 0));
         break;
     }
     case CATH: {
-        output = sqrt(pow(v1.getValue(), 2) - pow(v2.getValue(), 2) - (!e3.isNone() ? pow(v3.getValue(), 2) : 0));
+        output = sqrt(pow(v1.getValue(), 2) - pow(v2.getValue(), 2) - (argc > 2 ? pow(v3.getValue(), 2) : 0));
         break;
     }
     case ROUND:
@@ -2630,19 +3086,11 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     case FLOOR:
         output = floor(value);
         break;
-    case ROTATIONX:
-    case ROTATIONY:
-    case ROTATIONZ:
-        return Py::asObject(new Base::RotationPy(Base::Rotation(
-            Vector3d(static_cast<double>(f == ROTATIONX), static_cast<double>(f == ROTATIONY), static_cast<double>(f == ROTATIONZ)),
-            value)));
-    case TRANSLATIONM:
-        return translationMatrix(v1.getValue(), v2.getValue(), v3.getValue());
     default:
         _EXPR_THROW("Unknown function: " << f,0);
     }
 
-    return Py::asObject(new QuantityPy(new Quantity(scaler * output, unit)));
+    return Quantity(scaler * output, unit);
 }
 
 Py::Object FunctionExpression::_getPyValue() const {
@@ -2907,6 +3355,18 @@ const Property * VariableExpression::getProperty() const
         throw Expression::Exception(var.resolveErrorString().c_str());
 }
 
+/**
+  * Get the referenced property if the variable refers to the plain property
+  * without any sub path, see ObjectIdentifier::getDirectProperty().
+  *
+  * @returns The Property object, or 0 if not directly accessible.
+  */
+
+const Property * VariableExpression::getDirectProperty() const
+{
+    return var.getDirectProperty();
+}
+
 void VariableExpression::addComponent(Component *c) {
     do {
         if(!components.empty())
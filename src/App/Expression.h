@@ -24,6 +24,7 @@
 #define EXPRESSION_H
 
 #include <deque>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -179,6 +180,9 @@ public:
 
     bool hasComponent() const {return !components.empty();}
 
+    /// Revision of the expression tree, increased whenever it is modified
+    unsigned int getRevision() const {return revision;}
+
     boost::any getValueAsAny() const;
 
     Py::Object getPyValue() const;
@@ -216,6 +220,17 @@ protected:
 
     ComponentList components;
 
+private:
+    struct NativeProgram;
+
+    bool getNativeValue(App::any &value) const;
+    void markModified();
+
+    /// Compiled form of a purely numeric expression, evaluated without Python
+    mutable std::shared_ptr<NativeProgram> nativeProgram;
+    mutable bool nativeCompiled{false};
+    unsigned int revision{0};
+
 public:
     std::string comment;
 };
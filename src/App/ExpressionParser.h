@@ -336,6 +336,8 @@ public:
     Expression * simplify() const override;
 
     static Py::Object evaluate(const Expression *owner, int type, const std::vector<Expression*> &args);
+    static Base::Quantity evaluateScalar(const Expression *owner, int type, std::size_t argc,
+            const Base::Quantity &v1, const Base::Quantity &v2, const Base::Quantity &v3);
 
     Function getFunction() const {return f;}
     const std::vector<Expression*> &getArgs() const {return args;}
@@ -388,6 +390,8 @@ public:
 
     const App::Property *getProperty() const;
 
+    const App::Property *getDirectProperty() const;
+
     void addComponent(Component* component) override;
 
 protected:
@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <atomic>
 # include <cassert>
 #endif
 
@@ -1267,6 +1268,83 @@ Property *ObjectIdentifier::getProperty(int *ptype) const
     return result.resolvedProperty;
 }
 
+/**
+ * @brief Get pointer to the property if this object identifier refers to
+ * nothing but the plain property, i.e. without any pseudo property, sub path
+ * or unresolved sub object.
+ *
+ * This is used to read simple property values directly, bypassing Python.
+ *
+ * @return Pointer to property, or 0 otherwise.
+ */
+
+Property *ObjectIdentifier::getDirectProperty() const
+{
+    ResolveResults result(*this);
+    if(!result.resolvedDocumentObject
+            || !result.resolvedProperty
+            || result.propertyType != PseudoNone
+            || (!subObjectName.getString().empty() && !result.resolvedSubObject)
+            || result.propertyIndex + 1 != static_cast<int>(components.size())
+            || !components[result.propertyIndex].isSimple())
+        return nullptr;
+
+    auto container = result.resolvedProperty->getContainer();
+    if(!container || !container->isDerivedFrom(DocumentObject::getClassTypeId()))
+        return nullptr;
+    return result.resolvedProperty;
+}
+
+namespace {
+std::atomic<unsigned long> _ResolveRevision;
+}
+
+/**
+ * @brief Get the revision of the documents that identifiers are resolved in.
+ *
+ * The revision is increased whenever a document or object is created,
+ * deleted or relabeled, or a dynamic property is removed, i.e. whenever an
+ * identifier may resolve to a different property than before. A property
+ * returned by getDirectProperty() can therefore be cached as long as the
+ * revision doesn't change.
+ *
+ * @return The current revision.
+ */
+
+unsigned long ObjectIdentifier::getResolveRevision()
+{
+    static const bool connected = []() {
+        auto &app = GetApplication();
+        auto bump = []() {
+            touchResolveRevision();
+        };
+        app.signalNewDocument.connect([bump](const Document &, bool) {bump();});
+        app.signalDeleteDocument.connect([bump](const Document &) {bump();});
+        app.signalRelabelDocument.connect([bump](const Document &) {bump();});
+        app.signalRenameDocument.connect([bump](const Document &) {bump();});
+        app.signalNewObject.connect([bump](const DocumentObject &) {bump();});
+        app.signalDeletedObject.connect([bump](const DocumentObject &) {bump();});
+        app.signalRelabelObject.connect([bump](const DocumentObject &) {bump();});
+        app.signalRemoveDynamicProperty.connect([bump](const Property &) {bump();});
+        return true;
+    }();
+    (void)connected;
+    return _ResolveRevision;
+}
+
+/**
+ * @brief Increase the resolve revision.
+ *
+ * Call this when identifiers may resolve differently without any document
+ * signal being emitted, e.g. when a spreadsheet alias is moved to another
+ * cell.
+ */
+
+void ObjectIdentifier::touchResolveRevision()
+{
+    ++_ResolveRevision;
+}
+
 Property *ObjectIdentifier::resolveProperty(const App::DocumentObject *obj,
         const char *propertyName, App::DocumentObject *&sobj, int &ptype) const
 {
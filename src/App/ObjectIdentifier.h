@@ -323,6 +323,12 @@ public:
 
     App::Property *getProperty(int *ptype=nullptr) const;
 
+    App::Property *getDirectProperty() const;
+
+    static unsigned long getResolveRevision();
+
+    static void touchResolveRevision();
+
     App::ObjectIdentifier canonicalPath() const;
 
     // Document-centric functions
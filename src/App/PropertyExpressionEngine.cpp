@@ -128,6 +128,8 @@ Property *PropertyExpressionEngine::Copy() const
 
 void PropertyExpressionEngine::hasSetValue()
 {
+    cachedEvaluationOrderValid = false;
+
     App::DocumentObject *owner = dynamic_cast<App::DocumentObject*>(getContainer());
     if(!owner || !owner->getNameInDocument() || owner->isRestoring() || testFlag(LinkDetached)) {
         PropertyExpressionContainer::hasSetValue();
@@ -316,17 +318,56 @@ void PropertyExpressionEngine::Restore(Base::XMLReader &reader)
     reader.readEndElement("ExpressionEngine");
 }
 
+/**
+ * @brief Get the canonical dependency paths of an expression.
+ *
+ * The paths are cached in \a info and only collected again after the
+ * expression has been replaced or modified, or the paths may resolve
+ * differently, e.g. after an object was relabeled or a spreadsheet alias
+ * was changed.
+ *
+ * @param info Expression to query for dependencies
+ * @return Canonical paths of the dependencies
+ */
+
+const std::vector<ObjectIdentifier> &PropertyExpressionEngine::getDependencies(const ExpressionInfo &info) const
+{
+    unsigned long resolveRevision = ObjectIdentifier::getResolveRevision();
+    if (info.deps && info.deps->expression == info.expression
+            && info.deps->resolveRevision == resolveRevision
+            && (!info.expression || info.deps->revision == info.expression->getRevision()))
+        return info.deps->paths;
+
+    auto deps = std::make_shared<ExpressionInfo::Dependencies>();
+    deps->expression = info.expression;
+    deps->revision = 0;
+    deps->resolveRevision = resolveRevision;
+    if (info.expression) {
+        deps->revision = info.expression->getRevision();
+        for(auto &dep : info.expression->getDeps()) {
+            for(auto &propDeps : dep.second) {
+                if(propDeps.first.empty())
+                    continue;
+                for(auto &oid : propDeps.second)
+                    deps->paths.push_back(oid.canonicalPath());
+            }
+        }
+    }
+    info.deps = deps;
+    return deps->paths;
+}
+
 /**
  * @brief Update graph structure with given path and expression.
  * @param path Path
- * @param expression Expression to query for dependencies
+ * @param info Expression to query for dependencies
  * @param nodes Map with nodes of graph, including dependencies of 'expression'
  * @param revNodes Reverse map of the nodes, containing only the given paths, without dependencies.
  * @param edges Edges in graph
  */
 
 void PropertyExpressionEngine::buildGraphStructures(const ObjectIdentifier & path,
-                                                    const std::shared_ptr<Expression> expression,
+                                                    const ExpressionInfo &info,
                                                     boost::unordered_map<ObjectIdentifier, int> & nodes,
                                                     boost::unordered_map<int, ObjectIdentifier> & revNodes,
                                                     std::vector<Edge> & edges) const
@@ -343,23 +384,12 @@ void PropertyExpressionEngine::buildGraphStructures(const ObjectIdentifier & pat
     }
 
     /* Insert dependencies into nodes structure */
-    ExpressionDeps deps;
-    if (expression)
-        deps = expression->getDeps();
-
-    for(auto &dep : deps) {
-        for(auto &info : dep.second) {
-            if(info.first.empty())
-                continue;
-            for(auto &oid : info.second) {
-                ObjectIdentifier cPath(oid.canonicalPath());
-                if (nodes.find(cPath) == nodes.end()) {
-                    int s = nodes.size();
-                    nodes[cPath] = s;
-                }
-                edges.emplace_back(nodes[path], nodes[cPath]);
-            }
+    for(auto &cPath : getDependencies(info)) {
+        if (nodes.find(cPath) == nodes.end()) {
+            int s = nodes.size();
+            nodes[cPath] = s;
         }
+        edges.emplace_back(nodes[path], nodes[cPath]);
     }
 }
 
@@ -430,6 +460,7 @@ void PropertyExpressionEngine::afterRestore()
 }
 
 void PropertyExpressionEngine::onContainerRestored() {
+    cachedEvaluationOrderValid = false;
     Base::FlagToggler<bool> flag(restoring);
     unregisterElementReference();
     UpdateElementReferenceExpressionVisitor<PropertyExpressionEngine> v(*this);
@@ -519,6 +550,29 @@ struct cycle_detector : public boost::dfs_visitor<> {
     int & _src;
 };
 
+/**
+ * @brief Check whether the expression bound to \a path is evaluated with \a option.
+ */
+
+static bool isExecuted(const ObjectIdentifier &path, PropertyExpressionEngine::ExecuteOption option)
+{
+    if(option == PropertyExpressionEngine::ExecuteAll)
+        return true;
+    auto prop = path.getProperty();
+    if(!prop)
+        throw Base::RuntimeError("Path does not resolve to a property.");
+    bool is_output = prop->testStatus(App::Property::Output)||(prop->getType()&App::Prop_Output);
+    if((is_output && option==PropertyExpressionEngine::ExecuteNonOutput)
+            || (!is_output && option==PropertyExpressionEngine::ExecuteOutput))
+        return false;
+    if(option == PropertyExpressionEngine::ExecuteOnRestore
+            && !prop->testStatus(Property::Transient)
+            && !(prop->getType() & Prop_Transient)
+            && !prop->testStatus(Property::EvalOnRestore))
+        return false;
+    return true;
+}
+
 /**
  * @brief Build a graph of all expressions in \a exprs.
  * @param exprs Expressions to use in graph
@@ -535,20 +589,9 @@ void PropertyExpressionEngine::buildGraph(const ExpressionMap & exprs,
 
     // Build data structure for graph
     for (const auto & expr : exprs) {
-        if(option!=ExecuteAll) {
-            auto prop = expr.first.getProperty();
-            if(!prop)
-                throw Base::RuntimeError("Path does not resolve to a property.");
-            bool is_output = prop->testStatus(App::Property::Output)||(prop->getType()&App::Prop_Output);
-            if((is_output && option==ExecuteNonOutput) || (!is_output && option==ExecuteOutput))
-                continue;
-            if(option == ExecuteOnRestore
-                    && !prop->testStatus(Property::Transient)
-                    && !(prop->getType() & Prop_Transient)
-                    && !prop->testStatus(Property::EvalOnRestore))
-                continue;
-        }
-        buildGraphStructures(expr.first, expr.second.expression, nodes, revNodes, edges);
+        if(!isExecuted(expr.first, option))
+            continue;
+        buildGraphStructures(expr.first, expr.second, nodes, revNodes, edges);
     }
 
     // Create graph
@@ -575,27 +618,59 @@ void PropertyExpressionEngine::buildGraph(const ExpressionMap & exprs,
  * The code below builds a graph for all expressions in the engine, and
  * finds any circular dependencies. It also computes the internal evaluation
  * order, in case properties depends on each other.
+ *
+ * The order of all expressions is cached until the expressions change or
+ * their paths may resolve differently, and filtered for the requested
+ * \a option. A subset of a valid order stays
+ * valid, as it still respects the dependencies among the selected
+ * expressions.
  */
 
 std::vector<App::ObjectIdentifier> PropertyExpressionEngine::computeEvaluationOrder(ExecuteOption option)
 {
-    std::vector<App::ObjectIdentifier> evaluationOrder;
-    boost::unordered_map<int, ObjectIdentifier> revNodes;
-    DiGraph g;
+    auto sortExpressions = [this](ExecuteOption opt) {
+        std::vector<App::ObjectIdentifier> evaluationOrder;
+        boost::unordered_map<int, ObjectIdentifier> revNodes;
+        DiGraph g;
+
+        buildGraph(expressions, revNodes, g, opt);
+
+        /* Compute evaluation order for expressions */
+        std::vector<int> c;
+        topological_sort(g, std::back_inserter(c));
 
-    buildGraph(expressions, revNodes, g, option);
+        for (int i : c) {
+            // we return the evaluation order for our properties, not the dependencies
+            // the topo sort will contain node ids for both our props and their deps
+            if (revNodes.find(i) != revNodes.end())
+                evaluationOrder.push_back(revNodes[i]);
+        }
 
-    /* Compute evaluation order for expressions */
-    std::vector<int> c;
-    topological_sort(g, std::back_inserter(c));
+        return evaluationOrder;
+    };
 
-    for (int i : c) {
-        // we return the evaluation order for our properties, not the dependencies
-        // the topo sort will contain node ids for both our props and their deps
-        if (revNodes.find(i) != revNodes.end())
-            evaluationOrder.push_back(revNodes[i]);
+    unsigned long resolveRevision = ObjectIdentifier::getResolveRevision();
+    if (!cachedEvaluationOrderValid || cachedEvaluationOrderRevision != resolveRevision) {
+        try {
+            cachedEvaluationOrder = sortExpressions(ExecuteAll);
+        }
+        catch (Base::Exception &) {
+            // A cycle among all expressions may not involve the ones
+            // selected by option, so sort those alone
+            return sortExpressions(option);
+        }
+        cachedEvaluationOrderValid = true;
+        cachedEvaluationOrderRevision = resolveRevision;
     }
 
+    if (option == ExecuteAll)
+        return cachedEvaluationOrder;
+
+    std::vector<App::ObjectIdentifier> evaluationOrder;
+    for (const auto &path : cachedEvaluationOrder) {
+        if (isExecuted(path, option))
+            evaluationOrder.push_back(path);
+    }
     return evaluationOrder;
 }
 
@@ -792,12 +867,14 @@ std::string PropertyExpressionEngine::validateExpression(const ObjectIdentifier
 
     // Check for internal document object dependencies
 
-    // Copy current expressions
+    // Copy current expressions, sharing their cached dependencies
+    for (const auto &e : expressions)
+        getDependencies(e.second);
     ExpressionMap newExpressions = expressions;
 
     // Add expression in question
     std::shared_ptr<Expression> exprClone(expr->copy());
-    newExpressions[usePath].expression = exprClone;
+    newExpressions[usePath] = ExpressionInfo(exprClone);
 
     // Build graph; an exception will be thrown if it is not a DAG
     try {
@@ -87,6 +87,17 @@ public:
         std::shared_ptr<App::Expression> expression; /**< The actual expression tree */
         bool busy;
 
+        /// Canonical dependency paths of an expression at a given revision
+        struct Dependencies {
+            std::shared_ptr<const App::Expression> expression;
+            unsigned int revision;
+            /// see ObjectIdentifier::getResolveRevision()
+            unsigned long resolveRevision;
+            std::vector<App::ObjectIdentifier> paths;
+        };
+        /// Cached dependencies, see PropertyExpressionEngine::getDependencies()
+        mutable std::shared_ptr<const Dependencies> deps;
+
         explicit ExpressionInfo(std::shared_ptr<App::Expression> expression = std::shared_ptr<App::Expression>()) {
             this->expression = expression;
             this->busy = false;
@@ -180,8 +191,10 @@ private:
 
     std::vector<App::ObjectIdentifier> computeEvaluationOrder(ExecuteOption option);
 
+    const std::vector<App::ObjectIdentifier> &getDependencies(const ExpressionInfo &info) const;
+
     void buildGraphStructures(const App::ObjectIdentifier &path,
-                              const std::shared_ptr<Expression> expression, boost::unordered_map<App::ObjectIdentifier, int> &nodes,
+                              const ExpressionInfo &info, boost::unordered_map<App::ObjectIdentifier, int> &nodes,
                               boost::unordered_map<int, App::ObjectIdentifier> &revNodes, std::vector<Edge> &edges) const;
 
     void buildGraph(const ExpressionMap &exprs,
@@ -197,6 +210,10 @@ private:
 
     ExpressionMap expressions; /**< Stored expressions */
 
+    std::vector<App::ObjectIdentifier> cachedEvaluationOrder; /**< Evaluation order of all expressions */
+    bool cachedEvaluationOrderValid = false;
+    unsigned long cachedEvaluationOrderRevision = 0; /**< Resolve revision of the cached order */
+
     ValidatorFunc validator; /**< Valdiator functor */
 
     struct RestoredExpression {
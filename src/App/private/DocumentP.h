@@ -27,8 +27,10 @@
 #include <App/DocumentObserver.h>
 #include <CXX/Objects.hxx>
 #include <boost/graph/adjacency_list.hpp>
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // using VertexProperty = boost::property<boost::vertex_root_t, DocumentObject* >;
 using DependencyList = boost::adjacency_list <
@@ -57,6 +59,8 @@ struct DocumentP
     std::unordered_set<App::DocumentObject*> touchedObjs;
     std::unordered_map<std::string, DocumentObject*> objectMap;
     std::unordered_map<long, DocumentObject*> objectIdMap;
+    // Objects grouped by the key of their exact type, each in creation order
+    std::unordered_map<unsigned int, std::vector<DocumentObject*>> objectTypeMap;
     std::unordered_map<std::string, bool> partialLoadObjects;
     std::vector<DocumentObjectT> pendingRemove;
     long lastObjectId;
@@ -108,8 +112,41 @@ struct DocumentP
             _RecomputeLog.erase(obj);
     }
 
+    void addToTypeMap(DocumentObject *obj) {
+        objectTypeMap[obj->getTypeId().getKey()].push_back(obj);
+    }
+
+    void removeFromTypeMap(DocumentObject *obj) {
+        auto it = objectTypeMap.find(obj->getTypeId().getKey());
+        if (it == objectTypeMap.end())
+            return;
+        auto &objs = it->second;
+        objs.erase(std::remove(objs.begin(), objs.end(), obj), objs.end());
+        if (objs.empty())
+            objectTypeMap.erase(it);
+    }
+
+    /** Looks up the object types of the document derived from \a type
+     * @return the number of matching objects. \a objs is set to the objects
+     * of the matching type if there is only one, or to nullptr otherwise.
+     */
+    std::size_t findObjectsOfType(Base::Type type,
+                                  const std::vector<DocumentObject*> *&objs) const {
+        std::size_t count = 0;
+        int types = 0;
+        objs = nullptr;
+        for (const auto &v : objectTypeMap) {
+            if (Base::Type::fromKey(v.first).isDerivedFrom(type)) {
+                count += v.second.size();
+                objs = ++types == 1 ? &v.second : nullptr;
+            }
+        }
+        return count;
+    }
+
     void clearDocument() {
         objectArray.clear();
+        objectTypeMap.clear();
         for(auto &v : objectMap) {
             v.second->setStatus(ObjectStatus::Destroy, true);
             delete(v.second);
@@ -0,0 +1,537 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <string>
+#endif
+
+#include "BatchTransform.h"
+
+// SSE2 is part of every x86-64 CPU and thus can be used unconditionally. The AVX and AVX-512
+// kernels are compiled with function specific target attributes and are only selected if the
+// CPU and the operating system support them.
+#if defined(__GNUC__) && !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__)) \
+    && defined(__SSE2__)
+# define FC_BATCH_SSE2
+# define FC_BATCH_AVX
+# define FC_TARGET(arch) __attribute__((target(arch)))
+# include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define FC_BATCH_SSE2
+# if !defined(__clang__)
+#  define FC_BATCH_AVX
+# endif
+# define FC_TARGET(arch)
+# include <immintrin.h>
+# include <intrin.h>
+#endif
+
+using namespace Base;
+
+namespace {
+
+using TransformFunc = void (*)(const Matrix4D&, char*, std::size_t, std::size_t, BoundBox3f*);
+using BoundFunc = BoundBox3f (*)(const char*, std::size_t, std::size_t);
+using BoundTransformedFunc = BoundBox3d (*)(const Matrix4D&, const char*, std::size_t, std::size_t);
+
+struct Kernels
+{
+    TransformFunc transform;
+    BoundFunc bound;
+    BoundTransformedFunc boundTransformed;
+    const char* name;
+};
+
+inline const float* pointAt(const char* data, std::size_t index, std::size_t stride)
+{
+    return reinterpret_cast<const float*>(data + index * stride);
+}
+
+inline float* pointAt(char* data, std::size_t index, std::size_t stride)
+{
+    return reinterpret_cast<float*>(data + index * stride);
+}
+
+void transformScalar(const Matrix4D& mat, char* data, std::size_t count, std::size_t stride,
+                     BoundBox3f* box)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        Vector3f& pnt = *reinterpret_cast<Vector3f*>(pointAt(data, i, stride));
+        pnt = mat * pnt;
+        if (box) {
+            box->Add(pnt);
+        }
+    }
+}
+
+BoundBox3f boundScalar(const char* data, std::size_t count, std::size_t stride)
+{
+    BoundBox3f box;
+    for (std::size_t i = 0; i < count; i++) {
+        box.Add(*reinterpret_cast<const Vector3f*>(pointAt(data, i, stride)));
+    }
+    return box;
+}
+
+BoundBox3d boundTransformedScalar(const Matrix4D& mat, const char* data, std::size_t count,
+                                  std::size_t stride)
+{
+    BoundBox3d box;
+    for (std::size_t i = 0; i < count; i++) {
+        const float* pnt = pointAt(data, i, stride);
+        box.Add(mat * Vector3d(pnt[0], pnt[1], pnt[2]));
+    }
+    return box;
+}
+
+#if defined(FC_BATCH_SSE2)
+
+// The columns of the upper 3x4 part of the matrix, padded with a zero
+struct Columns
+{
+    double col[4][4];
+
+    explicit Columns(const Matrix4D& mat)
+    {
+        for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < 3; i++) {
+                col[j][i] = mat[i][j];
+            }
+            col[j][3] = 0.0;
+        }
+    }
+};
+
+// Only the three coordinates are read and written because the memory after them may
+// belong to another point or to data of a derived class.
+inline __m128 loadPoint(const float* pnt)
+{
+    __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(pnt)));
+    return _mm_movelh_ps(xy, _mm_load_ss(pnt + 2));
+}
+
+inline void storePoint(float* pnt, __m128 val)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(pnt), val);
+    _mm_store_ss(pnt + 2, _mm_movehl_ps(val, val));
+}
+
+// The minimum and maximum are computed as std::min/std::max do so that NaN values
+// are skipped in the same way as BoundBox3::Add does.
+inline BoundBox3f toBoundBox(__m128 minVal, __m128 maxVal)
+{
+    float minPnt[4];
+    float maxPnt[4];
+    _mm_storeu_ps(minPnt, minVal);
+    _mm_storeu_ps(maxPnt, maxVal);
+    return BoundBox3f(minPnt[0], minPnt[1], minPnt[2], maxPnt[0], maxPnt[1], maxPnt[2]);
+}
+
+inline BoundBox3d toBoundBox(const double* minPnt, const double* maxPnt)
+{
+    return BoundBox3d(minPnt[0], minPnt[1], minPnt[2], maxPnt[0], maxPnt[1], maxPnt[2]);
+}
+
+void transformSSE2(const Matrix4D& mat, char* data, std::size_t count, std::size_t stride,
+                   BoundBox3f* box)
+{
+    Columns cols(mat);
+    __m128d c0xy = _mm_loadu_pd(cols.col[0]);
+    __m128d c0zw = _mm_loadu_pd(cols.col[0] + 2);
+    __m128d c1xy = _mm_loadu_pd(cols.col[1]);
+    __m128d c1zw = _mm_loadu_pd(cols.col[1] + 2);
+    __m128d c2xy = _mm_loadu_pd(cols.col[2]);
+    __m128d c2zw = _mm_loadu_pd(cols.col[2] + 2);
+    __m128d c3xy = _mm_loadu_pd(cols.col[3]);
+    __m128d c3zw = _mm_loadu_pd(cols.col[3] + 2);
+
+    __m128 minVal = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 maxVal = _mm_set1_ps(-std::numeric_limits<float>::max());
+    for (std::size_t i = 0; i < count; i++) {
+        float* pnt = pointAt(data, i, stride);
+        __m128d x = _mm_set1_pd(pnt[0]);
+        __m128d y = _mm_set1_pd(pnt[1]);
+        __m128d z = _mm_set1_pd(pnt[2]);
+        __m128d rxy = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c0xy, x), _mm_mul_pd(c1xy, y)),
+                                            _mm_mul_pd(c2xy, z)), c3xy);
+        __m128d rzw = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c0zw, x), _mm_mul_pd(c1zw, y)),
+                                            _mm_mul_pd(c2zw, z)), c3zw);
+        __m128 res = _mm_movelh_ps(_mm_cvtpd_ps(rxy), _mm_cvtpd_ps(rzw));
+        storePoint(pnt, res);
+        minVal = _mm_min_ps(res, minVal);
+        maxVal = _mm_max_ps(res, maxVal);
+    }
+
+    if (box) {
+        *box = toBoundBox(minVal, maxVal);
+    }
+}
+
+BoundBox3f boundSSE2(const char* data, std::size_t count, std::size_t stride)
+{
+    __m128 minVal = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 maxVal = _mm_set1_ps(-std::numeric_limits<float>::max());
+    for (std::size_t i = 0; i < count; i++) {
+        __m128 pnt = loadPoint(pointAt(data, i, stride));
+        minVal = _mm_min_ps(pnt, minVal);
+        maxVal = _mm_max_ps(pnt, maxVal);
+    }
+    return toBoundBox(minVal, maxVal);
+}
+
+BoundBox3d boundTransformedSSE2(const Matrix4D& mat, const char* data, std::size_t count,
+                                std::size_t stride)
+{
+    Columns cols(mat);
+    __m128d c0xy = _mm_loadu_pd(cols.col[0]);
+    __m128d c0zw = _mm_loadu_pd(cols.col[0] + 2);
+    __m128d c1xy = _mm_loadu_pd(cols.col[1]);
+    __m128d c1zw = _mm_loadu_pd(cols.col[1] + 2);
+    __m128d c2xy = _mm_loadu_pd(cols.col[2]);
+    __m128d c2zw = _mm_loadu_pd(cols.col[2] + 2);
+    __m128d c3xy = _mm_loadu_pd(cols.col[3]);
+    __m128d c3zw = _mm_loadu_pd(cols.col[3] + 2);
+
+    __m128d minXY = _mm_set1_pd(std::numeric_limits<double>::max());
+    __m128d minZW = minXY;
+    __m128d maxXY = _mm_set1_pd(-std::numeric_limits<double>::max());
+    __m128d maxZW = maxXY;
+    for (std::size_t i = 0; i < count; i++) {
+        const float* pnt = pointAt(data, i, stride);
+        __m128d x = _mm_set1_pd(pnt[0]);
+        __m128d y = _mm_set1_pd(pnt[1]);
+        __m128d z = _mm_set1_pd(pnt[2]);
+        __m128d rxy = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c0xy, x), _mm_mul_pd(c1xy, y)),
+                                            _mm_mul_pd(c2xy, z)), c3xy);
+        __m128d rzw = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c0zw, x), _mm_mul_pd(c1zw, y)),
+                                            _mm_mul_pd(c2zw, z)), c3zw);
+        minXY = _mm_min_pd(rxy, minXY);
+        minZW = _mm_min_pd(rzw, minZW);
+        maxXY = _mm_max_pd(rxy, maxXY);
+        maxZW = _mm_max_pd(rzw, maxZW);
+    }
+
+    double minPnt[4];
+    double maxPnt[4];
+    _mm_storeu_pd(minPnt, minXY);
+    _mm_storeu_pd(minPnt + 2, minZW);
+    _mm_storeu_pd(maxPnt, maxXY);
+    _mm_storeu_pd(maxPnt + 2, maxZW);
+    return toBoundBox(minPnt, maxPnt);
+}
+
+#endif // FC_BATCH_SSE2
+
+#if defined(FC_BATCH_AVX)
+
+// With AVX one register holds a whole transformed point in double precision
+FC_TARGET("avx")
+void transformAVX(const Matrix4D& mat, char* data, std::size_t count, std::size_t stride,
+                  BoundBox3f* box)
+{
+    Columns cols(mat);
+    __m256d c0 = _mm256_loadu_pd(cols.col[0]);
+    __m256d c1 = _mm256_loadu_pd(cols.col[1]);
+    __m256d c2 = _mm256_loadu_pd(cols.col[2]);
+    __m256d c3 = _mm256_loadu_pd(cols.col[3]);
+
+    __m128 minVal = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 maxVal = _mm_set1_ps(-std::numeric_limits<float>::max());
+    for (std::size_t i = 0; i < count; i++) {
+        float* pnt = pointAt(data, i, stride);
+        __m256d x = _mm256_set1_pd(pnt[0]);
+        __m256d y = _mm256_set1_pd(pnt[1]);
+        __m256d z = _mm256_set1_pd(pnt[2]);
+        __m256d r = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c0, x),
+                                                              _mm256_mul_pd(c1, y)),
+                                                _mm256_mul_pd(c2, z)), c3);
+        __m128 res = _mm256_cvtpd_ps(r);
+        storePoint(pnt, res);
+        minVal = _mm_min_ps(res, minVal);
+        maxVal = _mm_max_ps(res, maxVal);
+    }
+
+    if (box) {
+        *box = toBoundBox(minVal, maxVal);
+    }
+}
+
+FC_TARGET("avx")
+BoundBox3d boundTransformedAVX(const Matrix4D& mat, const char* data, std::size_t count,
+                               std::size_t stride)
+{
+    Columns cols(mat);
+    __m256d c0 = _mm256_loadu_pd(cols.col[0]);
+    __m256d c1 = _mm256_loadu_pd(cols.col[1]);
+    __m256d c2 = _mm256_loadu_pd(cols.col[2]);
+    __m256d c3 = _mm256_loadu_pd(cols.col[3]);
+
+    __m256d minVal = _mm256_set1_pd(std::numeric_limits<double>::max());
+    __m256d maxVal = _mm256_set1_pd(-std::numeric_limits<double>::max());
+    for (std::size_t i = 0; i < count; i++) {
+        const float* pnt = pointAt(data, i, stride);
+        __m256d x = _mm256_set1_pd(pnt[0]);
+        __m256d y = _mm256_set1_pd(pnt[1]);
+        __m256d z = _mm256_set1_pd(pnt[2]);
+        __m256d r = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c0, x),
+                                                              _mm256_mul_pd(c1, y)),
+                                                _mm256_mul_pd(c2, z)), c3);
+        minVal = _mm256_min_pd(r, minVal);
+        maxVal = _mm256_max_pd(r, maxVal);
+    }
+
+    double minPnt[4];
+    double maxPnt[4];
+    _mm256_storeu_pd(minPnt, minVal);
+    _mm256_storeu_pd(maxPnt, maxVal);
+    return toBoundBox(minPnt, maxPnt);
+}
+
+// GCC 12 and later warn about the undefined pass-through operand that the headers use in
+// most AVX-512 intrinsics. The lanes in question are always overwritten.
+#if defined(__clang__)
+#elif defined(__GNUC__)
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// With AVX-512 two points are transformed at once, one in each 256-bit half
+FC_TARGET("avx512f")
+inline __m512d broadcastPair(double lower, double upper)
+{
+    return _mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_set1_pd(lower)),
+                              _mm256_set1_pd(upper), 1);
+}
+
+FC_TARGET("avx512f")
+void transformAVX512(const Matrix4D& mat, char* data, std::size_t count, std::size_t stride,
+                     BoundBox3f* box)
+{
+    Columns cols(mat);
+    __m512d c0 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[0]));
+    __m512d c1 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[1]));
+    __m512d c2 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[2]));
+    __m512d c3 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[3]));
+
+    __m128 minVal = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 maxVal = _mm_set1_ps(-std::numeric_limits<float>::max());
+    std::size_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        float* pnt1 = pointAt(data, i, stride);
+        float* pnt2 = pointAt(data, i + 1, stride);
+        __m512d x = broadcastPair(pnt1[0], pnt2[0]);
+        __m512d y = broadcastPair(pnt1[1], pnt2[1]);
+        __m512d z = broadcastPair(pnt1[2], pnt2[2]);
+        __m512d r = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(c0, x),
+                                                              _mm512_mul_pd(c1, y)),
+                                                _mm512_mul_pd(c2, z)), c3);
+        __m256 res = _mm512_cvtpd_ps(r);
+        __m128 res1 = _mm256_castps256_ps128(res);
+        __m128 res2 = _mm256_extractf128_ps(res, 1);
+        storePoint(pnt1, res1);
+        storePoint(pnt2, res2);
+        minVal = _mm_min_ps(res2, _mm_min_ps(res1, minVal));
+        maxVal = _mm_max_ps(res2, _mm_max_ps(res1, maxVal));
+    }
+
+    BoundBox3f rest;
+    transformAVX(mat, data + i * stride, count - i, stride, &rest);
+    if (box) {
+        *box = toBoundBox(minVal, maxVal);
+        box->Add(rest);
+    }
+}
+
+FC_TARGET("avx512f")
+BoundBox3d boundTransformedAVX512(const Matrix4D& mat, const char* data, std::size_t count,
+                                  std::size_t stride)
+{
+    Columns cols(mat);
+    __m512d c0 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[0]));
+    __m512d c1 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[1]));
+    __m512d c2 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[2]));
+    __m512d c3 = _mm512_broadcast_f64x4(_mm256_loadu_pd(cols.col[3]));
+
+    __m512d minVal = _mm512_set1_pd(std::numeric_limits<double>::max());
+    __m512d maxVal = _mm512_set1_pd(-std::numeric_limits<double>::max());
+    std::size_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        const float* pnt1 = pointAt(data, i, stride);
+        const float* pnt2 = pointAt(data, i + 1, stride);
+        __m512d x = broadcastPair(pnt1[0], pnt2[0]);
+        __m512d y = broadcastPair(pnt1[1], pnt2[1]);
+        __m512d z = broadcastPair(pnt1[2], pnt2[2]);
+        __m512d r = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(c0, x),
+                                                              _mm512_mul_pd(c1, y)),
+                                                _mm512_mul_pd(c2, z)), c3);
+        minVal = _mm512_min_pd(r, minVal);
+        maxVal = _mm512_max_pd(r, maxVal);
+    }
+
+    double minPnt[8];
+    double maxPnt[8];
+    _mm512_storeu_pd(minPnt, minVal);
+    _mm512_storeu_pd(maxPnt, maxVal);
+    BoundBox3d box = toBoundBox(minPnt, maxPnt);
+    box.Add(toBoundBox(minPnt + 4, maxPnt + 4));
+    box.Add(boundTransformedAVX(mat, data + i * stride, count - i, stride));
+    return box;
+}
+
+#if defined(__clang__)
+#elif defined(__GNUC__)
+# pragma GCC diagnostic pop
+#endif
+
+bool hasAVX()
+{
+# if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    // the OS must save the YMM registers
+    return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+# else
+    return __builtin_cpu_supports("avx");
+# endif
+}
+
+bool hasAVX512()
+{
+# if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7 || !hasAVX()) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    // the OS must save the opmask and upper ZMM registers
+    return (info[1] & (1 << 16)) != 0 && (_xgetbv(0) & 0xe6) == 0xe6;
+# else
+    return __builtin_cpu_supports("avx512f");
+# endif
+}
+
+#endif // FC_BATCH_AVX
+
+// Returns the kernels of the named instruction set if this machine supports them
+bool findKernels(const std::string& name, Kernels& impl)
+{
+#if defined(FC_BATCH_AVX)
+    if (name == "AVX-512" && hasAVX512()) {
+        impl = {transformAVX512, boundSSE2, boundTransformedAVX512, "AVX-512"};
+        return true;
+    }
+    if (name == "AVX" && hasAVX()) {
+        impl = {transformAVX, boundSSE2, boundTransformedAVX, "AVX"};
+        return true;
+    }
+#endif
+#if defined(FC_BATCH_SSE2)
+    if (name == "SSE2") {
+        impl = {transformSSE2, boundSSE2, boundTransformedSSE2, "SSE2"};
+        return true;
+    }
+#endif
+    if (name == "Scalar") {
+        impl = {transformScalar, boundScalar, boundTransformedScalar, "Scalar"};
+        return true;
+    }
+    return false;
+}
+
+Kernels selectKernels()
+{
+#if defined(FC_BATCH_AVX) && !defined(_MSC_VER)
+    __builtin_cpu_init();
+#endif
+    Kernels impl {};
+    for (const char* name : {"AVX-512", "AVX", "SSE2", "Scalar"}) {
+        if (findKernels(name, impl)) {
+            break;
+        }
+    }
+    return impl;
+}
+
+Kernels& kernels()
+{
+    static Kernels impl = selectKernels();
+    return impl;
+}
+
+} // namespace
+
+void Base::transformPoints(const Matrix4D& mat,
+                           Vector3f* points,
+                           std::size_t count,
+                           std::size_t stride,
+                           BoundBox3f* box)
+{
+    if (box) {
+        box->SetVoid();
+    }
+    if (count > 0) {
+        kernels().transform(mat, reinterpret_cast<char*>(points), count, stride, box);
+    }
+}
+
+BoundBox3f Base::boundBoxOfPoints(const Vector3f* points, std::size_t count, std::size_t stride)
+{
+    if (count == 0) {
+        return BoundBox3f();
+    }
+    return kernels().bound(reinterpret_cast<const char*>(points), count, stride);
+}
+
+BoundBox3d Base::boundBoxOfPoints(const Matrix4D& mat,
+                                  const Vector3f* points,
+                                  std::size_t count,
+                                  std::size_t stride)
+{
+    if (count == 0) {
+        return BoundBox3d();
+    }
+    return kernels().boundTransformed(mat, reinterpret_cast<const char*>(points), count, stride);
+}
+
+const char* Base::batchInstructionSet()
+{
+    return kernels().name;
+}
+
+bool Base::setBatchInstructionSet(const char* name)
+{
+    Kernels& impl = kernels();
+    if (!name) {
+        impl = selectKernels();
+        return true;
+    }
+    return findKernels(name, impl);
+}
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef BASE_BATCHTRANSFORM_H
+#define BASE_BATCHTRANSFORM_H
+
+#include <cstddef>
+#include <vector>
+
+#include "BoundBox.h"
+#include "Matrix.h"
+#include "Vector3D.h"
+
+namespace Base
+{
+
+/** @name Batch operations on point arrays
+ * The functions process whole arrays of points and use SSE2, AVX or AVX-512 depending on
+ * what the CPU supports at runtime. On other platforms a scalar implementation is used.
+ * The arithmetic is done in the same order and precision as Matrix4D's operators so that
+ * the results match the point-wise computation.
+ *
+ * The points are addressed with a byte \a stride. This way arrays of classes derived from
+ * Vector3f that carry additional data (like mesh points) can be processed in place.
+ */
+//@{
+/** Transforms \a count points in place. If \a box is given it's set to the
+ * bounding box of the transformed points.
+ */
+BaseExport void transformPoints(const Matrix4D& mat,
+                                Vector3f* points,
+                                std::size_t count,
+                                std::size_t stride,
+                                BoundBox3f* box = nullptr);
+/** Returns the bounding box of \a count points. */
+BaseExport BoundBox3f boundBoxOfPoints(const Vector3f* points,
+                                       std::size_t count,
+                                       std::size_t stride);
+/** Returns the bounding box of \a count points transformed with \a mat in double precision.
+ * The points themselves are not modified.
+ */
+BaseExport BoundBox3d boundBoxOfPoints(const Matrix4D& mat,
+                                       const Vector3f* points,
+                                       std::size_t count,
+                                       std::size_t stride);
+/** Returns the name of the instruction set the batch operations use on this machine. */
+BaseExport const char* batchInstructionSet();
+/** Forces the batch operations to use the instruction set \a name, one of "AVX-512", "AVX",
+ * "SSE2" or "Scalar", and returns false if it isn't available on this machine. A null
+ * pointer restores the automatic selection. This is meant for testing and must not be
+ * called while other threads use the batch operations.
+ */
+BaseExport bool setBatchInstructionSet(const char* name);
+
+template<typename T>
+inline void transformPoints(const Matrix4D& mat, std::vector<T>& points, BoundBox3f* box = nullptr)
+{
+    transformPoints(mat, points.data(), points.size(), sizeof(T), box);
+}
+
+template<typename T>
+inline BoundBox3f boundBoxOfPoints(const std::vector<T>& points)
+{
+    return boundBoxOfPoints(points.data(), points.size(), sizeof(T));
+}
+
+template<typename T>
+inline BoundBox3d boundBoxOfPoints(const Matrix4D& mat, const std::vector<T>& points)
+{
+    return boundBoxOfPoints(mat, points.data(), points.size(), sizeof(T));
+}
+//@}
+
+}  // namespace Base
+
+#endif  // BASE_BATCHTRANSFORM_H
@@ -29,8 +29,12 @@
 # elif defined(FC_OS_LINUX) || defined(FC_OS_MACOSX)
 #  include <unistd.h>
 # endif
+# include <condition_variable>
 # include <cstring>
 # include <functional>
+# include <memory>
+# include <mutex>
+# include <thread>
 #endif
 
 #include "Console.h"
@@ -110,6 +114,183 @@ private:
 
 ConsoleOutput* ConsoleOutput::instance = nullptr;
 
+/** Delivers messages to the observers from a background thread.
+ * Producers reserve a slot of a bounded ring buffer with a single atomic
+ * operation and never block unless the buffer is full. Each slot carries a
+ * sequence number telling whether it is free for the producer of a given
+ * round or ready for the dispatcher.
+ */
+class ConsoleDispatcher
+{
+public:
+    static ConsoleDispatcher* getInstance() {
+        if (!instance)
+            instance = new ConsoleDispatcher;
+        return instance;
+    }
+    static bool exists() {
+        return instance != nullptr;
+    }
+    static void destruct() {
+        delete instance;
+        instance = nullptr;
+    }
+
+    void push(LogStyle category, IntendedRecipient recipient, ContentType content,
+              const std::string& notifier, std::string&& msg)
+    {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & (capacity - 1)];
+            std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.category = category;
+                    slot.recipient = recipient;
+                    slot.content = content;
+                    slot.notifier = notifier;
+                    slot.msg = std::move(msg);
+                    slot.sequence.store(pos + 1);
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                // The buffer is full, let the dispatcher catch up
+                wake();
+                std::this_thread::yield();
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (idle) {
+            wake();
+        }
+    }
+
+    void flush(bool wait) {
+        // The dispatcher thread is either delivering already or has crashed
+        if (isDispatcherThread()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(consumerMutex, std::defer_lock);
+        // A crashing thread may hold the lock itself, so it must not wait for it
+        if (wait) {
+            lock.lock();
+        }
+        else if (!lock.try_lock()) {
+            return;
+        }
+        dispatchPending();
+    }
+
+    bool isDispatcherThread() const {
+        return std::this_thread::get_id() == thread.get_id();
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        LogStyle category{LogStyle::Message};
+        IntendedRecipient recipient{IntendedRecipient::All};
+        ContentType content{ContentType::Untranslated};
+        std::string notifier;
+        std::string msg;
+    };
+
+    ConsoleDispatcher()
+        : slots(new Slot[capacity])
+    {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        thread = std::thread([this] { run(); });
+    }
+
+    ~ConsoleDispatcher() {
+        stop = true;
+        wake();
+        thread.join();
+        std::lock_guard<std::mutex> lock(consumerMutex);
+        dispatchPending();
+    }
+
+    void wake() {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeup.notify_one();
+    }
+
+    bool hasPending() const {
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        return slots[pos & (capacity - 1)].sequence.load() == pos + 1;
+    }
+
+    // Must be called with consumerMutex held
+    bool dispatchPending() {
+        bool dispatched = false;
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & (capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            LogStyle category = slot.category;
+            IntendedRecipient recipient = slot.recipient;
+            ContentType content = slot.content;
+            std::string notifier = std::move(slot.notifier);
+            std::string msg = std::move(slot.msg);
+            // Hand the slot back to the producers before notifying
+            slot.sequence.store(pos + capacity, std::memory_order_release);
+            dequeuePos.store(++pos, std::memory_order_relaxed);
+
+            try {
+                Console().notifyPrivate(category, recipient, content, notifier, msg);
+            }
+            catch (...) {
+                // an observer must not stop the delivery of further messages
+            }
+            dispatched = true;
+        }
+        return dispatched;
+    }
+
+    void run() {
+        while (!stop) {
+            {
+                std::lock_guard<std::mutex> lock(consumerMutex);
+                if (dispatchPending()) {
+                    continue;
+                }
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            idle = true;
+            // The timeout only guards against a wake-up racing with 'idle'
+            wakeup.wait_for(lock, std::chrono::milliseconds(50),
+                            [this] { return stop || hasPending(); });
+            idle = false;
+        }
+    }
+
+    static constexpr std::size_t capacity = 4096; // must be a power of two
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::size_t> enqueuePos{0};
+    std::atomic<std::size_t> dequeuePos{0};
+    std::mutex consumerMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wakeup;
+    std::atomic<bool> idle{false};
+    std::atomic<bool> stop{false};
+    std::thread thread;
+
+    static ConsoleDispatcher* instance;
+};
+
+ConsoleDispatcher* ConsoleDispatcher::instance = nullptr;
+
 }
 
 //**************************************************************************
@@ -127,6 +308,7 @@ ConsoleSingleton::ConsoleSingleton()
 
 ConsoleSingleton::~ConsoleSingleton()
 {
+    ConsoleDispatcher::destruct();
     ConsoleOutput::destruct();
     for (ILogger* Iter : _aclObservers)
         delete Iter;
@@ -241,12 +423,21 @@ bool ConsoleSingleton::IsMsgTypeEnabled(const char* sObs, FreeCAD_ConsoleMsgType
 
 void ConsoleSingleton::SetConnectionMode(ConnectionMode mode)
 {
-    connectionMode = mode;
-
     // make sure this method gets called from the main thread
-    if (connectionMode == Queued) {
+    if (mode == Queued) {
         ConsoleOutput::getInstance();
     }
+    // start the dispatcher before the first message is posted to it
+    else if (mode == Async) {
+        ConsoleDispatcher::getInstance();
+    }
+
+    connectionMode = mode;
+
+    // deliver what is left over from the asynchronous mode in order
+    if (mode != Async) {
+        Flush();
+    }
 }
 
 //**************************************************************************
@@ -292,6 +483,37 @@ void ConsoleSingleton::postEvent(ConsoleSingleton::FreeCAD_ConsoleMsgType type,
     QCoreApplication::postEvent(ConsoleOutput::getInstance(), new ConsoleEvent(type, recipient, content, notifiername, msg));
 }
 
+void ConsoleSingleton::postAsync(LogStyle category, IntendedRecipient recipient, ContentType content,
+                                 const std::string& notifiername, std::string&& msg)
+{
+    ConsoleDispatcher* dispatcher = ConsoleDispatcher::getInstance();
+    // Messages sent by an observer while it is notified are delivered at once,
+    // waiting for the dispatcher here would dead-lock on a full buffer
+    if (dispatcher->isDispatcherThread()) {
+        notifyPrivate(category, recipient, content, notifiername, msg);
+    }
+    else {
+        dispatcher->push(category, recipient, content, notifiername, std::move(msg));
+    }
+}
+
+bool ConsoleSingleton::IsActive(LogStyle category) const
+{
+    for (ILogger* Iter : _aclObservers) {
+        if (Iter->isActive(category)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ConsoleSingleton::Flush(bool wait)
+{
+    if (ConsoleDispatcher::exists()) {
+        ConsoleDispatcher::getInstance()->flush(wait);
+    }
+}
+
 ILogger *ConsoleSingleton::Get(const char *Name) const
 {
     const char* OName{};
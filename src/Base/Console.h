@@ -26,6 +26,7 @@
 
 // Std. configurations
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <set>
@@ -667,7 +668,8 @@ public:
         This function is used by all specific convenience functions (Send(), Message(), Warning(), Error(), Log(), Critical and
         UserNotification, without or without notifier id).
 
-        Notification can be direct or via queue.
+        Notification can be direct, via the Qt event queue or via the asynchronous dispatcher.
+        The message is only formatted if at least one observer accepts its category.
     */
     template <Base::LogStyle,
           Base::IntendedRecipient = Base::IntendedRecipient::All,
@@ -742,6 +744,13 @@ public:
     void AttachObserver(ILogger *pcObserver);
     /// Detaches an Observer from FCConsole
     void DetachObserver(ILogger *pcObserver);
+    /// Checks whether any attached observer accepts messages of the given category
+    bool IsActive(LogStyle category) const;
+    /** Delivers all messages pending in the asynchronous dispatcher
+     * If \a wait is false nothing is delivered while another thread is
+     * delivering, which is what the crash handlers use.
+     */
+    void Flush(bool wait = true);
 
     /// enumeration for the console modes
     enum ConsoleMode{
@@ -749,7 +758,11 @@ public:
     };
     enum ConnectionMode {
         Direct = 0,
-        Queued =1
+        Queued =1,
+        /** Messages are passed through a lock-free buffer and delivered by a background thread.
+         * This is opt-in: the observers are then called from that thread and must not touch the GUI.
+         */
+        Async = 2
     };
 
     enum FreeCAD_ConsoleMsgType {
@@ -816,7 +829,7 @@ protected:
 
     bool _bVerbose{true};
     bool _bCanRefresh{true};
-    ConnectionMode connectionMode{Direct};
+    std::atomic<ConnectionMode> connectionMode{Direct};
 
     // Singleton!
     ConsoleSingleton();
@@ -825,6 +838,8 @@ protected:
 private:
     void postEvent(ConsoleSingleton::FreeCAD_ConsoleMsgType type, IntendedRecipient recipient,
                    ContentType content, const std::string& notifiername, const std::string& msg);
+    void postAsync(LogStyle category, IntendedRecipient recipient, ContentType content,
+                   const std::string& notifiername, std::string&& msg);
     void notifyPrivate(LogStyle category, IntendedRecipient recipient, ContentType content,
                        const std::string& notifiername, const std::string& msg);
 
@@ -839,6 +854,7 @@ private:
     int _defaultLogLevel;
 
     friend class ConsoleOutput;
+    friend class ConsoleDispatcher;
 };
 
 /** Access to the Console
@@ -1064,11 +1080,19 @@ template <Base::LogStyle category,
           typename... Args>
 inline void Base::ConsoleSingleton::Send( const std::string & notifiername, const char * pMsg, Args&&... args )
 {
+    if (!IsActive(category)) {
+        return;
+    }
+
     std::string format = fmt::sprintf(pMsg, args...);
 
-    if (connectionMode == Direct) {
+    ConnectionMode mode = connectionMode;
+    if (mode == Direct) {
         Notify<category, recipient, contenttype>(notifiername,format);
     }
+    else if (mode == Async) {
+        postAsync(category, recipient, contenttype, notifiername, std::move(format));
+    }
     else {
 
         auto type = getConsoleMsg(category);
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <exception>
+# include <vector>
+#endif
+
+#include <QtConcurrentMap>
+
+#include "Parallel.h"
+
+
+void Base::parallelForRange(std::size_t count,
+                            const std::function<void(std::size_t, std::size_t)>& func,
+                            std::size_t blockSize)
+{
+    if (count == 0) {
+        return;
+    }
+
+    blockSize = std::max<std::size_t>(blockSize, 1);
+    if (count <= blockSize) {
+        func(0, count);
+        return;
+    }
+
+    std::vector<std::size_t> blocks;
+    blocks.reserve((count + blockSize - 1) / blockSize);
+    for (std::size_t begin = 0; begin < count; begin += blockSize) {
+        blocks.push_back(begin);
+    }
+
+    // QtConcurrent only transfers QException to the calling thread
+    std::vector<std::exception_ptr> errors(blocks.size());
+    QtConcurrent::blockingMap(blocks, [&](const std::size_t& begin) {
+        try {
+            func(begin, std::min(begin + blockSize, count));
+        }
+        catch (...) {
+            errors[begin / blockSize] = std::current_exception();
+        }
+    });
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
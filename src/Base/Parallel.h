@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef BASE_PARALLEL_H
+#define BASE_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include <FCGlobal.h>
+
+namespace Base
+{
+
+/** @name Data parallel loops
+ * The index range [0, count) is split into consecutive blocks of \a blockSize indices
+ * that are processed by the global thread pool. Each call must only write to data that
+ * belongs to its own indices.
+ *
+ * If there is a single block it's processed in the calling thread. This way callers can
+ * force a serial run by passing \a count as block size.
+ *
+ * Exceptions are caught per block. When all blocks are done the exception of the first
+ * failed block in index order is rethrown, so the outcome doesn't depend on the scheduling.
+ */
+//@{
+/** Calls \a func(begin, end) for every block [begin, end) of the index range. */
+BaseExport void parallelForRange(std::size_t count,
+                                 const std::function<void(std::size_t, std::size_t)>& func,
+                                 std::size_t blockSize = 1024);
+
+/** Calls \a func(i) for every index of the range. */
+template<typename Func>
+inline void parallelFor(std::size_t count, Func&& func, std::size_t blockSize = 1024)
+{
+    parallelForRange(
+        count,
+        [&func](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                func(i);
+            }
+        },
+        blockSize);
+}
+//@}
+
+}  // namespace Base
+
+#endif  // BASE_PARALLEL_H
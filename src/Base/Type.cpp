@@ -49,9 +49,11 @@ struct Base::TypeData
   Type parent;
   Type type;
   Type::instantiationMethod instMethod;
+  /// The keys of all ancestors from the root type down to this type
+  std::vector<unsigned int> ancestors;
 };
 
-map<string,unsigned int> Type::typemap;
+unordered_map<string,unsigned int> Type::typemap;
 vector<TypeData*>        Type::typedata;
 set<string>              Type::loadModuleSet;
 
@@ -117,6 +119,11 @@ const Type Type::createType(const Type parent, const char *name, instantiationMe
   Type newType;
   newType.index = static_cast<unsigned int>(Type::typedata.size());
   TypeData * typeData = new TypeData(name, newType, parent,method);
+  // The ancestor chain lets isDerivedFrom() check a single slot given by
+  // the depth of the queried type instead of walking up the hierarchy
+  if (!parent.isBad())
+    typeData->ancestors = Type::typedata[parent.getKey()]->ancestors;
+  typeData->ancestors.push_back(newType.getKey());
   Type::typedata.push_back(typeData);
 
   // add to dictionary for fast lookup
@@ -131,7 +138,9 @@ void Type::init()
   assert(Type::typedata.size() == 0);
 
 
-  Type::typedata.push_back(new TypeData("BadType"));
+  auto badTypeData = new TypeData("BadType");
+  badTypeData->ancestors.push_back(0);
+  Type::typedata.push_back(badTypeData);
   Type::typemap["BadType"] = 0;
 
 
@@ -148,9 +157,7 @@ void Type::destruct()
 
 Type Type::fromName(const char *name)
 {
-  std::map<std::string,unsigned int>::const_iterator pos;
-
-  pos = typemap.find(name);
+  auto pos = typemap.find(name);
   if (pos != typemap.end())
     return typedata[pos->second]->type;
   else
@@ -177,15 +184,9 @@ const Type Type::getParent() const
 
 bool Type::isDerivedFrom(const Type type) const
 {
-
-  Type temp(*this);
-  do {
-    if (temp == type)
-      return true;
-    temp = temp.getParent();
-  } while (temp != badType());
-
-  return false;
+  const auto& ancestors = typedata[index]->ancestors;
+  const auto depth = typedata[type.index]->ancestors.size() - 1;
+  return depth < ancestors.size() && ancestors[depth] == type.index;
 }
 
 int Type::getAllDerivedFrom(const Type type, std::vector<Type> & List)
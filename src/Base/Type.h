@@ -29,6 +29,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #ifndef FC_GLOBAL_H
 #include <FCGlobal.h>
@@ -133,7 +134,7 @@ protected:
 private:
   unsigned int index{0};
 
-  static std::map<std::string,unsigned int> typemap;
+  static std::unordered_map<std::string,unsigned int> typemap;
   static std::vector<TypeData*>     typedata;
   static std::set<std::string>  loadModuleSet;
 
@@ -95,6 +95,14 @@ public:
                            &Module::projectToDXF,
                            "string = projectToDXF(TopoShape[,App.Vector Direction, string type])\n"
                            " -- Project a shape and return the DXF representation as string.");
+        add_varargs_method(
+            "projectToFiles",
+            &Module::projectToFiles,
+            "list = projectToFiles(list of TopoShape, list of file names[, App.Vector direction, "
+            "string type, float tolerance])\n"
+            " -- Project the shapes concurrently and write each to the file of the same index.\n"
+            "Files with the extension svg are written as SVG, all others as DXF.\n"
+            "Returns the list of error messages, an empty string means success.");
         add_varargs_method(
             "removeSvgTags",
             &Module::removeSvgTags,
@@ -339,6 +347,66 @@ private:
             Alg.getDXF(hidden ? ProjectionAlgos::WithHidden : ProjectionAlgos::Plain, scale, tol));
         return result;
     }
+    Py::Object projectToFiles(const Py::Tuple& args)
+    {
+        PyObject* pcObjShapes;
+        PyObject* pcObjFiles;
+        PyObject* pcObjDir = nullptr;
+        const char* type = nullptr;
+        float tol = 0.1f;
+
+        if (!PyArg_ParseTuple(args.ptr(),
+                              "OO|O!sf",
+                              &pcObjShapes,
+                              &pcObjFiles,
+                              &(Base::VectorPy::Type),
+                              &pcObjDir,
+                              &type,
+                              &tol)) {
+            throw Py::Exception();
+        }
+
+        std::vector<TopoDS_Shape> shapes;
+        Py::Sequence shapeList(pcObjShapes);
+        shapes.reserve(shapeList.size());
+        for (Py::Sequence::iterator it = shapeList.begin(); it != shapeList.end(); ++it) {
+            PyObject* item = (*it).ptr();
+            if (!PyObject_TypeCheck(item, &(TopoShapePy::Type))) {
+                throw Py::TypeError("Expected a list of shapes");
+            }
+            shapes.push_back(static_cast<TopoShapePy*>(item)->getTopoShapePtr()->getShape());
+        }
+
+        std::vector<std::string> files;
+        Py::Sequence fileList(pcObjFiles);
+        files.reserve(fileList.size());
+        for (Py::Sequence::iterator it = fileList.begin(); it != fileList.end(); ++it) {
+            files.push_back(Py::String(*it));
+        }
+
+        Base::Vector3d Vector(0, 0, 1);
+        if (pcObjDir) {
+            Vector = static_cast<Base::VectorPy*>(pcObjDir)->value();
+        }
+
+        ProjectionAlgos::ExtractionType extractionType = ProjectionAlgos::Plain;
+        if (type && std::string(type) == "ShowHiddenLines") {
+            extractionType = ProjectionAlgos::WithHidden;
+        }
+
+        std::vector<BatchProjection::Result> results;
+        {
+            Base::PyGILStateRelease release;
+            BatchProjection batch(Vector, extractionType, tol);
+            results = batch.exportFiles(shapes, files);
+        }
+
+        Py::List output;
+        for (const auto& it : results) {
+            output.append(Py::String(it.error));
+        }
+        return output;
+    }
     Py::Object removeSvgTags(const Py::Tuple& args)
     {
         const char* svgcode;
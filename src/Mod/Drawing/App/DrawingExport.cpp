@@ -22,8 +22,11 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
 #include <cmath>
+#include <exception>
 #include <sstream>
+#include <vector>
 
 #include <Approx_Curve3d.hxx>
 #include <BRepAdaptor_Curve.hxx>
@@ -52,6 +55,10 @@
 #endif
 #endif
 
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
 #include <Base/Tools.h>
 #include <Base/Vector3D.h>
 
@@ -65,6 +72,45 @@ using BRepAdaptor_HCurve = BRepAdaptor_Curve;
 using namespace Drawing;
 using namespace std;
 
+namespace
+{
+// Writes a floating point number exactly as a stream with default settings does
+// (i.e. like printf's %g) but bypasses the locale facets of the stream.
+class Num
+{
+public:
+    explicit Num(double value)
+        : value(value)
+    {}
+
+    friend std::ostream& operator<<(std::ostream& out, const Num& num)
+    {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        char buf[32];
+        auto res = std::to_chars(buf, buf + sizeof(buf), num.value, std::chars_format::general, 6);
+        if (res.ec == std::errc()) {
+            return out.write(buf, res.ptr - buf);
+        }
+#endif
+        return out << num.value;
+    }
+
+private:
+    double value;
+};
+}  // namespace
+
+std::string DrawingOutput::convertEdges(const TopoDS_Shape& input, const PrintEdge& print) const
+{
+    std::ostringstream result;
+    int i = 1;
+    for (TopExp_Explorer xp(input, TopAbs_EDGE); xp.More(); xp.Next(), i++) {
+        BRepAdaptor_Curve adapt(TopoDS::Edge(xp.Current()));
+        print(adapt, i, result);
+    }
+    return result.str();
+}
+
 TopoDS_Edge DrawingOutput::asCircle(const BRepAdaptor_Curve& c) const
 {
     double curv = 0;
@@ -159,12 +205,7 @@ SVGOutput::SVGOutput()
 
 std::string SVGOutput::exportEdges(const TopoDS_Shape& input)
 {
-    std::stringstream result;
-
-    TopExp_Explorer edges(input, TopAbs_EDGE);
-    for (int i = 1; edges.More(); edges.Next(), i++) {
-        const TopoDS_Edge& edge = TopoDS::Edge(edges.Current());
-        BRepAdaptor_Curve adapt(edge);
+    return convertEdges(input, [this](const BRepAdaptor_Curve& adapt, int i, std::ostream& result) {
         if (adapt.GetType() == GeomAbs_Circle) {
             printCircle(adapt, result);
         }
@@ -188,9 +229,7 @@ std::string SVGOutput::exportEdges(const TopoDS_Shape& input)
         else {
             printGeneric(adapt, i, result);
         }
-    }
-
-    return result.str();
+    });
 }
 
 void SVGOutput::printCircle(const BRepAdaptor_Curve& c, std::ostream& out)
@@ -211,7 +250,8 @@ void SVGOutput::printCircle(const BRepAdaptor_Curve& c, std::ostream& out)
 
     // a full circle
     if (fabs(l - f) > 1.0 && s.SquareDistance(e) < 0.001) {
-        out << "<circle cx =\"" << p.X() << "\" cy =\"" << p.Y() << "\" r =\"" << r << "\" />";
+        out << "<circle cx =\"" << Num(p.X()) << "\" cy =\"" << Num(p.Y()) << "\" r =\"" << Num(r)
+            << "\" />";
     }
     // arc of circle
     else {
@@ -219,8 +259,9 @@ void SVGOutput::printCircle(const BRepAdaptor_Curve& c, std::ostream& out)
         char xar = '0';                         // x-axis-rotation
         char las = (l - f > D_PI) ? '1' : '0';  // large-arc-flag
         char swp = (a < 0) ? '1' : '0';  // sweep-flag, i.e. clockwise (0) or counter-clockwise (1)
-        out << "<path d=\"M" << s.X() << " " << s.Y() << " A" << r << " " << r << " " << xar << " "
-            << las << " " << swp << " " << e.X() << " " << e.Y() << "\" />";
+        out << "<path d=\"M" << Num(s.X()) << " " << Num(s.Y()) << " A" << Num(r) << " " << Num(r)
+            << " " << xar << " " << las << " " << swp << " " << Num(e.X()) << " " << Num(e.Y())
+            << "\" />";
     }
 }
 
@@ -255,18 +296,19 @@ void SVGOutput::printEllipse(const BRepAdaptor_Curve& c, int id, std::ostream& o
     Standard_Real angle = xaxis.AngleWithRef(gp_Dir(1, 0, 0), gp_Dir(0, 0, -1));
     angle = Base::toDegrees<double>(angle);
     if (fabs(l - f) > 1.0 && s.SquareDistance(e) < 0.001) {
-        out << "<g transform = \"rotate(" << angle << "," << p.X() << "," << p.Y() << ")\">"
-            << std::endl;
-        out << "<ellipse cx =\"" << p.X() << "\" cy =\"" << p.Y() << "\" rx =\"" << r1
-            << "\"  ry =\"" << r2 << "\"/>" << std::endl;
-        out << "</g>" << std::endl;
+        out << "<g transform = \"rotate(" << Num(angle) << "," << Num(p.X()) << "," << Num(p.Y())
+            << ")\">" << '\n';
+        out << "<ellipse cx =\"" << Num(p.X()) << "\" cy =\"" << Num(p.Y()) << "\" rx =\""
+            << Num(r1) << "\"  ry =\"" << Num(r2) << "\"/>" << '\n';
+        out << "</g>" << '\n';
     }
     // arc of ellipse
     else {
         char las = (l - f > D_PI) ? '1' : '0';  // large-arc-flag
         char swp = (a < 0) ? '1' : '0';  // sweep-flag, i.e. clockwise (0) or counter-clockwise (1)
-        out << "<path d=\"M" << s.X() << " " << s.Y() << " A" << r1 << " " << r2 << " " << angle
-            << " " << las << " " << swp << " " << e.X() << " " << e.Y() << "\" />" << std::endl;
+        out << "<path d=\"M" << Num(s.X()) << " " << Num(s.Y()) << " A" << Num(r1) << " " << Num(r2)
+            << " " << Num(angle) << " " << las << " " << swp << " " << Num(e.X()) << " "
+            << Num(e.Y()) << "\" />" << '\n';
     }
 }
 
@@ -295,7 +337,7 @@ void SVGOutput::printBezier(const BRepAdaptor_Curve& c, int id, std::ostream& ou
 
 
         gp_Pnt p1 = bezier->Pole(1);
-        str << p1.X() << "," << p1.Y();
+        str << Num(p1.X()) << "," << Num(p1.Y());
         if (bezier->Degree() == 3) {
             if (poles != 4) {
                 Standard_Failure::Raise("do it the generic way");
@@ -303,8 +345,8 @@ void SVGOutput::printBezier(const BRepAdaptor_Curve& c, int id, std::ostream& ou
             gp_Pnt p2 = bezier->Pole(2);
             gp_Pnt p3 = bezier->Pole(3);
             gp_Pnt p4 = bezier->Pole(4);
-            str << " C" << p2.X() << "," << p2.Y() << " " << p3.X() << "," << p3.Y() << " "
-                << p4.X() << "," << p4.Y() << " ";
+            str << " C" << Num(p2.X()) << "," << Num(p2.Y()) << " " << Num(p3.X()) << ","
+                << Num(p3.Y()) << " " << Num(p4.X()) << "," << Num(p4.Y()) << " ";
         }
         else if (bezier->Degree() == 2) {
             if (poles != 3) {
@@ -312,14 +354,15 @@ void SVGOutput::printBezier(const BRepAdaptor_Curve& c, int id, std::ostream& ou
             }
             gp_Pnt p2 = bezier->Pole(2);
             gp_Pnt p3 = bezier->Pole(3);
-            str << " Q" << p2.X() << "," << p2.Y() << " " << p3.X() << "," << p3.Y() << " ";
+            str << " Q" << Num(p2.X()) << "," << Num(p2.Y()) << " " << Num(p3.X()) << ","
+                << Num(p3.Y()) << " ";
         }
         else if (bezier->Degree() == 1) {
             if (poles != 2) {
                 Standard_Failure::Raise("do it the generic way");
             }
             gp_Pnt p2 = bezier->Pole(2);
-            str << " L" << p2.X() << "," << p2.Y() << " ";
+            str << " L" << Num(p2.X()) << "," << Num(p2.Y()) << " ";
         }
         else {
             Standard_Failure::Raise("do it the generic way");
@@ -360,7 +403,7 @@ void SVGOutput::printBSpline(const BRepAdaptor_Curve& c, int id, std::ostream& o
             Standard_Integer poles = bezier->NbPoles();
             if (i == 1) {
                 gp_Pnt p1 = bezier->Pole(1);
-                str << p1.X() << "," << p1.Y();
+                str << Num(p1.X()) << "," << Num(p1.Y());
             }
             if (bezier->Degree() == 3) {
                 if (poles != 4) {
@@ -369,8 +412,8 @@ void SVGOutput::printBSpline(const BRepAdaptor_Curve& c, int id, std::ostream& o
                 gp_Pnt p2 = bezier->Pole(2);
                 gp_Pnt p3 = bezier->Pole(3);
                 gp_Pnt p4 = bezier->Pole(4);
-                str << " C" << p2.X() << "," << p2.Y() << " " << p3.X() << "," << p3.Y() << " "
-                    << p4.X() << "," << p4.Y() << " ";
+                str << " C" << Num(p2.X()) << "," << Num(p2.Y()) << " " << Num(p3.X()) << ","
+                    << Num(p3.Y()) << " " << Num(p4.X()) << "," << Num(p4.Y()) << " ";
             }
             else if (bezier->Degree() == 2) {
                 if (poles != 3) {
@@ -378,14 +421,15 @@ void SVGOutput::printBSpline(const BRepAdaptor_Curve& c, int id, std::ostream& o
                 }
                 gp_Pnt p2 = bezier->Pole(2);
                 gp_Pnt p3 = bezier->Pole(3);
-                str << " Q" << p2.X() << "," << p2.Y() << " " << p3.X() << "," << p3.Y() << " ";
+                str << " Q" << Num(p2.X()) << "," << Num(p2.Y()) << " " << Num(p3.X()) << ","
+                    << Num(p3.Y()) << " ";
             }
             else if (bezier->Degree() == 1) {
                 if (poles != 2) {
                     Standard_Failure::Raise("do it the generic way");
                 }
                 gp_Pnt p2 = bezier->Pole(2);
-                str << " L" << p2.X() << "," << p2.Y() << " ";
+                str << " L" << Num(p2.X()) << "," << Num(p2.Y()) << " ";
             }
             else {
                 Standard_Failure::Raise("do it the generic way");
@@ -409,10 +453,10 @@ void SVGOutput::printGeneric(const BRepAdaptor_Curve& bac, int id, std::ostream&
         char c = 'M';
         out << "<path id= \"" /*<< ViewName*/ << id << "\" d=\" ";
         for (int i = nodes.Lower(); i <= nodes.Upper(); i++) {
-            out << c << " " << nodes(i).X() << " " << nodes(i).Y() << " ";
+            out << c << " " << Num(nodes(i).X()) << " " << Num(nodes(i).Y()) << " ";
             c = 'L';
         }
-        out << "\" />" << endl;
+        out << "\" />" << '\n';
     }
     else if (bac.GetType() == GeomAbs_Line) {
         // BRep_Tool::Polygon3D assumes the edge has polygon representation - ie already been
@@ -423,10 +467,10 @@ void SVGOutput::printGeneric(const BRepAdaptor_Curve& bac, int id, std::ostream&
         gp_Pnt e = bac.Value(l);
         char c = 'M';
         out << "<path id= \"" /*<< ViewName*/ << id << "\" d=\" ";
-        out << c << " " << s.X() << " " << s.Y() << " ";
+        out << c << " " << Num(s.X()) << " " << Num(s.Y()) << " ";
         c = 'L';
-        out << c << " " << e.X() << " " << e.Y() << " ";
-        out << "\" />" << endl;
+        out << c << " " << Num(e.X()) << " " << Num(e.Y()) << " ";
+        out << "\" />" << '\n';
     }
 }
 
@@ -437,12 +481,7 @@ DXFOutput::DXFOutput()
 
 std::string DXFOutput::exportEdges(const TopoDS_Shape& input)
 {
-    std::stringstream result;
-
-    TopExp_Explorer edges(input, TopAbs_EDGE);
-    for (int i = 1; edges.More(); edges.Next(), i++) {
-        const TopoDS_Edge& edge = TopoDS::Edge(edges.Current());
-        BRepAdaptor_Curve adapt(edge);
+    return convertEdges(input, [this](const BRepAdaptor_Curve& adapt, int i, std::ostream& result) {
         if (adapt.GetType() == GeomAbs_Circle) {
             printCircle(adapt, result);
         }
@@ -456,17 +495,15 @@ std::string DXFOutput::exportEdges(const TopoDS_Shape& input)
         else {
             printGeneric(adapt, i, result);
         }
-    }
-
-    return result.str();
+    });
 }
 
 void DXFOutput::printHeader(std::ostream& out)
 {
-    out << 0 << endl;
-    out << "SECTION" << endl;
-    out << 2 << endl;
-    out << "ENTITIES" << endl;
+    out << 0 << '\n';
+    out << "SECTION" << '\n';
+    out << 2 << '\n';
+    out << "ENTITIES" << '\n';
 }
 
 void DXFOutput::printCircle(const BRepAdaptor_Curve& c, std::ostream& out)
@@ -490,22 +527,22 @@ void DXFOutput::printCircle(const BRepAdaptor_Curve& c, std::ostream& out)
     if (s.SquareDistance(e) < 0.001) {
         // out << "<circle cx =\"" << p.X() << "\" cy =\""
         //<< p.Y() << "\" r =\"" << r << "\" />";
-        out << 0 << endl;
-        out << "CIRCLE" << endl;
-        out << 8 << endl;              // Group code for layer name
-        out << "sheet_layer" << endl;  // Layer number
-        out << "100" << endl;
-        out << "AcDbEntity" << endl;
-        out << "100" << endl;
-        out << "AcDbCircle" << endl;
-        out << 10 << endl;     // Centre X
-        out << p.X() << endl;  // X in WCS coordinates
-        out << 20 << endl;
-        out << p.Y() << endl;  // Y in WCS coordinates
-        out << 30 << endl;
-        out << 0 << endl;   // Z in WCS coordinates-leaving flat
-        out << 40 << endl;  //
-        out << r << endl;   // Radius
+        out << 0 << '\n';
+        out << "CIRCLE" << '\n';
+        out << 8 << '\n';              // Group code for layer name
+        out << "sheet_layer" << '\n';  // Layer number
+        out << "100" << '\n';
+        out << "AcDbEntity" << '\n';
+        out << "100" << '\n';
+        out << "AcDbCircle" << '\n';
+        out << 10 << '\n';          // Centre X
+        out << Num(p.X()) << '\n';  // X in WCS coordinates
+        out << 20 << '\n';
+        out << Num(p.Y()) << '\n';  // Y in WCS coordinates
+        out << 30 << '\n';
+        out << 0 << '\n';       // Z in WCS coordinates-leaving flat
+        out << 40 << '\n';      //
+        out << Num(r) << '\n';  // Radius
     }
 
 
@@ -533,28 +570,28 @@ void DXFOutput::printCircle(const BRepAdaptor_Curve& c, std::ostream& out)
             start_angle = end_angle;
             end_angle = temp;
         }
-        out << 0 << endl;
-        out << "ARC" << endl;
-        out << 8 << endl;              // Group code for layer name
-        out << "sheet_layer" << endl;  // Layer number
-        out << "100" << endl;
-        out << "AcDbEntity" << endl;
-        out << "100" << endl;
-        out << "AcDbCircle" << endl;
-        out << 10 << endl;     // Centre X
-        out << p.X() << endl;  // X in WCS coordinates
-        out << 20 << endl;
-        out << p.Y() << endl;  // Y in WCS coordinates
-        out << 30 << endl;
-        out << 0 << endl;   // Z in WCS coordinates
-        out << 40 << endl;  //
-        out << r << endl;   // Radius
-        out << "100" << endl;
-        out << "AcDbArc" << endl;
-        out << 50 << endl;
-        out << start_angle << endl;  // Start angle
-        out << 51 << endl;
-        out << end_angle << endl;  // End angle
+        out << 0 << '\n';
+        out << "ARC" << '\n';
+        out << 8 << '\n';              // Group code for layer name
+        out << "sheet_layer" << '\n';  // Layer number
+        out << "100" << '\n';
+        out << "AcDbEntity" << '\n';
+        out << "100" << '\n';
+        out << "AcDbCircle" << '\n';
+        out << 10 << '\n';          // Centre X
+        out << Num(p.X()) << '\n';  // X in WCS coordinates
+        out << 20 << '\n';
+        out << Num(p.Y()) << '\n';  // Y in WCS coordinates
+        out << 30 << '\n';
+        out << 0 << '\n';       // Z in WCS coordinates
+        out << 40 << '\n';      //
+        out << Num(r) << '\n';  // Radius
+        out << "100" << '\n';
+        out << "AcDbArc" << '\n';
+        out << 50 << '\n';
+        out << Num(start_angle) << '\n';  // Start angle
+        out << 51 << '\n';
+        out << Num(end_angle) << '\n';  // End angle
     }
 }
 
@@ -604,32 +641,32 @@ void DXFOutput::printEllipse(const BRepAdaptor_Curve& c, int /*id*/, std::ostrea
         start_angle = end_angle;
         end_angle = temp;
     }
-    out << 0 << endl;
-    out << "ELLIPSE" << endl;
-    out << 8 << endl;              // Group code for layer name
-    out << "sheet_layer" << endl;  // Layer number
-    out << "100" << endl;
-    out << "AcDbEntity" << endl;
-    out << "100" << endl;
-    out << "AcDbEllipse" << endl;
-    out << 10 << endl;     // Centre X
-    out << p.X() << endl;  // X in WCS coordinates
-    out << 20 << endl;
-    out << p.Y() << endl;  // Y in WCS coordinates
-    out << 30 << endl;
-    out << 0 << endl;        // Z in WCS coordinates
-    out << 11 << endl;       //
-    out << major_x << endl;  // Major X
-    out << 21 << endl;
-    out << major_y << endl;  // Major Y
-    out << 31 << endl;
-    out << 0 << endl;      // Major Z
-    out << 40 << endl;     //
-    out << ratio << endl;  // Ratio
-    out << 41 << endl;
-    out << start_angle << endl;  // Start angle
-    out << 42 << endl;
-    out << end_angle << endl;  // End angle
+    out << 0 << '\n';
+    out << "ELLIPSE" << '\n';
+    out << 8 << '\n';              // Group code for layer name
+    out << "sheet_layer" << '\n';  // Layer number
+    out << "100" << '\n';
+    out << "AcDbEntity" << '\n';
+    out << "100" << '\n';
+    out << "AcDbEllipse" << '\n';
+    out << 10 << '\n';          // Centre X
+    out << Num(p.X()) << '\n';  // X in WCS coordinates
+    out << 20 << '\n';
+    out << Num(p.Y()) << '\n';  // Y in WCS coordinates
+    out << 30 << '\n';
+    out << 0 << '\n';             // Z in WCS coordinates
+    out << 11 << '\n';            //
+    out << Num(major_x) << '\n';  // Major X
+    out << 21 << '\n';
+    out << Num(major_y) << '\n';  // Major Y
+    out << 31 << '\n';
+    out << 0 << '\n';           // Major Z
+    out << 40 << '\n';          //
+    out << Num(ratio) << '\n';  // Ratio
+    out << 41 << '\n';
+    out << Num(start_angle) << '\n';  // Start angle
+    out << 42 << '\n';
+    out << Num(end_angle) << '\n';  // End angle
 }
 
 void DXFOutput::printBSpline(const BRepAdaptor_Curve& c,
@@ -672,38 +709,38 @@ void DXFOutput::printBSpline(const BRepAdaptor_Curve& c,
         spline->Poles(poles);
 
 
-        str << 0 << endl
-            << "SPLINE" << endl
-            << 8 << endl              // Group code for layer name
-            << "sheet_layer" << endl  // Layer name
-            << "100" << endl
-            << "AcDbEntity" << endl
-            << "100" << endl
-            << "AcDbSpline" << endl
-            << 70 << endl
-            << spline->IsRational() * 4 << endl  // flags
-            << 71 << endl
-            << spline->Degree() << endl
-            << 72 << endl
-            << knotsequence.Length() << endl
-            << 73 << endl
-            << poles.Length() << endl
-            << 74 << endl
-            << 0 << endl;  // fitpoints
+        str << 0 << '\n'
+            << "SPLINE" << '\n'
+            << 8 << '\n'              // Group code for layer name
+            << "sheet_layer" << '\n'  // Layer name
+            << "100" << '\n'
+            << "AcDbEntity" << '\n'
+            << "100" << '\n'
+            << "AcDbSpline" << '\n'
+            << 70 << '\n'
+            << spline->IsRational() * 4 << '\n'  // flags
+            << 71 << '\n'
+            << spline->Degree() << '\n'
+            << 72 << '\n'
+            << knotsequence.Length() << '\n'
+            << 73 << '\n'
+            << poles.Length() << '\n'
+            << 74 << '\n'
+            << 0 << '\n';  // fitpoints
 
         for (int i = knotsequence.Lower(); i <= knotsequence.Upper(); i++) {
-            str << 40 << endl << knotsequence(i) << endl;
+            str << 40 << '\n' << Num(knotsequence(i)) << '\n';
         }
         for (int i = poles.Lower(); i <= poles.Upper(); i++) {
             gp_Pnt pole = poles(i);
-            str << 10 << endl
-                << pole.X() << endl
-                << 20 << endl
-                << pole.Y() << endl
-                << 30 << endl
-                << pole.Z() << endl;
+            str << 10 << '\n'
+                << Num(pole.X()) << '\n'
+                << 20 << '\n'
+                << Num(pole.Y()) << '\n'
+                << 30 << '\n'
+                << Num(pole.Z()) << '\n';
             if (spline->IsRational()) {
-                str << 41 << endl << spline->Weight(i) << endl;
+                str << 41 << '\n' << Num(spline->Weight(i)) << '\n';
             }
         }
 
@@ -727,24 +764,24 @@ void DXFOutput::printGeneric(const BRepAdaptor_Curve& c, int /*id*/, std::ostrea
     gp_Vec VE;
     c.D1(uEnd, PE, VE);
 
-    out << "0" << endl;
-    out << "LINE" << endl;
-    out << "8" << endl;            // Group code for layer name
-    out << "sheet_layer" << endl;  // Layer name
-    out << "100" << endl;
-    out << "AcDbEntity" << endl;
-    out << "100" << endl;
-    out << "AcDbLine" << endl;
-    out << "10" << endl;    // Start point of line
-    out << PS.X() << endl;  // X in WCS coordinates
-    out << "20" << endl;
-    out << PS.Y() << endl;  // Y in WCS coordinates
-    out << "30" << endl;
-    out << "0" << endl;     // Z in WCS coordinates
-    out << "11" << endl;    // End point of line
-    out << PE.X() << endl;  // X in WCS coordinates
-    out << "21" << endl;
-    out << PE.Y() << endl;  // Y in WCS coordinates
-    out << "31" << endl;
-    out << "0" << endl;  // Z in WCS coordinates
+    out << "0" << '\n';
+    out << "LINE" << '\n';
+    out << "8" << '\n';            // Group code for layer name
+    out << "sheet_layer" << '\n';  // Layer name
+    out << "100" << '\n';
+    out << "AcDbEntity" << '\n';
+    out << "100" << '\n';
+    out << "AcDbLine" << '\n';
+    out << "10" << '\n';         // Start point of line
+    out << Num(PS.X()) << '\n';  // X in WCS coordinates
+    out << "20" << '\n';
+    out << Num(PS.Y()) << '\n';  // Y in WCS coordinates
+    out << "30" << '\n';
+    out << "0" << '\n';          // Z in WCS coordinates
+    out << "11" << '\n';         // End point of line
+    out << Num(PE.X()) << '\n';  // X in WCS coordinates
+    out << "21" << '\n';
+    out << Num(PE.Y()) << '\n';  // Y in WCS coordinates
+    out << "31" << '\n';
+    out << "0" << '\n';  // Z in WCS coordinates
 }
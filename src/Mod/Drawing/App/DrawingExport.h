@@ -25,6 +25,8 @@
 
 #include <Mod/Drawing/DrawingGlobal.h>
 #include <TopoDS_Edge.hxx>
+#include <functional>
+#include <iosfwd>
 #include <string>
 
 
@@ -41,6 +43,11 @@ public:
     // otherwise a null edge is returned.
     TopoDS_Edge asCircle(const BRepAdaptor_Curve&) const;
     TopoDS_Edge asBSpline(const BRepAdaptor_Curve&, int maxDegree) const;
+
+protected:
+    using PrintEdge = std::function<void(const BRepAdaptor_Curve&, int, std::ostream&)>;
+    // Converts the edges of the shape in the order they are explored.
+    std::string convertEdges(const TopoDS_Shape&, const PrintEdge&) const;
 };
 
 class DrawingExport SVGOutput: public DrawingOutput
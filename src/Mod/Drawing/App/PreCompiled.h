@@ -40,6 +40,7 @@
 // OpenCasCade
 #include <Approx_Curve3d.hxx>
 #include <BRepAdaptor_Curve.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepLProp_CLProps.hxx>
 #include <BRepLib.hxx>
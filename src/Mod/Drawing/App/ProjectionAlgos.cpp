@@ -22,13 +22,16 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
 #include <sstream>
 
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepLib.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <HLRAlgo_Projector.hxx>
 #include <HLRBRep_Algo.hxx>
 #include <HLRBRep_HLRToShape.hxx>
+#include <Standard_Failure.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
 #include <TopoDS_Shape.hxx>
@@ -37,7 +40,12 @@
 #include <gp_Pnt.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 #include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+#include <Base/Tools.h>
 
 #include "DrawingExport.h"
 #include "ProjectionAlgos.h"
@@ -124,7 +132,7 @@ string ProjectionAlgos::getSVG(ExtractionType type,
         for (const auto& attribute : H_style) {
             result << "   " << attribute.first << "=\"" << attribute.second << "\"\n";
         }
-        result << "  >" << endl << output.exportEdges(H) << "</g>" << endl;
+        result << "  >" << '\n' << output.exportEdges(H) << "</g>" << '\n';
     }
     if (!HO.IsNull() && (type & WithHidden)) {
         H0_style.insert({"stroke", "rgb(0, 0, 0)"});
@@ -139,7 +147,7 @@ string ProjectionAlgos::getSVG(ExtractionType type,
         for (const auto& attribute : H0_style) {
             result << "   " << attribute.first << "=\"" << attribute.second << "\"\n";
         }
-        result << "  >" << endl << output.exportEdges(HO) << "</g>" << endl;
+        result << "  >" << '\n' << output.exportEdges(HO) << "</g>" << '\n';
     }
     if (!VO.IsNull()) {
         V0_style.insert({"stroke", "rgb(0, 0, 0)"});
@@ -153,7 +161,7 @@ string ProjectionAlgos::getSVG(ExtractionType type,
         for (const auto& attribute : V0_style) {
             result << "   " << attribute.first << "=\"" << attribute.second << "\"\n";
         }
-        result << "  >" << endl << output.exportEdges(VO) << "</g>" << endl;
+        result << "  >" << '\n' << output.exportEdges(VO) << "</g>" << '\n';
     }
     if (!V.IsNull()) {
         V_style.insert({"stroke", "rgb(0, 0, 0)"});
@@ -167,7 +175,7 @@ string ProjectionAlgos::getSVG(ExtractionType type,
         for (const auto& attribute : V_style) {
             result << "   " << attribute.first << "=\"" << attribute.second << "\"\n";
         }
-        result << "  >" << endl << output.exportEdges(V) << "</g>" << endl;
+        result << "  >" << '\n' << output.exportEdges(V) << "</g>" << '\n';
     }
     if (!V1.IsNull() && (type & WithSmooth)) {
         V1_style.insert({"stroke", "rgb(0, 0, 0)"});
@@ -181,7 +189,7 @@ string ProjectionAlgos::getSVG(ExtractionType type,
         for (const auto& attribute : V1_style) {
             result << "   " << attribute.first << "=\"" << attribute.second << "\"\n";
         }
-        result << "  >" << endl << output.exportEdges(V1) << "</g>" << endl;
+        result << "  >" << '\n' << output.exportEdges(V1) << "</g>" << '\n';
     }
     if (!H1.IsNull() && (type & WithSmooth) && (type & WithHidden)) {
         H1_style.insert({"stroke", "rgb(0, 0, 0)"});
@@ -196,7 +204,7 @@ string ProjectionAlgos::getSVG(ExtractionType type,
         for (const auto& attribute : H1_style) {
             result << "   " << attribute.first << "=\"" << attribute.second << "\"\n";
         }
-        result << "  >" << endl << output.exportEdges(H1) << "</g>" << endl;
+        result << "  >" << '\n' << output.exportEdges(H1) << "</g>" << '\n';
     }
     return result.str();
 }
@@ -241,3 +249,76 @@ string ProjectionAlgos::getDXF(ExtractionType type, double /*scale*/, double tol
 
     return result.str();
 }
+
+//===========================================================================
+// BatchProjection
+//===========================================================================
+
+BatchProjection::BatchProjection(const Base::Vector3d& Dir,
+                                 ProjectionAlgos::ExtractionType type,
+                                 double tolerance)
+    : direction(Dir)
+    , type(type)
+    , tolerance(tolerance)
+{}
+
+std::vector<BatchProjection::Result>
+BatchProjection::exportFiles(const std::vector<TopoDS_Shape>& shapes,
+                             const std::vector<std::string>& files) const
+{
+    if (shapes.size() != files.size()) {
+        throw Base::ValueError("Number of shapes and file names doesn't match");
+    }
+
+    std::vector<Result> results(shapes.size());
+    std::vector<std::size_t> index(shapes.size());
+    std::generate(index.begin(), index.end(), Base::iotaGen<std::size_t>(0));
+
+    // Shapes of the list may share sub-shapes or geometry, e.g. placed copies of the same
+    // shape. The projection works on a deep copy so that no OCC data is modified by two
+    // threads at the same time.
+    QtConcurrent::blockingMap(index, [&](std::size_t i) {
+        Result& result = results[i];
+        try {
+            BRepBuilderAPI_Copy copy(shapes[i]);
+            ProjectionAlgos alg(copy.Shape(), direction);
+            Base::FileInfo fi(files[i]);
+            Base::ofstream str(fi, std::ios::out);
+            if (!str) {
+                result.error = "Cannot open file";
+                return;
+            }
+
+            if (fi.hasExtension("svg")) {
+                str << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n"
+                    << alg.getSVG(type, tolerance) << "</svg>\n";
+            }
+            else {
+                // The entities use the subclass markers of AutoCAD 2000, so the version
+                // must be declared for readers to accept them
+                str << "0\nSECTION\n2\nHEADER\n9\n$ACADVER\n1\nAC1015\n0\nENDSEC\n"
+                    << "0\nSECTION\n2\nENTITIES\n"
+                    << alg.getDXF(type, 1.0, tolerance) << "0\nENDSEC\n0\nEOF\n";
+            }
+
+            if (!str) {
+                result.error = "Failed to write file";
+            }
+        }
+        catch (const Standard_Failure& e) {
+            Standard_CString msg = e.GetMessageString();
+            result.error = (msg && msg[0] != '\0') ? msg : "OCC exception";
+        }
+        catch (const Base::Exception& e) {
+            result.error = e.what();
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+        }
+        catch (...) {
+            result.error = "Unknown exception";
+        }
+    });
+
+    return results;
+}
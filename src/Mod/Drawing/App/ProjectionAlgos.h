@@ -24,7 +24,9 @@
 #define _ProjectionAlgos_h_
 
 #include <TopoDS_Shape.hxx>
+#include <map>
 #include <string>
+#include <vector>
 
 #include <Base/Vector3D.h>
 #include <Mod/Drawing/DrawingGlobal.h>
@@ -81,6 +83,35 @@ public:
     TopoDS_Shape HI;  // isoparamtriques   invisibly
 };
 
+/**
+ * The BatchProjection class projects a list of shapes along a common direction and writes
+ * each result to its own file. Files with the extension svg get the SVG output, all others
+ * the DXF output with a minimal header. The shapes are processed concurrently on the global
+ * thread pool, each one on a deep copy of the input. For each shape the error message is
+ * recorded in case it failed.
+ */
+class DrawingExport BatchProjection
+{
+public:
+    struct Result
+    {
+        /// error message if the shape couldn't be exported
+        std::string error;
+    };
+
+    BatchProjection(const Base::Vector3d& Dir,
+                    ProjectionAlgos::ExtractionType type,
+                    double tolerance);
+
+    std::vector<Result> exportFiles(const std::vector<TopoDS_Shape>& shapes,
+                                    const std::vector<std::string>& files) const;
+
+private:
+    Base::Vector3d direction;
+    ProjectionAlgos::ExtractionType type;
+    double tolerance;
+};
+
 }  // namespace Drawing
 
 
@@ -25,7 +25,9 @@
 #define WNT  // avoid conflict with GUID
 #endif
 #ifndef _PreComp_
+#include <algorithm>
 #include <Interface_Static.hxx>
+#include <OSD_Parallel.hxx>
 #include <Quantity_ColorRGBA.hxx>
 #include <Standard_Failure.hxx>
 #include <Standard_Version.hxx>
@@ -216,6 +218,7 @@ ImportOCAFOptions ImportOCAF2::customImportOptions()
     defaultOptions.reduceObjects = settings.getReduceObjects();
     defaultOptions.showProgress = settings.getShowProgress();
     defaultOptions.expandCompound = settings.getExpandCompound();
+    defaultOptions.dedupSolids = settings.getDedupSolids();
     defaultOptions.mode = static_cast<int>(settings.getImportMode());
 
     auto hGrp =
@@ -408,129 +411,285 @@ ImportOCAF2::expandShape(App::Document* doc, TDF_Label label, const TopoDS_Shape
     return info.obj;
 }
 
-bool ImportOCAF2::createObject(App::Document* doc,
-                               TDF_Label label,
-                               const TopoDS_Shape& shape,
-                               Info& info,
-                               bool newDoc)
+void ImportOCAF2::prepareObject(TDF_Label label, const TopoDS_Shape& shape, ObjectData& data)
 {
-    if (shape.IsNull() || !TopExp_Explorer(shape, TopAbs_VERTEX).More()) {
-        FC_WARN(labelName(label) << " has empty shape");
-        return false;
+    readObjectData(label, shape, data);
+    computeObjectData(shape, data);
+}
+
+void ImportOCAF2::readObjectData(TDF_Label label, const TopoDS_Shape& shape, ObjectData& data)
+{
+    data.label = label;
+    getColor(shape, data.info);
+    data.shapeName = Part::TopoShape(shape).shapeName();
+
+    TDF_LabelSequence seq;
+    if (label.IsNull() || !aShapeTool->GetSubShapes(label, seq)) {
+        return;
     }
 
-    getColor(shape, info);
-    bool hasFaceColors = false;
-    bool hasEdgeColors = false;
+    // Two passes to get sub shape colors. First pass, look for solid, and
+    // second pass look for face and edges. This allows lower level
+    // subshape to override color of higher level ones.
+    for (int j = 0; j < 2; ++j) {
+        for (int i = 1; i <= seq.Length(); ++i) {
+            TDF_Label l = seq.Value(i);
+            TopoDS_Shape subShape = aShapeTool->GetShape(l);
+            if (subShape.IsNull()) {
+                continue;
+            }
+            if (subShape.ShapeType() == TopAbs_FACE || subShape.ShapeType() == TopAbs_EDGE) {
+                if (j == 0) {
+                    continue;
+                }
+            }
+            else if (j != 0) {
+                continue;
+            }
 
-    Part::TopoShape tshape(shape);
-    std::vector<App::Color> faceColors;
-    std::vector<App::Color> edgeColors;
+            SubShapeColor sub;
+            sub.shape = subShape;
+            sub.isFaceOrEdge = (j != 0);
+            Quantity_ColorRGBA aColor;
+            if (aColorTool->GetColor(l, XCAFDoc_ColorSurf, aColor)
+                || aColorTool->GetColor(l, XCAFDoc_ColorGen, aColor)) {
+                sub.faceColor = convertColor(aColor);
+                sub.hasFaceColor = true;
+            }
+            if (aColorTool->GetColor(l, XCAFDoc_ColorCurv, aColor)) {
+                sub.edgeColor = convertColor(aColor);
+                sub.hasEdgeColor = true;
+            }
+            if (sub.hasFaceColor || sub.hasEdgeColor) {
+                data.subShapeColors.push_back(sub);
+            }
+        }
+    }
+}
 
-    TDF_LabelSequence seq;
-    if (!label.IsNull() && aShapeTool->GetSubShapes(label, seq)) {
+void ImportOCAF2::computeObjectData(const TopoDS_Shape& shape, ObjectData& data) const
+{
+    Part::TopoShape tshape(shape);
 
+    if (!data.subShapeColors.empty()) {
         TopTools_IndexedMapOfShape faceMap, edgeMap;
         TopExp::MapShapes(tshape.getShape(), TopAbs_FACE, faceMap);
         TopExp::MapShapes(tshape.getShape(), TopAbs_EDGE, edgeMap);
 
-        faceColors.assign(faceMap.Extent(), info.faceColor);
-        edgeColors.assign(edgeMap.Extent(), info.edgeColor);
-        // Two passes to get sub shape colors. First pass, look for solid, and
-        // second pass look for face and edges. This allows lower level
-        // subshape to override color of higher level ones.
-        for (int j = 0; j < 2; ++j) {
-            for (int i = 1; i <= seq.Length(); ++i) {
-                TDF_Label l = seq.Value(i);
-                TopoDS_Shape subShape = aShapeTool->GetShape(l);
-                if (subShape.IsNull()) {
-                    continue;
-                }
-                if (subShape.ShapeType() == TopAbs_FACE || subShape.ShapeType() == TopAbs_EDGE) {
-                    if (j == 0) {
-                        continue;
-                    }
-                }
-                else if (j != 0) {
-                    continue;
-                }
+        data.faceColors.assign(faceMap.Extent(), data.info.faceColor);
+        data.edgeColors.assign(edgeMap.Extent(), data.info.edgeColor);
+        for (const auto& sub : data.subShapeColors) {
+            bool foundEdgeColor = sub.hasEdgeColor;
+            if (!sub.isFaceOrEdge && sub.hasFaceColor && !data.faceColors.empty()
+                && sub.edgeColor == sub.faceColor) {
+                // Do not set edge the same color as face
+                foundEdgeColor = false;
+            }
 
-                bool foundFaceColor = false, foundEdgeColor = false;
-                App::Color faceColor, edgeColor;
-                Quantity_ColorRGBA aColor;
-                if (aColorTool->GetColor(l, XCAFDoc_ColorSurf, aColor)
-                    || aColorTool->GetColor(l, XCAFDoc_ColorGen, aColor)) {
-                    faceColor = convertColor(aColor);
-                    foundFaceColor = true;
-                }
-                if (aColorTool->GetColor(l, XCAFDoc_ColorCurv, aColor)) {
-                    edgeColor = convertColor(aColor);
-                    foundEdgeColor = true;
-                    if (j == 0 && foundFaceColor && !faceColors.empty() && edgeColor == faceColor) {
-                        // Do not set edge the same color as face
-                        foundEdgeColor = false;
+            if (sub.hasFaceColor) {
+                for (TopExp_Explorer exp(sub.shape, TopAbs_FACE); exp.More(); exp.Next()) {
+                    int idx = faceMap.FindIndex(exp.Current()) - 1;
+                    if (idx >= 0 && idx < (int)data.faceColors.size()) {
+                        data.faceColors[idx] = sub.faceColor;
+                        data.hasFaceColors = true;
+                        data.info.hasFaceColor = true;
                     }
-                }
-
-                if (foundFaceColor) {
-                    for (TopExp_Explorer exp(subShape, TopAbs_FACE); exp.More(); exp.Next()) {
-                        int idx = faceMap.FindIndex(exp.Current()) - 1;
-                        if (idx >= 0 && idx < (int)faceColors.size()) {
-                            faceColors[idx] = faceColor;
-                            hasFaceColors = true;
-                            info.hasFaceColor = true;
-                        }
-                        else {
-                            assert(0);
-                        }
+                    else {
+                        assert(0);
                     }
                 }
-                if (foundEdgeColor) {
-                    for (TopExp_Explorer exp(subShape, TopAbs_EDGE); exp.More(); exp.Next()) {
-                        int idx = edgeMap.FindIndex(exp.Current()) - 1;
-                        if (idx >= 0 && idx < (int)edgeColors.size()) {
-                            edgeColors[idx] = edgeColor;
-                            hasEdgeColors = true;
-                            info.hasEdgeColor = true;
-                        }
+            }
+            if (foundEdgeColor) {
+                for (TopExp_Explorer exp(sub.shape, TopAbs_EDGE); exp.More(); exp.Next()) {
+                    int idx = edgeMap.FindIndex(exp.Current()) - 1;
+                    if (idx >= 0 && idx < (int)data.edgeColors.size()) {
+                        data.edgeColors[idx] = sub.edgeColor;
+                        data.hasEdgeColors = true;
+                        data.info.hasEdgeColor = true;
                     }
                 }
             }
         }
+        // only needed to fill the arrays
+        data.subShapeColors.clear();
     }
 
-    Part::Feature* feature;
+    data.expand = options.expandCompound
+        && (tshape.countSubShapes(TopAbs_SOLID) > 1
+            || (!tshape.countSubShapes(TopAbs_SOLID) && tshape.countSubShapes(TopAbs_SHELL) > 1));
+
+    // Solids with colored sub-shapes are not shared, because the colors of a
+    // link can only be overridden as a whole.
+    if (options.dedupSolids && !data.expand && !data.hasFaceColors && !data.hasEdgeColors) {
+        data.fingerprint.emplace(shape);
+    }
+}
+
+void ImportOCAF2::readObjects(const TDF_LabelSequence& labels,
+                              std::vector<TopoDS_Shape>& shapes,
+                              std::vector<ObjectData>& results)
+{
+    // The XCAF document is read here, the workers only get shapes and values
+    for (Standard_Integer i = 1; i <= labels.Length(); i++) {
+        auto label = labels.Value(i);
+        if (aShapeTool->IsAssembly(label)) {
+            continue;
+        }
+        auto shape = aShapeTool->GetShape(label);
+        if (shape.IsNull() || !TopExp_Explorer(shape, TopAbs_VERTEX).More()) {
+            continue;
+        }
+        shapes.push_back(shape.Located(TopLoc_Location()));
+        results.emplace_back();
+        try {
+            readObjectData(label, shapes.back(), results.back());
+        }
+        catch (Standard_Failure&) {
+            // prepared again in createObject() to report the error
+            shapes.pop_back();
+            results.pop_back();
+        }
+    }
+}
+
+void ImportOCAF2::prepareObjects(const std::vector<TopoDS_Shape>& shapes,
+                                 std::vector<ObjectData>& results)
+{
+    // Document objects are created afterwards in label order by loadShape(),
+    // which picks up the result. The shapes are processed in blocks so that
+    // the progress can be reported from this thread.
+    const int blockSize = 64;
+    const int count = static_cast<int>(shapes.size());
+    std::vector<char> failed(shapes.size(), 0);
+    for (int begin = 0; begin < count; begin += blockSize) {
+        int end = std::min(count, begin + blockSize);
+        OSD_Parallel::For(begin, end, [&](int i) {
+            try {
+                computeObjectData(shapes[i], results[i]);
+            }
+            catch (...) {
+                // an exception must not escape a worker thread
+                failed[i] = 1;
+            }
+        });
+        if (sequencer) {
+            for (int i = begin; i < end; ++i) {
+                sequencer->next(true);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < shapes.size(); ++i) {
+        // Failed shapes are prepared again in createObject() to report the error
+        if (!failed[i]) {
+            myObjectData.emplace(shapes[i], std::move(results[i]));
+        }
+    }
+}
+
+bool ImportOCAF2::createObject(App::Document* doc,
+                               TDF_Label label,
+                               const TopoDS_Shape& shape,
+                               Info& info,
+                               bool newDoc)
+{
+    if (shape.IsNull() || !TopExp_Explorer(shape, TopAbs_VERTEX).More()) {
+        FC_WARN(labelName(label) << " has empty shape");
+        return false;
+    }
+
+    ObjectData data;
+    auto it = myObjectData.find(shape);
+    if (it != myObjectData.end() && it->second.label == label) {
+        data = std::move(it->second);
+        myObjectData.erase(it);
+    }
+    else {
+        prepareObject(label, shape, data);
+    }
+    info.faceColor = data.info.faceColor;
+    info.edgeColor = data.info.edgeColor;
+    info.hasFaceColor = data.info.hasFaceColor;
+    info.hasEdgeColor = data.info.hasEdgeColor;
 
     if (newDoc && (options.mode == ObjectPerDoc || options.mode == ObjectPerDir)) {
         doc = getDocument(doc, label);
     }
 
-    if (options.expandCompound
-        && (tshape.countSubShapes(TopAbs_SOLID) > 1
-            || (!tshape.countSubShapes(TopAbs_SOLID) && tshape.countSubShapes(TopAbs_SHELL) > 1))) {
+    // the link must be created in the same document as the feature would be
+    if (data.fingerprint && findDuplicate(doc, shape, *data.fingerprint, info)) {
+        return true;
+    }
+
+    Part::Feature* feature;
+
+    if (data.expand) {
         feature = dynamic_cast<Part::Feature*>(expandShape(doc, label, shape));
         assert(feature);
     }
     else {
         feature = static_cast<Part::Feature*>(
-            doc->addObject("Part::Feature", tshape.shapeName().c_str()));
+            doc->addObject("Part::Feature", data.shapeName.c_str()));
         feature->Shape.setValue(shape);
         // feature->Visibility.setValue(false);
     }
     applyFaceColors(feature, {info.faceColor});
     applyEdgeColors(feature, {info.edgeColor});
-    if (hasFaceColors) {
-        applyFaceColors(feature, faceColors);
+    if (data.hasFaceColors) {
+        applyFaceColors(feature, data.faceColors);
     }
-    if (hasEdgeColors) {
-        applyEdgeColors(feature, edgeColors);
+    if (data.hasEdgeColors) {
+        applyEdgeColors(feature, data.edgeColors);
     }
 
     info.propPlacement = &feature->Placement;
     info.obj = feature;
+
+    if (data.fingerprint && data.fingerprint->isValid()) {
+        auto& solids = mySolids[data.fingerprint->hash()];
+        solids.push_back({std::move(*data.fingerprint), feature, info.faceColor, info.edgeColor});
+    }
     return true;
 }
 
+bool ImportOCAF2::findDuplicate(App::Document* doc,
+                                const TopoDS_Shape& shape,
+                                const ShapeFingerprint& fingerprint,
+                                Info& info)
+{
+    if (!fingerprint.isValid()) {
+        return false;
+    }
+    auto it = mySolids.find(fingerprint.hash());
+    if (it == mySolids.end()) {
+        return false;
+    }
+    for (const auto& solid : it->second) {
+        gp_Trsf trsf;
+        if (solid.edgeColor != info.edgeColor
+            || !solid.fingerprint.findTransform(fingerprint, trsf)) {
+            continue;
+        }
+        FC_LOG("share solid " << solid.obj->getFullName());
+
+        // The link placement overrides the one of the linked feature, so it
+        // must include the motion from the feature shape onto this one.
+        auto link = static_cast<App::Link*>(doc->addObject("App::Link", "Link"));
+        link->setLink(-1, solid.obj);
+        gp_Trsf placement = shape.Location().Transformation().Multiplied(trsf);
+        link->Placement.setValue(Base::Placement(Part::TopoShape::convert(placement)));
+        if (info.faceColor != solid.faceColor) {
+            applyLinkColor(link, -1, info.faceColor);
+        }
+        info.propPlacement = &link->Placement;
+        info.obj = link;
+        mySharedLinks[link] =
+            {solid.obj, link->Placement.getValue(), solid.faceColor, info.faceColor};
+        return true;
+    }
+    return false;
+}
+
 App::Document* ImportOCAF2::getDocument(App::Document* doc, TDF_Label label)
 {
     if (filePath.empty() || options.mode == SingleDoc || options.merge) {
@@ -648,14 +807,24 @@ App::DocumentObject* ImportOCAF2::loadShapes()
 
     TDF_LabelSequence labels;
     aShapeTool->GetShapes(labels);
-    Base::SequencerLauncher seq("Importing...", labels.Length());
     FC_MSG("free shape count " << labels.Length());
-    sequencer = options.showProgress ? &seq : nullptr;
 
-    labels.Clear();
     myShapes.clear();
     myNames.clear();
     myCollapsedObjects.clear();
+    mySolids.clear();
+    mySharedLinks.clear();
+    myObjectData.clear();
+
+    // the simple shapes are first prepared and then all shapes are loaded
+    std::vector<TopoDS_Shape> shapes;
+    std::vector<ObjectData> results;
+    readObjects(labels, shapes, results);
+    Base::SequencerLauncher seq("Importing...", shapes.size() + labels.Length());
+    sequencer = options.showProgress ? &seq : nullptr;
+
+    prepareObjects(shapes, results);
+    labels.Clear();
 
     std::vector<App::DocumentObject*> objs;
     aShapeTool->GetFreeShapes(labels);
@@ -711,6 +880,7 @@ App::DocumentObject* ImportOCAF2::loadShapes()
         ret = feature;
         ret->recomputeFeature(true);
     }
+    myObjectData.clear();
     sequencer = nullptr;
     return ret;
 }
@@ -849,11 +1019,21 @@ App::DocumentObject* ImportOCAF2::loadShape(App::Document* doc,
     }
 
     auto link = static_cast<App::Link*>(doc->addObject("App::Link", "Link"));
-    link->setLink(-1, info.obj);
+    App::Color baseColor = it->second.faceColor;
+    auto shared = mySharedLinks.find(info.obj);
+    if (shared != mySharedLinks.end()) {
+        // the placement of a linked link is ignored
+        link->setLink(-1, shared->second.obj);
+        link->Placement.setValue(shared->second.offset);
+        baseColor = shared->second.faceColor;
+    }
+    else {
+        link->setLink(-1, info.obj);
+    }
     setPlacement(&link->Placement, shape);
     info.obj = link;
     setObjectName(info, label);
-    if (info.faceColor != it->second.faceColor) {
+    if (info.faceColor != baseColor) {
         applyLinkColor(link, -1, info.faceColor);
     }
 
@@ -956,7 +1136,8 @@ bool ImportOCAF2::createAssembly(App::Document* _doc,
 
             // Okay, we are creating a link array
             auto link = static_cast<App::Link*>(doc->addObject("App::Link", "Link"));
-            link->setLink(-1, child);
+            auto shared = mySharedLinks.find(child);
+            link->setLink(-1, shared != mySharedLinks.end() ? shared->second.obj : child);
             link->ShowElement.setValue(false);
             link->ElementCount.setValue(childInfo.plas.size());
             auto it = myCollapsedObjects.find(child);
@@ -967,6 +1148,16 @@ bool ImportOCAF2::createAssembly(App::Document* _doc,
                     pla *= it->second->getValue();
                 }
             }
+            else if (shared != mySharedLinks.end()) {
+                // child links to a repeated solid, whose placement would be ignored
+                for (auto& pla : childInfo.plas) {
+                    pla *= shared->second.offset;
+                }
+            }
+            if (shared != mySharedLinks.end()
+                && shared->second.linkColor != shared->second.faceColor) {
+                applyLinkColor(link, -1, shared->second.linkColor);
+            }
             link->PlacementList.setValue(childInfo.plas);
             link->VisibilityList.setValue(childInfo.vis);
 
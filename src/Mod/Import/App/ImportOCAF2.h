@@ -25,25 +25,29 @@
 
 #include <climits>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <TDF_Label.hxx>
 #include <TDF_LabelMapHasher.hxx>
+#include <TDF_LabelSequence.hxx>
 #include <TDocStd_Document.hxx>
 #include <TopoDS_Shape.hxx>
 #include <XCAFDoc_ColorTool.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
 
+#include <Base/Placement.h>
 #include <Base/Sequencer.h>
 #include <Mod/Part/App/TopoShape.h>
 
 #include "ExportOCAF.h"
 #include "ImportOCAF.h"
+#include "ShapeFingerprint.h"
 
 
-class TDF_Label;
 class TopLoc_Location;
 
 namespace App
@@ -87,6 +91,7 @@ struct ImportExport ImportOCAFOptions
     bool reduceObjects = false;
     bool showProgress = false;
     bool expandCompound = false;
+    bool dedupSolids = false;
     int mode = 0;
 };
 
@@ -124,6 +129,10 @@ public:
     {
         options.expandCompound = enable;
     }
+    void setDedupSolids(bool enable)
+    {
+        options.dedupSolids = enable;
+    }
 
     enum ImportMode
     {
@@ -153,6 +162,43 @@ private:
         int free = true;
     };
 
+    // Color of a sub-shape label of a simple shape
+    struct SubShapeColor
+    {
+        TopoDS_Shape shape;
+        App::Color faceColor;
+        App::Color edgeColor;
+        bool hasFaceColor = false;
+        bool hasEdgeColor = false;
+        // set for faces and edges, which override the color of higher level sub-shapes
+        bool isFaceOrEdge = false;
+    };
+
+    // Data of a simple shape that can be gathered without touching the document
+    struct ObjectData
+    {
+        TDF_Label label;
+        Info info;
+        std::string shapeName;
+        std::vector<SubShapeColor> subShapeColors;
+        std::vector<App::Color> faceColors;
+        std::vector<App::Color> edgeColors;
+        bool hasFaceColors = false;
+        bool hasEdgeColors = false;
+        bool expand = false;
+        std::optional<ShapeFingerprint> fingerprint;
+    };
+
+    // Reads the data of the simple shapes of the labels
+    void readObjects(const TDF_LabelSequence& labels,
+                     std::vector<TopoDS_Shape>& shapes,
+                     std::vector<ObjectData>& results);
+    void prepareObjects(const std::vector<TopoDS_Shape>& shapes, std::vector<ObjectData>& results);
+    void prepareObject(TDF_Label label, const TopoDS_Shape& shape, ObjectData& data);
+    // Reads the colors of the shape and its sub-shapes, the XCAF document is not thread-safe
+    void readObjectData(TDF_Label label, const TopoDS_Shape& shape, ObjectData& data);
+    // Computes the rest of the data from the shape only, can be run concurrently
+    void computeObjectData(const TopoDS_Shape& shape, ObjectData& data) const;
     App::DocumentObject* loadShape(App::Document* doc,
                                    TDF_Label label,
                                    const TopoDS_Shape& shape,
@@ -169,6 +215,10 @@ private:
                       const TopoDS_Shape& shape,
                       Info& info,
                       bool newDoc);
+    bool findDuplicate(App::Document* doc,
+                       const TopoDS_Shape& shape,
+                       const ShapeFingerprint& fingerprint,
+                       Info& info);
     bool createGroup(App::Document* doc,
                      Info& info,
                      const TopoDS_Shape& shape,
@@ -225,6 +275,30 @@ private:
     std::unordered_map<TDF_Label, std::string, LabelHasher> myNames;
     std::unordered_map<App::DocumentObject*, App::PropertyPlacement*> myCollapsedObjects;
 
+    struct SolidInfo
+    {
+        ShapeFingerprint fingerprint;
+        App::DocumentObject* obj;
+        App::Color faceColor;
+        App::Color edgeColor;
+    };
+    std::unordered_map<TopoDS_Shape, ObjectData, ShapeHasher> myObjectData;
+    // Imported solids by fingerprint hash, used to detect repeated solids
+    std::unordered_map<std::size_t, std::vector<SolidInfo>> mySolids;
+
+    // A link to a repeated solid. Other links ignore its placement, so they must
+    // link to the shared feature directly and include the offset.
+    struct SharedLink
+    {
+        App::DocumentObject* obj;
+        // motion from the shape of the shared feature onto the repeated one
+        Base::Placement offset;
+        App::Color faceColor;
+        // face color of the repeated solid
+        App::Color linkColor;
+    };
+    std::unordered_map<App::DocumentObject*, SharedLink> mySharedLinks;
+
     Base::SequencerLauncher* sequencer {nullptr};
 };
 
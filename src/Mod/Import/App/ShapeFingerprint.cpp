@@ -0,0 +1,374 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <cmath>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepGProp.hxx>
+#include <BRep_Tool.hxx>
+#include <GProp_GProps.hxx>
+#include <GProp_PrincipalProps.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#endif
+
+#include <boost/functional/hash.hpp>
+
+#include "ShapeFingerprint.h"
+
+
+using namespace Import;
+
+namespace
+{
+
+// Relative tolerance used to compare the integral properties. They are
+// computed numerically, so rotated copies do not give bitwise equal values.
+constexpr double RelativeTolerance = 1e-5;
+
+// Upper bound of candidate transformations checked against the vertices
+constexpr int MaxCandidates = 256;
+
+bool isClose(double a, double b, double scale)
+{
+    return std::fabs(a - b) <= RelativeTolerance * std::max(scale, Precision::Confusion());
+}
+
+double distanceToLine(const gp_Pnt& pnt, const gp_Pnt& origin, const gp_Dir& dir)
+{
+    gp_Vec vec(origin, pnt);
+    return vec.Crossed(gp_Vec(dir)).Magnitude();
+}
+
+}  // namespace
+
+ShapeFingerprint::ShapeFingerprint(const TopoDS_Shape& s)
+{
+    if (s.IsNull() || !TopExp_Explorer(s, TopAbs_SOLID).More()) {
+        return;
+    }
+    TopoDS_Shape shape = s.Located(TopLoc_Location());
+
+    GProp_GProps volumeProps;
+    BRepGProp::VolumeProperties(shape, volumeProps);
+    volume = volumeProps.Mass();
+    if (std::fabs(volume) <= Precision::Confusion()) {
+        return;
+    }
+    center = volumeProps.CentreOfMass();
+
+    GProp_GProps surfaceProps;
+    BRepGProp::SurfaceProperties(shape, surfaceProps);
+    area = surfaceProps.Mass();
+
+    // Keep moments and axes in ascending order of the moments
+    GProp_PrincipalProps principal = volumeProps.PrincipalProperties();
+    std::array<std::pair<double, gp_Dir>, 3> props {
+        std::make_pair(0.0, principal.FirstAxisOfInertia()),
+        std::make_pair(0.0, principal.SecondAxisOfInertia()),
+        std::make_pair(0.0, principal.ThirdAxisOfInertia())};
+    principal.Moments(props[0].first, props[1].first, props[2].first);
+    std::sort(props.begin(), props.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (std::size_t i = 0; i < props.size(); ++i) {
+        moments[i] = props[i].first;
+        axes[i] = props[i].second;
+    }
+
+    TopTools_IndexedMapOfShape vertexMap;
+    TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
+    vertices.reserve(vertexMap.Extent());
+    tolerance = Precision::Confusion();
+    for (int i = 1; i <= vertexMap.Extent(); ++i) {
+        const TopoDS_Vertex& vertex = TopoDS::Vertex(vertexMap(i));
+        vertices.push_back(BRep_Tool::Pnt(vertex));
+        tolerance = std::max(tolerance, BRep_Tool::Tolerance(vertex));
+        radius = std::max(radius, center.Distance(vertices.back()));
+    }
+    std::sort(vertices.begin(), vertices.end(), [](const gp_Pnt& a, const gp_Pnt& b) {
+        return a.X() < b.X();
+    });
+
+    // The extent along a principal axis is only defined if its moment is unique
+    double scale = moments[2];
+    for (int i = 0; i < 3; ++i) {
+        bool unique = !isClose(moments[i], moments[(i + 1) % 3], scale)
+            && !isClose(moments[i], moments[(i + 2) % 3], scale);
+        if (!unique || vertices.empty()) {
+            continue;
+        }
+        double minValue = Precision::Infinite();
+        double maxValue = -Precision::Infinite();
+        gp_Vec dir(axes[i]);
+        for (const auto& pnt : vertices) {
+            double value = gp_Vec(center, pnt).Dot(dir);
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+        }
+        extent[i] = maxValue - minValue;
+    }
+
+    TopTools_IndexedMapOfShape edgeMap;
+    TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
+    numEdges = edgeMap.Extent();
+    edges.reserve(numEdges);
+    for (int i = 1; i <= edgeMap.Extent(); ++i) {
+        const TopoDS_Edge& edge = TopoDS::Edge(edgeMap(i));
+        if (BRep_Tool::Degenerated(edge)) {
+            continue;
+        }
+        int type = static_cast<int>(BRepAdaptor_Curve(edge).GetType());
+        type = std::clamp(type, 0, static_cast<int>(edgeTypes.size()) - 1);
+        ++edgeTypes[type];
+
+        GProp_GProps props;
+        BRepGProp::LinearProperties(edge, props);
+        edges.push_back({type, props.CentreOfMass()});
+    }
+
+    // Topology signature: sorted (surface type, wires, edges) of every face
+    std::vector<std::array<int, 3>> signatures;
+    TopTools_IndexedMapOfShape faceMap;
+    TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
+    signatures.reserve(faceMap.Extent());
+    faces.reserve(faceMap.Extent());
+    for (int i = 1; i <= faceMap.Extent(); ++i) {
+        const TopoDS_Face& face = TopoDS::Face(faceMap(i));
+        int type = static_cast<int>(BRepAdaptor_Surface(face, Standard_False).GetType());
+        type = std::clamp(type, 0, static_cast<int>(faceTypes.size()) - 1);
+        ++faceTypes[type];
+
+        int wires = 0;
+        int wireEdges = 0;
+        for (TopoDS_Iterator it(face); it.More(); it.Next()) {
+            ++wires;
+            for (TopoDS_Iterator jt(it.Value()); jt.More(); jt.Next()) {
+                ++wireEdges;
+            }
+        }
+        signatures.push_back({type, wires, wireEdges});
+
+        GProp_GProps props;
+        BRepGProp::SurfaceProperties(face, props);
+        faces.push_back({type, props.CentreOfMass()});
+    }
+    std::sort(signatures.begin(), signatures.end());
+    topology.reserve(signatures.size() * 3);
+    for (const auto& signature : signatures) {
+        topology.insert(topology.end(), signature.begin(), signature.end());
+    }
+
+    auto byCenterX = [](const Element& a, const Element& b) {
+        return a.center.X() < b.center.X();
+    };
+    std::sort(edges.begin(), edges.end(), byCenterX);
+    std::sort(faces.begin(), faces.end(), byCenterX);
+
+    boost::hash_combine(hashValue, vertices.size());
+    boost::hash_combine(hashValue, numEdges);
+    boost::hash_range(hashValue, edgeTypes.begin(), edgeTypes.end());
+    boost::hash_range(hashValue, faceTypes.begin(), faceTypes.end());
+    boost::hash_range(hashValue, topology.begin(), topology.end());
+    valid = true;
+}
+
+bool ShapeFingerprint::matches(const ShapeFingerprint& other) const
+{
+    if (!valid || !other.valid || hashValue != other.hashValue) {
+        return false;
+    }
+    if (vertices.size() != other.vertices.size() || numEdges != other.numEdges
+        || edges.size() != other.edges.size() || faces.size() != other.faces.size()
+        || edgeTypes != other.edgeTypes || faceTypes != other.faceTypes) {
+        return false;
+    }
+    if (!isClose(volume, other.volume, std::fabs(volume))
+        || !isClose(area, other.area, std::fabs(area))
+        || !isClose(radius, other.radius, radius)) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (!isClose(moments[i], other.moments[i], moments[2])
+            || !isClose(extent[i], other.extent[i], radius)) {
+            return false;
+        }
+    }
+    // Only compared on collision, as it is the most expensive part
+    return topology == other.topology;
+}
+
+gp_Ax3 ShapeFingerprint::principalFrame(bool flipX, bool flipY) const
+{
+    gp_Dir xDir = flipX ? axes[0].Reversed() : axes[0];
+    gp_Dir yDir = flipY ? axes[1].Reversed() : axes[1];
+    return gp_Ax3(center, xDir.Crossed(yDir), xDir);
+}
+
+bool ShapeFingerprint::findVertex(const gp_Pnt& pnt, double tol) const
+{
+    auto it = std::lower_bound(vertices.begin(),
+                               vertices.end(),
+                               pnt.X() - tol,
+                               [](const gp_Pnt& p, double x) {
+                                   return p.X() < x;
+                               });
+    double tol2 = tol * tol;
+    for (; it != vertices.end() && it->X() <= pnt.X() + tol; ++it) {
+        if (it->SquareDistance(pnt) <= tol2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShapeFingerprint::findElement(const std::vector<Element>& elements,
+                                   const Element& element,
+                                   double tol)
+{
+    const gp_Pnt& pnt = element.center;
+    auto it = std::lower_bound(elements.begin(),
+                               elements.end(),
+                               pnt.X() - tol,
+                               [](const Element& e, double x) {
+                                   return e.center.X() < x;
+                               });
+    double tol2 = tol * tol;
+    for (; it != elements.end() && it->center.X() <= pnt.X() + tol; ++it) {
+        if (it->type == element.type && it->center.SquareDistance(pnt) <= tol2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShapeFingerprint::verify(const ShapeFingerprint& other, const gp_Trsf& trsf) const
+{
+    if (vertices.size() != other.vertices.size() || edges.size() != other.edges.size()
+        || faces.size() != other.faces.size()) {
+        return false;
+    }
+
+    double tol = std::max(tolerance, other.tolerance);
+    for (const auto& pnt : vertices) {
+        if (!other.findVertex(pnt.Transformed(trsf), tol)) {
+            return false;
+        }
+    }
+
+    // Shapes with the same vertices may still differ in their edges and faces,
+    // e.g. a fillet and a chamfer. The centers of mass are computed numerically.
+    double centerTol = std::max(tol, RelativeTolerance * std::max(radius, other.radius));
+    for (const auto& list : {std::make_pair(&edges, &other.edges),
+                             std::make_pair(&faces, &other.faces)}) {
+        for (const auto& element : *list.first) {
+            Element moved {element.type, element.center.Transformed(trsf)};
+            if (!findElement(*list.second, moved, centerTol)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool ShapeFingerprint::findTransform(const ShapeFingerprint& other, gp_Trsf& trsf) const
+{
+    if (!matches(other)) {
+        return false;
+    }
+
+    double scale = moments[2];
+    bool distinct = !isClose(moments[0], moments[1], scale)
+        && !isClose(moments[1], moments[2], scale);
+    if (distinct) {
+        // The principal frames are defined up to the sign of the axes
+        for (int i = 0; i < 4; ++i) {
+            trsf.SetDisplacement(principalFrame(false, false),
+                                 other.principalFrame((i & 1) != 0, (i & 2) != 0));
+            if (verify(other, trsf)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Symmetric inertia (e.g. bolts, cubes): build a frame from the vertex
+    // farthest from the center and the vertex farthest from that direction,
+    // and try every pair of vertices of the other shape at the same distances.
+    double tol = std::max(tolerance, other.tolerance);
+    auto first = std::max_element(vertices.begin(),
+                                  vertices.end(),
+                                  [this](const gp_Pnt& a, const gp_Pnt& b) {
+                                      return center.SquareDistance(a) < center.SquareDistance(b);
+                                  });
+    if (first == vertices.end() || center.Distance(*first) <= tol) {
+        return false;
+    }
+    gp_Dir xDir(gp_Vec(center, *first));
+    auto second = std::max_element(vertices.begin(),
+                                   vertices.end(),
+                                   [this, &xDir](const gp_Pnt& a, const gp_Pnt& b) {
+                                       return distanceToLine(a, center, xDir)
+                                           < distanceToLine(b, center, xDir);
+                                   });
+    if (distanceToLine(*second, center, xDir) <= tol) {
+        return false;
+    }
+    gp_Ax3 frame(center, gp_Dir(gp_Vec(xDir).Crossed(gp_Vec(center, *second))), xDir);
+
+    double dist1 = center.Distance(*first);
+    double dist2 = center.Distance(*second);
+    double dist12 = first->Distance(*second);
+    int candidates = 0;
+    for (const auto& pnt1 : other.vertices) {
+        if (std::fabs(other.center.Distance(pnt1) - dist1) > tol) {
+            continue;
+        }
+        gp_Dir otherX(gp_Vec(other.center, pnt1));
+        for (const auto& pnt2 : other.vertices) {
+            if (std::fabs(other.center.Distance(pnt2) - dist2) > tol
+                || std::fabs(pnt1.Distance(pnt2) - dist12) > tol
+                || distanceToLine(pnt2, other.center, otherX) <= tol) {
+                continue;
+            }
+            gp_Ax3 otherFrame(other.center,
+                              gp_Dir(gp_Vec(otherX).Crossed(gp_Vec(other.center, pnt2))),
+                              otherX);
+            trsf.SetDisplacement(frame, otherFrame);
+            if (verify(other, trsf)) {
+                return true;
+            }
+            if (++candidates >= MaxCandidates) {
+                return false;
+            }
+        }
+    }
+    return false;
+}
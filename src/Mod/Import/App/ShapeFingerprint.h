@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef IMPORT_SHAPEFINGERPRINT_H
+#define IMPORT_SHAPEFINGERPRINT_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <gp_Ax3.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <Mod/Import/ImportGlobal.h>
+
+
+namespace Import
+{
+
+/** Geometric fingerprint of a solid shape
+ *
+ * The fingerprint is made of placement invariant properties (volume, area,
+ * principal moments of inertia, extent along the principal axes, edge and face
+ * type histograms and a topology signature). It is used on import to detect solids
+ * that are repeated in a file without any instancing information, so that
+ * they can be loaded once and referenced by links.
+ */
+class ImportExport ShapeFingerprint
+{
+public:
+    /// Computes the fingerprint of \a shape ignoring its location
+    explicit ShapeFingerprint(const TopoDS_Shape& shape);
+
+    /// Returns false if the shape has no solid and cannot be fingerprinted
+    bool isValid() const
+    {
+        return valid;
+    }
+    /// Hash of the discrete part of the fingerprint
+    std::size_t hash() const
+    {
+        return hashValue;
+    }
+    /// Compares the invariants of both fingerprints
+    bool matches(const ShapeFingerprint& other) const;
+    /** Searches for the rigid motion that maps this shape onto \a other
+     * The transformation is verified against the vertices of both shapes.
+     * Mirrored shapes are not considered as equal.
+     */
+    bool findTransform(const ShapeFingerprint& other, gp_Trsf& trsf) const;
+    /** Checks if \a trsf maps this shape onto \a other
+     * All vertices, and the centers of mass and the geometry types of all edges
+     * and faces must coincide.
+     */
+    bool verify(const ShapeFingerprint& other, const gp_Trsf& trsf) const;
+
+private:
+    /// The center of mass and geometry type of an edge or face
+    struct Element
+    {
+        int type;
+        gp_Pnt center;
+    };
+
+    bool findVertex(const gp_Pnt& pnt, double tol) const;
+    static bool findElement(const std::vector<Element>& elements,
+                            const Element& element,
+                            double tol);
+    gp_Ax3 principalFrame(bool flipX, bool flipY) const;
+
+private:
+    bool valid = false;
+    std::size_t hashValue = 0;
+    double volume = 0.0;
+    double area = 0.0;
+    double radius = 0.0;
+    double tolerance = 0.0;
+    gp_Pnt center;
+    std::array<double, 3> moments {};
+    std::array<gp_Dir, 3> axes;
+    std::array<double, 3> extent {};
+    std::array<int, 11> faceTypes {};
+    std::array<int, 9> edgeTypes {};
+    int numEdges = 0;
+    std::vector<int> topology;
+    /// Vertices sorted by their X coordinate
+    std::vector<gp_Pnt> vertices;
+    /// Edges and faces sorted by the X coordinate of their center
+    std::vector<Element> edges;
+    std::vector<Element> faces;
+};
+
+}  // namespace Import
+
+#endif  // IMPORT_SHAPEFINGERPRINT_H
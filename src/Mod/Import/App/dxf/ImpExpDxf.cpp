@@ -58,6 +58,7 @@
 #include <Base/Console.h>
 #include <Base/Interpreter.h>
 #include <Base/Matrix.h>
+#include <Base/Parallel.h>
 #include <Base/Parameter.h>
 #include <Base/Vector3D.h>
 #include <Mod/Part/App/PartFeature.h>
@@ -111,17 +112,19 @@ void ImpExpDxfRead::OnReadLine(const double* s, const double* e, bool /*hidden*/
     if (p0.IsEqual(p1, 0.00000001)) {
         return;
     }
-    BRepBuilderAPI_MakeEdge makeEdge(p0, p1);
-    TopoDS_Edge edge = makeEdge.Edge();
-    AddObject(new Part::TopoShape(edge));
+    AddEntity([p0, p1]() -> TopoDS_Shape {
+        BRepBuilderAPI_MakeEdge makeEdge(p0, p1);
+        return makeEdge.Edge();
+    });
 }
 
 
 void ImpExpDxfRead::OnReadPoint(const double* s)
 {
-    BRepBuilderAPI_MakeVertex makeVertex(makePoint(s));
-    TopoDS_Vertex vertex = makeVertex.Vertex();
-    AddObject(new Part::TopoShape(vertex));
+    AddEntity([p = makePoint(s)]() -> TopoDS_Shape {
+        BRepBuilderAPI_MakeVertex makeVertex(p);
+        return makeVertex.Vertex();
+    });
 }
 
 
@@ -140,9 +143,10 @@ void ImpExpDxfRead::OnReadArc(const double* s,
     gp_Pnt pc = makePoint(c);
     gp_Circ circle(gp_Ax2(pc, up), p0.Distance(pc));
     if (circle.Radius() > 0) {
-        BRepBuilderAPI_MakeEdge makeEdge(circle, p0, p1);
-        TopoDS_Edge edge = makeEdge.Edge();
-        AddObject(new Part::TopoShape(edge));
+        AddEntity([circle, p0, p1]() -> TopoDS_Shape {
+            BRepBuilderAPI_MakeEdge makeEdge(circle, p0, p1);
+            return makeEdge.Edge();
+        });
     }
     else {
         Base::Console().Warning("ImpExpDxf - ignore degenerate arc of circle\n");
@@ -160,9 +164,10 @@ void ImpExpDxfRead::OnReadCircle(const double* s, const double* c, bool dir, boo
     gp_Pnt pc = makePoint(c);
     gp_Circ circle(gp_Ax2(pc, up), p0.Distance(pc));
     if (circle.Radius() > 0) {
-        BRepBuilderAPI_MakeEdge makeEdge(circle);
-        TopoDS_Edge edge = makeEdge.Edge();
-        AddObject(new Part::TopoShape(edge));
+        AddEntity([circle]() -> TopoDS_Shape {
+            BRepBuilderAPI_MakeEdge makeEdge(circle);
+            return makeEdge.Edge();
+        });
     }
     else {
         Base::Console().Warning("ImpExpDxf - ignore degenerate circle\n");
@@ -267,26 +272,30 @@ void ImpExpDxfRead::OnReadSpline(struct SplineData& sd)
     // Flags:
     // 1: Closed, 2: Periodic, 4: Rational, 8: Planar, 16: Linear
 
-    try {
-        Handle(Geom_BSplineCurve) geom;
-        if (sd.control_points > 0) {
-            geom = getSplineFromPolesAndKnots(sd);
-        }
-        else if (sd.fit_points > 0) {
-            geom = getInterpolationSpline(sd);
-        }
+    // a null shape reports the failure when the entities are added
+    AddEntity(
+        [sd]() mutable -> TopoDS_Shape {
+            try {
+                Handle(Geom_BSplineCurve) geom;
+                if (sd.control_points > 0) {
+                    geom = getSplineFromPolesAndKnots(sd);
+                }
+                else if (sd.fit_points > 0) {
+                    geom = getInterpolationSpline(sd);
+                }
 
-        if (geom.IsNull()) {
-            throw Standard_Failure();
-        }
+                if (geom.IsNull()) {
+                    throw Standard_Failure();
+                }
 
-        BRepBuilderAPI_MakeEdge makeEdge(geom);
-        TopoDS_Edge edge = makeEdge.Edge();
-        AddObject(new Part::TopoShape(edge));
-    }
-    catch (const Standard_Failure&) {
-        Base::Console().Warning("ImpExpDxf - failed to create bspline\n");
-    }
+                BRepBuilderAPI_MakeEdge makeEdge(geom);
+                return makeEdge.Edge();
+            }
+            catch (const Standard_Failure&) {
+                return TopoDS_Shape();
+            }
+        },
+        "ImpExpDxf - failed to create bspline\n");
 }
 
 
@@ -306,9 +315,10 @@ void ImpExpDxfRead::OnReadEllipse(const double* c,
     gp_Elips ellipse(gp_Ax2(pc, up), major_radius * optionScaling, minor_radius * optionScaling);
     ellipse.Rotate(gp_Ax1(pc, up), rotation);
     if (ellipse.MinorRadius() > 0) {
-        BRepBuilderAPI_MakeEdge makeEdge(ellipse);
-        TopoDS_Edge edge = makeEdge.Edge();
-        AddObject(new Part::TopoShape(edge));
+        AddEntity([ellipse]() -> TopoDS_Shape {
+            BRepBuilderAPI_MakeEdge makeEdge(ellipse);
+            return makeEdge.Edge();
+        });
     }
     else {
         Base::Console().Warning("ImpExpDxf - ignore degenerate ellipse\n");
@@ -341,6 +351,9 @@ void ImpExpDxfRead::OnReadInsert(const double* point,
     // std::cout << "Inserting block " << name << " rotation " << rotation << " pos " << point[0] <<
     // "," << point[1] << "," << point[2] << " scale " << scale[0] << "," << scale[1] << "," <<
     // scale[2] << std::endl;
+    // the block entities must be built before they are copied
+    BuildEntities();
+
     std::string prefix = "BLOCKS ";
     prefix += name;
     prefix += " ";
@@ -402,17 +415,55 @@ void ImpExpDxfRead::OnReadDimension(const double* s,
 }
 
 
-void ImpExpDxfRead::AddObject(Part::TopoShape* shape)
+void ImpExpDxfRead::AddEntity(std::function<TopoDS_Shape()> build, const char* failure)
+{
+    pendingEntities.push_back({LayerName(), std::move(build), failure});
+}
+
+
+void ImpExpDxfRead::BuildEntities()
 {
-    // std::cout << "layer:" << LayerName() << std::endl;
-    std::vector<Part::TopoShape*> vec;
-    if (layers.count(LayerName())) {
-        vec = layers[LayerName()];
+    // The shapes are built concurrently, they are then added one by one in
+    // file order so that the layers and features come out the same as before
+    std::vector<TopoDS_Shape> shapes(pendingEntities.size());
+    Base::parallelFor(
+        pendingEntities.size(),
+        [this, &shapes](std::size_t i) {
+            shapes[i] = pendingEntities[i].build();
+        },
+        256);
+
+    for (std::size_t i = 0; i < pendingEntities.size(); i++) {
+        if (shapes[i].IsNull()) {
+            if (pendingEntities[i].failure) {
+                Base::Console().Warning(pendingEntities[i].failure);
+            }
+            continue;
+        }
+        AddObject(pendingEntities[i].layer, new Part::TopoShape(shapes[i]));
     }
-    vec.push_back(shape);
-    layers[LayerName()] = vec;
+    pendingEntities.clear();
+}
+
+
+void ImpExpDxfRead::FinishRead()
+{
+    BuildEntities();
+}
+
+
+void ImpExpDxfRead::AddObject(Part::TopoShape* shape)
+{
+    AddObject(LayerName(), shape);
+}
+
+
+void ImpExpDxfRead::AddObject(const std::string& layer, Part::TopoShape* shape)
+{
+    // std::cout << "layer:" << layer << std::endl;
+    layers[layer].push_back(shape);
     if (!optionGroupLayers) {
-        if (LayerName().substr(0, 6) != "BLOCKS") {
+        if (layer.substr(0, 6) != "BLOCKS") {
             Part::Feature* pcFeature =
                 static_cast<Part::Feature*>(document->addObject("Part::Feature", "Shape"));
             pcFeature->Shape.setValue(shape->getShape());
@@ -464,22 +515,17 @@ std::string ImpExpDxfRead::Deformat(const char* text)
 void ImpExpDxfRead::AddGraphics() const
 {
     if (optionGroupLayers) {
-        for (std::map<std::string, std::vector<Part::TopoShape*>>::const_iterator i =
-                 layers.begin();
-             i != layers.end();
-             ++i) {
+        for (const auto& it : layers) {
             BRep_Builder builder;
             TopoDS_Compound comp;
             builder.MakeCompound(comp);
-            std::string k = i->first;
+            std::string k = it.first;
             if (k == "0") {  // FreeCAD doesn't like an object name being '0'...
                 k = "LAYER_0";
             }
-            std::vector<Part::TopoShape*> v = i->second;
             if (k.substr(0, 6) != "BLOCKS") {
-                for (std::vector<Part::TopoShape*>::const_iterator j = v.begin(); j != v.end();
-                     ++j) {
-                    const TopoDS_Shape& sh = (*j)->getShape();
+                for (const auto& shape : it.second) {
+                    const TopoDS_Shape& sh = shape->getShape();
                     if (!sh.IsNull()) {
                         builder.Add(comp, sh);
                     }
@@ -23,6 +23,8 @@
 #ifndef IMPEXPDXF_H
 #define IMPEXPDXF_H
 
+#include <functional>
+
 #include <gp_Pnt.hxx>
 
 #include <App/Document.h>
@@ -63,6 +65,7 @@ public:
                          const double* e,
                          const double* point,
                          double rotation) override;
+    void FinishRead() override;
     void AddGraphics() const override;
 
     // FreeCAD-specific functions
@@ -81,6 +84,18 @@ public:
 
 private:
     gp_Pnt makePoint(const double* p);
+    // Records an entity of the current layer, its shape is built later by BuildEntities()
+    void AddEntity(std::function<TopoDS_Shape()> build, const char* failure = nullptr);
+    void BuildEntities();
+    void AddObject(const std::string& layer, Part::TopoShape* shape);
+
+    struct PendingEntity
+    {
+        std::string layer;
+        std::function<TopoDS_Shape()> build;
+        const char* failure;  // warning if the shape can't be built
+    };
+    std::vector<PendingEntity> pendingEntities;
 
 protected:
     App::Document* document;
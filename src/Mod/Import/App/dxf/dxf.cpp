@@ -1809,13 +1809,25 @@ CDxfRead::CDxfRead(const char* filepath)
     memset(m_block_name, '\0', sizeof(m_block_name));
     m_ignore_errors = true;
 
-    m_ifs = new ifstream(filepath);
-    if (!(*m_ifs)) {
+    m_pos = 0;
+    m_eof = false;
+
+    // Read the file with a single bulk read instead of a getline() call per line
+    ifstream ifs(filepath, std::ios::in | std::ios::binary);
+    if (!ifs) {
         m_fail = true;
+        m_eof = true;
         printf("DXF file didn't load\n");
         return;
     }
-    m_ifs->imbue(std::locale("C"));
+    ifs.seekg(0, std::ios::end);
+    std::streamoff size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    if (size > 0) {
+        m_buffer.resize(static_cast<std::size_t>(size));
+        ifs.read(m_buffer.data(), size);
+        m_buffer.resize(static_cast<std::size_t>(ifs.gcount()));
+    }
 
     m_version = RUnknown;
     m_CodePage = nullptr;
@@ -1825,7 +1837,6 @@ CDxfRead::CDxfRead(const char* filepath)
 
 CDxfRead::~CDxfRead()
 {
-    delete m_ifs;
     delete m_CodePage;
     delete m_encoding;
 }
@@ -1896,7 +1907,7 @@ bool CDxfRead::ReadLine()
     double e[3] = {0, 0, 0};
     bool hidden = false;
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
 
@@ -2029,7 +2040,7 @@ bool CDxfRead::ReadPoint()
 {
     double s[3] = {0, 0, 0};
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
 
@@ -2130,7 +2141,7 @@ bool CDxfRead::ReadArc()
     double z_extrusion_dir = 1.0;
     bool hidden = false;
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -2271,7 +2282,7 @@ bool CDxfRead::ReadSpline()
 
     double temp_double;
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -2549,7 +2560,7 @@ bool CDxfRead::ReadCircle()
     double c[3] = {0, 0, 0};  // centre
     bool hidden = false;
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -2656,7 +2667,7 @@ bool CDxfRead::ReadText()
 
     memset(c, 0, sizeof(c));
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -2778,7 +2789,7 @@ bool CDxfRead::ReadEllipse()
     double start = 0;         // start of arc
     double end = 0;           // end of arc
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -2990,7 +3001,7 @@ bool CDxfRead::ReadLwPolyLine()
     int flags;
     bool next_item_found = false;
 
-    while (!((*m_ifs).eof()) && !next_item_found) {
+    while (!is_eof() && !next_item_found) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -3118,7 +3129,7 @@ bool CDxfRead::ReadVertex(double* pVertex, bool* bulge_found, double* bulge)
     pVertex[1] = 0.0;
     pVertex[2] = 0.0;
 
-    while (!(*m_ifs).eof()) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -3213,7 +3224,7 @@ bool CDxfRead::ReadPolyLine()
     bool bulge_found;
     double bulge;
 
-    while (!(*m_ifs).eof()) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -3353,7 +3364,7 @@ bool CDxfRead::ReadInsert()
     double rot = 0.0;         // rotation
     char name[1024] = {0};
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -3478,7 +3489,7 @@ bool CDxfRead::ReadDimension()
     double p[3] = {0, 0, 0};  // dimpoint
     double rot = -1.0;        // rotation
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -3626,7 +3637,7 @@ bool CDxfRead::ReadDimension()
 
 bool CDxfRead::ReadBlockInfo()
 {
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
         if (sscanf(m_str, "%d", &n) != 1) {
@@ -3664,23 +3675,37 @@ void CDxfRead::get_line()
         return;
     }
 
-    m_ifs->getline(m_str, 1024);
+    // Behaves like std::istream::getline(): the eof flag is raised when the end
+    // of the buffer is reached before a line terminator is found
+    const std::size_t size = m_buffer.size();
+    if (m_pos >= size) {
+        m_str[0] = '\0';
+        m_eof = true;
+        return;
+    }
 
-    char str[1024];
-    size_t len = strlen(m_str);
-    int j = 0;
-    bool non_white_found = false;
-    for (size_t i = 0; i < len; i++) {
-        if (non_white_found || (m_str[i] != ' ' && m_str[i] != '\t')) {
-            if (m_str[i] != '\r') {
-                str[j] = m_str[i];
-                j++;
-            }
-            non_white_found = true;
+    const char* begin = m_buffer.data() + m_pos;
+    const char* end = static_cast<const char*>(memchr(begin, '\n', size - m_pos));
+    if (end) {
+        m_pos = static_cast<std::size_t>(end - m_buffer.data()) + 1;
+    }
+    else {
+        end = m_buffer.data() + size;
+        m_pos = size;
+        m_eof = true;
+    }
+
+    // skip leading white space and drop carriage returns
+    while (begin != end && (*begin == ' ' || *begin == '\t')) {
+        ++begin;
+    }
+    std::size_t j = 0;
+    for (const char* it = begin; it != end && j < sizeof(m_str) - 1; ++it) {
+        if (*it != '\r') {
+            m_str[j++] = *it;
         }
     }
-    str[j] = 0;
-    strcpy(m_str, str);
+    m_str[j] = '\0';
 }
 
 void dxf_strncpy(char* dst, const char* src, size_t size)
@@ -3721,7 +3746,7 @@ bool CDxfRead::ReadLayer()
     std::string layername;
     ColorIndex_t colorIndex = -1;
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         get_line();
         int n;
 
@@ -3909,12 +3934,22 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */)
         return;
     }
 
+    // the entities read up to an error are still passed on
+    bool complete = ReadSections();
+    FinishRead();
+    if (complete) {
+        AddGraphics();
+    }
+}
+
+bool CDxfRead::ReadSections()
+{
     get_line();
 
-    while (!((*m_ifs).eof())) {
+    while (!is_eof()) {
         if (!strcmp(m_str, "$INSUNITS")) {
             if (!ReadUnits()) {
-                return;
+                return false;
             }
             continue;
         }  // End if - then
@@ -3933,14 +3968,14 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */)
 
         if (!strcmp(m_str, "$ACADVER")) {
             if (!ReadVersion()) {
-                return;
+                return false;
             }
             continue;
         }  // End if - then
 
         if (!strcmp(m_str, "$DWGCODEPAGE")) {
             if (!ReadDWGCodePage()) {
-                return;
+                return false;
             }
             continue;
         }  // End if - then
@@ -3975,7 +4010,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */)
             else if (!strcmp(m_str, "BLOCK")) {
                 if (!ReadBlockInfo()) {
                     printf("CDxfRead::DoRead() Failed to read block info\n");
-                    return;
+                    return false;
                 }
                 continue;
             }  // End if - then
@@ -3987,84 +4022,84 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */)
             else if (!strcmp(m_str, "LINE")) {
                 if (!ReadLine()) {
                     printf("CDxfRead::DoRead() Failed to read line\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "ARC")) {
                 if (!ReadArc()) {
                     printf("CDxfRead::DoRead() Failed to read arc\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "CIRCLE")) {
                 if (!ReadCircle()) {
                     printf("CDxfRead::DoRead() Failed to read circle\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "MTEXT")) {
                 if (!ReadText()) {
                     printf("CDxfRead::DoRead() Failed to read text\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "TEXT")) {
                 if (!ReadText()) {
                     printf("CDxfRead::DoRead() Failed to read text\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "ELLIPSE")) {
                 if (!ReadEllipse()) {
                     printf("CDxfRead::DoRead() Failed to read ellipse\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "SPLINE")) {
                 if (!ReadSpline()) {
                     printf("CDxfRead::DoRead() Failed to read spline\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "LWPOLYLINE")) {
                 if (!ReadLwPolyLine()) {
                     printf("CDxfRead::DoRead() Failed to read LW Polyline\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "POLYLINE")) {
                 if (!ReadPolyLine()) {
                     printf("CDxfRead::DoRead() Failed to read Polyline\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "POINT")) {
                 if (!ReadPoint()) {
                     printf("CDxfRead::DoRead() Failed to read Point\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "INSERT")) {
                 if (!ReadInsert()) {
                     printf("CDxfRead::DoRead() Failed to read Insert\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
             else if (!strcmp(m_str, "DIMENSION")) {
                 if (!ReadDimension()) {
                     printf("CDxfRead::DoRead() Failed to read Dimension\n");
-                    return;
+                    return false;
                 }
                 continue;
             }
@@ -4072,7 +4107,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */)
 
         get_line();
     }
-    AddGraphics();
+    return true;
 }
 
 
@@ -305,7 +305,10 @@ public:
 class CDxfRead
 {
 private:
-    std::ifstream* m_ifs;
+    // The whole file is read into memory once and lines are scanned from the buffer
+    std::vector<char> m_buffer;
+    std::size_t m_pos;
+    bool m_eof;
 
     bool m_fail;
     char m_str[1024];
@@ -353,9 +356,14 @@ private:
     bool ReadVersion();
     bool ReadDWGCodePage();
     bool ResolveEncoding();
+    bool ReadSections();
 
     void get_line();
     void put_line(const char* value);
+    bool is_eof() const
+    {
+        return m_eof;
+    }
     void ResolveColorIndex();
 
 protected:
@@ -425,6 +433,9 @@ public:
                                               const double* /*point*/,
                                               double /*rotation*/)
     {}
+    // Called once reading stopped, also after an error, and before AddGraphics()
+    ImportExport virtual void FinishRead()
+    {}
     ImportExport virtual void AddGraphics() const
     {}
 
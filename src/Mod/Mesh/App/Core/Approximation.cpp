@@ -26,6 +26,7 @@
 # include <algorithm>
 # include <cstdlib>
 # include <iterator>
+# include <tuple>
 #endif
 
 #include <Base/BoundBox.h>
@@ -51,6 +52,51 @@
 
 using namespace MeshCore;
 
+void PointMoments::Add(const Base::Vector3f& rcPoint)
+{
+    // Welford's update: 'd' is relative to the old, 'e' to the new centroid
+    Base::Vector3d pnt = Base::convertTo<Base::Vector3d>(rcPoint);
+    ++_count;
+    Base::Vector3d d = pnt - _mean;
+    _mean += d / double(_count);
+    Base::Vector3d e = pnt - _mean;
+    _sxx += d.x * e.x; _sxy += d.x * e.y; _sxz += d.x * e.z;
+    _syy += d.y * e.y; _syz += d.y * e.z; _szz += d.z * e.z;
+}
+
+void PointMoments::Remove(const Base::Vector3f& rcPoint)
+{
+    if (_count <= 1) {
+        Clear();
+        return;
+    }
+
+    // Inverse of Add(): 'e' is relative to the old, 'd' to the new centroid
+    Base::Vector3d pnt = Base::convertTo<Base::Vector3d>(rcPoint);
+    Base::Vector3d e = pnt - _mean;
+    --_count;
+    _mean -= e / double(_count);
+    Base::Vector3d d = pnt - _mean;
+    _sxx -= d.x * e.x; _sxy -= d.x * e.y; _sxz -= d.x * e.z;
+    _syy -= d.y * e.y; _syz -= d.y * e.z; _szz -= d.z * e.z;
+}
+
+void PointMoments::Clear()
+{
+    _count = 0;
+    _mean.Set(0.0, 0.0, 0.0);
+    _sxx = _sxy = _sxz = _syy = _syz = _szz = 0.0;
+}
+
+Wm4::Matrix3<double> PointMoments::GetScatter() const
+{
+    return Wm4::Matrix3<double>(_sxx, _sxy, _sxz,
+                                _sxy, _syy, _syz,
+                                _sxz, _syz, _szz);
+}
+
+// -------------------------------------------------------------------------------
+
 Approximation::Approximation() = default;
 
 Approximation::~Approximation()
@@ -60,52 +106,105 @@ Approximation::~Approximation()
 
 void Approximation::GetMgcVectorArray(std::vector< Wm4::Vector3<double> >& rcPts) const
 {
-    std::list< Base::Vector3f >::const_iterator It;
     rcPts.reserve(_vPoints.size());
-    for (It = _vPoints.begin(); It != _vPoints.end(); ++It) {
-        rcPts.push_back(Base::convertTo<Wm4::Vector3d>(*It));
+    for (const auto& It : _vPoints) {
+        rcPts.push_back(Base::convertTo<Wm4::Vector3d>(It));
+    }
+}
+
+void Approximation::UpdateMoments()
+{
+    _moments.Clear();
+    for (const auto& It : _vPoints) {
+        _moments.Add(It);
     }
 }
 
 void Approximation::AddPoint(const Base::Vector3f &rcVector)
 {
     _vPoints.push_back(rcVector);
+    _moments.Add(rcVector);
     _bIsFitted = false;
 }
 
 void Approximation::AddPoints(const std::vector<Base::Vector3f> &points)
 {
-    std::copy(points.begin(), points.end(), std::back_inserter(_vPoints));
+    _vPoints.insert(_vPoints.end(), points.begin(), points.end());
+    for (const auto& It : points)
+        _moments.Add(It);
     _bIsFitted = false;
 }
 
 void Approximation::AddPoints(const std::set<Base::Vector3f> &points)
 {
-    std::copy(points.begin(), points.end(), std::back_inserter(_vPoints));
+    _vPoints.insert(_vPoints.end(), points.begin(), points.end());
+    for (const auto& It : points)
+        _moments.Add(It);
     _bIsFitted = false;
 }
 
 void Approximation::AddPoints(const std::list<Base::Vector3f> &points)
 {
-    std::copy(points.begin(), points.end(), std::back_inserter(_vPoints));
+    _vPoints.insert(_vPoints.end(), points.begin(), points.end());
+    for (const auto& It : points)
+        _moments.Add(It);
     _bIsFitted = false;
 }
 
 void Approximation::AddPoints(const MeshPointArray &points)
 {
-    std::copy(points.begin(), points.end(), std::back_inserter(_vPoints));
+    _vPoints.insert(_vPoints.end(), points.begin(), points.end());
+    for (const auto& It : points)
+        _moments.Add(It);
+    _bIsFitted = false;
+}
+
+bool Approximation::RemovePoint(const Base::Vector3f &rcVector)
+{
+    // search from the end because usually the most recently added points are removed
+    auto It = std::find(_vPoints.rbegin(), _vPoints.rend(), rcVector);
+    if (It == _vPoints.rend())
+        return false;
+
+    _vPoints.erase(std::next(It).base());
+    _moments.Remove(rcVector);
+    _bIsFitted = false;
+    return true;
+}
+
+void Approximation::RemovePoints(const std::vector<Base::Vector3f> &points)
+{
+    if (points.empty())
+        return;
+
+    // Remove all points in a single pass. Each given point removes at most one stored point.
+    auto less = [](const Base::Vector3f& p1, const Base::Vector3f& p2) {
+        return std::tie(p1.x, p1.y, p1.z) < std::tie(p2.x, p2.y, p2.z);
+    };
+    std::vector<Base::Vector3f> pending(points);
+    std::sort(pending.begin(), pending.end(), less);
+    std::vector<bool> used(pending.size(), false);
+
+    auto end = std::remove_if(_vPoints.begin(), _vPoints.end(), [&](const Base::Vector3f& pnt) {
+        auto range = std::equal_range(pending.begin(), pending.end(), pnt, less);
+        for (auto It = range.first; It != range.second; ++It) {
+            std::size_t index = std::distance(pending.begin(), It);
+            if (!used[index]) {
+                used[index] = true;
+                _moments.Remove(pnt);
+                return true;
+            }
+        }
+        return false;
+    });
+
+    _vPoints.erase(end, _vPoints.end());
     _bIsFitted = false;
 }
 
 Base::Vector3f Approximation::GetGravity() const
 {
-    Base::Vector3f clGravity;
-    if (!_vPoints.empty()) {
-        for (const auto& vPoint : _vPoints)
-            clGravity += vPoint;
-        clGravity *= 1.0f / float(_vPoints.size());
-    }
-    return clGravity;
+    return Base::convertTo<Base::Vector3f>(_moments.GetMean());
 }
 
 std::size_t Approximation::CountPoints() const
@@ -116,6 +215,7 @@ std::size_t Approximation::CountPoints() const
 void Approximation::Clear()
 {
     _vPoints.clear();
+    _moments.Clear();
     _bIsFitted = false;
 }
 
@@ -145,25 +245,15 @@ float PlaneFit::Fit()
     if (CountPoints() < 3)
         return FLOAT_MAX;
 
-    double sxx,sxy,sxz,syy,syz,szz,mx,my,mz;
-    sxx=sxy=sxz=syy=syz=szz=mx=my=mz=0.0;
-
-    for (const auto & vPoint : _vPoints) {
-        sxx += double(vPoint.x * vPoint.x); sxy += double(vPoint.x * vPoint.y);
-        sxz += double(vPoint.x * vPoint.z); syy += double(vPoint.y * vPoint.y);
-        syz += double(vPoint.y * vPoint.z); szz += double(vPoint.z * vPoint.z);
-        mx  += double(vPoint.x); my += double(vPoint.y); mz += double(vPoint.z);
-    }
-
-    size_t nSize = _vPoints.size();
-    sxx = sxx - mx*mx/(double(nSize));
-    sxy = sxy - mx*my/(double(nSize));
-    sxz = sxz - mx*mz/(double(nSize));
-    syy = syy - my*my/(double(nSize));
-    syz = syz - my*mz/(double(nSize));
-    szz = szz - mz*mz/(double(nSize));
+    // The scatter matrix is kept up to date while adding points, so there is no need
+    // to traverse the points again
+    size_t nSize = _moments.Count();
+    const Base::Vector3d& mean = _moments.GetMean();
+    Wm4::Matrix3<double> akMat = _moments.GetScatter();
 
 #if defined(FC_USE_EIGEN)
+    double sxx = akMat(0,0), sxy = akMat(0,1), sxz = akMat(0,2);
+    double syy = akMat(1,1), syz = akMat(1,2), szz = akMat(2,2);
     Eigen::Matrix3d covMat = Eigen::Matrix3d::Zero();
     covMat(0,0) = sxx;
     covMat(1,1) = syy;
@@ -180,12 +270,11 @@ float PlaneFit::Fit()
     _vDirU.Set(u.x(), u.y(), u.z());
     _vDirV.Set(v.x(), v.y(), v.z());
     _vDirW.Set(w.x(), w.y(), w.z());
-    _vBase.Set(mx/(float)nSize, my/(float)nSize, mz/(float)nSize);
+    _vBase = Base::convertTo<Base::Vector3f>(mean);
 
     float sigma = w.dot(covMat * w);
 #else
     // Covariance matrix
-    Wm4::Matrix3<double> akMat(sxx,sxy,sxz,sxy,syy,syz,sxz,syz,szz);
     Wm4::Matrix3<double> rkRot, rkDiag;
     try {
         akMat.EigenDecomposition(rkRot, rkDiag);
@@ -230,7 +319,7 @@ float PlaneFit::Fit()
     _vDirU.Set(float(U.X()), float(U.Y()), float(U.Z()));
     _vDirV.Set(float(V.X()), float(V.Y()), float(V.Z()));
     _vDirW.Set(float(W.X()), float(W.Y()), float(W.Z()));
-    _vBase.Set(float(mx/nSize), float(my/nSize), float(mz/nSize));
+    _vBase = Base::convertTo<Base::Vector3f>(mean);
     float sigma = float(W.Dot(akMat * W));
 #endif
 
@@ -312,7 +401,7 @@ float PlaneFit::GetStdDeviation() const
           fMean  = 0.0f, fDist   = 0.0f;
 
     float ulPtCt = float(CountPoints());
-    std::list< Base::Vector3f >::const_iterator cIt;
+    std::vector< Base::Vector3f >::const_iterator cIt;
 
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt) {
         fDist = GetDistanceToPlane( *cIt );
@@ -339,7 +428,7 @@ float PlaneFit::GetSignedStdDeviation() const
 
     float ulPtCt = float(CountPoints());
     Base::Vector3f clGravity, clPt;
-    std::list<Base::Vector3f>::const_iterator cIt;
+    std::vector<Base::Vector3f>::const_iterator cIt;
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
         clGravity += *cIt;
     clGravity *= (1.0f / ulPtCt);
@@ -374,6 +463,8 @@ void PlaneFit::ProjectToPlane ()
         float fD = (cPnt - cGravity) * cNormal;
         cPnt = cPnt - fD * cNormal;
     }
+
+    UpdateMoments();
 }
 
 void PlaneFit::Dimension(float& length, float& width) const
@@ -383,7 +474,7 @@ void PlaneFit::Dimension(float& length, float& width) const
     const Base::Vector3f& ey = _vDirV;
 
     Base::BoundBox3f bbox;
-    std::list<Base::Vector3f>::const_iterator cIt;
+    std::vector<Base::Vector3f>::const_iterator cIt;
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt) {
         Base::Vector3f pnt = *cIt;
         pnt.TransformToCoordinateSystem(bs, ex, ey);
@@ -647,7 +738,7 @@ double SurfaceFit::PolynomFit()
     transform.reserve(_vPoints.size());
 
     double dW2 = 0;
-    for (std::list<Base::Vector3f>::const_iterator it = _vPoints.begin(); it != _vPoints.end(); ++it) {
+    for (std::vector<Base::Vector3f>::const_iterator it = _vPoints.begin(); it != _vPoints.end(); ++it) {
         Base::Vector3d clPoint = Base::convertTo<Base::Vector3d>(*it);
         clPoint.TransformToCoordinateSystem(bs, ex, ey);
         transform.push_back(clPoint);
@@ -1208,7 +1299,7 @@ float CylinderFit::GetStdDeviation() const
           fMean  = 0.0f, fDist   = 0.0f;
 
     float ulPtCt = float(CountPoints());
-    std::list< Base::Vector3f >::const_iterator cIt;
+    std::vector< Base::Vector3f >::const_iterator cIt;
 
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt) {
         fDist = GetDistanceToCylinder( *cIt );
@@ -1225,7 +1316,7 @@ void CylinderFit::GetBounding(Base::Vector3f& bottom, Base::Vector3f& top) const
     float distMin = FLT_MAX;
     float distMax = FLT_MIN;
 
-    std::list<Base::Vector3f>::const_iterator cIt;
+    std::vector<Base::Vector3f>::const_iterator cIt;
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt) {
         float dist = cIt->DistanceToPlane(_vBase, _vAxis);
         if (dist < distMin) {
@@ -1275,6 +1366,8 @@ void CylinderFit::ProjectToCylinder()
             cPnt = proj + diff * _fRadius;
         }
     }
+
+    UpdateMoments();
 }
 
 // -----------------------------------------------------------------------------
@@ -1363,7 +1456,7 @@ float SphereFit::GetStdDeviation() const
           fMean  = 0.0f, fDist   = 0.0f;
 
     float ulPtCt = float(CountPoints());
-    std::list< Base::Vector3f >::const_iterator cIt;
+    std::vector< Base::Vector3f >::const_iterator cIt;
 
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt) {
         fDist = GetDistanceToSphere( *cIt );
@@ -1396,6 +1489,8 @@ void SphereFit::ProjectToSphere()
             cPnt = _vCenter + diff * _fRadius;
         }
     }
+
+    UpdateMoments();
 }
 
 // -------------------------------------------------------------------------------
@@ -1411,7 +1506,7 @@ float PolynomialFit::Fit()
     x.reserve(_vPoints.size());
     y.reserve(_vPoints.size());
     z.reserve(_vPoints.size());
-    for (std::list<Base::Vector3f>::const_iterator it = _vPoints.begin(); it != _vPoints.end(); ++it) {
+    for (std::vector<Base::Vector3f>::const_iterator it = _vPoints.begin(); it != _vPoints.end(); ++it) {
         x.push_back(it->x);
         y.push_back(it->y);
         z.push_back(it->z);
@@ -95,6 +95,37 @@ protected:
 namespace MeshCore {
 class MeshPointArray;
 
+/**
+ * Accumulates the centroid and the scatter matrix (the sum of the outer products of the
+ * centred points) of a point set. Points can be added and removed in constant time and the
+ * centred update keeps the result accurate for points far away from the origin.
+ */
+class MeshExport PointMoments
+{
+public:
+    void Add(const Base::Vector3f& rcPoint);
+    void Remove(const Base::Vector3f& rcPoint);
+    void Clear();
+    std::size_t Count() const
+    {
+        return _count;
+    }
+    const Base::Vector3d& GetMean() const
+    {
+        return _mean;
+    }
+    /**
+     * Returns the scatter matrix. Divided by the number of points it gives the covariance matrix.
+     */
+    Wm4::Matrix3<double> GetScatter() const;
+
+private:
+    std::size_t _count{0};
+    Base::Vector3d _mean;
+    double _sxx{0.0}, _sxy{0.0}, _sxz{0.0};
+    double _syy{0.0}, _syz{0.0}, _szz{0.0};
+};
+
 /**
  * Abstract base class for approximation of a geometry to a given set of points.
  */
@@ -129,10 +160,23 @@ public:
      * Add points for the fit algorithm.
      */
     void AddPoints(const MeshPointArray &points);
+    /**
+     * Removes a previously added point. Returns false if the point is not part of the fit.
+     */
+    bool RemovePoint(const Base::Vector3f &rcVector);
+    /**
+     * Removes previously added points. Points that are not part of the fit are ignored.
+     */
+    void RemovePoints(const std::vector<Base::Vector3f> &rvPointVect);
     /**
      * Get all added points.
      */
-    const std::list<Base::Vector3f>& GetPoints() const { return _vPoints; }
+    const std::vector<Base::Vector3f>& GetPoints() const { return _vPoints; }
+    /**
+     * Returns the centroid and scatter matrix of the added points which are kept up to date
+     * while adding or removing points.
+     */
+    const PointMoments& GetMoments() const { return _moments; }
     /**
      * Returns the center of gravity of the current added points.
      * @return Base::Vector3f
@@ -167,10 +211,15 @@ protected:
      * Creates a vector of Wm4::Vector3 elements.
      */
     void GetMgcVectorArray( std::vector< Wm4::Vector3<double> >& rcPts ) const;
+    /**
+     * Recomputes the moments after the points have been modified in place.
+     */
+    void UpdateMoments();
 
 protected:
     //NOLINTBEGIN
-    std::list< Base::Vector3f > _vPoints; /**< Holds the points for the fit algorithm.  */
+    std::vector< Base::Vector3f > _vPoints; /**< Holds the points for the fit algorithm.  */
+    PointMoments _moments; /**< Centroid and scatter matrix of the points. */
     bool _bIsFitted{false}; /**< Flag, whether the fit has been called. */
     float _fLastResult{FLOAT_MAX}; /**< Stores the last result of the fit */
     //NOLINTEND
@@ -0,0 +1,557 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <cmath>
+#endif
+
+#include <QtConcurrentMap>
+
+#include <Base/Tools.h>
+
+#include "BVH.h"
+#include "MeshKernel.h"
+
+// SSE2 is part of every x86-64 CPU. On other architectures the four lanes of a packet
+// are processed with plain loops.
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) \
+    && !defined(MESH_BVH_NO_SIMD)
+# define MESH_BVH_SSE2
+# include <emmintrin.h>
+#endif
+
+
+using namespace MeshCore;
+
+namespace {
+
+// Maximum number of facets per leaf
+const std::uint32_t LeafSize = 4;
+// Same tolerance as used by MeshGeomFacet::Foraminate to reject rays parallel to a facet
+const float ParallelEps = 1e-06F;
+
+#if defined(MESH_BVH_SSE2)
+struct Float4
+{
+    __m128 v;
+};
+
+inline Float4 load4(const float* p)
+{
+    return {_mm_loadu_ps(p)};
+}
+inline Float4 set4(float f)
+{
+    return {_mm_set1_ps(f)};
+}
+inline Float4 operator+(Float4 a, Float4 b)
+{
+    return {_mm_add_ps(a.v, b.v)};
+}
+inline Float4 operator-(Float4 a, Float4 b)
+{
+    return {_mm_sub_ps(a.v, b.v)};
+}
+inline Float4 operator*(Float4 a, Float4 b)
+{
+    return {_mm_mul_ps(a.v, b.v)};
+}
+inline Float4 operator/(Float4 a, Float4 b)
+{
+    return {_mm_div_ps(a.v, b.v)};
+}
+inline Float4 min4(Float4 a, Float4 b)
+{
+    return {_mm_min_ps(a.v, b.v)};
+}
+inline Float4 max4(Float4 a, Float4 b)
+{
+    return {_mm_max_ps(a.v, b.v)};
+}
+inline Float4 operator&(Float4 a, Float4 b)
+{
+    return {_mm_and_ps(a.v, b.v)};
+}
+inline Float4 operator<=(Float4 a, Float4 b)
+{
+    return {_mm_cmple_ps(a.v, b.v)};
+}
+inline Float4 operator<(Float4 a, Float4 b)
+{
+    return {_mm_cmplt_ps(a.v, b.v)};
+}
+inline Float4 operator>=(Float4 a, Float4 b)
+{
+    return {_mm_cmpge_ps(a.v, b.v)};
+}
+inline Float4 operator>(Float4 a, Float4 b)
+{
+    return {_mm_cmpgt_ps(a.v, b.v)};
+}
+// Returns a bit mask of the lanes where the comparison \a m is true
+inline int mask4(Float4 m)
+{
+    return _mm_movemask_ps(m.v);
+}
+inline void store4(float* p, Float4 a)
+{
+    _mm_storeu_ps(p, a.v);
+}
+#else
+struct Float4
+{
+    float v[4];
+};
+
+template<typename Op>
+inline Float4 apply4(Float4 a, Float4 b, Op op)
+{
+    Float4 r;
+    for (int i = 0; i < 4; i++) {
+        r.v[i] = op(a.v[i], b.v[i]);
+    }
+    return r;
+}
+
+inline Float4 load4(const float* p)
+{
+    return {{p[0], p[1], p[2], p[3]}};
+}
+inline Float4 set4(float f)
+{
+    return {{f, f, f, f}};
+}
+inline Float4 operator+(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x + y; });
+}
+inline Float4 operator-(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x - y; });
+}
+inline Float4 operator*(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x * y; });
+}
+inline Float4 operator/(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x / y; });
+}
+inline Float4 min4(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x < y ? x : y; });
+}
+inline Float4 max4(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x > y ? x : y; });
+}
+// Comparisons set a lane to 1 if true and to 0 otherwise
+inline Float4 operator&(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return (x != 0.0F && y != 0.0F) ? 1.0F : 0.0F; });
+}
+inline Float4 operator<=(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x <= y ? 1.0F : 0.0F; });
+}
+inline Float4 operator<(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x < y ? 1.0F : 0.0F; });
+}
+inline Float4 operator>=(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x >= y ? 1.0F : 0.0F; });
+}
+inline Float4 operator>(Float4 a, Float4 b)
+{
+    return apply4(a, b, [](float x, float y) { return x > y ? 1.0F : 0.0F; });
+}
+inline int mask4(Float4 m)
+{
+    int bits = 0;
+    for (int i = 0; i < 4; i++) {
+        if (m.v[i] != 0.0F) {
+            bits |= 1 << i;
+        }
+    }
+    return bits;
+}
+inline void store4(float* p, Float4 a)
+{
+    std::copy(a.v, a.v + 4, p);
+}
+#endif
+
+// Reciprocal of a direction component that avoids infinities in the slab test
+inline float safeInverse(float f)
+{
+    const float tiny = 1e-30F;
+    if (std::fabs(f) < tiny) {
+        return f < 0.0F ? -1.0F / tiny : 1.0F / tiny;
+    }
+    return 1.0F / f;
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+struct MeshFacetBVH::Node
+{
+    float min[3];
+    std::uint32_t index;  // first triangle of a leaf or the second child of an inner node
+    float max[3];
+    std::uint16_t count;  // number of triangles of a leaf, 0 for inner nodes
+    std::uint16_t axis;   // split axis of an inner node
+};
+
+struct MeshFacetBVH::Triangle
+{
+    float v0[3];
+    float e1[3];
+    float e2[3];
+    float nn;  // squared length of the unnormalized normal
+    FacetIndex facet;
+};
+
+// Four rays in structure-of-arrays layout
+struct MeshFacetBVH::Packet
+{
+    float ox[4], oy[4], oz[4];
+    float dx[4], dy[4], dz[4];
+    float ix[4], iy[4], iz[4];
+    float dd[4];
+    // parameter of the nearest hit so far, negative for unused lanes
+    float tmax[4];
+    std::uint32_t triangle[4];
+};
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& mesh)
+    : _rclMesh(mesh)
+{
+    Rebuild();
+}
+
+MeshFacetBVH::~MeshFacetBVH() = default;
+
+std::size_t MeshFacetBVH::CountNodes() const
+{
+    return _nodes.size();
+}
+
+void MeshFacetBVH::Rebuild()
+{
+    _nodes.clear();
+    _triangles.clear();
+
+    const MeshPointArray& points = _rclMesh.GetPoints();
+    const MeshFacetArray& facets = _rclMesh.GetFacets();
+    std::uint32_t count = static_cast<std::uint32_t>(facets.size());
+    if (count == 0) {
+        return;
+    }
+
+    std::vector<Base::Vector3f> centers(count);
+    std::vector<Base::BoundBox3f> boxes(count);
+    for (std::uint32_t i = 0; i < count; i++) {
+        const MeshFacet& face = facets[i];
+        const Base::Vector3f& p0 = points[face._aulPoints[0]];
+        const Base::Vector3f& p1 = points[face._aulPoints[1]];
+        const Base::Vector3f& p2 = points[face._aulPoints[2]];
+        boxes[i].Add(p0);
+        boxes[i].Add(p1);
+        boxes[i].Add(p2);
+        centers[i] = boxes[i].GetCenter();
+    }
+
+    std::vector<std::uint32_t> indices(count);
+    std::generate(indices.begin(), indices.end(), Base::iotaGen<std::uint32_t>(0));
+    _nodes.reserve(2 * (count / LeafSize + 1));
+    BuildNode(indices, 0, count, centers, boxes);
+
+    // store the facets in the order of the leaves
+    _triangles.resize(count);
+    for (std::uint32_t i = 0; i < count; i++) {
+        const MeshFacet& face = facets[indices[i]];
+        const Base::Vector3f& p0 = points[face._aulPoints[0]];
+        Base::Vector3f e1 = points[face._aulPoints[1]] - p0;
+        Base::Vector3f e2 = points[face._aulPoints[2]] - p0;
+        Base::Vector3f n = e1 % e2;
+
+        Triangle& tria = _triangles[i];
+        tria.v0[0] = p0.x;
+        tria.v0[1] = p0.y;
+        tria.v0[2] = p0.z;
+        tria.e1[0] = e1.x;
+        tria.e1[1] = e1.y;
+        tria.e1[2] = e1.z;
+        tria.e2[0] = e2.x;
+        tria.e2[1] = e2.y;
+        tria.e2[2] = e2.z;
+        tria.nn = n * n;
+        tria.facet = indices[i];
+    }
+}
+
+std::uint32_t MeshFacetBVH::BuildNode(std::vector<std::uint32_t>& indices,
+                                      std::uint32_t begin,
+                                      std::uint32_t end,
+                                      const std::vector<Base::Vector3f>& centers,
+                                      const std::vector<Base::BoundBox3f>& boxes)
+{
+    Base::BoundBox3f bounds;
+    Base::BoundBox3f centerBounds;
+    for (std::uint32_t i = begin; i < end; i++) {
+        bounds.Add(boxes[indices[i]]);
+        centerBounds.Add(centers[indices[i]]);
+    }
+
+    std::uint32_t index = static_cast<std::uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+    Node& node = _nodes.back();
+    node.min[0] = bounds.MinX;
+    node.min[1] = bounds.MinY;
+    node.min[2] = bounds.MinZ;
+    node.max[0] = bounds.MaxX;
+    node.max[1] = bounds.MaxY;
+    node.max[2] = bounds.MaxZ;
+    node.index = begin;
+    node.count = 0;
+    node.axis = 0;
+
+    if (end - begin <= LeafSize) {
+        node.count = static_cast<std::uint16_t>(end - begin);
+        return index;
+    }
+
+    // split at the median of the facet centers along the longest axis
+    std::uint16_t axis = 0;
+    float lengthX = centerBounds.LengthX();
+    float lengthY = centerBounds.LengthY();
+    float lengthZ = centerBounds.LengthZ();
+    if (lengthY > lengthX && lengthY >= lengthZ) {
+        axis = 1;
+    }
+    else if (lengthZ > lengthX && lengthZ > lengthY) {
+        axis = 2;
+    }
+
+    std::uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(indices.begin() + begin,
+                     indices.begin() + mid,
+                     indices.begin() + end,
+                     [&centers, axis](std::uint32_t a, std::uint32_t b) {
+                         return centers[a][axis] < centers[b][axis];
+                     });
+
+    // the first child directly follows its parent
+    BuildNode(indices, begin, mid, centers, boxes);
+    std::uint32_t second = BuildNode(indices, mid, end, centers, boxes);
+    _nodes[index].index = second;
+    _nodes[index].axis = axis;
+    return index;
+}
+
+void MeshFacetBVH::TracePacket(Packet& packet) const
+{
+    const Float4 zero = set4(0.0F);
+    const Float4 one = set4(1.0F);
+    const Float4 eps = set4(ParallelEps);
+
+    const Float4 ox = load4(packet.ox);
+    const Float4 oy = load4(packet.oy);
+    const Float4 oz = load4(packet.oz);
+    const Float4 dx = load4(packet.dx);
+    const Float4 dy = load4(packet.dy);
+    const Float4 dz = load4(packet.dz);
+    const Float4 ix = load4(packet.ix);
+    const Float4 iy = load4(packet.iy);
+    const Float4 iz = load4(packet.iz);
+    const Float4 dd = load4(packet.dd);
+
+    // the direction of the first active ray decides which child is visited first
+    int lead = 0;
+    while (lead < 3 && packet.tmax[lead] < 0.0F) {
+        lead++;
+    }
+    const float leadDir[3] = {packet.dx[lead], packet.dy[lead], packet.dz[lead]};
+
+    std::uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        std::uint32_t current = stack[--top];
+        const Node& node = _nodes[current];
+        Float4 tmax = load4(packet.tmax);
+
+        // slab test of the four rays against the bounding box
+        Float4 t1 = (set4(node.min[0]) - ox) * ix;
+        Float4 t2 = (set4(node.max[0]) - ox) * ix;
+        Float4 tnear = min4(t1, t2);
+        Float4 tfar = max4(t1, t2);
+        t1 = (set4(node.min[1]) - oy) * iy;
+        t2 = (set4(node.max[1]) - oy) * iy;
+        tnear = max4(tnear, min4(t1, t2));
+        tfar = min4(tfar, max4(t1, t2));
+        t1 = (set4(node.min[2]) - oz) * iz;
+        t2 = (set4(node.max[2]) - oz) * iz;
+        tnear = max4(max4(tnear, min4(t1, t2)), zero);
+        tfar = min4(tfar, max4(t1, t2));
+        if (mask4((tnear <= tfar) & (tnear <= tmax)) == 0) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            std::uint32_t first = current + 1;
+            std::uint32_t second = node.index;
+            if (leadDir[node.axis] < 0.0F) {
+                std::swap(first, second);
+            }
+            stack[top++] = second;
+            stack[top++] = first;
+            continue;
+        }
+
+        // Moeller-Trumbore intersection of the four rays with each facet of the leaf
+        for (std::uint32_t i = node.index; i < node.index + node.count; i++) {
+            const Triangle& tria = _triangles[i];
+            Float4 e1x = set4(tria.e1[0]);
+            Float4 e1y = set4(tria.e1[1]);
+            Float4 e1z = set4(tria.e1[2]);
+            Float4 e2x = set4(tria.e2[0]);
+            Float4 e2y = set4(tria.e2[1]);
+            Float4 e2z = set4(tria.e2[2]);
+
+            Float4 px = dy * e2z - dz * e2y;
+            Float4 py = dz * e2x - dx * e2z;
+            Float4 pz = dx * e2y - dy * e2x;
+            Float4 det = e1x * px + e1y * py + e1z * pz;
+            Float4 valid = (det * det) > (eps * dd * set4(tria.nn));
+            if (mask4(valid) == 0) {
+                continue;
+            }
+
+            Float4 inv = one / det;
+            Float4 tx = ox - set4(tria.v0[0]);
+            Float4 ty = oy - set4(tria.v0[1]);
+            Float4 tz = oz - set4(tria.v0[2]);
+            Float4 u = (tx * px + ty * py + tz * pz) * inv;
+            Float4 qx = ty * e1z - tz * e1y;
+            Float4 qy = tz * e1x - tx * e1z;
+            Float4 qz = tx * e1y - ty * e1x;
+            Float4 v = (dx * qx + dy * qy + dz * qz) * inv;
+            Float4 t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+
+            int hit = mask4(valid & (u >= zero) & (v >= zero) & ((u + v) <= one) & (t >= zero)
+                            & (t < tmax));
+            if (hit != 0) {
+                float param[4];
+                store4(param, t);
+                for (int k = 0; k < 4; k++) {
+                    if (hit & (1 << k)) {
+                        packet.tmax[k] = param[k];
+                        packet.triangle[k] = i;
+                    }
+                }
+                tmax = load4(packet.tmax);
+            }
+        }
+    }
+}
+
+void MeshFacetBVH::NearestFacetsOnRays(const Ray* rays, std::size_t count, Hit* hits) const
+{
+    for (std::size_t i = 0; i < count; i += 4) {
+        std::size_t size = std::min<std::size_t>(4, count - i);
+
+        Packet packet {};
+        for (std::size_t k = 0; k < 4; k++) {
+            // unused lanes repeat the first ray but are never hit
+            const Ray& ray = rays[i + (k < size ? k : 0)];
+            packet.ox[k] = ray.pnt.x;
+            packet.oy[k] = ray.pnt.y;
+            packet.oz[k] = ray.pnt.z;
+            packet.dx[k] = ray.dir.x;
+            packet.dy[k] = ray.dir.y;
+            packet.dz[k] = ray.dir.z;
+            packet.ix[k] = safeInverse(ray.dir.x);
+            packet.iy[k] = safeInverse(ray.dir.y);
+            packet.iz[k] = safeInverse(ray.dir.z);
+            packet.dd[k] = ray.dir * ray.dir;
+            packet.tmax[k] = k < size ? FLT_MAX : -1.0F;
+            packet.triangle[k] = 0;
+        }
+
+        if (!_nodes.empty()) {
+            TracePacket(packet);
+        }
+
+        for (std::size_t k = 0; k < size; k++) {
+            Hit& hit = hits[i + k];
+            if (packet.tmax[k] < FLT_MAX) {
+                const Ray& ray = rays[i + k];
+                hit.point = ray.pnt + packet.tmax[k] * ray.dir;
+                hit.facet = _triangles[packet.triangle[k]].facet;
+            }
+            else {
+                hit = Hit();
+            }
+        }
+    }
+}
+
+std::vector<MeshFacetBVH::Hit> MeshFacetBVH::NearestFacetsOnRays(const std::vector<Ray>& rays) const
+{
+    std::vector<Hit> hits(rays.size());
+    std::vector<std::size_t> packets((rays.size() + 3) / 4);
+    std::generate(packets.begin(), packets.end(), Base::iotaGen<std::size_t>(0));
+
+    QtConcurrent::blockingMap(packets, [this, &rays, &hits](std::size_t index) {
+        std::size_t first = 4 * index;
+        std::size_t count = std::min<std::size_t>(4, rays.size() - first);
+        NearestFacetsOnRays(rays.data() + first, count, hits.data() + first);
+    });
+
+    return hits;
+}
+
+bool MeshFacetBVH::NearestFacetOnRay(const Base::Vector3f& rclPt,
+                                     const Base::Vector3f& rclDir,
+                                     Base::Vector3f& rclRes,
+                                     FacetIndex& rulFacet) const
+{
+    Ray ray {rclPt, rclDir};
+    Hit hit;
+    NearestFacetsOnRays(&ray, 1, &hit);
+    if (hit.isValid()) {
+        rclRes = hit.point;
+        rulFacet = hit.facet;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Elements.h"
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy over the facets of a mesh
+ * that is optimized for ray queries.
+ *
+ * Rays are traced in packets of four. A packet descends into a node if at least one
+ * of its rays hits the node's bounding box and each leaf facet is intersected with
+ * all four rays at once using SIMD instructions where available.
+ * Unlike MeshAlgorithm::NearestFacetOnRay() with a grid, the time of a query hardly
+ * depends on the distribution of the facets. The hierarchy is read-only after
+ * construction and can be shared between threads.
+ * \note The hierarchy keeps a copy of the facet geometry. If the mesh is modified
+ * Rebuild() must be called.
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+    /// A ray starting at \a pnt with the direction \a dir.
+    struct Ray
+    {
+        Base::Vector3f pnt;
+        Base::Vector3f dir;
+    };
+    /// The result of a ray query.
+    struct Hit
+    {
+        Base::Vector3f point;
+        FacetIndex facet = FACET_INDEX_MAX;
+
+        bool isValid() const
+        {
+            return facet != FACET_INDEX_MAX;
+        }
+    };
+
+    explicit MeshFacetBVH(const MeshKernel& mesh);
+    ~MeshFacetBVH();
+
+    /** Builds the hierarchy anew from the mesh passed to the constructor. */
+    void Rebuild();
+    /** Returns the number of nodes of the hierarchy. */
+    std::size_t CountNodes() const;
+
+    /**
+     * Searches for the nearest facet hit by the ray defined by (\a rclPt, \a rclDir).
+     * Only intersections in the direction of the ray are considered. The point \a rclRes
+     * holds the intersection point and \a rulFacet the index of the facet.
+     */
+    bool NearestFacetOnRay(const Base::Vector3f& rclPt,
+                           const Base::Vector3f& rclDir,
+                           Base::Vector3f& rclRes,
+                           FacetIndex& rulFacet) const;
+    /**
+     * Traces \a count rays and writes the nearest hits to \a hits. The rays are processed
+     * in packets of four in the calling thread so coherent rays, e.g. of neighbouring
+     * pixels, should be adjacent.
+     */
+    void NearestFacetsOnRays(const Ray* rays, std::size_t count, Hit* hits) const;
+    /**
+     * Traces all \a rays and returns the nearest hits in the same order. The packets are
+     * distributed over all available threads.
+     */
+    std::vector<Hit> NearestFacetsOnRays(const std::vector<Ray>& rays) const;
+
+private:
+    struct Node;
+    struct Triangle;
+    struct Packet;
+
+    std::uint32_t BuildNode(std::vector<std::uint32_t>& indices,
+                            std::uint32_t begin,
+                            std::uint32_t end,
+                            const std::vector<Base::Vector3f>& centers,
+                            const std::vector<Base::BoundBox3f>& boxes);
+    void TracePacket(Packet& packet) const;
+
+private:
+    const MeshKernel& _rclMesh;
+    std::vector<Node> _nodes;
+    std::vector<Triangle> _triangles;
+
+public:
+    MeshFacetBVH(const MeshFacetBVH&) = delete;
+    void operator=(const MeshFacetBVH&) = delete;
+};
+
+}  // namespace MeshCore
+
+
+#endif  // MESH_BVH_H
@@ -100,7 +100,7 @@ void CylinderFit::SetApproximations(const Base::Vector3d &base, const Base::Vect
 	_dRadius = 0.0;
 	if (!_vPoints.empty())
 	{
-		for (std::list< Base::Vector3f >::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
+		for (std::vector< Base::Vector3f >::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
 			_dRadius += Base::Vector3d(cIt->x, cIt->y, cIt->z).DistanceToLine(_vBase, _vAxis);
 		_dRadius /= (double)_vPoints.size();
 	}
@@ -215,6 +215,8 @@ void CylinderFit::ProjectToCylinder()
             cPnt = proj + diff * _dRadius;
         }
     }
+
+    UpdateMoments();
 }
 
 // Compute approximations for the parameters using all points by computing a
@@ -238,7 +240,7 @@ void CylinderFit::ComputeApproximationsLine()
 		_vBase.Set(kLine.Origin.X(), kLine.Origin.Y(), kLine.Origin.Z());
 		_vAxis.Set(kLine.Direction.X(), kLine.Direction.Y(), kLine.Direction.Z());
 
-		for (std::list< Base::Vector3f >::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
+		for (std::vector< Base::Vector3f >::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
 			_dRadius += Base::Vector3d(cIt->x, cIt->y, cIt->z).DistanceToLine(_vBase, _vAxis);
 		_dRadius /= (double)_vPoints.size();
 	}
@@ -381,7 +383,7 @@ double CylinderFit::meanXObs()
 	double mx = 0.0;
 	if (!_vPoints.empty())
 	{
-		for (std::list<Base::Vector3f>::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
+		for (std::vector<Base::Vector3f>::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
 			mx += cIt->x;
 		mx /= double(_vPoints.size());
 	}
@@ -393,7 +395,7 @@ double CylinderFit::meanYObs()
 	double my = 0.0;
 	if (!_vPoints.empty())
 	{
-		for (std::list<Base::Vector3f>::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
+		for (std::vector<Base::Vector3f>::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
 			my += cIt->y;
 		my /= double(_vPoints.size());
 	}
@@ -405,7 +407,7 @@ double CylinderFit::meanZObs()
 	double mz = 0.0;
 	if (!_vPoints.empty())
 	{
-		for (std::list<Base::Vector3f>::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
+		for (std::vector<Base::Vector3f>::const_iterator cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
 			mz += cIt->z;
 		mz /= double(_vPoints.size());
 	}
@@ -426,7 +428,7 @@ void CylinderFit::setupNormalEquationMatrices(SolutionD solDir, const std::vecto
 	double a[5], b[3];
 	double f0, qw;
     std::vector< Base::Vector3d >::const_iterator vIt = residuals.begin();
-    std::list< Base::Vector3f >::const_iterator cIt;
+    std::vector< Base::Vector3f >::const_iterator cIt;
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt, ++vIt)
 	{
 		// if (using this point) { // currently all given points are used (could modify this if eliminating outliers, etc....
@@ -578,7 +580,7 @@ bool CylinderFit::computeResiduals(SolutionD solDir, const Eigen::VectorXd &x, s
 	//double maxdVz = 0.0;
 	//double rmsVv = 0.0;
     std::vector< Base::Vector3d >::iterator vIt = residuals.begin();
-    std::list< Base::Vector3f >::const_iterator cIt;
+    std::vector< Base::Vector3f >::const_iterator cIt;
     for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt, ++vIt)
 	{
 		// if (using this point) { // currently all given points are used (could modify this if eliminating outliers, etc....
@@ -29,6 +29,7 @@
 # include <stdexcept>
 #endif
 
+#include <Base/BatchTransform.h>
 #include <Base/Exception.h>
 #include <Base/Stream.h>
 #include <Base/Swap.h>
@@ -1032,15 +1033,8 @@ void MeshKernel::operator *= (const Base::Matrix4D &rclMat)
 
 void MeshKernel::Transform (const Base::Matrix4D &rclMat)
 {
-    MeshPointArray::_TIterator  clPIter = _aclPointArray.begin(), clPEIter = _aclPointArray.end();
-    Base::Matrix4D clMatrix(rclMat);
-
-    _clBoundBox.SetVoid();
-    while (clPIter < clPEIter) {
-        *clPIter *= clMatrix;
-        _clBoundBox.Add(*clPIter);
-        clPIter++;
-    }
+    Base::transformPoints(rclMat, _aclPointArray.data(), _aclPointArray.size(),
+                          sizeof(MeshPoint), &_clBoundBox);
 }
 
 void MeshKernel::Smooth(int iterations, float stepsize)
@@ -1051,9 +1045,8 @@ void MeshKernel::Smooth(int iterations, float stepsize)
 
 void MeshKernel::RecalcBoundBox () const
 {
-    _clBoundBox.SetVoid();
-    for (const auto & pI : _aclPointArray)
-        _clBoundBox.Add(pI);
+    _clBoundBox = Base::boundBoxOfPoints(_aclPointArray.data(), _aclPointArray.size(),
+                                         sizeof(MeshPoint));
 }
 
 std::vector<Base::Vector3f> MeshKernel::CalcVertexNormals() const
@@ -138,6 +138,8 @@ void SphereFit::ProjectToSphere()
 			cPnt.z = (float)proj.z;
 		}
 	}
+
+	UpdateMoments();
 }
 
 // Compute approximations for the parameters using all points:
@@ -152,7 +154,7 @@ void SphereFit::ComputeApproximations()
 	_dRadius = 0.0;
 	if (!_vPoints.empty())
 	{
-		std::list< Base::Vector3f >::const_iterator cIt;
+		std::vector< Base::Vector3f >::const_iterator cIt;
 		for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt)
 		{
 			_vCenter.x += cIt->x;
@@ -249,7 +251,7 @@ void SphereFit::setupNormalEquationMatrices(const std::vector< Base::Vector3d >
 	double a[4], b[3];
 	double f0, qw;
 	std::vector< Base::Vector3d >::const_iterator vIt = residuals.begin();
-	std::list< Base::Vector3f >::const_iterator cIt;
+	std::vector< Base::Vector3f >::const_iterator cIt;
 	for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt, ++vIt)
 	{
 		// if (using this point) { // currently all given points are used (could modify this if eliminating outliers, etc....
@@ -350,7 +352,7 @@ bool SphereFit::computeResiduals(const Eigen::VectorXd &x, std::vector< Base::Ve
 	//double maxdVz = 0.0;
 	//double rmsVv = 0.0;
 	std::vector< Base::Vector3d >::iterator vIt = residuals.begin();
-	std::list< Base::Vector3f >::const_iterator cIt;
+	std::vector< Base::Vector3f >::const_iterator cIt;
 	for (cIt = _vPoints.begin(); cIt != _vPoints.end(); ++cIt, ++vIt)
 	{
 		// if (using this point) { // currently all given points are used (could modify this if eliminating outliers, etc....
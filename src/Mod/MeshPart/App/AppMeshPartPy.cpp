@@ -139,6 +139,25 @@ public:
             "    SegPerEdge (optional, float)\n"
             "    SegPerRadius (optional, float)\n"
         );
+        add_keyword_method("meshFromShapes",&Module::meshFromShapes,
+            "Create surface meshes from a list of shapes using the standard mesher.\n"
+            "The shapes are meshed concurrently.\n"
+            "\n"
+            "    meshFromShapes(Shapes, LinearDeflection,\n"
+            "                           AngularDeflection=0.5,\n"
+            "                           Relative=False,\n"
+            "                           Segments=False) -> list\n"
+            "\n"
+            "Args:\n"
+            "    Shapes (required, list of topology) - TopoShapes to create meshes of.\n"
+            "    LinearDeflection (required, float)\n"
+            "    AngularDeflection (optional, float)\n"
+            "    Relative (optional, boolean)\n"
+            "    Segments (optional, boolean)\n"
+            "\n"
+            "Returns a list of (Mesh, Time, Error) tuples in the order of the input shapes.\n"
+            "For a shape that failed Mesh is None and Error contains the reason.\n"
+        );
         initialize("This module is the MeshPart module."); // register with Python
     }
 
@@ -632,6 +651,64 @@ private:
 
         throw Py::TypeError("Wrong arguments");
     }
+    Py::Object meshFromShapes(const Py::Tuple& args, const Py::Dict& kwds)
+    {
+        static const std::array<const char *, 6> kwds_lindeflection{"Shapes", "LinearDeflection", "AngularDeflection",
+                                                                    "Relative", "Segments", nullptr};
+        PyObject* shapes;
+        double lindeflection=0;
+        double angdeflection=0.5;
+        PyObject* relative = Py_False;
+        PyObject* segment = Py_False;
+        if (!Base::Wrapped_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "Od|dO!O!", kwds_lindeflection,
+                                                 &shapes, &lindeflection, &angdeflection,
+                                                 &(PyBool_Type), &relative, &(PyBool_Type), &segment)) {
+            throw Py::Exception();
+        }
+
+        std::vector<TopoDS_Shape> input;
+        Py::Sequence list(shapes);
+        input.reserve(list.size());
+        for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+            PyObject* item = (*it).ptr();
+            if (!PyObject_TypeCheck(item, &(Part::TopoShapePy::Type))) {
+                throw Py::TypeError("Expected a list of shapes");
+            }
+            input.push_back(static_cast<Part::TopoShapePy*>(item)->getTopoShapePtr()->getShape());
+        }
+
+        TopoDS_Shape aNull;
+        MeshPart::Mesher settings(aNull);
+        settings.setMethod(MeshPart::Mesher::Standard);
+        settings.setDeflection(lindeflection);
+        settings.setAngularDeflection(angdeflection);
+        settings.setRegular(true);
+        settings.setRelative(Base::asBoolean(relative));
+        settings.setSegments(Base::asBoolean(segment));
+
+        std::vector<MeshPart::BatchMesher::Result> results;
+        {
+            Base::PyGILStateRelease release;
+            MeshPart::BatchMesher batch(settings);
+            results = batch.createMeshes(input);
+        }
+
+        Py::List output;
+        for (auto& it : results) {
+            Py::Tuple item(3);
+            if (it.isValid()) {
+                item.setItem(0, Py::asObject(new Mesh::MeshPy(it.mesh.release())));
+            }
+            else {
+                item.setItem(0, Py::None());
+            }
+            item.setItem(1, Py::Float(it.time));
+            item.setItem(2, Py::String(it.error));
+            output.append(item);
+        }
+
+        return output;
+    }
 };
 
 PyObject* initModule()
@@ -22,6 +22,8 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
+#include <cmath>
 #ifdef FC_OS_LINUX
 #include <unistd.h>
 #endif
@@ -44,12 +46,16 @@
 #include <gp_Pln.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 #include <Base/Console.h>
 #include <Base/FileInfo.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Tools.h>
 
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
@@ -66,11 +72,116 @@ using MeshCore::MeshFacetIterator;
 using MeshCore::MeshKernel;
 using MeshCore::MeshPointIterator;
 
+namespace
+{
+// Projects the point along the normal of a facet and keeps it if it's the nearest so far
+bool projectOnFacet(const MeshKernel& MeshK,
+                    MeshCore::FacetIndex Index,
+                    const Base::Vector3f& Pnt,
+                    float& MinLength,
+                    Base::Vector3f& Rslt,
+                    MeshCore::FacetIndex& FaceIndex)
+{
+    Base::Vector3f TempResultPoint;
+    MeshGeomFacet facet = MeshK.GetFacet(Index);
+    // try to project (with angle) to the face
+    if (facet.Foraminate(Pnt, facet.GetNormal(), TempResultPoint)) {
+        // distance to the projected point
+        float Dist = (Pnt - TempResultPoint).Length();
+        if (Dist < MinLength) {
+            // remember the point with the closest distance
+            MinLength = Dist;
+            Rslt = TempResultPoint;
+            FaceIndex = Index;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Projects the point onto all facets of the mesh
+bool projectOnAllFacets(const MeshKernel& MeshK,
+                        const Base::Vector3f& Pnt,
+                        Base::Vector3f& Rslt,
+                        MeshCore::FacetIndex& FaceIndex)
+{
+    float MinLength = FLOAT_MAX;
+    bool bHit = false;
+    MeshCore::FacetIndex count = MeshK.CountFacets();
+    for (MeshCore::FacetIndex index = 0; index < count; index++) {
+        if (projectOnFacet(MeshK, index, Pnt, MinLength, Rslt, FaceIndex)) {
+            bHit = true;
+        }
+    }
+    return bHit;
+}
+
+// Calls func for the samples [0, count) in parallel. The sequencer must only be used by
+// the calling thread, so the samples are processed in blocks and the progress is updated
+// and the user may cancel between two blocks.
+template<typename Func>
+void mapSamples(const char* text, unsigned long count, Func func)
+{
+    const unsigned long blockSize = 100;
+    Base::SequencerLauncher seq(text, (count + blockSize - 1) / blockSize);
+    std::vector<unsigned long> samples;
+    for (unsigned long begin = 0; begin < count; begin += blockSize) {
+        samples.resize(std::min(blockSize, count - begin));
+        std::generate(samples.begin(), samples.end(), Base::iotaGen<unsigned long>(begin));
+        QtConcurrent::blockingMap(samples, func);
+        seq.next(true);  // allow to cancel
+    }
+}
+}  // namespace
+
 CurveProjector::CurveProjector(const TopoDS_Shape& aShape, const MeshKernel& pMesh)
     : _Shape(aShape)
     , _Mesh(pMesh)
+    , _Grid(new MeshFacetGrid(pMesh))
 {}
 
+CurveProjector::~CurveProjector() = default;
+
+bool CurveProjector::findNearestProjection(const Base::Vector3f& Pnt,
+                                           Base::Vector3f& Rslt,
+                                           MeshCore::FacetIndex& FaceIndex) const
+{
+    // a growing box would never contain the mesh
+    if (_Mesh.CountFacets() == 0 || !std::isfinite(Pnt.x) || !std::isfinite(Pnt.y)
+        || !std::isfinite(Pnt.z)) {
+        return false;
+    }
+
+    float fLenX, fLenY, fLenZ;
+    _Grid->GetGridLengths(fLenX, fLenY, fLenZ);
+    float fRadius = std::max({fLenX, fLenY, fLenZ, FLOAT_EPS});
+    std::vector<MeshCore::ElementIndex> facets;
+
+    // Search in a growing box around the point. A projected point closer than the half
+    // box size lies inside the box so its facet is registered in the grid elements of
+    // the box. Thus the search can stop as soon as such a facet is found.
+    for (;;) {
+        Base::BoundBox3f box(Pnt, fRadius);
+        if (box.IsInBox(_Mesh.GetBoundBox())) {
+            return projectOnAllFacets(_Mesh, Pnt, Rslt, FaceIndex);
+        }
+
+        float MinLength = FLOAT_MAX;
+        bool bHit = false;
+        _Grid->Inside(box, facets);
+        for (MeshCore::ElementIndex index : facets) {
+            if (projectOnFacet(_Mesh, index, Pnt, MinLength, Rslt, FaceIndex)) {
+                bHit = true;
+            }
+        }
+        if (bHit && MinLength <= fRadius) {
+            return true;
+        }
+
+        fRadius *= 2.0F;
+    }
+}
+
 void CurveProjector::writeIntersectionPointsToFile(const char* name)
 {
     // export points
@@ -100,12 +211,24 @@ CurveProjectorShape::CurveProjectorShape(const TopoDS_Shape& aShape, const MeshK
 
 void CurveProjectorShape::Do()
 {
+    std::vector<TopoDS_Edge> edges;
     TopExp_Explorer Ex;
     for (Ex.Init(_Shape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
-        const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
+        edges.push_back(TopoDS::Edge(Ex.Current()));
+    }
 
-        // std::vector<FaceSplitEdge> vSplitEdges;
-        projectCurve(aEdge, mvEdgeSplitPoints[aEdge]);
+    // the edges are independent of each other
+    std::vector<std::vector<FaceSplitEdge>> splitEdges(edges.size());
+    std::vector<std::size_t> indices(edges.size());
+    std::generate(indices.begin(), indices.end(), Base::iotaGen<std::size_t>(0));
+    QtConcurrent::blockingMap(indices, [&](std::size_t index) {
+        projectCurve(edges[index], splitEdges[index]);
+    });
+
+    // an edge may be visited more than once
+    for (std::size_t index = 0; index < edges.size(); index++) {
+        std::vector<FaceSplitEdge>& vSplitEdges = mvEdgeSplitPoints[edges[index]];
+        vSplitEdges.insert(vSplitEdges.end(), splitEdges[index].begin(), splitEdges[index].end());
     }
 }
 
@@ -235,27 +358,12 @@ bool CurveProjectorShape::findStartPoint(const MeshKernel& MeshK,
                                          Base::Vector3f& Rslt,
                                          MeshCore::FacetIndex& FaceIndex)
 {
-    Base::Vector3f TempResultPoint;
-    float MinLength = FLOAT_MAX;
-    bool bHit = false;
+    if (&MeshK == &_Mesh) {
+        return findNearestProjection(Pnt, Rslt, FaceIndex);
+    }
 
     // go through the whole Mesh
-    MeshFacetIterator It(MeshK);
-    for (It.Init(); It.More(); It.Next()) {
-        // try to project (with angle) to the face
-        if (It->Foraminate(Pnt, It->GetNormal(), TempResultPoint)) {
-            // distance to the projected point
-            float Dist = (Pnt - TempResultPoint).Length();
-            if (Dist < MinLength) {
-                // remember the point with the closest distance
-                bHit = true;
-                MinLength = Dist;
-                Rslt = TempResultPoint;
-                FaceIndex = It.Position();
-            }
-        }
-    }
-    return bHit;
+    return projectOnAllFacets(MeshK, Pnt, Rslt, FaceIndex);
 }
 
 
@@ -311,7 +419,6 @@ void CurveProjectorSimple::projectCurve(const TopoDS_Edge& aEdge,
                                         const std::vector<Base::Vector3f>& /*rclPoints*/,
                                         std::vector<FaceSplitEdge>& /*vSplitEdges*/)
 {
-    Base::Vector3f /*cResultPoint, cSplitPoint, cPlanePnt, cPlaneNormal,*/ TempResultPoint;
     bool bFirst = true;
     // unsigned long auNeighboursIdx[3];
     // std::map<unsigned long,std::vector<Base::Vector3f> >::iterator N1,N2,N3;
@@ -322,9 +429,6 @@ void CurveProjectorSimple::projectCurve(const TopoDS_Edge& aEdge,
 
     unsigned long ulNbOfPoints = 1000, PointCount = 0;
 
-    MeshFacetIterator It(_Mesh);
-
-    Base::SequencerLauncher seq("Building up projection map...", ulNbOfPoints + 1);
     Base::FileInfo fi("projected.asc");
     Base::ofstream str(fi, std::ios::out | std::ios::binary);
     str.precision(4);
@@ -332,29 +436,40 @@ void CurveProjectorSimple::projectCurve(const TopoDS_Edge& aEdge,
 
     std::map<MeshCore::FacetIndex, std::vector<Base::Vector3f>> FaceProjctMap;
 
-    for (unsigned long i = 0; i <= ulNbOfPoints; i++) {
-        seq.next();
+    // project the samples in parallel
+    using FacetHit = std::pair<MeshCore::FacetIndex, Base::Vector3f>;
+    std::vector<std::vector<FacetHit>> sampleHits(ulNbOfPoints + 1);
+    mapSamples("Building up projection map...", ulNbOfPoints + 1, [&](unsigned long i) {
         gp_Pnt gpPt = hCurve->Value(fBegin + (fLen * float(i)) / float(ulNbOfPoints - 1));
+        Base::Vector3f LinePoint((float)gpPt.X(), (float)gpPt.Y(), (float)gpPt.Z());
+        Base::Vector3f TempResultPoint;
 
         // go through the whole Mesh
-        for (It.Init(); It.More(); It.Next()) {
+        MeshCore::FacetIndex count = _Mesh.CountFacets();
+        for (MeshCore::FacetIndex index = 0; index < count; index++) {
+            MeshGeomFacet facet = _Mesh.GetFacet(index);
             // try to project (with angle) to the face
-            if (It->IntersectWithLine(
-                    Base::Vector3f((float)gpPt.X(), (float)gpPt.Y(), (float)gpPt.Z()),
-                    It->GetNormal(),
-                    TempResultPoint)) {
-                FaceProjctMap[It.Position()].push_back(TempResultPoint);
-                str << TempResultPoint.x << " " << TempResultPoint.y << " " << TempResultPoint.z
-                    << std::endl;
-                Base::Console().Log("IDX %d\n", It.Position());
-
-                if (bFirst) {
-                    bFirst = false;
-                }
-
-                PointCount++;
+            if (facet.IntersectWithLine(LinePoint, facet.GetNormal(), TempResultPoint)) {
+                sampleHits[i].emplace_back(index, TempResultPoint);
             }
         }
+    });
+
+    // collect the results in the order of the samples
+    for (const auto& hits : sampleHits) {
+        for (const auto& hit : hits) {
+            const Base::Vector3f& TempResultPoint = hit.second;
+            FaceProjctMap[hit.first].push_back(TempResultPoint);
+            str << TempResultPoint.x << " " << TempResultPoint.y << " " << TempResultPoint.z
+                << std::endl;
+            Base::Console().Log("IDX %d\n", hit.first);
+
+            if (bFirst) {
+                bFirst = false;
+            }
+
+            PointCount++;
+        }
     }
 
     str.close();
@@ -550,27 +665,12 @@ bool CurveProjectorSimple::findStartPoint(const MeshKernel& MeshK,
                                           Base::Vector3f& Rslt,
                                           MeshCore::FacetIndex& FaceIndex)
 {
-    Base::Vector3f TempResultPoint;
-    float MinLength = FLOAT_MAX;
-    bool bHit = false;
+    if (&MeshK == &_Mesh) {
+        return findNearestProjection(Pnt, Rslt, FaceIndex);
+    }
 
     // go through the whole Mesh
-    MeshFacetIterator It(MeshK);
-    for (It.Init(); It.More(); It.Next()) {
-        // try to project (with angle) to the face
-        if (It->Foraminate(Pnt, It->GetNormal(), TempResultPoint)) {
-            // distance to the projected point
-            float Dist = (Pnt - TempResultPoint).Length();
-            if (Dist < MinLength) {
-                // remember the point with the closest distance
-                bHit = true;
-                MinLength = Dist;
-                Rslt = TempResultPoint;
-                FaceIndex = It.Position();
-            }
-        }
-    }
-    return bHit;
+    return projectOnAllFacets(MeshK, Pnt, Rslt, FaceIndex);
 }
 
 //**************************************************************************
@@ -610,42 +710,38 @@ void CurveProjectorWithToolMesh::makeToolMesh(const TopoDS_Edge& aEdge,
     Standard_Real fBegin, fEnd;
     Handle(Geom_Curve) hCurve = BRep_Tool::Curve(aEdge, fBegin, fEnd);
     float fLen = float(fEnd - fBegin);
-    Base::Vector3f cResultPoint;
 
     unsigned long ulNbOfPoints = 15, PointCount = 0 /*,uCurFacetIdx*/;
+    const float fMaxDist = 0.5F;
 
-    std::vector<LineSeg> LineSegs;
-
-    MeshFacetIterator It(_Mesh);
-
-    Base::SequencerLauncher seq("Building up tool mesh...", ulNbOfPoints + 1);
+    std::vector<LineSeg> LineSegs(ulNbOfPoints);
 
     std::map<MeshCore::FacetIndex, std::vector<Base::Vector3f>> FaceProjctMap;
 
-    for (unsigned long i = 0; i < ulNbOfPoints; i++) {
-        seq.next();
+    // project the samples in parallel
+    mapSamples("Building up tool mesh...", ulNbOfPoints, [&](unsigned long i) {
         gp_Pnt gpPt = hCurve->Value(fBegin + (fLen * float(i)) / float(ulNbOfPoints - 1));
         Base::Vector3f LinePoint((float)gpPt.X(), (float)gpPt.Y(), (float)gpPt.Z());
 
         Base::Vector3f ResultNormal;
+        Base::Vector3f cResultPoint;
 
-        // go through the whole Mesh
-        for (It.Init(); It.More(); It.Next()) {
+        // only facets near the point can contribute, the facets are in ascending order
+        std::vector<MeshCore::ElementIndex> facets;
+        _Grid->Inside(Base::BoundBox3f(LinePoint, fMaxDist + FLOAT_EPS), facets);
+        for (MeshCore::ElementIndex index : facets) {
+            MeshGeomFacet facet = _Mesh.GetFacet(index);
             // try to project (with angle) to the face
-            if (It->IntersectWithLine(
-                    Base::Vector3f((float)gpPt.X(), (float)gpPt.Y(), (float)gpPt.Z()),
-                    It->GetNormal(),
-                    cResultPoint)) {
-                if (Base::Distance(LinePoint, cResultPoint) < 0.5) {
-                    ResultNormal += It->GetNormal();
+            if (facet.IntersectWithLine(LinePoint, facet.GetNormal(), cResultPoint)) {
+                if (Base::Distance(LinePoint, cResultPoint) < fMaxDist) {
+                    ResultNormal += facet.GetNormal();
                 }
             }
         }
-        LineSeg s;
-        s.p = Base::Vector3f((float)gpPt.X(), (float)gpPt.Y(), (float)gpPt.Z());
+        LineSeg& s = LineSegs[i];
+        s.p = LinePoint;
         s.n = ResultNormal.Normalize();
-        LineSegs.push_back(s);
-    }
+    });
 
     Base::Console().Log("Projection map [%d facets with %d points]\n",
                         FaceProjctMap.size(),
@@ -854,10 +950,14 @@ void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
                                    float tolerance,
                                    std::vector<Base::Vector3f>& pointsOut) const
 {
-    // calculate the average edge length and create a grid
-    MeshAlgorithm clAlg(_rcMesh);
-    float fAvgLen = clAlg.GetAverageEdgeLength();
-    MeshFacetGrid cGrid(_rcMesh, 5.0f * fAvgLen);
+    // all rays share the direction, so they are traced at once with a BVH
+    MeshCore::MeshFacetBVH bvh(_rcMesh);
+    std::vector<MeshCore::MeshFacetBVH::Ray> rays;
+    rays.reserve(pointsIn.size());
+    for (const auto& it : pointsIn) {
+        rays.push_back({it, dir});
+    }
+    std::vector<MeshCore::MeshFacetBVH::Hit> hits = bvh.NearestFacetsOnRays(rays);
 
     // get all boundary points and edges of the mesh
     std::vector<Base::Vector3f> boundaryPoints;
@@ -881,11 +981,11 @@ void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
 
     Base::SequencerLauncher seq("Project points on mesh", pointsIn.size());
 
-    for (auto it : pointsIn) {
-        Base::Vector3f result;
-        MeshCore::FacetIndex index;
-        if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-            MeshCore::MeshGeomFacet geomFacet = _rcMesh.GetFacet(index);
+    for (std::size_t i = 0; i < pointsIn.size(); i++) {
+        const Base::Vector3f& it = pointsIn[i];
+        Base::Vector3f result = hits[i].point;
+        if (hits[i].isValid()) {
+            MeshCore::MeshGeomFacet geomFacet = _rcMesh.GetFacet(hits[i].facet);
             if (tolerance > 0 && geomFacet.IntersectPlaneWithLine(it, dir, result)) {
                 if (geomFacet.IsPointOfFace(result, tolerance)) {
                     pointsOut.push_back(result);
@@ -27,6 +27,8 @@
 #include <gts.h>
 #endif
 
+#include <memory>
+
 #include <TopoDS_Edge.hxx>
 
 #include <Mod/Mesh/App/Mesh.h>
@@ -47,12 +49,15 @@ namespace MeshPart
 {
 
 /** The father of all projection algorithms
+ * The edges or the samples of an edge are projected in parallel. The results are
+ * collected in the order of the edges and samples so that they don't depend on
+ * the number of threads.
  */
 class MeshPartExport CurveProjector
 {
 public:
     CurveProjector(const TopoDS_Shape& aShape, const MeshKernel& pMesh);
-    virtual ~CurveProjector() = default;
+    virtual ~CurveProjector();
 
     struct FaceSplitEdge
     {
@@ -81,8 +86,17 @@ public:
 
 protected:
     virtual void Do() = 0;
+    /** Projects \a Pnt along the facet normals onto the mesh and returns the nearest
+     * result. It gives the same result as testing all facets but only checks the facets
+     * of the grid near the point.
+     */
+    bool findNearestProjection(const Base::Vector3f& Pnt,
+                               Base::Vector3f& Rslt,
+                               MeshCore::FacetIndex& FaceIndex) const;
     const TopoDS_Shape& _Shape;
     const MeshKernel& _Mesh;
+    /// read-only search grid of the mesh that is shared by all threads
+    std::unique_ptr<MeshCore::MeshFacetGrid> _Grid;
     result_type mvEdgeSplitPoints;
 };
 
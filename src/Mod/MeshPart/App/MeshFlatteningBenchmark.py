@@ -0,0 +1,108 @@
+# ***************************************************************************
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of the FreeCAD CAx development system.              *
+# *                                                                         *
+# *   This library is free software; you can redistribute it and/or         *
+# *   modify it under the terms of the GNU Lesser General Public            *
+# *   License as published by the Free Software Foundation; either          *
+# *   version 2.1 of the License, or (at your option) any later version.    *
+# *                                                                         *
+# *   This library is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with this library; if not, write to the Free Software   *
+# *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+# *   02110-1301  USA                                                       *
+# *                                                                         *
+# ***************************************************************************
+
+"""Convergence benchmark of the mesh flattening.
+
+Unwraps a doubly curved pattern (by default 501 x 501 nodes, i.e. 500k triangles)
+twice, once with cold and once with warm started solvers. Each run does the lscm
+solve followed by the relaxation steps, as FaceUnwrapper.findFlatNodes does, and
+prints the timings of every step together with the remaining area distortion.
+Both runs must end with the same flat mesh, otherwise the script exits with an
+error. The lscm solve starts from zero flat vertices in both runs, so only the
+relaxation steps can gain from the warm start.
+
+Usage: python MeshFlatteningBenchmark.py [nodes per side] [relax steps]
+The script is copied next to the flatmesh module of the build (Mod/MeshPart).
+"""
+
+import sys
+import time
+
+import numpy as np
+import flatmesh
+
+
+def make_pattern(n):
+    """a n x n grid draped over a mould"""
+    u, v = np.meshgrid(np.linspace(0, 1, n), np.linspace(0, 1, n))
+    z = 150 * np.sin(np.pi * u) * np.sin(np.pi * v) + 50 * u * v
+    nodes = np.array([1000 * u.ravel(), 1000 * v.ravel(), z.ravel()]).T
+
+    index = np.arange(n * n).reshape(n, n)
+    a = index[:-1, :-1].ravel()
+    b = index[:-1, 1:].ravel()
+    c = index[1:, 1:].ravel()
+    d = index[1:, :-1].ravel()
+    tris = np.concatenate([np.array([a, b, c]).T, np.array([a, c, d]).T])
+    return nodes, tris
+
+
+def run(nodes, tris, steps, warm_start):
+    """flattens the pattern and returns the total time and the flat vertices"""
+    name = "warm" if warm_start else "cold"
+    flattener = flatmesh.LscmRelax(nodes, tris, [])
+    flattener.warm_start = warm_start
+
+    start = time.perf_counter()
+    flattener.lscm()
+    total = time.perf_counter() - start
+    print(
+        "{} lscm: {:.3f}s, {} iterations, error {:.3g}".format(
+            name, total, flattener.lscm_iterations, flattener.lscm_error
+        )
+    )
+
+    for i in range(steps):
+        start = time.perf_counter()
+        flattener.relax(0.95)
+        elapsed = time.perf_counter() - start
+        total += elapsed
+        distortion = abs(flattener.flat_area - flattener.area) / flattener.area
+        print("{} relax {}: {:.3f}s, area distortion {:.3g}".format(name, i, elapsed, distortion))
+
+    print("{} total: {:.3f}s".format(name, total))
+    return total, np.array(flattener.flat_vertices)
+
+
+# max. deviation of the flat vertices between both runs, relative to the pattern size
+TOLERANCE = 1e-9
+
+
+def main():
+    n = int(sys.argv[1]) if len(sys.argv) > 1 else 501
+    steps = int(sys.argv[2]) if len(sys.argv) > 2 else 10
+
+    nodes, tris = make_pattern(n)
+    print("{} nodes, {} triangles".format(len(nodes), len(tris)))
+
+    cold, cold_vertices = run(nodes, tris, steps, False)
+    warm, warm_vertices = run(nodes, tris, steps, True)
+    deviation = np.abs(cold_vertices - warm_vertices).max()
+    print(
+        "speed-up {:.2f}, max. deviation of the flat vertices {:.3g}".format(cold / warm, deviation)
+    )
+    if not np.isfinite(deviation) or deviation > TOLERANCE * np.abs(cold_vertices).max():
+        sys.exit("warm and cold start give different flat meshes")
+
+
+if __name__ == "__main__":
+    main()
@@ -206,6 +206,9 @@ BOOST_PYTHON_MODULE(flatmesh)
         .def("transform", &lscmrelax::LscmRelax::transform)
         .def_readonly("rhs", &lscmrelax::LscmRelax::rhs)
         .def_readonly("MATRIX", &lscmrelax::LscmRelax::MATRIX)
+        .def_readonly("lscm_iterations", &lscmrelax::LscmRelax::lscm_iterations)
+        .def_readonly("lscm_error", &lscmrelax::LscmRelax::lscm_error)
+        .def_readwrite("warm_start", &lscmrelax::LscmRelax::warm_start)
         .def_readonly("area", &lscmrelax::LscmRelax::get_area)
         .def_readonly("flat_area", &lscmrelax::LscmRelax::get_flat_area)
 //        .def_readonly("flat_vertices", [](lscmrelax::LscmRelax& L){return L.flat_vertices.transpose();}, py::return_value_policy<py::copy_const_reference>())
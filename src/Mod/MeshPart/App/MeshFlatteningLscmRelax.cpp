@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <iostream>
@@ -36,6 +37,8 @@
 
 #include <Eigen/SparseCholesky>
 
+#include <Base/Parallel.h>
+
 #include "MeshFlatteningLscmRelax.h"
 
 
@@ -51,7 +54,6 @@ using trip = Eigen::Triplet<double>;
 using spMat = Eigen::SparseMatrix<double>;
 
 
-
 ColMat<double, 2> map_to_2D(ColMat<double, 3> points)
 {
     ColMat<double, 4> mat(points.size(), 4);
@@ -100,7 +102,8 @@ LscmRelax::LscmRelax(
 {
     this->vertices = vertices;
     this->triangles = triangles;
-    this->flat_vertices.resize(2, this->vertices.cols());
+    // zero is the initial guess of the first lscm solve
+    this->flat_vertices.setZero(2, this->vertices.cols());
     this->fixed_pins = fixed_pins;
 
     // set the fixed pins of the flat-mesh:
@@ -148,24 +151,27 @@ LscmRelax::LscmRelax(
 void LscmRelax::relax(double weight)
 {
     ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
-    // for every triangle
-    Eigen::Matrix<double, 3, 6> B;
-    Eigen::Matrix<double, 2, 2> T;
-    Eigen::Matrix<double, 6, 6> K_m;
-    Eigen::Matrix<double, 6, 1> u_m, rhs_m;
-    Eigen::VectorXd rhs(this->vertices.cols() * 2 + 3);
+    const long n = this->flat_vertices.cols();
+    Eigen::VectorXd rhs(n * 2 + 3);
     if (this->sol.size() == 0)
-        this->sol.Zero(this->vertices.cols() * 2 + 3);
-    spMat K_g(this->vertices.cols() * 2 + 3, this->vertices.cols() * 2 + 3);
-    std::vector<trip> K_g_triplets;
-    Vector2 v1, v2, v3, v12, v23, v31;
-    long row_pos, col_pos;
-    double A;
+        this->sol.setZero(n * 2 + 3);
+    spMat K_g(n * 2 + 3, n * 2 + 3);
+    // every triangle writes its 36 triplets and its rhs to its own slots so the elements
+    // can be computed in parallel. The slots keep the serial order of the assembly.
+    std::vector<trip> K_g_triplets(this->triangles.cols() * 36 + n * 8);
+    Eigen::Matrix<double, 6, Eigen::Dynamic> rhs_elements(6, this->triangles.cols());
 
     rhs.setZero();
 
-    for (long i=0; i<this->triangles.cols(); i++)
+    Base::parallelFor(this->triangles.cols(), [&](long i)
     {
+        Eigen::Matrix<double, 3, 6> B;
+        Eigen::Matrix<double, 2, 2> T;
+        Eigen::Matrix<double, 6, 6> K_m;
+        Eigen::Matrix<double, 6, 1> u_m;
+        Vector2 v1, v2, v3, v12, v23, v31;
+        double A;
+
         // 1: construct B-mat in m-system
         v1 = this->flat_vertices.col(this->triangles(0, i));
         v2 = this->flat_vertices.col(this->triangles(1, i));
@@ -187,25 +193,35 @@ void LscmRelax::relax(double weight)
 
         // 3: rhs_m = B.T * C * B * dqlg_m
         //    K_m = B.T * C * B
-        rhs_m = B.transpose() * this->C * B * u_m * A;
+        rhs_elements.col(i) = B.transpose() * this->C * B * u_m * A;
         K_m = B.transpose() * this->C * B * A;
 
-        // 5: add to rhs_g, K_g
+        // 5: add to K_g
+        trip* element_triplets = &K_g_triplets[i * 36];
         for (int j=0; j < 3; j++)
         {
-            row_pos = this->triangles(j, i);
-            rhs[row_pos * 2]     += rhs_m[j * 2];
-            rhs[row_pos * 2 + 1] += rhs_m[j * 2 +1];
+            long row_pos = this->triangles(j, i);
             for (int k=0; k < 3; k++)
             {
-                col_pos = this->triangles(k, i);
-                K_g_triplets.emplace_back(trip(row_pos * 2,     col_pos * 2,        K_m(j * 2,      k * 2)));
-                K_g_triplets.emplace_back(trip(row_pos * 2 + 1, col_pos * 2,        K_m(j * 2 + 1,  k * 2)));
-                K_g_triplets.emplace_back(trip(row_pos * 2 + 1, col_pos * 2 + 1,    K_m(j * 2 + 1,  k * 2 + 1)));
-                K_g_triplets.emplace_back(trip(row_pos * 2,     col_pos * 2 + 1,    K_m(j * 2,      k * 2 + 1)));
+                long col_pos = this->triangles(k, i);
+                *element_triplets++ = trip(row_pos * 2,     col_pos * 2,        K_m(j * 2,      k * 2));
+                *element_triplets++ = trip(row_pos * 2 + 1, col_pos * 2,        K_m(j * 2 + 1,  k * 2));
+                *element_triplets++ = trip(row_pos * 2 + 1, col_pos * 2 + 1,    K_m(j * 2 + 1,  k * 2 + 1));
+                *element_triplets++ = trip(row_pos * 2,     col_pos * 2 + 1,    K_m(j * 2,      k * 2 + 1));
                 // we don't have to fill all because the matrix is symmetric.
             }
         }
+    });
+
+    // 5: add to rhs_g (serially to keep the summation order)
+    for (long i=0; i<this->triangles.cols(); i++)
+    {
+        for (int j=0; j < 3; j++)
+        {
+            long row_pos = this->triangles(j, i);
+            rhs[row_pos * 2]     += rhs_elements(j * 2, i);
+            rhs[row_pos * 2 + 1] += rhs_elements(j * 2 + 1, i);
+        }
     }
     // FIXING SOME PINS:
     // - if there are no pins (or only one pin) selected solve the system without the nullspace solution.
@@ -251,19 +267,20 @@ void LscmRelax::relax(double weight)
     //     K_g_triplets.push_back(trip(i, i, 0.01));
 
     // lagrange multiplier
-    for (long i=0; i < this->flat_vertices.cols() ; i++)
+    trip* lagrange_triplets = &K_g_triplets[this->triangles.cols() * 36];
+    for (long i=0; i < n ; i++)
     {
         // fixing total ux
-        K_g_triplets.emplace_back(trip(i * 2, this->flat_vertices.cols() * 2, 1));
-        K_g_triplets.emplace_back(trip(this->flat_vertices.cols() * 2, i * 2, 1));
+        *lagrange_triplets++ = trip(i * 2, n * 2, 1);
+        *lagrange_triplets++ = trip(n * 2, i * 2, 1);
         // fixing total uy
-        K_g_triplets.emplace_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 1, 1));
-        K_g_triplets.emplace_back(trip(this->flat_vertices.cols() * 2 + 1, i * 2 + 1, 1));
+        *lagrange_triplets++ = trip(i * 2 + 1, n * 2 + 1, 1);
+        *lagrange_triplets++ = trip(n * 2 + 1, i * 2 + 1, 1);
         // fixing ux*y-uy*x
-        K_g_triplets.emplace_back(trip(i * 2, this->flat_vertices.cols() * 2 + 2, - this->flat_vertices(1, i)));
-        K_g_triplets.emplace_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2, - this->flat_vertices(1, i)));
-        K_g_triplets.emplace_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 2, this->flat_vertices(0, i)));
-        K_g_triplets.emplace_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2 + 1, this->flat_vertices(0, i)));
+        *lagrange_triplets++ = trip(i * 2, n * 2 + 2, - this->flat_vertices(1, i));
+        *lagrange_triplets++ = trip(n * 2 + 2, i * 2, - this->flat_vertices(1, i));
+        *lagrange_triplets++ = trip(i * 2 + 1, n * 2 + 2, this->flat_vertices(0, i));
+        *lagrange_triplets++ = trip(n * 2 + 2, i * 2 + 1, this->flat_vertices(0, i));
     }
 
     // project out the nullspace solution:
@@ -286,10 +303,17 @@ void LscmRelax::relax(double weight)
     // rhs +=  K_g * Eigen::VectorXd::Ones(K_g.rows());
 
     // solve linear system (privately store the value for guess in next step)
-    Eigen::SimplicialLDLT<spMat, Eigen::Lower> solver;
-    solver.compute(K_g);
-    this->sol = solver.solve(-rhs);
-    this->set_shift(this->sol.head(this->vertices.cols() * 2) * weight);
+    // the pattern of K_g is the same for every iteration, so only the numerical
+    // factorization has to be redone
+    if (!this->warm_start || !this->relax_solver || this->relax_non_zeros != K_g.nonZeros())
+    {
+        this->relax_solver = std::make_shared<Eigen::SimplicialLDLT<spMat, Eigen::Lower>>();
+        this->relax_solver->analyzePattern(K_g);
+        this->relax_non_zeros = K_g.nonZeros();
+    }
+    this->relax_solver->factorize(K_g);
+    this->sol = this->relax_solver->solve(-rhs);
+    this->set_shift(this->sol.head(n * 2) * weight);
     this->set_q_l_m();
 }
 
@@ -425,31 +449,29 @@ void LscmRelax::edge_relax(double weight)
 void LscmRelax::lscm()
 {
     this->set_q_l_g();
-    std::vector<trip> triple_list;
-    long i;
-    double x21, x31, y31, x32;
+    std::vector<trip> triple_list(this->triangles.cols() * 10);
 
-    // 1. create the triplet list (t * 2, v * 2)
-    for(i=0; i<this->triangles.cols(); i++)
+    // 1. create the triplet list (t * 2, v * 2), every triangle fills its own 10 slots
+    Base::parallelFor(this->triangles.cols(), [&](long i)
     {
-        x21 = this->q_l_g(i, 0);
-        x31 = this->q_l_g(i, 1);
-        y31 = this->q_l_g(i, 2);
-        x32 = x31 - x21;
-
-        triple_list.emplace_back(trip(2 * i, this->new_order[this->triangles(0, i)] * 2, x32));
-        triple_list.emplace_back(trip(2 * i, this->new_order[this->triangles(0, i)] * 2 + 1, -y31));
-        triple_list.emplace_back(trip(2 * i, this->new_order[this->triangles(1, i)] * 2, -x31));
-        triple_list.emplace_back(trip(2 * i, this->new_order[this->triangles(1, i)] * 2 + 1, y31));
-        triple_list.emplace_back(trip(2 * i, this->new_order[this->triangles(2, i)] * 2, x21));
-
-        triple_list.emplace_back(trip(2 * i + 1, this->new_order[this->triangles(0, i)] * 2, y31));
-        triple_list.emplace_back(trip(2 * i + 1, this->new_order[this->triangles(0, i)] * 2 + 1, x32));
-        triple_list.emplace_back(trip(2 * i + 1, this->new_order[this->triangles(1, i)] * 2, -y31));
-        triple_list.emplace_back(trip(2 * i + 1, this->new_order[this->triangles(1, i)] * 2 + 1, -x31));
-        triple_list.emplace_back(trip(2 * i + 1, this->new_order[this->triangles(2, i)] * 2 + 1, x21));
-
-    }
+        double x21 = this->q_l_g(i, 0);
+        double x31 = this->q_l_g(i, 1);
+        double y31 = this->q_l_g(i, 2);
+        double x32 = x31 - x21;
+        trip* element_triplets = &triple_list[i * 10];
+
+        *element_triplets++ = trip(2 * i, this->new_order[this->triangles(0, i)] * 2, x32);
+        *element_triplets++ = trip(2 * i, this->new_order[this->triangles(0, i)] * 2 + 1, -y31);
+        *element_triplets++ = trip(2 * i, this->new_order[this->triangles(1, i)] * 2, -x31);
+        *element_triplets++ = trip(2 * i, this->new_order[this->triangles(1, i)] * 2 + 1, y31);
+        *element_triplets++ = trip(2 * i, this->new_order[this->triangles(2, i)] * 2, x21);
+
+        *element_triplets++ = trip(2 * i + 1, this->new_order[this->triangles(0, i)] * 2, y31);
+        *element_triplets++ = trip(2 * i + 1, this->new_order[this->triangles(0, i)] * 2 + 1, x32);
+        *element_triplets++ = trip(2 * i + 1, this->new_order[this->triangles(1, i)] * 2, -y31);
+        *element_triplets++ = trip(2 * i + 1, this->new_order[this->triangles(1, i)] * 2 + 1, -x31);
+        *element_triplets++ = trip(2 * i + 1, this->new_order[this->triangles(2, i)] * 2 + 1, x21);
+    });
     // 2. divide the triplets in matrix(unknown part) and rhs(known part) and reset the position
     std::vector<trip> rhs_triplets;
     std::vector<trip> mat_triplets;
@@ -483,9 +505,20 @@ void LscmRelax::lscm()
     // 6. solve the system and set the flatted coordinates
     // Eigen::SparseQR<spMat, Eigen::COLAMDOrdering<int> > solver;
     Eigen::LeastSquaresConjugateGradient<spMat > solver;
-    Eigen::VectorXd sol(this->vertices.size() * 2);
+    Eigen::VectorXd sol = Eigen::VectorXd::Zero(A.cols());
+    if (this->warm_start)
+    {
+        // start with the current flat vertices of the unknowns
+        for (long i=0; i < A.cols() / 2; i++)
+        {
+            sol[i * 2] = this->flat_vertices(0, this->old_order[i]);
+            sol[i * 2 + 1] = this->flat_vertices(1, this->old_order[i]);
+        }
+    }
     solver.compute(A);
-    sol = solver.solve(-rhs);
+    sol = solver.solveWithGuess(-rhs, sol);
+    this->lscm_iterations = solver.iterations();
+    this->lscm_error = solver.error();
 
     // TODO: create function, is needed also in the fem step
     this->set_position(sol);
@@ -502,7 +535,7 @@ void LscmRelax::set_q_l_g()
     // x1, y1, y2 = 0
     // -> vector<x2, x3, y3>
     this->q_l_g.resize(this->triangles.cols(), 3);
-    for (long i = 0; i < this->triangles.cols(); i++)
+    Base::parallelFor(this->triangles.cols(), [this](long i)
     {
         Vector3 r1 = this->vertices.col(this->triangles(0, i));
         Vector3 r2 = this->vertices.col(this->triangles(1, i));
@@ -513,7 +546,7 @@ void LscmRelax::set_q_l_g()
         r21.normalize();
         // if triangle is fliped this gives wrong results?
         this->q_l_g.row(i) << r21_norm, r31.dot(r21), r31.cross(r21).norm();
-    }
+    });
 }
 
 void LscmRelax::set_q_l_m()
@@ -522,7 +555,7 @@ void LscmRelax::set_q_l_m()
     // x1, y1, y2 = 0
     // -> vector<x2, x3, y3>
     this->q_l_m.resize(this->triangles.cols(), 3);
-    for (long i = 0; i < this->triangles.cols(); i++)
+    Base::parallelFor(this->triangles.cols(), [this](long i)
     {
         Vector2 r1 = this->flat_vertices.col(this->triangles(0, i));
         Vector2 r2 = this->flat_vertices.col(this->triangles(1, i));
@@ -533,7 +566,7 @@ void LscmRelax::set_q_l_m()
         r21.normalize();
         // if triangle is fliped this gives wrong results!
         this->q_l_m.row(i) << r21_norm, r31.dot(r21), -(r31.x() * r21.y() - r31.y() * r21.x());
-    }
+    });
 }
 
 void LscmRelax::set_fixed_pins()
@@ -701,7 +734,7 @@ std::vector<long> LscmRelax::get_fem_fixed_pins()
 Eigen::MatrixXd LscmRelax::get_nullspace()
 {
     Eigen::MatrixXd null_space;
-    null_space.setZero(this->flat_vertices.size() * 2, 3);
+    null_space.setZero(this->flat_vertices.cols() * 2, 3);
 
     for (int i=0; i<this->flat_vertices.cols(); i++)
     {
@@ -40,6 +40,8 @@
 #include <tuple>
 #include <vector>
 
+#include <Eigen/SparseCholesky>
+
 #include "MeshFlattening.h"
 
 
@@ -86,6 +88,11 @@ private:
     Eigen::Matrix<double, 3, 3> C;
     Eigen::VectorXd sol;
 
+    // the sparsity pattern of the relax-system doesn't change between the iterations,
+    // so the symbolic analysis of the factorization is done only once
+    std::shared_ptr<Eigen::SimplicialLDLT<spMat, Eigen::Lower>> relax_solver;
+    long relax_non_zeros = 0;
+
     std::vector<long> get_fem_fixed_pins();
     Eigen::MatrixXd get_nullspace();
 
@@ -106,6 +113,18 @@ public:
     double nue=0.9;
     double elasticity=1.;
 
+    // iterations and estimated error of the last lscm solve
+    long lscm_iterations = 0;
+    double lscm_error = 0;
+
+    // relax reuses the symbolic analysis of its factorization between the
+    // iterations, which is where the warm start pays off. lscm starts its
+    // iterative solver from the current flat_vertices, but these are still zero
+    // when lscm runs once on a new object as in FaceUnwrapper, so it only helps
+    // when lscm is called again. Without warm start every solve starts from
+    // scratch, e.g. to compare the timings.
+    bool warm_start = true;
+
     void lscm();
     void relax(double);
     void area_relax(double);
@@ -23,11 +23,23 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <chrono>
+#include <unordered_map>
 
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <BRepTools.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Standard_Failure.hxx>
 #include <Standard_Version.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopoDS_TShape.hxx>
+
+#include <QtConcurrentMap>
 #endif
 
 #include <Base/Console.h>
@@ -126,45 +138,36 @@ int MeshingOutput::sync()
 namespace MeshPart
 {
 
-struct Vertex
+// Nodes on the boundary of adjacent faces are merged if their coordinates are equal
+struct VertexKey
 {
-    static const double deflection;
     Standard_Real x, y, z;
-    Standard_Integer i = 0;
-    mutable MeshCore::MeshPoint p;
 
-    Vertex(Standard_Real X, Standard_Real Y, Standard_Real Z)
-        : x(X)
-        , y(Y)
-        , z(Z)
-    {
-        p.x = static_cast<float>(x);
-        p.y = static_cast<float>(y);
-        p.z = static_cast<float>(z);
-    }
+    VertexKey(const gp_Pnt& p)
+        // adding zero turns -0.0 into +0.0 so that both have the same hash
+        : x(p.X() + 0.0)
+        , y(p.Y() + 0.0)
+        , z(p.Z() + 0.0)
+    {}
 
-    const MeshCore::MeshPoint& toPoint() const
+    bool operator==(const VertexKey& v) const
     {
-        return p;
+        return x == v.x && y == v.y && z == v.z;
     }
+};
 
-    bool operator<(const Vertex& v) const
+struct VertexKeyHash
+{
+    std::size_t operator()(const VertexKey& v) const
     {
-        if (fabs(this->x - v.x) >= deflection) {
-            return this->x < v.x;
-        }
-        if (fabs(this->y - v.y) >= deflection) {
-            return this->y < v.y;
-        }
-        if (fabs(this->z - v.z) >= deflection) {
-            return this->z < v.z;
-        }
-        return false;  // points are considered to be equal
+        std::hash<Standard_Real> hasher;
+        std::size_t seed = hasher(v.x);
+        seed ^= hasher(v.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= hasher(v.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
     }
 };
 
-const double Vertex::deflection = gp::Resolution();
-
 // ----------------------------------------------------------------------------
 
 class BrepMesh
@@ -172,97 +175,117 @@ class BrepMesh
     bool segments;
     std::vector<uint32_t> colors;
 
+    struct Domain
+    {
+        TopoDS_Face face;
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) mesh;
+    };
+
 public:
     BrepMesh(bool s, const std::vector<uint32_t>& c)
         : segments(s)
         , colors(c)
     {}
 
-    Mesh::MeshObject* create(const std::vector<Part::TopoShape::Domain>& domains) const
+    // Builds the mesh directly from the triangulations of the faces. The kernel arrays
+    // are sized up front and filled in place.
+    Mesh::MeshObject* create(const TopoDS_Shape& shape) const
     {
         std::map<uint32_t, std::vector<std::size_t>> colorMap;
         for (std::size_t i = 0; i < colors.size(); i++) {
             colorMap[colors[i]].push_back(i);
         }
 
+        // For a face that isn't meshed an empty domain is kept. It's important for the
+        // color mapping that the numbers of faces and domains match
+        std::vector<Domain> domains;
+        std::size_t numNodes = 0;
+        std::size_t numTriangles = 0;
+        for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+            Domain domain;
+            domain.face = TopoDS::Face(xp.Current());
+            domain.mesh = BRep_Tool::Triangulation(domain.face, domain.loc);
+            if (!domain.mesh.IsNull()) {
+                numNodes += domain.mesh->NbNodes();
+                numTriangles += domain.mesh->NbTriangles();
+            }
+            domains.push_back(domain);
+        }
+
         bool createSegm = (colors.size() == domains.size());
 
+        MeshCore::MeshPointArray verts;
+        verts.reserve(numNodes);
         MeshCore::MeshFacetArray faces;
-        std::size_t numTriangles = 0;
-        for (const auto& it : domains) {
-            numTriangles += it.facets.size();
-        }
         faces.reserve(numTriangles);
 
-        std::set<Vertex> vertices;
-        Standard_Real x1, y1, z1;
-        Standard_Real x2, y2, z2;
-        Standard_Real x3, y3, z3;
+        std::unordered_map<VertexKey, MeshCore::PointIndex, VertexKeyHash> vertices;
+        vertices.reserve(numNodes);
+        std::vector<MeshCore::PointIndex> nodeIndex;
 
         std::vector<std::vector<MeshCore::FacetIndex>> meshSegments;
         std::size_t numMeshFaces = 0;
 
         for (const auto& domain : domains) {
             std::size_t numDomainFaces = 0;
-            for (std::size_t j = 0; j < domain.facets.size(); ++j) {
-                const Part::TopoShape::Facet& tria = domain.facets[j];
-                x1 = domain.points[tria.I1].x;
-                y1 = domain.points[tria.I1].y;
-                z1 = domain.points[tria.I1].z;
-
-                x2 = domain.points[tria.I2].x;
-                y2 = domain.points[tria.I2].y;
-                z2 = domain.points[tria.I2].z;
-
-                x3 = domain.points[tria.I3].x;
-                y3 = domain.points[tria.I3].y;
-                z3 = domain.points[tria.I3].z;
-
-                std::set<Vertex>::iterator it;
-                MeshCore::MeshFacet face;
-
-                // 1st vertex
-                Vertex v1(x1, y1, z1);
-                it = vertices.find(v1);
-                if (it == vertices.end()) {
-                    v1.i = vertices.size();
-                    face._aulPoints[0] = v1.i;
-                    vertices.insert(v1);
-                }
-                else {
-                    face._aulPoints[0] = it->i;
-                }
-
-                // 2nd vertex
-                Vertex v2(x2, y2, z2);
-                it = vertices.find(v2);
-                if (it == vertices.end()) {
-                    v2.i = vertices.size();
-                    face._aulPoints[1] = v2.i;
-                    vertices.insert(v2);
-                }
-                else {
-                    face._aulPoints[1] = it->i;
-                }
-
-                // 3rd vertex
-                Vertex v3(x3, y3, z3);
-                it = vertices.find(v3);
-                if (it == vertices.end()) {
-                    v3.i = vertices.size();
-                    face._aulPoints[2] = v3.i;
-                    vertices.insert(v3);
-                }
-                else {
-                    face._aulPoints[2] = it->i;
-                }
+            if (!domain.mesh.IsNull()) {
+                const Handle(Poly_Triangulation)& hTria = domain.mesh;
+                bool identity = domain.loc.IsIdentity();
+                gp_Trsf transf = domain.loc.Transformation();
+                bool reversed = domain.face.Orientation() != TopAbs_FORWARD;
+#if OCC_VERSION_HEX < 0x070600
+                const TColgp_Array1OfPnt& nodes = hTria->Nodes();
+                const Poly_Array1OfTriangle& triangles = hTria->Triangles();
+#endif
 
-                // make sure that we don't insert invalid facets
-                if (face._aulPoints[0] != face._aulPoints[1]
-                    && face._aulPoints[1] != face._aulPoints[2]
-                    && face._aulPoints[2] != face._aulPoints[0]) {
-                    faces.push_back(face);
-                    numDomainFaces++;
+                // points are added in the order the triangles use them
+                nodeIndex.assign(hTria->NbNodes(), MeshCore::POINT_INDEX_MAX);
+                auto pointIndex = [&](Standard_Integer node) {
+                    MeshCore::PointIndex& index = nodeIndex[node - 1];
+                    if (index == MeshCore::POINT_INDEX_MAX) {
+#if OCC_VERSION_HEX < 0x070600
+                        gp_Pnt p = nodes(node);
+#else
+                        gp_Pnt p = hTria->Node(node);
+#endif
+                        if (!identity) {
+                            p.Transform(transf);
+                        }
+                        auto it = vertices.emplace(VertexKey(p), verts.size());
+                        if (it.second) {
+                            verts.emplace_back(static_cast<float>(p.X()),
+                                               static_cast<float>(p.Y()),
+                                               static_cast<float>(p.Z()));
+                        }
+                        index = it.first->second;
+                    }
+                    return index;
+                };
+
+                for (Standard_Integer i = 1; i <= hTria->NbTriangles(); i++) {
+                    Standard_Integer n1, n2, n3;
+#if OCC_VERSION_HEX < 0x070600
+                    triangles(i).Get(n1, n2, n3);
+#else
+                    hTria->Triangle(i).Get(n1, n2, n3);
+#endif
+                    if (reversed) {
+                        std::swap(n1, n2);
+                    }
+
+                    MeshCore::MeshFacet face;
+                    face._aulPoints[0] = pointIndex(n1);
+                    face._aulPoints[1] = pointIndex(n2);
+                    face._aulPoints[2] = pointIndex(n3);
+
+                    // make sure that we don't insert invalid facets
+                    if (face._aulPoints[0] != face._aulPoints[1]
+                        && face._aulPoints[1] != face._aulPoints[2]
+                        && face._aulPoints[2] != face._aulPoints[0]) {
+                        faces.push_back(face);
+                        numDomainFaces++;
+                    }
                 }
             }
 
@@ -277,12 +300,6 @@ public:
             }
         }
 
-        MeshCore::MeshPointArray verts;
-        verts.resize(vertices.size());
-        for (const auto& it : vertices) {
-            verts[it.i] = it.toPoint();
-        }
-
         MeshCore::MeshKernel kernel;
         kernel.Adopt(verts, faces, true);
 
@@ -321,20 +338,53 @@ Mesher::Mesher(const TopoDS_Shape& s)
     : shape(s)
 {}
 
+Mesher::Mesher(const Mesher& other, const TopoDS_Shape& s)
+    : shape(s)
+    , method(other.method)
+    , maxLength(other.maxLength)
+    , maxArea(other.maxArea)
+    , localLength(other.localLength)
+    , deflection(other.deflection)
+    , angularDeflection(other.angularDeflection)
+    , minLen(other.minLen)
+    , maxLen(other.maxLen)
+    , relative(other.relative)
+    , regular(other.regular)
+    , segments(other.segments)
+#if defined(HAVE_NETGEN)
+    , fineness(other.fineness)
+    , growthRate(other.growthRate)
+    , nbSegPerEdge(other.nbSegPerEdge)
+    , nbSegPerRadius(other.nbSegPerRadius)
+    , secondOrder(other.secondOrder)
+    , optimize(other.optimize)
+    , allowquad(other.allowquad)
+#endif
+    , colors(other.colors)
+{}
+
 Mesher::~Mesher() = default;
 
 Mesh::MeshObject* Mesher::createStandard() const
+{
+    triangulateStandard();
+    return convertStandard();
+}
+
+void Mesher::triangulateStandard(bool clean) const
 {
     if (!shape.IsNull()) {
-        BRepTools::Clean(shape);
+        if (clean) {
+            BRepTools::Clean(shape);
+        }
         BRepMesh_IncrementalMesh aMesh(shape, deflection, relative, angularDeflection);
     }
+}
 
-    std::vector<Part::TopoShape::Domain> domains;
-    Part::TopoShape(shape).getDomains(domains);
-
+Mesh::MeshObject* Mesher::convertStandard() const
+{
     BrepMesh brepmesh(this->segments, this->colors);
-    return brepmesh.create(domains);
+    return brepmesh.create(shape);
 }
 
 Mesh::MeshObject* Mesher::createMesh() const
@@ -686,3 +736,175 @@ Mesh::MeshObject* Mesher::createFrom(SMESH_Mesh* mesh) const
     meshdata->swap(kernel);
     return meshdata;
 }
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double elapsedSince(const Clock::time_point& start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template<typename Func>
+void runGuarded(BatchMesher::Result& result, Func&& func)
+{
+    auto start = Clock::now();
+    try {
+        func();
+    }
+    catch (const Standard_Failure& e) {
+        Standard_CString msg = e.GetMessageString();
+        result.error = (msg && msg[0] != '\0') ? msg : "OCC exception";
+    }
+    catch (const Base::Exception& e) {
+        result.error = e.what();
+    }
+    catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    catch (...) {
+        result.error = "Unknown exception";
+    }
+    result.time += elapsedSince(start);
+}
+
+// The settings of a BatchMesher refer to this shape
+const TopoDS_Shape& nullShape()
+{
+    static const TopoDS_Shape shape;
+    return shape;
+}
+
+// Puts the indices of shapes that share their TShape or any face or edge into the same group.
+std::vector<std::vector<std::size_t>> groupBySharedGeometry(const std::vector<TopoDS_Shape>& shapes)
+{
+    std::vector<std::size_t> parent(shapes.size());
+    std::generate(parent.begin(), parent.end(), Base::iotaGen<std::size_t>(0));
+    auto findRoot = [&parent](std::size_t index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    };
+
+    std::unordered_map<const TopoDS_TShape*, std::size_t> owner;
+    auto addTShape = [&](const TopoDS_Shape& sub, std::size_t index) {
+        auto it = owner.emplace(sub.TShape().get(), index);
+        if (!it.second) {
+            parent[findRoot(index)] = findRoot(it.first->second);
+        }
+    };
+
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        if (shapes[i].IsNull()) {
+            continue;
+        }
+        addTShape(shapes[i], i);
+        for (TopAbs_ShapeEnum type : {TopAbs_FACE, TopAbs_EDGE}) {
+            for (TopExp_Explorer xp(shapes[i], type); xp.More(); xp.Next()) {
+                addTShape(xp.Current(), i);
+            }
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> groups;
+    std::unordered_map<std::size_t, std::size_t> groupOfRoot;
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        auto it = groupOfRoot.emplace(findRoot(i), groups.size());
+        if (it.second) {
+            groups.emplace_back();
+        }
+        groups[it.first->second].push_back(i);
+    }
+    return groups;
+}
+}  // namespace
+
+BatchMesher::BatchMesher(const Mesher& settings)
+    : settings(settings, nullShape())
+{}
+
+std::vector<BatchMesher::Result>
+BatchMesher::createMeshes(const std::vector<TopoDS_Shape>& shapes) const
+{
+    std::vector<Result> results(shapes.size());
+
+    // The SMESH generator is shared and not thread-safe
+    if (settings.getMethod() != Mesher::Standard) {
+        for (std::size_t i = 0; i < shapes.size(); i++) {
+            Result& result = results[i];
+            runGuarded(result, [&]() {
+                Mesher mesher(settings, shapes[i]);
+                result.mesh.reset(mesher.createMesh());
+            });
+        }
+        return results;
+    }
+
+    auto convert = [&](std::size_t index) {
+        Result& result = results[index];
+        if (result.error.empty() && !result.mesh) {
+            runGuarded(result, [&]() {
+                Mesher mesher(settings, shapes[index]);
+                result.mesh.reset(mesher.convertStandard());
+            });
+        }
+    };
+
+    // BRepMesh stores the triangulation at the faces and the polygons at the edges of the
+    // underlying TShapes. Shapes that share any of them (copies that only differ in their
+    // location, a compound and its children, ...) are triangulated sequentially by the same
+    // worker and only independent groups run concurrently.
+    std::vector<std::vector<std::size_t>> groups = groupBySharedGeometry(shapes);
+    QtConcurrent::blockingMap(groups, [&](const std::vector<std::size_t>& group) {
+        // the same TShape is triangulated only once for all its copies
+        std::vector<std::vector<std::size_t>> copies;
+        std::unordered_map<const TopoDS_TShape*, std::size_t> copyOf;
+        for (std::size_t index : group) {
+            auto it = copyOf.emplace(shapes[index].TShape().get(), copies.size());
+            if (it.second) {
+                copies.emplace_back();
+            }
+            copies[it.first->second].push_back(index);
+        }
+
+        // With an absolute deflection the triangulation of a face doesn't depend on the
+        // shape it belongs to. Shared faces are triangulated once by the first shape and
+        // reused by the others. With a relative deflection it depends on the size of the
+        // meshed shape, so every shape re-triangulates its faces and is converted before
+        // the next one changes them. This way the result doesn't depend on the batch.
+        if (!settings.relative) {
+            for (const auto& it : copies) {
+                if (!shapes[it.front()].IsNull()) {
+                    BRepTools::Clean(shapes[it.front()]);
+                }
+            }
+        }
+
+        for (const auto& it : copies) {
+            Result& first = results[it.front()];
+            runGuarded(first, [&]() {
+                Mesher mesher(settings, shapes[it.front()]);
+                mesher.triangulateStandard(settings.relative);
+            });
+            for (std::size_t index : it) {
+                if (index != it.front()) {
+                    results[index].error = first.error;
+                }
+                if (settings.relative) {
+                    convert(index);
+                }
+            }
+        }
+    });
+
+    std::vector<std::size_t> all(shapes.size());
+    std::generate(all.begin(), all.end(), Base::iotaGen<std::size_t>(0));
+    QtConcurrent::blockingMap(all, convert);
+
+    return results;
+}
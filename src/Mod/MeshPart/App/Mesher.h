@@ -23,7 +23,10 @@
 #ifndef MESHPART_MESHER_H
 #define MESHPART_MESHER_H
 
+#include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <Base/Stream.h>
 
@@ -56,6 +59,8 @@ public:
     };
 
     explicit Mesher(const TopoDS_Shape&);
+    /// Creates a mesher for the shape \a s that uses the same settings as \a other
+    Mesher(const Mesher& other, const TopoDS_Shape& s);
     ~Mesher();
 
     void setMethod(Method m)
@@ -215,6 +220,8 @@ public:
 
 private:
     Mesh::MeshObject* createStandard() const;
+    void triangulateStandard(bool clean = true) const;
+    Mesh::MeshObject* convertStandard() const;
     Mesh::MeshObject* createFrom(SMESH_Mesh*) const;
 
 private:
@@ -241,6 +248,42 @@ private:
     std::vector<uint32_t> colors;
 
     static SMESH_Gen* _mesh_gen;
+
+    friend class BatchMesher;
+};
+
+/**
+ * The BatchMesher class meshes a list of shapes with the settings of a given Mesher.
+ * With the standard mesher the shapes are processed concurrently on the global thread
+ * pool. Shapes that share faces or edges are triangulated sequentially by the same worker
+ * and shapes that only differ in placement are triangulated only once. Each mesh is the
+ * same as if the shape was meshed on its own. The SMESH based methods are not re-entrant
+ * and thus the shapes are processed sequentially.
+ * For each shape the elapsed time and, in case it failed, the error message is recorded.
+ */
+class BatchMesher
+{
+public:
+    struct Result
+    {
+        std::unique_ptr<Mesh::MeshObject> mesh;
+        /// elapsed time in seconds
+        double time {0};
+        /// error message if the shape couldn't be meshed
+        std::string error;
+
+        bool isValid() const
+        {
+            return mesh != nullptr;
+        }
+    };
+
+    explicit BatchMesher(const Mesher& settings);
+
+    std::vector<Result> createMeshes(const std::vector<TopoDS_Shape>& shapes) const;
+
+private:
+    Mesher settings;
 };
 
 class MeshingOutput: public std::streambuf
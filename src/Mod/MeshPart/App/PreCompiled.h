@@ -41,11 +41,13 @@
 // STL
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 // OpenCasCade
@@ -76,7 +78,11 @@
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopoDS_TShape.hxx>
 #include <gp_Pln.hxx>
 
+// Qt
+#include <QtConcurrentMap>
+
 #endif  // _PreComp_
 #endif
@@ -237,6 +237,16 @@ bool ImportExportSettings::getExpandCompound() const
     return pGroup->GetBool("ExpandCompound", false);
 }
 
+void ImportExportSettings::setDedupSolids(bool on)
+{
+    pGroup->SetBool("DedupSolids", on);
+}
+
+bool ImportExportSettings::getDedupSolids() const
+{
+    return pGroup->GetBool("DedupSolids", false);
+}
+
 void ImportExportSettings::setShowProgress(bool on)
 {
     pGroup->SetBool("ShowProgress", on);
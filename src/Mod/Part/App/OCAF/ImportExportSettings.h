@@ -88,6 +88,9 @@ public:
     void setExpandCompound(bool);
     bool getExpandCompound() const;
 
+    void setDedupSolids(bool);
+    bool getDedupSolids() const;
+
     void setShowProgress(bool);
     bool getShowProgress() const;
 
@@ -172,6 +172,7 @@
 #include <Base/Writer.h>
 
 #include "TopoShape.h"
+#include "TopoShapeCache.h"
 #include "BRepOffsetAPI_MakeOffsetFix.h"
 #include "CrossSection.h"
 #include "encodeFilename.h"
@@ -289,6 +290,7 @@ TopoShape::TopoShape(const TopoDS_Shape& shape)
 
 TopoShape::TopoShape(const TopoShape& shape)
   : _Shape(shape._Shape)
+  , _cache(std::atomic_load(&shape._cache))
 {
     Tag = shape.Tag;
 }
@@ -355,8 +357,8 @@ TopoDS_Shape TopoShape::getSubShape(TopAbs_ShapeEnum type, int index, bool silen
                     return it.Value();
             }
         } else {
-            TopTools_IndexedMapOfShape anIndices;
-            TopExp::MapShapes(this->_Shape, type, anIndices);
+            auto cache = initCache();
+            const auto& anIndices = cache->getSubShapes(type);
             if(index <= anIndices.Extent())
                 return anIndices.FindKey(index);
         }
@@ -390,9 +392,7 @@ unsigned long TopoShape::countSubShapes(TopAbs_ShapeEnum Type) const
             ++count;
         return count;
     }
-    TopTools_IndexedMapOfShape anIndices;
-    TopExp::MapShapes(this->_Shape, Type, anIndices);
-    return anIndices.Extent();
+    return initCache()->countShapes(Type);
 }
 
 bool TopoShape::hasSubShape(TopAbs_ShapeEnum type) const {
@@ -410,7 +410,8 @@ bool TopoShape::hasSubShape(const char *Type) const {
 }
 
 template<class T>
-static inline std::vector<T> _getSubShapes(const TopoDS_Shape &s, TopAbs_ShapeEnum type) {
+static inline std::vector<T> _getSubShapes(const TopoDS_Shape &s, TopAbs_ShapeEnum type,
+                                           TopoShapeCache* cache) {
     std::vector<T> shapes;
     if(s.IsNull())
         return shapes;
@@ -421,8 +422,7 @@ static inline std::vector<T> _getSubShapes(const TopoDS_Shape &s, TopAbs_ShapeEn
         return shapes;
     }
 
-    TopTools_IndexedMapOfShape anIndices;
-    TopExp::MapShapes(s, type, anIndices);
+    const auto& anIndices = cache->getSubShapes(type);
     int count = anIndices.Extent();
     shapes.reserve(count);
     for(int i=1;i<=count;++i)
@@ -431,11 +431,39 @@ static inline std::vector<T> _getSubShapes(const TopoDS_Shape &s, TopAbs_ShapeEn
 }
 
 std::vector<TopoShape> TopoShape::getSubTopoShapes(TopAbs_ShapeEnum type) const {
-    return _getSubShapes<TopoShape>(_Shape,type);
+    return _getSubShapes<TopoShape>(_Shape,type,initCache().get());
 }
 
 std::vector<TopoDS_Shape> TopoShape::getSubShapes(TopAbs_ShapeEnum type) const {
-    return _getSubShapes<TopoDS_Shape>(_Shape,type);
+    return _getSubShapes<TopoDS_Shape>(_Shape,type,initCache().get());
+}
+
+int TopoShape::findShape(const TopoDS_Shape& subshape) const {
+    if(_Shape.IsNull())
+        return 0;
+    return initCache()->findShape(subshape);
+}
+
+std::vector<TopoDS_Shape> TopoShape::findAncestorsShapes(const TopoDS_Shape& subshape,
+                                                         TopAbs_ShapeEnum type) const {
+    std::vector<TopoDS_Shape> shapes;
+    auto cache = initCache();
+    const auto& list = cache->findAncestors(subshape, type);
+    shapes.reserve(list.Extent());
+    for(TopTools_ListIteratorOfListOfShape it(list);it.More();it.Next())
+        shapes.push_back(it.Value());
+    return shapes;
+}
+
+std::shared_ptr<TopoShapeCache> TopoShape::initCache() const {
+    // Several threads may call const methods of the same object, so the pointer is
+    // exchanged atomically. The caller keeps the returned cache alive while using it.
+    auto cache = std::atomic_load(&_cache);
+    if(!cache || !cache->isValidFor(_Shape)) {
+        cache = std::make_shared<TopoShapeCache>(_Shape);
+        std::atomic_store(&_cache, cache);
+    }
+    return cache;
 }
 
 static std::array<std::string,TopAbs_SHAPE> _ShapeNames;
@@ -583,7 +611,7 @@ PyObject * TopoShape::getPyObject()
 void TopoShape::setPyObject(PyObject* obj)
 {
     if (PyObject_TypeCheck(obj, &TopoShapePy::Type)) {
-        this->_Shape = static_cast<TopoShapePy*>(obj)->getTopoShapePtr()->getShape();
+        setShape(static_cast<TopoShapePy*>(obj)->getTopoShapePtr()->getShape());
     }
     else {
         std::string error = std::string("type must be 'Shape', not ");
@@ -597,6 +625,7 @@ void TopoShape::operator = (const TopoShape& sh)
     if (this != &sh) {
         this->Tag = sh.Tag;
         this->_Shape = sh._Shape;
+        std::atomic_store(&this->_cache, std::atomic_load(&sh._cache));
     }
 }
 
@@ -25,6 +25,7 @@
 
 #include <iosfwd>
 #include <list>
+#include <memory>
 
 #include <App/ComplexGeoData.h>
 #include <Base/Exception.h>
@@ -47,6 +48,8 @@ class Color;
 namespace Part
 {
 
+class TopoShapeCache;
+
 /* A special sub-class to indicate null shapes
  */
 class PartExport NullShapeException : public Base::ValueError
@@ -101,6 +104,8 @@ public:
 
     inline void setShape(const TopoDS_Shape& shape) {
         this->_Shape = shape;
+        // the shape may have been modified in place, e.g. by adding to a compound
+        std::atomic_store(&this->_cache, std::shared_ptr<TopoShapeCache>());
     }
 
     inline const TopoDS_Shape& getShape() const {
@@ -186,6 +191,10 @@ public:
     unsigned long countSubShapes(TopAbs_ShapeEnum type) const;
     bool hasSubShape(const char *Type) const;
     bool hasSubShape(TopAbs_ShapeEnum type) const;
+    /// get the 1-based index of the given sub-shape, or 0 if it isn't a sub-shape
+    int findShape(const TopoDS_Shape& subshape) const;
+    /// get all ancestors of type \a type of the given sub-shape
+    std::vector<TopoDS_Shape> findAncestorsShapes(const TopoDS_Shape& subshape, TopAbs_ShapeEnum type) const;
     /// get the Topo"sub"Shape with the given name
     PyObject * getPySubShape(const char* Type, bool silent=false) const;
     PyObject * getPyObject() override;
@@ -388,8 +397,14 @@ public:
     static const std::string &shapeName(TopAbs_ShapeEnum type,bool silent=false);
     const std::string &shapeName(bool silent=false) const;
     static std::pair<TopAbs_ShapeEnum,int> shapeTypeAndIndex(const char *name);
+private:
+    /// get the sub-shape index of the current shape, (re)build it if the shape has changed
+    std::shared_ptr<TopoShapeCache> initCache() const;
+
 private:
     TopoDS_Shape _Shape;
+    /// shared by copies and only accessed with std::atomic_load/atomic_store
+    mutable std::shared_ptr<TopoShapeCache> _cache;
 };
 
 } //namespace Part
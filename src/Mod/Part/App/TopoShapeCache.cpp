@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <Standard_Version.hxx>
+# include <TopExp.hxx>
+# include <TopTools_ListOfShape.hxx>
+# include <TopoDS_TShape.hxx>
+#endif
+
+#include "TopoShapeCache.h"
+
+
+using namespace Part;
+
+namespace {
+int countChildren(const TopoDS_Shape& shape)
+{
+#if OCC_VERSION_HEX >= 0x070400
+    return shape.IsNull() ? 0 : shape.TShape()->NbChildren();
+#else
+    (void)shape;
+    return 0;
+#endif
+}
+}
+
+TopoShapeCache::TopoShapeCache(const TopoDS_Shape& shape)
+  : shape(shape)
+  , numChildren(countChildren(shape))
+{
+}
+
+bool TopoShapeCache::isValidFor(const TopoDS_Shape& other) const
+{
+    // same TShape, location and orientation and no sub-shape added or removed in place
+    return shape.IsEqual(other) && numChildren == countChildren(other);
+}
+
+const TopTools_IndexedMapOfShape& TopoShapeCache::getSubShapes(TopAbs_ShapeEnum type)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return buildSubShapes(type);
+}
+
+const TopTools_IndexedMapOfShape& TopoShapeCache::buildSubShapes(TopAbs_ShapeEnum type)
+{
+    auto& map = shapes[type];
+    if (!built[type]) {
+        if (!shape.IsNull())
+            TopExp::MapShapes(shape, type, map);
+        built[type] = true;
+    }
+    return map;
+}
+
+int TopoShapeCache::countShapes(TopAbs_ShapeEnum type)
+{
+    return getSubShapes(type).Extent();
+}
+
+int TopoShapeCache::findShape(const TopoDS_Shape& subshape)
+{
+    if (subshape.IsNull() || subshape.ShapeType() >= TopAbs_SHAPE)
+        return 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    return buildSubShapes(subshape.ShapeType()).FindIndex(subshape);
+}
+
+const TopTools_ListOfShape& TopoShapeCache::findAncestors(const TopoDS_Shape& subshape,
+                                                          TopAbs_ShapeEnum type)
+{
+    static const TopTools_ListOfShape empty;
+    if (shape.IsNull() || subshape.IsNull() || type >= TopAbs_SHAPE)
+        return empty;
+
+    auto key = std::make_pair(subshape.ShapeType(), type);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ancestors.find(key);
+    if (it == ancestors.end()) {
+        it = ancestors.emplace(key, TopTools_IndexedDataMapOfShapeListOfShape()).first;
+        TopExp::MapShapesAndAncestors(shape, key.first, key.second, it->second);
+    }
+
+    const auto& map = it->second;
+    int index = map.FindIndex(subshape);
+    if (index == 0)
+        return empty;
+    return map.FindFromIndex(index);
+}
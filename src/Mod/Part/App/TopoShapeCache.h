@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef PART_TOPOSHAPECACHE_H
+#define PART_TOPOSHAPECACHE_H
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <TopAbs_ShapeEnum.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <Mod/Part/PartGlobal.h>
+
+
+namespace Part
+{
+
+/** Lazily built sub-shape index of a TopoDS_Shape
+ *
+ * The indexed sub-shape maps of each shape type and the ancestor maps are
+ * built on first request and kept until the cache is discarded. Lookups by
+ * index and the reverse lookup of the index of a sub-shape are then O(1).
+ *
+ * A cache is bound to the exact shape (TShape, location and orientation) it
+ * was created for. TopoShape checks this with isValidFor() and replaces the
+ * cache whenever its shape changes. Sub-shapes added to the top-level TShape
+ * in place are detected, deeper in-place edits require TopoShape::setShape().
+ *
+ * A cache may be shared by copies of a TopoShape in several threads. All
+ * lookups are guarded and a map is never changed once it is built, so the
+ * returned references stay valid as long as the cache exists.
+ */
+class PartExport TopoShapeCache
+{
+public:
+    explicit TopoShapeCache(const TopoDS_Shape& shape);
+
+    const TopoDS_Shape& getShape() const
+    {
+        return shape;
+    }
+    /// Check if the cache can be used for the given shape
+    bool isValidFor(const TopoDS_Shape& other) const;
+
+    /// Get all sub-shapes of the given type, the map is 1-based
+    const TopTools_IndexedMapOfShape& getSubShapes(TopAbs_ShapeEnum type);
+    /// Get the number of sub-shapes of the given type
+    int countShapes(TopAbs_ShapeEnum type);
+    /// Get the 1-based index of a sub-shape, or 0 if it's not part of the shape
+    int findShape(const TopoDS_Shape& subshape);
+    /** Get the ancestors of type \a type of the given sub-shape
+     * @return a list of shapes which is empty if there are no ancestors
+     */
+    const TopTools_ListOfShape& findAncestors(const TopoDS_Shape& subshape,
+                                              TopAbs_ShapeEnum type);
+
+private:
+    const TopTools_IndexedMapOfShape& buildSubShapes(TopAbs_ShapeEnum type);
+
+private:
+    TopoDS_Shape shape;
+    int numChildren {0};
+    std::mutex mutex;
+    std::array<TopTools_IndexedMapOfShape, TopAbs_SHAPE> shapes;
+    std::array<bool, TopAbs_SHAPE> built {};
+    std::map<std::pair<TopAbs_ShapeEnum, TopAbs_ShapeEnum>,
+             TopTools_IndexedDataMapOfShapeListOfShape> ancestors;
+};
+
+}  // namespace Part
+
+#endif  // PART_TOPOSHAPECACHE_H
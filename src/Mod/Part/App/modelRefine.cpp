@@ -24,6 +24,7 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <exception>
 # include <iterator>
 # include <Bnd_Box.hxx>
 # include <BRep_Builder.hxx>
@@ -48,6 +49,8 @@
 # include <gp_Cylinder.hxx>
 # include <gp_Pln.hxx>
 # include <GProp_GProps.hxx>
+# include <NCollection_DataMap.hxx>
+# include <OSD_Parallel.hxx>
 # include <ShapeAnalysis_Curve.hxx>
 # include <ShapeAnalysis_Shell.hxx>
 # include <ShapeBuild_ReShape.hxx>
@@ -63,8 +66,10 @@
 # include <TopExp_Explorer.hxx>
 # include <TopTools_DataMapIteratorOfDataMapOfIntegerListOfShape.hxx>
 # include <TopTools_DataMapIteratorOfDataMapOfShapeShape.hxx>
+# include <TopTools_DataMapOfShapeInteger.hxx>
 # include <TopTools_ListIteratorOfListOfShape.hxx>
 # include <TopTools_ListOfShape.hxx>
+# include <TopTools_ShapeMapHasher.hxx>
 #endif // _PreComp_
 
 #include <Base/Console.h>
@@ -85,7 +90,11 @@ void ModelRefine::getFaceEdges(const TopoDS_Face &face, EdgeVectorType &edges)
 void ModelRefine::boundaryEdges(const FaceVectorType &faces, EdgeVectorType &edgesOut)
 {
     //this finds all the boundary edges. Maybe more than one boundary.
-    std::list<TopoDS_Edge> edges;
+    //an edge shared by two faces of the group is an inner edge and thus removed again.
+    //the hash map gives the position of an edge in the list so that this is O(n).
+    using EdgeListType = std::list<TopoDS_Edge>;
+    EdgeListType edges;
+    NCollection_DataMap<TopoDS_Shape, EdgeListType::iterator, TopTools_ShapeMapHasher> edgeMap;
     FaceVectorType::const_iterator faceIt;
     for (faceIt = faces.begin(); faceIt != faces.end(); ++faceIt)
     {
@@ -94,19 +103,16 @@ void ModelRefine::boundaryEdges(const FaceVectorType &faces, EdgeVectorType &edg
         getFaceEdges(*faceIt, faceEdges);
         for (faceEdgesIt = faceEdges.begin(); faceEdgesIt != faceEdges.end(); ++faceEdgesIt)
         {
-            bool foundSignal(false);
-            std::list<TopoDS_Edge>::iterator edgesIt;
-            for (edgesIt = edges.begin(); edgesIt != edges.end(); ++edgesIt)
+            EdgeListType::iterator* edgesIt = edgeMap.ChangeSeek(*faceEdgesIt);
+            if (edgesIt)
             {
-                if ((*edgesIt).IsSame(*faceEdgesIt))
-                {
-                    edgesIt = edges.erase(edgesIt);
-                    foundSignal = true;
-                    break;
-                }
+                edges.erase(*edgesIt);
+                edgeMap.UnBind(*faceEdgesIt);
+            }
+            else
+            {
+                edgeMap.Bind(*faceEdgesIt, edges.insert(edges.end(), *faceEdgesIt));
             }
-            if (!foundSignal)
-                edges.push_back(*faceEdgesIt);
         }
     }
 
@@ -299,18 +305,46 @@ GeomAbs_SurfaceType FaceTypedBase::getFaceType(const TopoDS_Face &faceIn)
 
 void FaceTypedBase::boundarySplit(const FaceVectorType &facesIn, std::vector<EdgeVectorType> &boundariesOut) const
 {
-    EdgeVectorType bEdges;
-    boundaryEdges(facesIn, bEdges);
+    EdgeVectorType edges;
+    boundaryEdges(facesIn, edges);
+
+    //bucket the edges by their first vertex. The buckets are in ascending edge order so
+    //that the first unused entry is the edge a linear search would have found.
+    TopTools_IndexedMapOfShape vertexMap;
+    std::vector<std::vector<std::size_t>> buckets;
+    std::vector<TopoDS_Vertex> lastVertices(edges.size());
+    for (std::size_t index = 0; index < edges.size(); ++index)
+    {
+        int vertexIndex = vertexMap.Add(TopExp::FirstVertex(edges[index], Standard_True));
+        if (static_cast<std::size_t>(vertexIndex) > buckets.size())
+            buckets.resize(vertexIndex);
+        buckets[vertexIndex - 1].push_back(index);
+        lastVertices[index] = TopExp::LastVertex(edges[index], Standard_True);
+    }
+
+    std::vector<bool> used(edges.size(), false);
+    auto findNext = [&](const TopoDS_Vertex &vertex) -> std::size_t {
+        int vertexIndex = vertexMap.FindIndex(vertex);
+        if (vertexIndex > 0)
+        {
+            for (std::size_t index : buckets[vertexIndex - 1])
+            {
+                if (!used[index])
+                    return index;
+            }
+        }
+        return edges.size();
+    };
 
-    std::list<TopoDS_Edge> edges;
-    std::copy(bEdges.begin(), bEdges.end(), back_inserter(edges));
-    while(!edges.empty())
+    for (std::size_t start = 0; start < edges.size(); ++start)
     {
-        TopoDS_Vertex destination = TopExp::FirstVertex(edges.front(), Standard_True);
-        TopoDS_Vertex lastVertex = TopExp::LastVertex(edges.front(), Standard_True);
+        if (used[start])
+            continue;
+        used[start] = true;
+        TopoDS_Vertex destination = TopExp::FirstVertex(edges[start], Standard_True);
+        TopoDS_Vertex lastVertex = lastVertices[start];
         EdgeVectorType boundary;
-        boundary.push_back(edges.front());
-        edges.pop_front();
+        boundary.push_back(edges[start]);
         //single edge closed check.
         if (destination.IsSame(lastVertex))
         {
@@ -319,24 +353,16 @@ void FaceTypedBase::boundarySplit(const FaceVectorType &facesIn, std::vector<Edg
         }
 
         bool closedSignal(false);
-        std::list<TopoDS_Edge>::iterator it;
-        for (it = edges.begin(); it != edges.end();)
+        for (std::size_t next = findNext(lastVertex); next < edges.size(); next = findNext(lastVertex))
         {
-            TopoDS_Vertex currentVertex = TopExp::FirstVertex(*it, Standard_True);
-            if (lastVertex.IsSame(currentVertex))
+            used[next] = true;
+            boundary.push_back(edges[next]);
+            lastVertex = lastVertices[next];
+            if (lastVertex.IsSame(destination))
             {
-                boundary.push_back(*it);
-                lastVertex = TopExp::LastVertex(*it, Standard_True);
-                edges.erase(it);
-                it = edges.begin();
-                if (lastVertex.IsSame(destination))
-                {
-                    closedSignal = true;
-                    break;
-                }
-                continue;
+                closedSignal = true;
+                break;
             }
-            ++it;
         }
         if (closedSignal)
             boundariesOut.push_back(boundary);
@@ -1211,6 +1237,57 @@ bool FaceUniter::process()
 
 //BRepBuilderAPI_RefineModel implement a way to log all modifications on the faces
 
+namespace ModelRefine
+{
+    //Shells that share edges or vertices must not be processed concurrently because
+    //ShapeFix and FuseEdges update the geometry and tolerances of the shared sub-shapes.
+    bool haveSharedSubShapes(const std::vector<TopoDS_Shell> &shells)
+    {
+        for (TopAbs_ShapeEnum type : {TopAbs_EDGE, TopAbs_VERTEX})
+        {
+            TopTools_DataMapOfShapeInteger owners;
+            for (std::size_t index = 0; index < shells.size(); ++index)
+            {
+                TopExp_Explorer xp;
+                for (xp.Init(shells[index], type); xp.More(); xp.Next())
+                {
+                    const Standard_Integer* owner = owners.Seek(xp.Current());
+                    if (!owner)
+                        owners.Bind(xp.Current(), static_cast<Standard_Integer>(index));
+                    else if (*owner != static_cast<Standard_Integer>(index))
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    //Independent shells are united concurrently. The modifications are logged afterwards
+    //in the original order. The faces of one shell are always united by one thread because
+    //neighbouring face groups share the boundary edges that ShapeFix writes to.
+    //If a shell raises an exception the first one in shell order is rethrown when all are
+    //done, as the sequential loop would do.
+    std::vector<char> processUniters(std::vector<FaceUniter> &uniters, bool sequential)
+    {
+        std::vector<char> done(uniters.size(), 0);
+        std::vector<std::exception_ptr> errors(uniters.size());
+        OSD_Parallel::For(0, static_cast<int>(uniters.size()), [&](int index) {
+            try {
+                done[index] = uniters[index].process() ? 1 : 0;
+            }
+            catch (...) {
+                // an exception must not escape a worker thread
+                errors[index] = std::current_exception();
+            }
+        }, sequential);
+        for (const auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+        return done;
+    }
+}
+
 Part::BRepBuilderAPI_RefineModel::BRepBuilderAPI_RefineModel(const TopoDS_Shape& shape)
 {
     myShape = shape;
@@ -1228,19 +1305,28 @@ void Part::BRepBuilderAPI_RefineModel::Build()
 
     if (myShape.ShapeType() == TopAbs_SOLID) {
         const TopoDS_Solid &solid = TopoDS::Solid(myShape);
-        BRepBuilderAPI_MakeSolid mkSolid;
+        std::vector<TopoDS_Shell> shells;
+        std::vector<ModelRefine::FaceUniter> uniters;
         TopExp_Explorer it;
         for (it.Init(solid, TopAbs_SHELL); it.More(); it.Next()) {
-            const TopoDS_Shell &currentShell = TopoDS::Shell(it.Current());
-            ModelRefine::FaceUniter uniter(currentShell);
-            if (uniter.process()) {
+            shells.push_back(TopoDS::Shell(it.Current()));
+            uniters.emplace_back(shells.back());
+        }
+
+        bool sequential = ModelRefine::haveSharedSubShapes(shells);
+        std::vector<char> done = ModelRefine::processUniters(uniters, sequential);
+
+        BRepBuilderAPI_MakeSolid mkSolid;
+        for (std::size_t index = 0; index < uniters.size(); ++index) {
+            ModelRefine::FaceUniter& uniter = uniters[index];
+            if (done[index]) {
                 if (uniter.isModified()) {
                     const TopoDS_Shell &newShell = uniter.getShell();
                     mkSolid.Add(newShell);
                     LogModifications(uniter);
                 }
                 else {
-                    mkSolid.Add(currentShell);
+                    mkSolid.Add(shells[index]);
                 }
             }
             else {
@@ -1267,32 +1353,57 @@ void Part::BRepBuilderAPI_RefineModel::Build()
         builder.MakeCompound(comp);
 
         TopExp_Explorer xp;
-        // solids
+        // collect the shells of the solids and the free shells and process them all at once
+        std::vector<TopoDS_Solid> solids;
+        std::vector<TopoDS_Shell> shells;
+        std::vector<std::size_t> solidOfShell;
         for (xp.Init(myShape, TopAbs_SOLID); xp.More(); xp.Next()) {
-            const TopoDS_Solid &solid = TopoDS::Solid(xp.Current());
-            BRepTools_ReShape reshape;
+            solids.push_back(TopoDS::Solid(xp.Current()));
             TopExp_Explorer it;
-            for (it.Init(solid, TopAbs_SHELL); it.More(); it.Next()) {
-                const TopoDS_Shell &currentShell = TopoDS::Shell(it.Current());
-                ModelRefine::FaceUniter uniter(currentShell);
-                if (uniter.process()) {
+            for (it.Init(solids.back(), TopAbs_SHELL); it.More(); it.Next()) {
+                shells.push_back(TopoDS::Shell(it.Current()));
+                solidOfShell.push_back(solids.size() - 1);
+            }
+        }
+        std::size_t numSolidShells = shells.size();
+        for (xp.Init(myShape, TopAbs_SHELL, TopAbs_SOLID); xp.More(); xp.Next()) {
+            shells.push_back(TopoDS::Shell(xp.Current()));
+        }
+
+        std::vector<ModelRefine::FaceUniter> uniters;
+        uniters.reserve(shells.size());
+        for (const auto& shell : shells) {
+            uniters.emplace_back(shell);
+        }
+        bool sequential = ModelRefine::haveSharedSubShapes(shells);
+        std::vector<char> done = ModelRefine::processUniters(uniters, sequential);
+
+        // solids
+        std::size_t index = 0;
+        for (std::size_t solidIndex = 0; solidIndex < solids.size(); ++solidIndex) {
+            BRepTools_ReShape reshape;
+            for (; index < numSolidShells && solidOfShell[index] == solidIndex; ++index) {
+                ModelRefine::FaceUniter& uniter = uniters[index];
+                if (done[index]) {
                     if (uniter.isModified()) {
                         const TopoDS_Shell &newShell = uniter.getShell();
-                        reshape.Replace(currentShell, newShell);
+                        reshape.Replace(shells[index], newShell);
                         LogModifications(uniter);
                     }
                 }
             }
-            builder.Add(comp, reshape.Apply(solid));
+            builder.Add(comp, reshape.Apply(solids[solidIndex]));
         }
-        // free shells
-        for (xp.Init(myShape, TopAbs_SHELL, TopAbs_SOLID); xp.More(); xp.Next()) {
-            const TopoDS_Shell& shell = TopoDS::Shell(xp.Current());
-            ModelRefine::FaceUniter uniter(shell);
-            if (uniter.process()) {
+        // free shells, a shell that cannot be refined is kept as it is
+        for (; index < shells.size(); ++index) {
+            ModelRefine::FaceUniter& uniter = uniters[index];
+            if (done[index]) {
                 builder.Add(comp, uniter.getShell());
                 LogModifications(uniter);
             }
+            else {
+                builder.Add(comp, shells[index]);
+            }
         }
         // the rest
         for (xp.Init(myShape, TopAbs_FACE, TopAbs_SHELL); xp.More(); xp.Next()) {
@@ -1328,7 +1439,7 @@ void Part::BRepBuilderAPI_RefineModel::LogModifications(const ModelRefine::FaceU
     }
     const ShapeVectorType& delShapes = uniter.getDeletedShapes();
     for (const auto & it : delShapes) {
-        myDeleted.Append(it);
+        myDeleted.Add(it);
     }
 }
 
@@ -1342,13 +1453,6 @@ const TopTools_ListOfShape& Part::BRepBuilderAPI_RefineModel::Modified(const Top
 
 Standard_Boolean Part::BRepBuilderAPI_RefineModel::IsDeleted(const TopoDS_Shape& S)
 {
-    TopTools_ListIteratorOfListOfShape it;
-    for (it.Initialize(myDeleted); it.More(); it.Next())
-    {
-        if (it.Value().IsSame(S))
-            return Standard_True;
-    }
-
-    return Standard_False;
+    return myDeleted.Contains(S);
 }
 
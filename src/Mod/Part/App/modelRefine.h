@@ -52,6 +52,8 @@ namespace ModelRefine
     void getFaceEdges(const TopoDS_Face &face, EdgeVectorType &edges);
     void boundaryEdges(const FaceVectorType &faces, EdgeVectorType &edgesOut);
     TopoDS_Shell removeFaces(const TopoDS_Shell &shell, const FaceVectorType &faces);
+    //Returns true if any two of the shells share an edge or a vertex.
+    PartExport bool haveSharedSubShapes(const std::vector<TopoDS_Shell> &shells);
 
     class FaceTypedBase
     {
@@ -213,7 +215,7 @@ private:
 private:
     TopTools_DataMapOfShapeListOfShape myModified;
     TopTools_ListOfShape myEmptyList;
-    TopTools_ListOfShape myDeleted;
+    TopTools_MapOfShape myDeleted;
 };
 }
 
@@ -44,6 +44,7 @@ DlgImportStep::DlgImportStep(QWidget* parent)
     ui->checkBoxUseBaseName->setChecked(settings.getUseBaseName());
     ui->checkBoxReduceObjects->setChecked(settings.getReduceObjects());
     ui->checkBoxExpandCompound->setChecked(settings.getExpandCompound());
+    ui->checkBoxDedupSolids->setChecked(settings.getDedupSolids());
     ui->checkBoxShowProgress->setChecked(settings.getShowProgress());
 }
 
@@ -61,6 +62,7 @@ void DlgImportStep::saveSettings()
     ui->checkBoxUseBaseName->onSave();
     ui->checkBoxReduceObjects->onSave();
     ui->checkBoxExpandCompound->onSave();
+    ui->checkBoxDedupSolids->onSave();
     ui->checkBoxShowProgress->onSave();
     ui->comboBoxImportMode->onSave();
 }
@@ -74,6 +76,7 @@ void DlgImportStep::loadSettings()
     ui->checkBoxUseBaseName->onRestore();
     ui->checkBoxReduceObjects->onRestore();
     ui->checkBoxExpandCompound->onRestore();
+    ui->checkBoxDedupSolids->onRestore();
     ui->checkBoxShowProgress->onRestore();
     ui->comboBoxImportMode->onRestore();
 }
@@ -39,6 +39,7 @@
 # include <BRepAdaptor_Curve.hxx>
 # include <BRepAdaptor_Surface.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeEdge.hxx>
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
@@ -72,6 +73,7 @@
 #include <App/Application.h>
 #include <App/Document.h>
 #include <Base/Exception.h>
+#include <Base/Parallel.h>
 #include <Mod/Part/App/CrossSection.h>
 #include <Mod/Part/App/FaceMakerBullseye.h>
 #include <Mod/Part/App/PartFeature.h>
@@ -159,7 +161,7 @@ CAreaConfig::~CAreaConfig() {
 
 TYPESYSTEM_SOURCE(Path::Area, Base::BaseClass)
 
-bool Area::s_aborting;
+std::atomic<bool> Area::s_aborting;
 
 Area::Area(const AreaParams* params)
     :myParams(s_params)
@@ -1380,6 +1382,41 @@ int Area::project(TopoDS_Shape& shape_out,
     return skips;
 }
 
+/** Returns the libarea settings of the calling thread */
+static CAreaParams currentCAreaParams() {
+    CAreaParams params;
+
+#define AREA_CONF_GET(_param) \
+    params.PARAM_FNAME(_param) = BOOST_PP_CAT(CArea::get_,PARAM_FARG(_param))();
+
+    PARAM_FOREACH(AREA_CONF_GET, AREA_PARAMS_CAREA);
+    return params;
+}
+
+/** Calls func(i) for each i in [0, count) concurrently
+ *
+ * Each call must only touch its own data. The first exception in index order
+ * is rethrown once all calls are done. Shape debugging adds document objects,
+ * so everything runs in the calling thread when tracing.
+ *
+ * The libarea settings are per thread, so each call runs with the settings of
+ * the calling thread instead of the defaults of the worker.
+ */
+template<class Func>
+static void parallelFor(std::size_t count, Func func) {
+    bool serial = FC_LOG_INSTANCE.level() > FC_LOGLEVEL_TRACE;
+    const CAreaParams settings = currentCAreaParams();
+    // every section is expensive, so each one is a block of its own
+    Base::parallelFor(count, [&](std::size_t i) {
+        if (Area::aborting())
+            return;
+        CAreaConfig conf(settings, /*no_fit_arcs*/ false);
+        func(i);
+    }, serial ? count : 1);
+    if (Area::aborting())
+        throw Base::AbortException("Area operation aborted");
+}
+
 std::vector<shared_ptr<Area> > Area::makeSections(
     PARAM_ARGS(PARAM_FARG, AREA_PARAMS_SECTION_EXTRA),
     const std::vector<double>& _heights,
@@ -1396,7 +1433,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     if (plane.IsNull())
         throw Base::ValueError("failed to obtain section plane");
 
-    FC_TIME_INIT2(t, t1);
+    FC_TIME_INIT(t);
 
     TopLoc_Location loc(trsf);
 
@@ -1531,7 +1568,11 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     bool can_retry = fabs(tolerance) > Precision::Confusion();
     TopLoc_Location locInverse(loc.Inverted());
 
-    for (size_t i = 0; i < heights.size(); ++i) {
+    // Each height is sliced independently, the sections are then collected
+    // in height order with the empty ones discarded
+    std::vector<shared_ptr<Area> > results(heights.size());
+    parallelFor(heights.size(), [&](std::size_t i) {
+        FC_TIME_INIT(t1);
         double z = heights[i];
         bool retried = !can_retry;
         while (true) {
@@ -1550,9 +1591,11 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                     gp_Trsf t;
                     t.SetTranslation(gp_Vec(0, 0, -d));
                     TopLoc_Location wloc(t);
-                    area->add(s.shape.Moved(wloc).Moved(locInverse), s.op);
+                    // copied so that no two sections share any geometry
+                    TopoDS_Shape shape = BRepBuilderAPI_Copy(s.shape).Shape();
+                    area->add(shape.Moved(wloc).Moved(locInverse), s.op);
                 }
-                sections.push_back(area);
+                results[i] = area;
                 break;
             }
 
@@ -1562,7 +1605,10 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 TopoDS_Compound comp;
                 builder.MakeCompound(comp);
 
-                for (TopExp_Explorer xp(s.shape.Moved(loc), TopAbs_SOLID); xp.More(); xp.Next()) {
+                // the section is a boolean operation on the solid, and the
+                // heights run concurrently, so each one cuts its own copy
+                TopoDS_Shape solids = BRepBuilderAPI_Copy(s.shape.Moved(loc)).Shape();
+                for (TopExp_Explorer xp(solids, TopAbs_SOLID); xp.More(); xp.Next()) {
                     showShape(xp.Current(), nullptr, "section_%u_shape", i);
                     std::list<TopoDS_Wire> wires;
                     Part::CrossSection section(a, b, c, xp.Current());
@@ -1623,7 +1669,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 }
             }
             if (!area->myShapes.empty()) {
-                sections.push_back(area);
+                results[i] = area;
                 FC_TIME_LOG(t1, "makeSection " << z);
                 showShape(area->getShape(), nullptr, "section_%u_final", i);
                 break;
@@ -1638,6 +1684,10 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 retried = true;
             }
         }
+    });
+    for (auto& area : results) {
+        if (area)
+            sections.push_back(area);
     }
     FC_TIME_LOG(t, "makeSection count: " << sections.size() << ", total");
     return sections;
@@ -1830,11 +1880,14 @@ TopoDS_Shape Area::toShape(CArea& area, short fill, int reorient) {
         if(_index>=(int)mySections.size())\
             return TopoDS_Shape();\
         if(_index<0) {\
+            std::vector<TopoDS_Shape> shapes(mySections.size());\
+            parallelFor(mySections.size(), [&](std::size_t i) {\
+                shapes[i] = mySections[i]->_op(_index, ## __VA_ARGS__);\
+            });\
             BRep_Builder builder;\
             TopoDS_Compound compound;\
             builder.MakeCompound(compound);\
-            for(shared_ptr<Area> area : mySections){\
-                const TopoDS_Shape &s = area->_op(_index, ## __VA_ARGS__);\
+            for(const TopoDS_Shape &s : shapes){\
                 if(s.IsNull()) continue;\
                 builder.Add(compound,s);\
             }\
@@ -3269,14 +3322,20 @@ static inline void addParameter(bool verbose, Command& cmd, const char* name,
         cmd.Parameters[name] = relative ? d : next;
 }
 
-static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
+static inline void setGCode(bool verbose, Command& cmd, const gp_Pnt& last,
     const gp_Pnt& next, const char* name)
 {
-    Command cmd;
     cmd.Name = name;
     addParameter(verbose, cmd, "X", last.X(), next.X());
     addParameter(verbose, cmd, "Y", last.Y(), next.Y());
     addParameter(verbose, cmd, "Z", last.Z(), next.Z());
+}
+
+static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
+    const gp_Pnt& next, const char* name)
+{
+    Command cmd;
+    setGCode(verbose, cmd, last, next, name);
     path.addCommand(cmd);
     return;
 }
@@ -3284,12 +3343,13 @@ static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
 static inline void addG1(bool verbose, Toolpath& path, const gp_Pnt& last,
     const gp_Pnt& next, double f, double& last_f)
 {
-    addGCode(verbose, path, last, next, "G1");
+    Command cmd;
+    setGCode(verbose, cmd, last, next, "G1");
     if (f > Precision::Confusion()) {
-        Command* cmd = path.getCommands().back();
-        addParameter(verbose, *cmd, "F", last_f, f);
+        addParameter(verbose, cmd, "F", last_f, f);
         last_f = f;
     }
+    path.addCommand(cmd);
     return;
 }
 
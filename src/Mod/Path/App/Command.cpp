@@ -23,6 +23,8 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <cinttypes>
+# include <cstdint>
+# include <cstdlib>
 # include <iomanip>
 # include <boost/algorithm/string.hpp>
 #endif
@@ -106,7 +108,7 @@ std::string Command::toGCode (int precision, bool padzero) const
         precision = 0;
     double scale = std::pow(10.0,precision+1);
     std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
-    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+    for(CommandParameters::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         if(i->first == "N") continue;
 
         str << " " << i->first;
@@ -135,70 +137,125 @@ std::string Command::toGCode (int precision, bool padzero) const
     return str.str();
 }
 
-void Command::setFromGCode (const std::string& str)
+namespace {
+
+// The character classes of the C locale, which setFromGCode() always used
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isAlpha(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char toUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// Converts the value of a parameter, which only holds digits, '-' and '.',
+// with the same result as std::atof(). Numbers with up to 15 significant
+// digits and 22 decimals are converted exactly with a single division,
+// anything else is handed to std::atof().
+double parseNumber(std::string_view str)
+{
+    static const double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    auto pos = str.begin();
+    bool negative = pos != str.end() && *pos == '-';
+    if (negative)
+        ++pos;
+
+    std::uint64_t mantissa = 0;
+    int significant = 0;
+    int decimals = 0;
+    bool found = false;
+    bool fraction = false;
+    for (; pos != str.end(); ++pos) {
+        if (*pos == '.' && !fraction) {
+            fraction = true;
+            continue;
+        }
+        if (!isDigit(*pos))
+            break;
+        found = true;
+        if (fraction)
+            ++decimals;
+        if (significant || *pos != '0') {
+            mantissa = mantissa * 10 + (*pos - '0');
+            ++significant;
+        }
+        if (significant > 15 || decimals > 22)
+            return std::atof(std::string(str).c_str());
+    }
+    if (!found)
+        return 0.0;
+    double value = static_cast<double>(mantissa) / powers[decimals];
+    return negative ? -value : value;
+}
+
+} // namespace
+
+void Command::setFromGCode (std::string_view str)
 {
+    enum class Mode { None, Command, Argument, Comment };
+
     Parameters.clear();
-    std::string mode = "none";
-    std::string key;
+    Mode mode = Mode::None;
+    // the letter of the current word, '(' after a closing bracket
+    char key = 0;
     std::string value;
-    for (unsigned int i=0; i < str.size(); i++) {
-        if ( (isdigit(str[i])) || (str[i] == '-') || (str[i] == '.') ) {
-            value += str[i];
-        } else if (isalpha(str[i])) {
-            if (mode == "command") {
-                if (!key.empty() && !value.empty()) {
-                    std::string cmd = key + value;
-                    boost::to_upper(cmd);
-                    Name = cmd;
-                    key = "";
-                    value = "";
-                    mode = "argument";
-                } else {
+    auto setName = [this, &key, &value](bool upper) {
+        Name.assign(1, upper ? toUpper(key) : key);
+        for (char c : value)
+            Name += upper ? toUpper(c) : c;
+    };
+    for (char c : str) {
+        if (isDigit(c) || c == '-' || c == '.') {
+            value += c;
+        } else if (isAlpha(c)) {
+            switch (mode) {
+            case Mode::Command:
+                if (!key || value.empty())
                     throw Base::BadFormatError("Badly formatted GCode command");
-                }
-                mode = "argument";
-            } else if (mode == "none") {
-                mode = "command";
-            } else if (mode == "argument") {
-                if (!key.empty() && !value.empty()) {
-                    double val = std::atof(value.c_str());
-                    boost::to_upper(key);
-                    Parameters[key] = val;
-                    key = "";
-                    value = "";
-                } else {
+                setName(true);
+                value.clear();
+                mode = Mode::Argument;
+                break;
+            case Mode::None:
+                mode = Mode::Command;
+                break;
+            case Mode::Argument:
+                if (!key || value.empty())
                     throw Base::BadFormatError("Badly formatted GCode argument");
-                }
-            } else if (mode == "comment") {
-                value += str[i];
+                Parameters[std::string(1, toUpper(key))] = parseNumber(value);
+                value.clear();
+                break;
+            case Mode::Comment:
+                value += c;
+                break;
             }
-            key = str[i];
-        } else if (str[i] == '(') {
-            mode = "comment";
-        } else if (str[i] == ')') {
-            key = "(";
-            value += ")";
-        } else {
+            key = c;
+        } else if (c == '(') {
+            mode = Mode::Comment;
+        } else if (c == ')') {
+            key = '(';
+            value += ')';
+        } else if (mode == Mode::Comment) {
             // add non-ascii characters only if this is a comment
-            if (mode == "comment") {
-                value += str[i];
-            }
+            value += c;
         }
     }
-    if (!key.empty() && !value.empty()) {
-        if ( (mode == "command") || (mode == "comment") ) {
-            std::string cmd = key + value;
-            if (mode == "command")
-                boost::to_upper(cmd);
-            Name = cmd;
-        } else {
-            double val = std::atof(value.c_str());
-            boost::to_upper(key);
-            Parameters[key] = val;
-        }
-    } else {
+    if (!key || value.empty())
         throw Base::BadFormatError("Badly formatted GCode argument");
-    }
+    if (mode == Mode::Command || mode == Mode::Comment)
+        setName(mode == Mode::Command);
+    else
+        Parameters[std::string(1, toUpper(key))] = parseNumber(value);
 }
 
 void Command::setFromPlacement (const Base::Placement &plac)
@@ -249,7 +306,7 @@ void Command::setCenter(const Base::Vector3d &pos, bool clockwise)
     Parameters[k] = kval;
 }
 
-Command Command::transform(const Base::Placement& other)
+Command Command::transform(const Base::Placement& other) const
 {
     Base::Placement plac = getPlacement();
     plac *= other;
@@ -260,8 +317,8 @@ Command Command::transform(const Base::Placement& other)
     plac.getRotation().getYawPitchRoll(aval,bval,cval);
     Command c = Command();
     c.Name = Name;
-    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
-        std::string k = i->first;
+    for(CommandParameters::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+        const std::string &k = i->first;
         double v = i->second;
         if (k == "X")
             v = xval;
@@ -282,7 +339,7 @@ Command Command::transform(const Base::Placement& other)
 
 void Command::scaleBy(double factor)
 {
-    for(std::map<std::string, double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+    for(CommandParameters::iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         switch (i->first[0]) {
             case 'X':
             case 'Y':
@@ -292,7 +349,7 @@ void Command::scaleBy(double factor)
             case 'R':
             case 'Q':
             case 'F':
-                Parameters[i->first] = i->second * factor;
+                i->second *= factor;
                 break;
         }
     }
@@ -24,8 +24,13 @@
 #ifndef PATH_COMMAND_H
 #define PATH_COMMAND_H
 
+#include <algorithm>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <Base/Persistence.h>
 #include <Base/Placement.h>
 #include <Base/Vector3D.h>
@@ -33,6 +38,94 @@
 
 namespace Path
 {
+    /** The parameters of a cnc command
+     * A flat map sorted by name, so that it iterates in the same order as
+     * std::map. A command carries only a few parameters, which are stored
+     * in a single allocation instead of a tree node per parameter.
+     */
+    class CommandParameters
+    {
+    public:
+        using value_type = std::pair<std::string,double>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        CommandParameters() = default;
+        // converts from and to the std::map that was used before
+        CommandParameters(const std::map<std::string,double>& parameters)
+            : values(parameters.begin(), parameters.end()) {}
+        operator std::map<std::string,double>() const {
+            return std::map<std::string,double>(values.begin(), values.end());
+        }
+
+        iterator begin() { return values.begin(); }
+        iterator end() { return values.end(); }
+        const_iterator begin() const { return values.begin(); }
+        const_iterator end() const { return values.end(); }
+        bool empty() const { return values.empty(); }
+        std::size_t size() const { return values.size(); }
+        void clear() { values.clear(); }
+
+        iterator find(const std::string &name) {
+            auto it = lowerBound(name);
+            return (it != values.end() && it->first == name) ? it : values.end();
+        }
+        const_iterator find(const std::string &name) const {
+            auto it = lowerBound(name);
+            return (it != values.end() && it->first == name) ? it : values.end();
+        }
+        std::size_t count(const std::string &name) const {
+            return find(name) != end() ? 1 : 0;
+        }
+        double &at(const std::string &name) {
+            auto it = find(name);
+            if (it == values.end())
+                throw std::out_of_range(name);
+            return it->second;
+        }
+        double at(const std::string &name) const {
+            auto it = find(name);
+            if (it == values.end())
+                throw std::out_of_range(name);
+            return it->second;
+        }
+        std::pair<iterator,bool> insert(const value_type &value) {
+            auto it = lowerBound(value.first);
+            if (it != values.end() && it->first == value.first)
+                return {it, false};
+            return {values.insert(it, value), true};
+        }
+        double &operator[](const std::string &name) {
+            auto it = lowerBound(name);
+            if (it == values.end() || it->first != name)
+                it = values.emplace(it, name, 0.0);
+            return it->second;
+        }
+        std::size_t erase(const std::string &name) {
+            auto it = find(name);
+            if (it == values.end())
+                return 0;
+            values.erase(it);
+            return 1;
+        }
+
+        bool operator==(const CommandParameters &other) const { return values == other.values; }
+        bool operator!=(const CommandParameters &other) const { return values != other.values; }
+
+    private:
+        static bool lessName(const value_type &v, const std::string &name) {
+            return v.first < name;
+        }
+        iterator lowerBound(const std::string &name) {
+            return std::lower_bound(values.begin(), values.end(), name, lessName);
+        }
+        const_iterator lowerBound(const std::string &name) const {
+            return std::lower_bound(values.begin(), values.end(), name, lessName);
+        }
+
+        std::vector<value_type> values;
+    };
+
     /** The representation of a cnc command in a path */
     class PathExport Command : public Base::Persistence
     {
@@ -43,7 +136,11 @@ namespace Path
         Command();
         Command(const char* name,
                 const std::map<std::string,double>& parameters);
+        Command(const Command&) = default;
+        Command(Command&&) = default;
         ~Command() override;
+        Command &operator=(const Command&) = default;
+        Command &operator=(Command&&) = default;
         // from base class
         unsigned int getMemSize () const override;
         void Save (Base::Writer &/*writer*/) const override;
@@ -54,10 +151,10 @@ namespace Path
         Base::Vector3d getCenter () const; // returns a 3d vector from the i,j,k parameters
         void setCenter(const Base::Vector3d&, bool clockwise=true); // sets the center coordinates and the command name
         std::string toGCode (int precision=6, bool padzero=true) const; // returns a GCode string representation of the command
-        void setFromGCode (const std::string&); // sets the parameters from the contents of the given GCode string
+        void setFromGCode (std::string_view); // sets the parameters from the contents of the given GCode string
         void setFromPlacement (const Base::Placement&); // sets the parameters from the contents of the given placement
         bool has(const std::string&) const; // returns true if the given string exists in the parameters
-        Command transform(const Base::Placement&); // returns a transformed copy of this command
+        Command transform(const Base::Placement&) const; // returns a transformed copy of this command
         double getValue(const std::string &name) const; // returns the value of a given parameter
         void scaleBy(double factor); // scales the receiver - use for imperial/metric conversions
 
@@ -69,7 +166,7 @@ namespace Path
 
         // attributes
         std::string Name;
-        std::map<std::string,double> Parameters;
+        CommandParameters Parameters;
     };
 
 } //namespace Path
@@ -21,9 +21,19 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <cstring>
+# include <exception>
+# include <iterator>
+# include <sstream>
+# include <unordered_map>
+#endif
 
 #include <App/Application.h>
 #include <Base/Console.h>
+#include <Base/Parallel.h>
 #include <Base/Reader.h>
 #include <Base/Stream.h>
 #include <Base/Writer.h>
@@ -37,21 +47,38 @@ using namespace Base;
 
 TYPESYSTEM_SOURCE(Path::Toolpath , Base::Persistence)
 
+// Writes the G-code of a toolpath, which is the default file format because
+// documents with the binary file can't be opened by older versions.
+class Toolpath::GCodeFile : public Base::Persistence
+{
+public:
+    explicit GCodeFile(const Toolpath &path) : path(path) {}
+
+    unsigned int getMemSize () const override { return 0; }
+    void Save (Base::Writer &) const override {}
+    void Restore(Base::XMLReader &) override {}
+    void SaveDocFile (Base::Writer &writer) const override
+    {
+        writer.Stream() << path.toGCode();
+    }
+
+private:
+    const Toolpath &path;
+};
+
 Toolpath::Toolpath()
 {
 }
 
 Toolpath::Toolpath(const Toolpath& otherPath)
-    : vpcCommands(otherPath.vpcCommands.size())
+    : vCommands(otherPath.vCommands)
     , center(otherPath.center)
 {
-    *this = otherPath;
     recalculate();
 }
 
 Toolpath::~Toolpath()
 {
-    clear();
 }
 
 Toolpath &Toolpath::operator=(const Toolpath& otherPath)
@@ -59,29 +86,34 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
     if (this == &otherPath)
         return *this;
 
-    clear();
-    vpcCommands.resize(otherPath.vpcCommands.size());
-    int i = 0;
-    for (std::vector<Command*>::const_iterator it=otherPath.vpcCommands.begin();it!=otherPath.vpcCommands.end();++it,i++) {
-        vpcCommands[i] = new Command(**it);
-    }
+    vCommands = otherPath.vCommands;
     center = otherPath.center;
     recalculate();
     return *this;
 }
 
+const std::vector<Command*> &Toolpath::getCommands() const
+{
+    // the addresses only change if the vector was resized or reallocated
+    if (commandPointers.size() != vCommands.size()
+            || (!vCommands.empty() && commandPointers.front() != &vCommands.front())) {
+        commandPointers.clear();
+        commandPointers.reserve(vCommands.size());
+        for (const Command &cmd : vCommands)
+            commandPointers.push_back(const_cast<Command*>(&cmd));
+    }
+    return commandPointers;
+}
+
 void Toolpath::clear()
 {
-    for(std::vector<Command*>::iterator it = vpcCommands.begin();it!=vpcCommands.end();++it)
-        delete ( *it );
-    vpcCommands.clear();
+    vCommands.clear();
     recalculate();
 }
 
 void Toolpath::addCommand(const Command &Cmd)
 {
-    Command *tmp = new Command(Cmd);
-    vpcCommands.push_back(tmp);
+    vCommands.push_back(Cmd);
     recalculate();
 }
 
@@ -89,9 +121,8 @@ void Toolpath::insertCommand(const Command &Cmd, int pos)
 {
     if (pos == -1) {
         addCommand(Cmd);
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        Command *tmp = new Command(Cmd);
-        vpcCommands.insert(vpcCommands.begin()+pos,tmp);
+    } else if (pos <= static_cast<int>(vCommands.size())) {
+        vCommands.insert(vCommands.begin()+pos,Cmd);
     } else {
         throw Base::IndexError("Index not in range");
     }
@@ -101,10 +132,10 @@ void Toolpath::insertCommand(const Command &Cmd, int pos)
 void Toolpath::deleteCommand(int pos)
 {
     if (pos == -1) {
-        //delete(*vpcCommands.rbegin()); // causes crash
-        vpcCommands.pop_back();
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        vpcCommands.erase (vpcCommands.begin()+pos);
+        if (!vCommands.empty())
+            vCommands.pop_back();
+    } else if (pos < static_cast<int>(vCommands.size())) {
+        vCommands.erase (vCommands.begin()+pos);
     } else {
         throw Base::IndexError("Index not in range");
     }
@@ -113,21 +144,21 @@ void Toolpath::deleteCommand(int pos)
 
 double Toolpath::getLength()
 {
-    if(vpcCommands.empty())
+    if(vCommands.empty())
         return 0;
     double l = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        next = (*it)->getPlacement(last).getPosition();
+    for(std::vector<Command>::const_iterator it = vCommands.begin();it!=vCommands.end();++it) {
+        const std::string &name = it->Name;
+        next = it->getPlacement(last).getPosition();
         if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
             // straight line
             l += (next - last).Length();
             last = next;
         } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
             // arc
-            Vector3d center = (*it)->getCenter();
+            Vector3d center = it->getCenter();
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -156,7 +187,7 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
         vRapid = vFeed;
     }
 
-    if (vpcCommands.empty()) {
+    if (vCommands.empty()) {
         return 0;
     }
     double l = 0;
@@ -164,14 +195,13 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
     bool verticalMove = false;
     Vector3d last(0,0,0);
     Vector3d next;
-    for (std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        float feedrate = (*it)->getParam("F");
+    for (std::vector<Command>::const_iterator it = vCommands.begin();it!=vCommands.end();++it) {
+        const std::string &name = it->Name;
+        float feedrate = hFeed;
 
         l = 0;
         verticalMove = false;
-        feedrate = hFeed;
-        next = (*it)->getPlacement(last).getPosition();
+        next = it->getPlacement(last).getPosition();
 
         if (last.z != next.z){
             verticalMove = true;
@@ -190,7 +220,7 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
             l += (next - last).Length();
         }else if ((name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
             // Arc Move
-            Vector3d center = (*it)->getCenter();
+            Vector3d center = it->getCenter();
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -274,82 +304,104 @@ Base::BoundBox3d Toolpath::getBoundBox() const
     return visitor.bb;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+// Splits a G-code string into the strings of its commands. A command starts
+// at a G or M letter or at a comment and anything before the first one is
+// ignored, as well as an unterminated comment.
+static void splitGCode(std::string_view str, std::vector<std::string_view> &commands)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
-        inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
-        inches = false;
-        delete cmd;
-    } else {
-        if (inches) {
-            cmd->scaleBy(25.4);
+    static const char *starts = "(gGmM";
+    bool comment = false;
+    std::size_t last = std::string_view::npos;
+    std::size_t found = str.find_first_of(starts);
+    while (found != std::string_view::npos) {
+        if (str[found] == '(') {
+            // start of comment, add the last found command before it
+            if (last != std::string_view::npos && !comment)
+                commands.push_back(str.substr(last, found - last));
+            comment = true;
+            last = found;
+            found = str.find(')', found + 1);
+        } else if (str[found] == ')') {
+            // end of comment
+            commands.push_back(str.substr(last, found - last + 1));
+            comment = false;
+            last = std::string_view::npos;
+            found = str.find_first_of(starts, found + 1);
+        } else {
+            if (last != std::string_view::npos)
+                commands.push_back(str.substr(last, found - last));
+            last = found;
+            found = str.find_first_of(starts, found + 1);
         }
-        commands.push_back(cmd);
     }
+    // add the last command found, if any
+    if (last != std::string_view::npos && !comment)
+        commands.push_back(str.substr(last));
 }
 
-void Toolpath::setFromGCode(const std::string instr)
+void Toolpath::setFromGCode(std::string_view str)
 {
     clear();
 
-    // remove comments
-    //boost::regex e("\\(.*?\\)");
-    //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
-
-    // split input string by () or G or M commands
-    std::string mode = "command";
-    std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
-    bool inches = false;
-    while (found != std::string::npos)
-    {
-        if (str[found] == '(') {
-            // start of comment
-            if ( (last > -1) && (mode == "command") ) {
-                // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+    std::vector<std::string_view> gcodes;
+    splitGCode(str, gcodes);
+
+    // The commands are independent of each other, so they are parsed in
+    // parallel in blocks. Only the first error in command order is reported.
+    const std::size_t blockSize = 4096;
+    std::size_t blocks = (gcodes.size() + blockSize - 1) / blockSize;
+    std::vector<Command> commands(gcodes.size());
+    std::vector<std::size_t> failures(blocks, gcodes.size());
+    std::vector<std::exception_ptr> errors(blocks);
+    Base::parallelForRange(gcodes.size(), [&](std::size_t begin, std::size_t end) {
+        std::size_t block = begin / blockSize;
+        for (std::size_t i = begin; i < end; ++i) {
+            try {
+                commands[i].setFromGCode(gcodes[i]);
             }
-            mode = "comment";
-            last = found;
-            found = str.find_first_of(')', found+1);
-        } else if (str[found] == ')') {
-            // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
-            found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
-            // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+            catch (...) {
+                failures[block] = i;
+                errors[block] = std::current_exception();
+                return;
             }
-            last = found;
-            found = str.find_first_of("(gGmM", found+1);
+        }
+    }, blockSize);
+
+    // Unit switches apply to the following commands, in order
+    std::size_t count = gcodes.size();
+    std::exception_ptr error;
+    for (std::size_t block = 0; block < blocks; ++block) {
+        if (errors[block]) {
+            count = failures[block];
+            error = errors[block];
+            break;
         }
     }
-    // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
+    vCommands.reserve(count);
+    bool inches = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        Command &cmd = commands[i];
+        if ("G20" == cmd.Name) {
+            inches = true;
+        } else if ("G21" == cmd.Name) {
+            inches = false;
+        } else {
+            if (inches) {
+                cmd.scaleBy(25.4);
+            }
+            vCommands.push_back(std::move(cmd));
         }
     }
+    if (error)
+        std::rethrow_exception(error);
     recalculate();
 }
 
 std::string Toolpath::toGCode() const
 {
     std::string result;
-    for (std::vector<Command*>::const_iterator it=vpcCommands.begin();it!=vpcCommands.end();++it) {
-        result += (*it)->toGCode();
+    for (std::vector<Command>::const_iterator it=vCommands.begin();it!=vCommands.end();++it) {
+        result += it->toGCode();
         result += "\n";
     }
     return result;
@@ -358,7 +410,7 @@ std::string Toolpath::toGCode() const
 void Toolpath::recalculate() // recalculates the path cache
 {
 
-    if(vpcCommands.empty())
+    if(vCommands.empty())
         return;
 
     // TODO recalculate the KDL stuff. At the moment, this is unused.
@@ -436,6 +488,257 @@ static void saveCenter(Writer &writer, const Base::Vector3d &center)
     writer.Stream() << writer.ind() << "<Center x=\"" << center.x << "\" y=\"" << center.y << "\" z=\"" << center.z << "\"/>" << std::endl;
 }
 
+// Binary toolpath file, all integers little endian:
+//
+//   "FCTP", uint32 format version
+//   uint32 name count, then per name uint32 length and the characters
+//   uint32 chunk count, then per chunk uint32 command count and byte size
+//   the chunks
+//
+// Command and parameter names are stored as varint indices into the name
+// table. A parameter value that is a multiple of 1e-6 is stored as the
+// zigzag varint of its difference to the previous value of the same
+// parameter, any other value as its 8 raw bytes. The previous values are
+// reset at each chunk, so that chunks can be decoded independently.
+
+namespace {
+
+const char BinaryMagic[] = "FCTP";
+const uint32_t BinaryVersion = 1;
+const std::size_t BinaryChunkSize = 4096;
+const double BinaryScale = 1e6;
+const double BinaryMaxScaled = 1e9;
+
+void writeVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint64_t readVarint(const char *&pos, const char *end)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos == end)
+            throw Base::BadFormatError("Truncated toolpath data");
+        auto byte = static_cast<unsigned char>(*pos++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw Base::BadFormatError("Invalid toolpath data");
+}
+
+uint64_t doubleBits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// returns true if value can be stored scaled and sets scaled accordingly
+bool scaleValue(double value, int64_t &scaled)
+{
+    if (!std::isfinite(value) || std::fabs(value) >= BinaryMaxScaled)
+        return false;
+    scaled = std::llround(value * BinaryScale);
+    return doubleBits(static_cast<double>(scaled) / BinaryScale) == doubleBits(value);
+}
+
+void writeValue(std::string &out, double value, int64_t &last)
+{
+    int64_t scaled;
+    if (scaleValue(value, scaled)) {
+        int64_t delta = scaled - last;
+        uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        writeVarint(out, zigzag << 1);
+        last = scaled;
+    }
+    else {
+        writeVarint(out, 1);
+        uint64_t bits = doubleBits(value);
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+        if (std::isfinite(value) && std::fabs(value) < BinaryMaxScaled)
+            last = std::llround(value * BinaryScale);
+    }
+}
+
+double readValue(const char *&pos, const char *end, int64_t &last)
+{
+    uint64_t tag = readVarint(pos, end);
+    if (tag & 1) {
+        if (end - pos < 8)
+            throw Base::BadFormatError("Truncated toolpath data");
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i)
+            bits |= static_cast<uint64_t>(static_cast<unsigned char>(*pos++)) << (8 * i);
+        double value = bitsDouble(bits);
+        if (std::isfinite(value) && std::fabs(value) < BinaryMaxScaled)
+            last = std::llround(value * BinaryScale);
+        return value;
+    }
+    uint64_t zigzag = tag >> 1;
+    int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    last += delta;
+    return static_cast<double>(last) / BinaryScale;
+}
+
+} // namespace
+
+void Toolpath::saveBinary(std::ostream &out) const
+{
+    std::unordered_map<std::string, uint32_t> index;
+    std::vector<const std::string*> names;
+    auto intern = [&](const std::string &name) {
+        auto res = index.emplace(name, static_cast<uint32_t>(names.size()));
+        if (res.second)
+            names.push_back(&res.first->first);
+        return res.first->second;
+    };
+
+    std::vector<std::string> chunks;
+    std::vector<uint32_t> counts;
+    std::vector<int64_t> last;
+    for (std::size_t first = 0; first < vCommands.size(); first += BinaryChunkSize) {
+        std::size_t count = std::min(BinaryChunkSize, vCommands.size() - first);
+        std::string data;
+        last.assign(names.size(), 0);
+        for (std::size_t i = first; i < first + count; ++i) {
+            const Command &cmd = vCommands[i];
+            writeVarint(data, intern(cmd.Name));
+            writeVarint(data, cmd.Parameters.size());
+            for (const auto &param : cmd.Parameters) {
+                uint32_t key = intern(param.first);
+                if (key >= last.size())
+                    last.resize(key + 1, 0);
+                writeVarint(data, key);
+                writeValue(data, param.second, last[key]);
+            }
+        }
+        chunks.push_back(std::move(data));
+        counts.push_back(static_cast<uint32_t>(count));
+    }
+
+    out.write(BinaryMagic, 4);
+    Base::OutputStream str(out);
+    str << BinaryVersion << static_cast<uint32_t>(names.size());
+    for (const std::string *name : names) {
+        str << static_cast<uint32_t>(name->size());
+        out.write(name->c_str(), name->size());
+    }
+    str << static_cast<uint32_t>(chunks.size());
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+        str << counts[i] << static_cast<uint32_t>(chunks[i].size());
+    for (const std::string &data : chunks)
+        out.write(data.c_str(), data.size());
+}
+
+void Toolpath::restoreBinary(const std::string &data)
+{
+    clear();
+
+    // All counts are checked against the size of the remaining data before
+    // anything is allocated, so a corrupt file can't request huge buffers.
+    std::istringstream in(data);
+    in.seekg(4);
+    Base::InputStream str(in);
+    auto remaining = [&]() -> std::size_t {
+        if (!in)
+            throw Base::BadFormatError("Truncated toolpath data");
+        return data.size() - static_cast<std::size_t>(in.tellg());
+    };
+
+    uint32_t version = 0, count = 0;
+    str >> version;
+    if (version > BinaryVersion)
+        throw Base::BadFormatError("Unsupported toolpath format version");
+
+    // each name takes at least its length
+    str >> count;
+    if (remaining() / sizeof(uint32_t) < count)
+        throw Base::BadFormatError("Truncated toolpath data");
+    std::vector<std::string> names(count);
+    for (std::string &name : names) {
+        uint32_t size = 0;
+        str >> size;
+        if (remaining() < size)
+            throw Base::BadFormatError("Truncated toolpath data");
+        name.resize(size);
+        in.read(&name[0], size);
+    }
+
+    // each chunk takes two integers in the index
+    str >> count;
+    if (remaining() / (2 * sizeof(uint32_t)) < count)
+        throw Base::BadFormatError("Truncated toolpath data");
+    std::vector<std::pair<uint32_t, uint32_t>> chunks(count);
+    std::size_t total = 0;
+    std::size_t size = 0;
+    for (auto &chunk : chunks) {
+        str >> chunk.first >> chunk.second;
+        // a command takes at least two bytes
+        if (chunk.first > chunk.second / 2)
+            throw Base::BadFormatError("Invalid toolpath data");
+        total += chunk.first;
+        size += chunk.second;
+    }
+    if (remaining() < size)
+        throw Base::BadFormatError("Truncated toolpath data");
+
+    std::vector<Command> commands;
+    commands.reserve(total);
+    const char *pos = data.c_str() + static_cast<std::size_t>(in.tellg());
+    const char *end = data.c_str() + data.size();
+    std::vector<int64_t> last;
+    for (const auto &chunk : chunks) {
+        if (static_cast<std::size_t>(end - pos) < chunk.second)
+            throw Base::BadFormatError("Truncated toolpath data");
+        const char *chunkEnd = pos + chunk.second;
+        last.assign(names.size(), 0);
+        for (uint32_t i = 0; i < chunk.first; ++i) {
+            Command cmd;
+            uint64_t name = readVarint(pos, chunkEnd);
+            uint64_t params = readVarint(pos, chunkEnd);
+            if (name >= names.size())
+                throw Base::BadFormatError("Invalid toolpath data");
+            cmd.Name = names[name];
+            for (uint64_t j = 0; j < params; ++j) {
+                uint64_t key = readVarint(pos, chunkEnd);
+                if (key >= names.size())
+                    throw Base::BadFormatError("Invalid toolpath data");
+                cmd.Parameters[names[key]] = readValue(pos, chunkEnd, last[key]);
+            }
+            commands.push_back(std::move(cmd));
+        }
+        pos = chunkEnd;
+    }
+    vCommands = std::move(commands);
+    recalculate();
+}
+
+void Toolpath::restoreGCode(const std::string &data)
+{
+    std::istringstream in(data);
+    std::string gcode;
+    std::string line;
+    while (in >> line) {
+        gcode += line;
+        gcode += " ";
+    }
+    setFromGCode(gcode);
+}
+
 void Toolpath::Save (Writer &writer) const
 {
     if (writer.isForceXML()) {
@@ -443,12 +746,26 @@ void Toolpath::Save (Writer &writer) const
         writer.incInd();
         saveCenter(writer, center);
         for(unsigned int i = 0; i < getSize(); i++) {
-            vpcCommands[i]->Save(writer);
+            vCommands[i].Save(writer);
         }
         writer.decInd();
     } else {
-        writer.Stream() << writer.ind()
-            << "<Path file=\"" << writer.addFile((writer.ObjectName+".nc").c_str(), this) << "\" version=\"" << SchemaVersion << "\">" << std::endl;
+        // The binary file is opt-in, because older versions can't read it and
+        // would open such a document with empty paths. It can become the
+        // default once the versions without a binary reader are out of use.
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Path");
+        if (hGrp->GetBool("SaveBinary", false)) {
+            writer.Stream() << writer.ind()
+                << "<Path file=\"\" binary=\"" << writer.addFile((writer.ObjectName+".bin").c_str(), this)
+                << "\" version=\"" << SchemaVersion << "\">" << std::endl;
+        }
+        else {
+            if (!gcodeFile)
+                gcodeFile = std::make_unique<GCodeFile>(*this);
+            writer.Stream() << writer.ind()
+                << "<Path file=\"" << writer.addFile((writer.ObjectName+".nc").c_str(), gcodeFile.get())
+                << "\" version=\"" << SchemaVersion << "\">" << std::endl;
+        }
         writer.incInd();
         saveCenter(writer, center);
         writer.decInd();
@@ -458,15 +775,17 @@ void Toolpath::Save (Writer &writer) const
 
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
-        return;
-    writer.Stream() << toGCode();
+    saveBinary(writer.Stream());
 }
 
 void Toolpath::Restore(XMLReader &reader)
 {
     reader.readElement("Path");
-    std::string file (reader.getAttribute("file") );
+    std::string file;
+    if (reader.hasAttribute("binary"))
+        file = reader.getAttribute("binary");
+    if (file.empty())
+        file = reader.getAttribute("file");
 
     if (!file.empty()) {
         // initiate a file read
@@ -476,14 +795,14 @@ void Toolpath::Restore(XMLReader &reader)
 
 void Toolpath::RestoreDocFile(Base::Reader &reader)
 {
-    std::string gcode;
-    std::string line;
-    while (reader >> line) {
-        gcode += line;
-        gcode += " ";
-    }
-    setFromGCode(gcode);
-
+    // The commands are decoded right away instead of on first access: the
+    // property notifies its container after the restore, and the recompute
+    // and the view provider read every command at that point anyway.
+    std::string data((std::istreambuf_iterator<char>(reader)), std::istreambuf_iterator<char>());
+    if (data.compare(0, 4, BinaryMagic) == 0)
+        restoreBinary(data);
+    else
+        restoreGCode(data);
 }
 
 
@@ -23,6 +23,10 @@
 #ifndef PATH_Path_H
 #define PATH_Path_H
 
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+
 #include <Base/BoundBox.h>
 #include <Base/Persistence.h>
 #include <Base/Vector3D.h>
@@ -61,26 +65,40 @@ namespace Path
             double getLength(); // return the Length (mm) of the Path
             double getCycleTime(double, double, double, double); // return the Cycle Time (s) of the Path
             void recalculate(); // recalculates the points
-            void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
+            void setFromGCode(std::string_view); // sets the path from the contents of the given GCode string
             std::string toGCode() const; // gets a gcode string representation from the Path
             Base::BoundBox3d getBoundBox() const;
 
             // shortcut functions
-            unsigned int getSize() const { return vpcCommands.size(); }
-            const std::vector<Command*> &getCommands() const { return vpcCommands; }
-            const Command &getCommand(unsigned int pos)    const { return *vpcCommands[pos]; }
+            unsigned int getSize() const { return vCommands.size(); }
+            // pointers to the commands as before they were stored by value,
+            // they are valid until the toolpath is modified
+            const std::vector<Command*> &getCommands() const;
+            const std::vector<Command> &getCommandList() const { return vCommands; }
+            const Command &getCommand(unsigned int pos)    const { return vCommands[pos]; }
 
             // support for rotation
             const Base::Vector3d& getCenter() const { return center; }
             void setCenter(const Base::Vector3d &c);
 
-            static const int SchemaVersion = 2;
+            // version 2 adds the center, version 3 the binary file
+            static const int SchemaVersion = 3;
 
         protected:
-            std::vector<Command*> vpcCommands;
+            // commands are stored by value to avoid an allocation per move
+            std::vector<Command> vCommands;
             Base::Vector3d center;
             //KDL::Path_Composite *pcPath;
 
+        private:
+            void saveBinary(std::ostream &) const;
+            void restoreBinary(const std::string &);
+            void restoreGCode(const std::string &);
+
+            class GCodeFile;
+            mutable std::unique_ptr<GCodeFile> gcodeFile;
+            mutable std::vector<Command*> commandPointers;
+
         /*
         inline  KDL::Frame toFrame(const Base::Placement &To){
             return KDL::Frame(KDL::Rotation::Quaternion(To.getRotation()[0],
@@ -106,7 +106,11 @@ void PropertyPath::Restore(Base::XMLReader &reader)
 {
     reader.readElement("Path");
 
-    std::string file (reader.getAttribute("file") );
+    std::string file;
+    if (reader.hasAttribute("binary"))
+        file = reader.getAttribute("binary");
+    if (file.empty())
+        file = reader.getAttribute("file");
     if (!file.empty()) {
         // initiate a file read
         reader.addFile(file.c_str(),this);
@@ -114,7 +118,7 @@ void PropertyPath::Restore(Base::XMLReader &reader)
 
     if (reader.hasAttribute("version")) {
         int version = reader.getAttributeAsInteger("version");
-        if (version >= Toolpath::SchemaVersion) {
+        if (version >= 2) {
             reader.readElement("Center");
             double x = reader.getAttributeAsFloat("x");
             double y = reader.getAttributeAsFloat("y");
@@ -26,6 +26,10 @@
 #include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <chrono>
+#include <future>
+#include <random>
+#include <thread>
 
 namespace ClipperLib
 {
@@ -923,6 +927,9 @@ class ClearedArea
 	void SetClearedPaths(const Paths &paths)
 	{
 		clearedPaths = paths;
+		clearedBounds.clear();
+		for (const auto &pth : clearedPaths)
+			clearedBounds.push_back(PathBounds(pth));
 		bboxPathsInvalid = true;
 		bboxClippedInvalid = true;
 	}
@@ -935,11 +942,38 @@ class ClearedArea
 		clipof.AddPath(toClearToolPath, JoinType::jtRound, EndType::etOpenRound);
 		Paths toolCoverPoly;
 		clipof.Execute(toolCoverPoly, toolRadiusScaled + 1);
+
+		// only the cleared paths whose bounds collide with the tool cover take part
+		// in the union, the others can neither overlap nor contain it (even-odd fill)
+		BoundBox coverBB = PathBounds(toolCoverPoly);
+		Paths nearPaths;
+		Paths farPaths;
+		std::vector<BoundBox> farBounds;
+		for (size_t i = 0; i < clearedPaths.size(); i++)
+		{
+			if (clearedBounds[i].CollidesWith(coverBB))
+			{
+				nearPaths.push_back(std::move(clearedPaths[i]));
+			}
+			else
+			{
+				farPaths.push_back(std::move(clearedPaths[i]));
+				farBounds.push_back(clearedBounds[i]);
+			}
+		}
 		clip.Clear();
-		clip.AddPaths(clearedPaths, PolyType::ptSubject, true);
+		clip.AddPaths(nearPaths, PolyType::ptSubject, true);
 		clip.AddPaths(toolCoverPoly, PolyType::ptClip, true);
-		clip.Execute(ClipType::ctUnion, clearedPaths);
-		CleanPolygons(clearedPaths);
+		clip.Execute(ClipType::ctUnion, nearPaths);
+		CleanPolygons(nearPaths);
+
+		clearedPaths = std::move(farPaths);
+		clearedBounds = std::move(farBounds);
+		for (auto &pth : nearPaths)
+		{
+			clearedBounds.push_back(PathBounds(pth));
+			clearedPaths.push_back(std::move(pth));
+		}
 		bboxPathsInvalid = true;
 		bboxClippedInvalid = true;
 		Perf_ExpandCleared.Stop();
@@ -959,9 +993,10 @@ class ClearedArea
 
 		BoundBox bb(toolPos, focusBBFactor2 * toolRadiusScaled);
 		clearedBoundedPaths.clear();
-		for (const auto &pth : clearedPaths)
+		for (size_t index = 0; index < clearedPaths.size(); index++)
 		{
-			if (pth.size() < 2)
+			const Path &pth = clearedPaths[index];
+			if (pth.size() < 2 || !clearedBounds[index].CollidesWith(bb))
 				continue;
 			Path bPath;
 			size_t size = pth.size();
@@ -1014,9 +1049,15 @@ class ClearedArea
 		bbPath.push_back(IntPoint(toolPos.X + delta2, toolPos.Y - delta2));
 		bbPath.push_back(IntPoint(toolPos.X + delta2, toolPos.Y + delta2));
 		bbPath.push_back(IntPoint(toolPos.X - delta2, toolPos.Y + delta2));
+		BoundBox bb(toolPos, delta2);
 		clip.Clear();
 		clip.AddPath(bbPath, PolyType::ptSubject, true);
-		clip.AddPaths(clearedPaths, PolyType::ptClip, true);
+		for (size_t i = 0; i < clearedPaths.size(); i++)
+		{
+			// paths outside of the box do not change the intersection
+			if (clearedBounds[i].CollidesWith(bb))
+				clip.AddPath(clearedPaths[i], PolyType::ptClip, true);
+		}
 		clip.Execute(ClipType::ctIntersection, clearedBoundedClipped);
 		bboxClippedInvalid = false;
 		return clearedBoundedClipped;
@@ -1029,9 +1070,43 @@ class ClearedArea
 	}
 
   private:
+	static BoundBox PathBounds(const Path &pth)
+	{
+		BoundBox bb;
+		if (!pth.empty())
+			bb.SetFirstPoint(pth.front());
+		for (const auto &pt : pth)
+			bb.AddPoint(pt);
+		return bb;
+	}
+
+	static BoundBox PathBounds(const Paths &paths)
+	{
+		BoundBox bb;
+		bool first = true;
+		for (const auto &pth : paths)
+		{
+			if (pth.empty())
+				continue;
+			BoundBox pathBB = PathBounds(pth);
+			if (first)
+			{
+				bb = pathBB;
+				first = false;
+			}
+			else
+			{
+				bb.AddPoint(IntPoint(pathBB.minX, pathBB.minY));
+				bb.AddPoint(IntPoint(pathBB.maxX, pathBB.maxY));
+			}
+		}
+		return bb;
+	}
+
 	Clipper clip;
 	ClipperOffset clipof;
 	Paths clearedPaths;
+	std::vector<BoundBox> clearedBounds; // bounds of each of clearedPaths
 	Paths clearedBoundedClipped;
 	Paths clearedBoundedPaths;
 
@@ -1114,7 +1189,9 @@ class Interpolation
 
 	double getRandomAngle()
 	{
-		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(rand()) / double(RAND_MAX);
+		// own generator, so that the result doesn't depend on the other regions
+		double r = double(random() - random.min()) / double(random.max() - random.min());
+		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * r;
 	}
 	size_t getPointCount()
 	{
@@ -1124,6 +1201,7 @@ class Interpolation
   private:
 	vector<double> angles;
 	vector<double> areas;
+	std::minstd_rand random;
 };
 
 //***************************************
@@ -1695,7 +1773,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 	toolRadiusScaled = long(toolDiameter * scaleFactor / 2);
 	stepOverScaled = toolRadiusScaled * stepOverFactor;
 	progressCallback = &progressCallbackFn;
-	lastProgressTime = clock();
+	lastProgressTime = std::chrono::steady_clock::now();
 	stopProcessing = false;
 
 	if(helixRampDiameter<NTOL)
@@ -1778,6 +1856,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 	//	Resolve hierarchy and run processing
 	//***************************************
 	double cornerRoundingOffset = 0.15 * toolRadiusScaled / 2;
+	std::vector<std::pair<Paths, Paths>> regions; // bound paths and tool bound paths
 	if (opType == OperationType::otClearingInside || opType == OperationType::otClearingOutside)
 	{
 
@@ -1830,7 +1909,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 				clipof.Clear();
 				clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 				clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
-				ProcessPolyNode(boundPaths, toolBoundPaths);
+				regions.emplace_back(boundPaths, toolBoundPaths);
 			}
 		}
 	}
@@ -1889,14 +1968,67 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 					clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 					clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
 
-					ProcessPolyNode(boundPaths, toolBoundPaths);
+					regions.emplace_back(boundPaths, toolBoundPaths);
 				}
 			}
 		}
 	}
+	ProcessRegions(regions);
 	return results;
 }
 
+void Adaptive2d::ProcessRegions(const std::vector<std::pair<Paths, Paths>> &regions)
+{
+	std::vector<std::list<AdaptiveOutput>> regionResults(regions.size());
+	size_t threadCount = maxThreads > 0 ? size_t(maxThreads) : size_t(std::thread::hardware_concurrency());
+	threadCount = std::min<size_t>(regions.size(), threadCount);
+#ifdef DEV_MODE
+	// perf counters and debug drawing are not thread safe
+	threadCount = 1;
+#endif
+	parallelRegions = threadCount > 1;
+	if (!parallelRegions)
+	{
+		for (size_t i = 0; i < regions.size(); i++)
+			ProcessPolyNode(regions[i].first, regions[i].second, regionResults[i]);
+	}
+	else
+	{
+		// the regions are disjoint, each one is cleared independently
+		std::atomic<size_t> nextRegion{0};
+		std::vector<std::future<void>> workers;
+		for (size_t t = 0; t < threadCount; t++)
+		{
+			workers.push_back(std::async(std::launch::async, [&]() {
+				for (size_t i = nextRegion++; i < regions.size(); i = nextRegion++)
+				{
+					try
+					{
+						ProcessPolyNode(regions[i].first, regions[i].second, regionResults[i]);
+					}
+					catch (...)
+					{
+						stopProcessing = true;
+						throw;
+					}
+				}
+			}));
+		}
+		// the progress callback may be a python function, so it is only called from this thread
+		for (auto &worker : workers)
+		{
+			while (worker.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+				ReportPendingProgress();
+		}
+		ReportPendingProgress();
+		parallelRegions = false;
+		for (auto &worker : workers)
+			worker.get();
+	}
+	for (auto &output : regionResults)
+		results.splice(results.end(), output);
+}
+
 bool Adaptive2d::FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &boundPaths,
 								ClearedArea &clearedArea /*output-initial cleared area by helix*/,
 								IntPoint &entryPoint /*output*/,
@@ -2169,15 +2301,16 @@ bool Adaptive2d::ResolveLinkPath(const IntPoint &startPoint, const IntPoint &end
 	double par;
 
 	// put a time limit on the resolving the link path
-	clock_t time_limit = (clock_t)(max(keepToolDownDistRatio, 3.0) * CLOCKS_PER_SEC / 6);
+	// (wall time, the CPU time of the process advances faster when regions are processed in parallel)
+	auto time_limit = std::chrono::duration<double>(max(keepToolDownDistRatio, 3.0) / 6);
 
-	clock_t time_out = clock() + time_limit;
+	auto time_out = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(time_limit);
 
 	while (!queue.empty())
 	{
 		if (stopProcessing)
 			return false;
-		if (clock() > time_out)
+		if (std::chrono::steady_clock::now() > time_out)
 		{
 			cout << "Unable to resolve tool down linking path (limit reached)." << endl;
 			return false;
@@ -2551,14 +2684,28 @@ void Adaptive2d::AppendToolPath(TPaths &progressPaths, AdaptiveOutput &output,
 
 void Adaptive2d::CheckReportProgress(TPaths &progressPaths, bool force)
 {
-	if (!force && (clock() - lastProgressTime < PROGRESS_TICKS))
-		return; // not yet
-	lastProgressTime = clock();
-	if (progressPaths.empty())
-		return;
-	if (progressCallback)
-		if ((*progressCallback)(progressPaths))
-			stopProcessing = true; // call python function, if returns true signal stop processing
+	if (parallelRegions)
+	{
+		// called on a worker thread, hand the paths over to ReportPendingProgress()
+		std::lock_guard<std::mutex> lock(progressMutex);
+		if (!force && (std::chrono::steady_clock::now() - lastProgressTime < PROGRESS_INTERVAL))
+			return; // not yet
+		lastProgressTime = std::chrono::steady_clock::now();
+		if (progressPaths.empty())
+			return;
+		pendingProgress.insert(pendingProgress.end(), progressPaths.begin(), progressPaths.end());
+	}
+	else
+	{
+		if (!force && (std::chrono::steady_clock::now() - lastProgressTime < PROGRESS_INTERVAL))
+			return; // not yet
+		lastProgressTime = std::chrono::steady_clock::now();
+		if (progressPaths.empty())
+			return;
+		if (progressCallback)
+			if ((*progressCallback)(progressPaths))
+				stopProcessing = true; // call python function, if returns true signal stop processing
+	}
 	// clean the paths - keep the last point
 	if (progressPaths.back().second.empty())
 		return;
@@ -2573,6 +2720,20 @@ void Adaptive2d::CheckReportProgress(TPaths &progressPaths, bool force)
 	progressPaths.front().second.push_back(next);
 }
 
+void Adaptive2d::ReportPendingProgress()
+{
+	TPaths progressPaths;
+	{
+		std::lock_guard<std::mutex> lock(progressMutex);
+		progressPaths.swap(pendingProgress);
+	}
+	if (progressPaths.empty())
+		return;
+	if (progressCallback)
+		if ((*progressCallback)(progressPaths))
+			stopProcessing = true;
+}
+
 void Adaptive2d::AddPathsToProgress(TPaths &progressPaths, Paths paths, MotionType mt)
 {
 	for (const auto &pth : paths)
@@ -2599,11 +2760,11 @@ void Adaptive2d::AddPathToProgress(TPaths &progressPaths, const Path pth, Motion
 	}
 }
 
-void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
+void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths, std::list<AdaptiveOutput> &regionResults)
 {
 	Perf_ProcessPolyNode.Start();
-	current_region++;
-	cout << "** Processing region: " << current_region << endl;
+	int region = ++current_region;
+	cout << "** Processing region: " << region << endl;
 
 	// node paths are already constrained to tool boundary path for adaptive path before finishing pass
 	Clipper clip;
@@ -3138,7 +3299,7 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 				<< "Hint: try to modify accuracy and/or step-over." << endl;
 		}
 	}
-	results.push_back(output);
+	regionResults.push_back(output);
 }
 
 } // namespace AdaptivePath
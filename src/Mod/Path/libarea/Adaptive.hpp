@@ -21,6 +21,10 @@
 ***************************************************************************/
 
 #include "clipper.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <vector>
 #include <list>
 #include <time.h>
@@ -81,7 +85,7 @@ struct AdaptiveOutput
 	int ReturnMotionType; // MotionType enum, problem with serialization if enum is used
 };
 
-// used to isolate state -> enable potential adding of multi-threaded processing of separate regions
+// used to isolate state -> separate regions are processed on multiple threads
 
 class Adaptive2d
 {
@@ -96,6 +100,7 @@ class Adaptive2d
 	bool finishingProfile = true;
 	double keepToolDownDistRatio = 3.0; // keep tool down distance ratio
 	OperationType opType = OperationType::otClearingInside;
+	int maxThreads = 0; // threads used to clear separate regions, 0 = hardware concurrency
 
 	std::list<AdaptiveOutput> Execute(const DPaths &stockPaths, const DPaths &paths, std::function<bool(TPaths)> progressCallbackFn);
 
@@ -118,14 +123,20 @@ class Adaptive2d
 	long helixRampRadiusScaled = 0;
 	double referenceCutArea = 0;
 	double optimalCutAreaPD = 0;
-	bool stopProcessing = false;
-	int current_region=0;
-	clock_t lastProgressTime = 0;
+	std::atomic<bool> stopProcessing{false};
+	std::atomic<int> current_region{0};
+	std::chrono::steady_clock::time_point lastProgressTime;
 
 	std::function<bool(TPaths)> *progressCallback = NULL;
 	Path toolGeometry; // tool geometry at coord 0,0, should not be modified
 
-	void ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths);
+	// progress of regions processed on worker threads, reported by the thread running Execute
+	bool parallelRegions = false;
+	std::mutex progressMutex;
+	TPaths pendingProgress;
+
+	void ProcessRegions(const std::vector<std::pair<Paths, Paths>> &regions);
+	void ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths, std::list<AdaptiveOutput> &regionResults);
 	bool FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &bound, ClearedArea &cleared /*output*/,
 						IntPoint &entryPoint /*output*/, IntPoint &toolPos, DoublePoint &toolDir);
 	bool FindEntryPointOutside(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &bound, ClearedArea &cleared /*output*/,
@@ -143,6 +154,7 @@ class Adaptive2d
 	friend class EngagePoint; // for CalcCutArea
 
 	void CheckReportProgress(TPaths &progressPaths, bool force = false);
+	void ReportPendingProgress();
 	void AddPathsToProgress(TPaths &progressPaths, const Paths paths, MotionType mt = MotionType::mtCutting);
 	void AddPathToProgress(TPaths &progressPaths, const Path pth, MotionType mt = MotionType::mtCutting);
 	void ApplyStockToLeave(Paths &inputPaths);
@@ -164,7 +176,8 @@ class Adaptive2d
 
 	const long PASSES_LIMIT = __LONG_MAX__;			   // limit used while debugging
 	const long POINTS_PER_PASS_LIMIT = __LONG_MAX__;   // limit used while debugging
-	const clock_t PROGRESS_TICKS = CLOCKS_PER_SEC / 10; // progress report interval
+	// progress report interval, wall time because regions may be processed on several threads
+	const std::chrono::milliseconds PROGRESS_INTERVAL{100};
 };
 } // namespace AdaptivePath
 #endif
\ No newline at end of file
@@ -21,6 +21,14 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+#endif
+
+#include <Base/Parallel.h>
 
 #include "PointsGrid.h"
 
@@ -122,7 +130,9 @@ void PointsGrid::Attach(const PointKernel& rclM)
 
 void PointsGrid::Clear()
 {
-    _aulGrid.clear();
+    _aulCellStart.clear();
+    _aulCellPoints.clear();
+    _aclCellPoints.clear();
     _pclPoints = nullptr;
 }
 
@@ -153,8 +163,6 @@ void PointsGrid::InitGrid()
 {
     assert(_pclPoints);
 
-    unsigned long i, j;
-
     // Calculate grid lengths if not initialized
     //
     if ((_ulCtGridsX == 0) || (_ulCtGridsY == 0) || (_ulCtGridsZ == 0)) {
@@ -204,14 +212,9 @@ void PointsGrid::InitGrid()
     }
 
     // Create data structure
-    _aulGrid.clear();
-    _aulGrid.resize(_ulCtGridsX);
-    for (i = 0; i < _ulCtGridsX; i++) {
-        _aulGrid[i].resize(_ulCtGridsY);
-        for (j = 0; j < _ulCtGridsY; j++) {
-            _aulGrid[i][j].resize(_ulCtGridsZ);
-        }
-    }
+    _aulCellStart.assign(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ + 1, 0);
+    _aulCellPoints.clear();
+    _aclCellPoints.clear();
 }
 
 unsigned long PointsGrid::InSide(const Base::BoundBox3d& rclBB,
@@ -229,9 +232,7 @@ unsigned long PointsGrid::InSide(const Base::BoundBox3d& rclBB,
     for (i = ulMinX; i <= ulMaxX; i++) {
         for (j = ulMinY; j <= ulMaxY; j++) {
             for (k = ulMinZ; k <= ulMaxZ; k++) {
-                raulElements.insert(raulElements.end(),
-                                    _aulGrid[i][j][k].begin(),
-                                    _aulGrid[i][j][k].end());
+                GetElements(i, j, k, raulElements);
             }
         }
     }
@@ -266,9 +267,7 @@ unsigned long PointsGrid::InSide(const Base::BoundBox3d& rclBB,
         for (j = ulMinY; j <= ulMaxY; j++) {
             for (k = ulMinZ; k <= ulMaxZ; k++) {
                 if (Base::DistanceP2(GetBoundBox(i, j, k).GetCenter(), rclOrg) < fMinDistP2) {
-                    raulElements.insert(raulElements.end(),
-                                        _aulGrid[i][j][k].begin(),
-                                        _aulGrid[i][j][k].end());
+                    GetElements(i, j, k, raulElements);
                 }
             }
         }
@@ -298,7 +297,7 @@ unsigned long PointsGrid::InSide(const Base::BoundBox3d& rclBB,
     for (i = ulMinX; i <= ulMaxX; i++) {
         for (j = ulMinY; j <= ulMaxY; j++) {
             for (k = ulMinZ; k <= ulMaxZ; k++) {
-                raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+                GetElements(i, j, k, raulElements);
             }
         }
     }
@@ -546,7 +545,7 @@ void PointsGrid::SearchNearestFromPoint(const Base::Vector3d& rclPt,
                 while (raclInd.empty()) {
                     for (unsigned long i = 0; i < _ulCtGridsY; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+                            GetElements(nX, i, j, raclInd);
                         }
                     }
                     nX++;
@@ -558,10 +557,12 @@ void PointsGrid::SearchNearestFromPoint(const Base::Vector3d& rclPt,
                 while (raclInd.empty()) {
                     for (unsigned long i = 0; i < _ulCtGridsY; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+                            GetElements(nX, i, j, raclInd);
                         }
                     }
-                    nX++;
+                    // walks from the far end of the grid towards the point,
+                    // incrementing here ran past the last column
+                    nX--;
                 }
                 break;
             }
@@ -570,7 +571,7 @@ void PointsGrid::SearchNearestFromPoint(const Base::Vector3d& rclPt,
                 while (raclInd.empty()) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+                            GetElements(i, nY, j, raclInd);
                         }
                     }
                     nY++;
@@ -582,7 +583,7 @@ void PointsGrid::SearchNearestFromPoint(const Base::Vector3d& rclPt,
                 while (raclInd.empty()) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+                            GetElements(i, nY, j, raclInd);
                         }
                     }
                     nY--;
@@ -594,7 +595,7 @@ void PointsGrid::SearchNearestFromPoint(const Base::Vector3d& rclPt,
                 while (raclInd.empty()) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-                            raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+                            GetElements(i, j, nZ, raclInd);
                         }
                     }
                     nZ++;
@@ -606,7 +607,7 @@ void PointsGrid::SearchNearestFromPoint(const Base::Vector3d& rclPt,
                 while (raclInd.empty()) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-                            raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+                            GetElements(i, j, nZ, raclInd);
                         }
                     }
                     nZ--;
@@ -678,21 +679,246 @@ unsigned long PointsGrid::GetElements(unsigned long ulX,
                                       unsigned long ulZ,
                                       std::set<unsigned long>& raclInd) const
 {
-    const std::set<unsigned long>& rclSet = _aulGrid[ulX][ulY][ulZ];
-    if (!rclSet.empty()) {
-        raclInd.insert(rclSet.begin(), rclSet.end());
-        return rclSet.size();
-    }
+    unsigned long ulCell = CellIndex(ulX, ulY, ulZ);
+    auto first = _aulCellPoints.begin() + _aulCellStart[ulCell];
+    auto last = _aulCellPoints.begin() + _aulCellStart[ulCell + 1];
+    raclInd.insert(first, last);
+    return std::distance(first, last);
+}
 
-    return 0;
+unsigned long PointsGrid::GetElements(unsigned long ulX,
+                                      unsigned long ulY,
+                                      unsigned long ulZ,
+                                      std::vector<unsigned long>& raulInd) const
+{
+    unsigned long ulCell = CellIndex(ulX, ulY, ulZ);
+    auto first = _aulCellPoints.begin() + _aulCellStart[ulCell];
+    auto last = _aulCellPoints.begin() + _aulCellStart[ulCell + 1];
+    raulInd.insert(raulInd.end(), first, last);
+    return std::distance(first, last);
 }
 
-void PointsGrid::AddPoint(const Base::Vector3d& rclPt, unsigned long ulPtIndex, float /*fEpsilon*/)
+void PointsGrid::NearestNeighbours(const Base::Vector3d& rclPt,
+                                   unsigned long ulCount,
+                                   std::vector<Neighbour>& raclHeap) const
 {
+    raclHeap.clear();
+    if (ulCount == 0 || _aulCellPoints.empty()) {
+        return;
+    }
+
     unsigned long ulX, ulY, ulZ;
-    Pos(Base::Vector3d(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
-    if ((ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ)) {
-        _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+    Position(rclPt, ulX, ulY, ulZ);
+    const long nX = long(ulX), nY = long(ulY), nZ = long(ulZ);
+    const long nCtX = long(_ulCtGridsX), nCtY = long(_ulCtGridsY), nCtZ = long(_ulCtGridsZ);
+
+    // Keeps the ulCount nearest points found so far as a max-heap
+    auto visitCell = [&](long i, long j, long k) {
+        unsigned long ulCell = CellIndex(i, j, k);
+        for (unsigned long n = _aulCellStart[ulCell]; n < _aulCellStart[ulCell + 1]; n++) {
+            const Base::Vector3f& pnt = _aclCellPoints[n];
+            Neighbour cand(Base::DistanceP2(rclPt, Base::Vector3d(pnt.x, pnt.y, pnt.z)),
+                           _aulCellPoints[n]);
+            if (raclHeap.size() < ulCount) {
+                raclHeap.push_back(cand);
+                std::push_heap(raclHeap.begin(), raclHeap.end());
+            }
+            else if (cand < raclHeap.front()) {
+                std::pop_heap(raclHeap.begin(), raclHeap.end());
+                raclHeap.back() = cand;
+                std::push_heap(raclHeap.begin(), raclHeap.end());
+            }
+        }
+    };
+
+    // Visit the grid elements shell by shell around the start element
+    for (long nLevel = 0;; nLevel++) {
+        long nX1 = std::max<long>(0, nX - nLevel), nX2 = std::min<long>(nCtX - 1, nX + nLevel);
+        long nY1 = std::max<long>(0, nY - nLevel), nY2 = std::min<long>(nCtY - 1, nY + nLevel);
+        long nZ1 = std::max<long>(0, nZ - nLevel), nZ2 = std::min<long>(nCtZ - 1, nZ + nLevel);
+        for (long i = nX1; i <= nX2; i++) {
+            for (long j = nY1; j <= nY2; j++) {
+                if (std::abs(i - nX) == nLevel || std::abs(j - nY) == nLevel) {
+                    for (long k = nZ1; k <= nZ2; k++) {
+                        visitCell(i, j, k);
+                    }
+                }
+                else {
+                    if (nZ - nLevel >= 0) {
+                        visitCell(i, j, nZ - nLevel);
+                    }
+                    if (nZ + nLevel < nCtZ) {
+                        visitCell(i, j, nZ + nLevel);
+                    }
+                }
+            }
+        }
+
+        // Distance from the point to the grid elements not yet visited
+        double fBound = DBL_MAX;
+        if (nX1 > 0) {
+            fBound = std::min(fBound, rclPt.x - (_fMinX + double(nX1) * _fGridLenX));
+        }
+        if (nX2 < nCtX - 1) {
+            fBound = std::min(fBound, _fMinX + double(nX2 + 1) * _fGridLenX - rclPt.x);
+        }
+        if (nY1 > 0) {
+            fBound = std::min(fBound, rclPt.y - (_fMinY + double(nY1) * _fGridLenY));
+        }
+        if (nY2 < nCtY - 1) {
+            fBound = std::min(fBound, _fMinY + double(nY2 + 1) * _fGridLenY - rclPt.y);
+        }
+        if (nZ1 > 0) {
+            fBound = std::min(fBound, rclPt.z - (_fMinZ + double(nZ1) * _fGridLenZ));
+        }
+        if (nZ2 < nCtZ - 1) {
+            fBound = std::min(fBound, _fMinZ + double(nZ2 + 1) * _fGridLenZ - rclPt.z);
+        }
+
+        if (fBound == DBL_MAX) {
+            break;  // all grid elements visited
+        }
+        fBound = std::max(fBound, 0.0);
+        if (raclHeap.size() == ulCount && raclHeap.front().first <= fBound * fBound) {
+            break;
+        }
+    }
+
+    std::sort_heap(raclHeap.begin(), raclHeap.end());
+}
+
+void PointsGrid::RadiusNeighbours(const Base::Vector3d& rclPt,
+                                  double fRadius,
+                                  std::vector<unsigned long>& raulElements) const
+{
+    if (_aulCellPoints.empty()) {
+        return;
+    }
+
+    unsigned long ulMinX, ulMinY, ulMinZ, ulMaxX, ulMaxY, ulMaxZ;
+    Position(rclPt - Base::Vector3d(fRadius, fRadius, fRadius), ulMinX, ulMinY, ulMinZ);
+    Position(rclPt + Base::Vector3d(fRadius, fRadius, fRadius), ulMaxX, ulMaxY, ulMaxZ);
+
+    double fRadiusP2 = fRadius * fRadius;
+    for (unsigned long k = ulMinZ; k <= ulMaxZ; k++) {
+        for (unsigned long j = ulMinY; j <= ulMaxY; j++) {
+            for (unsigned long i = ulMinX; i <= ulMaxX; i++) {
+                unsigned long ulCell = CellIndex(i, j, k);
+                for (unsigned long n = _aulCellStart[ulCell]; n < _aulCellStart[ulCell + 1]; n++) {
+                    const Base::Vector3f& pnt = _aclCellPoints[n];
+                    if (Base::DistanceP2(rclPt, Base::Vector3d(pnt.x, pnt.y, pnt.z))
+                        <= fRadiusP2) {
+                        raulElements.push_back(_aulCellPoints[n]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+unsigned long PointsGrid::SearchNearest(const Base::Vector3d& rclPt,
+                                        unsigned long ulCount,
+                                        std::vector<unsigned long>& raulElements) const
+{
+    std::vector<Neighbour> heap;
+    NearestNeighbours(rclPt, ulCount, heap);
+
+    raulElements.clear();
+    for (const auto& it : heap) {
+        raulElements.push_back(it.second);
+    }
+    return raulElements.size();
+}
+
+unsigned long PointsGrid::SearchNearest(const std::vector<Base::Vector3d>& raclPts,
+                                        unsigned long ulCount,
+                                        std::vector<unsigned long>& raulElements) const
+{
+    unsigned long ulRow = std::min<unsigned long>(ulCount, _aulCellPoints.size());
+    raulElements.resize(raclPts.size() * ulRow);
+
+    Base::parallelForRange(raclPts.size(), [&](std::size_t begin, std::size_t end) {
+        std::vector<Neighbour> heap;
+        heap.reserve(ulRow);
+        for (std::size_t i = begin; i < end; i++) {
+            NearestNeighbours(raclPts[i], ulRow, heap);
+            for (std::size_t j = 0; j < heap.size(); j++) {
+                raulElements[i * ulRow + j] = heap[j].second;
+            }
+        }
+    });
+
+    return ulRow;
+}
+
+unsigned long PointsGrid::SearchNearest(unsigned long ulCount,
+                                        std::vector<unsigned long>& raulElements) const
+{
+    const std::vector<PointKernel::value_type>& points = _pclPoints->getBasicPoints();
+    const Base::Matrix4D mat = _pclPoints->getTransform();
+    unsigned long ulRow = std::min<unsigned long>(ulCount, _aulCellPoints.size());
+    raulElements.resize(points.size() * ulRow);
+
+    Base::parallelForRange(points.size(), [&](std::size_t begin, std::size_t end) {
+        std::vector<Neighbour> heap;
+        heap.reserve(ulRow);
+        for (std::size_t i = begin; i < end; i++) {
+            const PointKernel::value_type& pnt = points[i];
+            NearestNeighbours(mat * Base::Vector3d(pnt.x, pnt.y, pnt.z), ulRow, heap);
+            for (std::size_t j = 0; j < heap.size(); j++) {
+                raulElements[i * ulRow + j] = heap[j].second;
+            }
+        }
+    });
+
+    return ulRow;
+}
+
+unsigned long PointsGrid::SearchRadius(const Base::Vector3d& rclPt,
+                                       double fRadius,
+                                       std::vector<unsigned long>& raulElements) const
+{
+    raulElements.clear();
+    RadiusNeighbours(rclPt, fRadius, raulElements);
+    return raulElements.size();
+}
+
+void PointsGrid::SearchRadius(const std::vector<Base::Vector3d>& raclPts,
+                              double fRadius,
+                              std::vector<unsigned long>& raulOffsets,
+                              std::vector<unsigned long>& raulElements) const
+{
+    // Each block collects its neighbours separately, they are joined afterwards
+    struct Block
+    {
+        std::size_t begin, end;
+        std::vector<unsigned long> counts;
+        std::vector<unsigned long> elements;
+    };
+    constexpr std::size_t blockSize = 1024;
+    std::vector<Block> blocks;
+    for (std::size_t begin = 0; begin < raclPts.size(); begin += blockSize) {
+        blocks.push_back({begin, std::min(begin + blockSize, raclPts.size()), {}, {}});
+    }
+
+    QtConcurrent::blockingMap(blocks, [&](Block& block) {
+        for (std::size_t i = block.begin; i < block.end; i++) {
+            std::size_t size = block.elements.size();
+            RadiusNeighbours(raclPts[i], fRadius, block.elements);
+            block.counts.push_back(block.elements.size() - size);
+        }
+    });
+
+    raulOffsets.resize(raclPts.size() + 1);
+    raulOffsets[0] = 0;
+    raulElements.clear();
+    std::size_t index = 0;
+    for (const auto& block : blocks) {
+        for (unsigned long count : block.counts) {
+            raulOffsets[index + 1] = raulOffsets[index] + count;
+            index++;
+        }
+        raulElements.insert(raulElements.end(), block.elements.begin(), block.elements.end());
     }
 }
 
@@ -747,11 +973,30 @@ void PointsGrid::RebuildGrid()
 
     InitGrid();
 
-    // Fill data structure
+    // Fill data structure: count the points of each grid element first and then place them,
+    // which keeps the indices of a grid element in ascending order
 
+    unsigned long ulX, ulY, ulZ;
+    for (const auto& pnt : *_pclPoints) {
+        Pos(pnt, ulX, ulY, ulZ);
+        if (CheckPos(ulX, ulY, ulZ)) {
+            _aulCellStart[CellIndex(ulX, ulY, ulZ) + 1]++;
+        }
+    }
+    std::partial_sum(_aulCellStart.begin(), _aulCellStart.end(), _aulCellStart.begin());
+
+    _aulCellPoints.resize(_aulCellStart.back());
+    _aclCellPoints.resize(_aulCellStart.back());
+    std::vector<unsigned long> next(_aulCellStart.begin(), _aulCellStart.end() - 1);
     unsigned long i = 0;
     for (const auto& pnt : *_pclPoints) {
-        AddPoint(pnt, i++);
+        Pos(pnt, ulX, ulY, ulZ);
+        if (CheckPos(ulX, ulY, ulZ)) {
+            unsigned long ulPos = next[CellIndex(ulX, ulY, ulZ)]++;
+            _aulCellPoints[ulPos] = i;
+            _aclCellPoints[ulPos] = Base::Vector3f(float(pnt.x), float(pnt.y), float(pnt.z));
+        }
+        i++;
     }
 }
 
@@ -815,9 +1060,7 @@ bool PointsGridIterator::InitOnRay(const Base::Vector3d& rclPt,
     // point lies within global BB
     if (_rclGrid.GetBoundBox().IsInBox(rclPt)) {  // determine the voxel by the starting point
         _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        _rclGrid.GetElements(_ulX, _ulY, _ulZ, raulElements);
         _bValidRay = true;
     }
     else {  // StartPoint outside
@@ -833,9 +1076,7 @@ bool PointsGridIterator::InitOnRay(const Base::Vector3d& rclPt,
                 _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
             }
 
-            raulElements.insert(raulElements.end(),
-                                _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                                _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+            _rclGrid.GetElements(_ulX, _ulY, _ulZ, raulElements);
             _bValidRay = true;
         }
     }
@@ -899,9 +1140,7 @@ bool PointsGridIterator::NextOnRay(std::vector<unsigned long>& raulElements)
     if (_bValidRay && _rclGrid.CheckPos(_ulX, _ulY, _ulZ)) {
         GridElement pos(_ulX, _ulY, _ulZ);
         _cSearchPositions.insert(pos);
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        _rclGrid.GetElements(_ulX, _ulY, _ulZ, raulElements);
     }
     else {
         _bValidRay = false;  // ray exited
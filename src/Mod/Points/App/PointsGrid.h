@@ -24,6 +24,8 @@
 #define POINTS_GRID_H
 
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <Base/BoundBox.h>
 #include <Base/Vector3D.h>
@@ -46,6 +48,9 @@ class PointsGrid;
  *
  * Grids can be used within algorithms to avoid to iterate through all elements, so grids can speed
  * up algorithms dramatically.
+ *
+ * The point indices are stored in one flat array sorted by grid element, together with a copy of
+ * their coordinates, so that neighbourhood queries touch contiguous memory.
  * @author Werner Mayer
  */
 class PointsExport PointsGrid
@@ -97,6 +102,33 @@ public:
     /** Searches for the nearest grids that contain elements from a point, the result are grid
      * indices. */
     void SearchNearestFromPoint(const Base::Vector3d& rclPt, std::set<unsigned long>& rclInd) const;
+    /** Searches for the \a ulCount points nearest to \a rclPt. The indices are written to
+     * \a raulElements sorted by increasing distance. Returns the number of found points which is
+     * less than \a ulCount only if the grid has fewer points. */
+    unsigned long SearchNearest(const Base::Vector3d& rclPt,
+                                unsigned long ulCount,
+                                std::vector<unsigned long>& raulElements) const;
+    /** Searches for the \a ulCount points nearest to each point of \a raclPts in parallel.
+     * Row \a i of \a raulElements holds the neighbours of the i-th point sorted by increasing
+     * distance. Returns the row length which is \a ulCount unless the grid has fewer points. */
+    unsigned long SearchNearest(const std::vector<Base::Vector3d>& raclPts,
+                                unsigned long ulCount,
+                                std::vector<unsigned long>& raulElements) const;
+    /** Searches for the \a ulCount points nearest to each point of the attached point kernel in
+     * parallel. Row \a i of \a raulElements holds the neighbours of the i-th point, which
+     * includes the point itself. Returns the row length. */
+    unsigned long SearchNearest(unsigned long ulCount, std::vector<unsigned long>& raulElements) const;
+    /** Searches for all points within the distance \a fRadius of \a rclPt. */
+    unsigned long SearchRadius(const Base::Vector3d& rclPt,
+                               double fRadius,
+                               std::vector<unsigned long>& raulElements) const;
+    /** Searches for all points within the distance \a fRadius of each point of \a raclPts in
+     * parallel. The neighbours of the i-th point are the elements of \a raulElements from
+     * \a raulOffsets[i] to \a raulOffsets[i+1]. */
+    void SearchRadius(const std::vector<Base::Vector3d>& raclPts,
+                      double fRadius,
+                      std::vector<unsigned long>& raulOffsets,
+                      std::vector<unsigned long>& raulElements) const;
     //@}
 
     /** Returns the lengths of the grid elements in x,y and z direction. */
@@ -125,7 +157,8 @@ public:
     /** Returns the number of elements in a given grid. */
     unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
     {
-        return _aulGrid[ulX][ulY][ulZ].size();
+        unsigned long ulCell = CellIndex(ulX, ulY, ulZ);
+        return _aulCellStart[ulCell + 1] - _aulCellStart[ulCell];
     }
     /** Finds all points that lie in the same grid as the point \a rclPoint. */
     unsigned long FindElements(const Base::Vector3d& rclPoint,
@@ -147,10 +180,20 @@ public:
                               unsigned long ulY,
                               unsigned long ulZ,
                               std::set<unsigned long>& raclInd) const;
+    /** Appends the indices of the elements in the given grid. */
+    unsigned long GetElements(unsigned long ulX,
+                              unsigned long ulY,
+                              unsigned long ulZ,
+                              std::vector<unsigned long>& raulInd) const;
 
 protected:
     /** Checks if this is a valid grid position. */
     inline bool CheckPos(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const;
+    /** Returns the position of a grid element in the flat cell arrays. */
+    unsigned long CellIndex(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+    {
+        return (ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX;
+    }
     /** Initializes the size of the internal structure. */
     virtual void InitGrid();
     /** Deletes the grid structure. */
@@ -174,10 +217,21 @@ protected:
                  unsigned long ulDistance,
                  std::set<unsigned long>& raclInd) const;
 
+private:
+    using Neighbour = std::pair<double, unsigned long>;
+    void NearestNeighbours(const Base::Vector3d& rclPt,
+                           unsigned long ulCount,
+                           std::vector<Neighbour>& raclHeap) const;
+    void RadiusNeighbours(const Base::Vector3d& rclPt,
+                          double fRadius,
+                          std::vector<unsigned long>& raulElements) const;
+
 protected:
-    std::vector<std::vector<std::vector<std::set<unsigned long>>>>
-        _aulGrid;                  /**< Grid data structure. */
-    const PointKernel* _pclPoints; /**< The point kernel. */
+    /** Offset of the first element of each grid in _aulCellPoints, with a final end offset. */
+    std::vector<unsigned long> _aulCellStart;
+    std::vector<unsigned long> _aulCellPoints; /**< Point indices sorted by grid element. */
+    std::vector<Base::Vector3f> _aclCellPoints; /**< Coordinates in the order of _aulCellPoints. */
+    const PointKernel* _pclPoints;              /**< The point kernel. */
     unsigned long _ulCtElements;   /**< Number of grid elements for validation issues. */
     unsigned long _ulCtGridsX;     /**< Number of grid elements in z. */
     unsigned long _ulCtGridsY;     /**< Number of grid elements in z. */
@@ -193,11 +247,7 @@ protected:
     friend class PointsGridIterator;
     friend class PointsGridIteratorStatistic;
 
-public:
 protected:
-    /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a
-     * ulPtIndex the corresponding index in the point kernel. */
-    void AddPoint(const Base::Vector3d& rclPt, unsigned long ulPtIndex, float fEpsilon = 0.0f);
     /** Returns the grid numbers to the given point \a rclPoint. */
     void Pos(const Base::Vector3d& rclPoint,
              unsigned long& rulX,
@@ -222,9 +272,7 @@ public:
     /** Returns indices of the elements in the current grid. */
     void GetElements(std::vector<unsigned long>& raulElements) const
     {
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        _rclGrid.GetElements(_ulX, _ulY, _ulZ, raulElements);
     }
     /** @name Iteration */
     //@{
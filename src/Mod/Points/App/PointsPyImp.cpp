@@ -31,6 +31,7 @@
 #include <Base/VectorPy.h>
 
 #include "Points.h"
+#include "PointsGrid.h"
 // inclusion of the generated files (generated out of PointsPy.xml)
 // clang-format off
 #include "PointsPy.h"
@@ -244,6 +245,108 @@ PyObject* PointsPy::fromValid(PyObject* args)
     }
 }
 
+namespace
+{
+std::vector<Base::Vector3d> getPointsFromSequence(PyObject* obj)
+{
+    std::vector<Base::Vector3d> points;
+    Py::Sequence list(obj);
+    Py::Type vType(Base::getTypeAsObject(&Base::VectorPy::Type));
+    points.reserve(list.size());
+    for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+        if ((*it).isType(vType)) {
+            points.push_back(Py::Vector(*it).toVector());
+        }
+        else {
+            Py::Tuple tuple(*it);
+            points.emplace_back((double)Py::Float(tuple[0]),
+                                (double)Py::Float(tuple[1]),
+                                (double)Py::Float(tuple[2]));
+        }
+    }
+    return points;
+}
+}  // namespace
+
+PyObject* PointsPy::searchNearest(PyObject* args)
+{
+    PyObject* obj;
+    unsigned long count;
+    if (!PyArg_ParseTuple(args, "Ok", &obj, &count)) {
+        return nullptr;
+    }
+
+    std::vector<Base::Vector3d> points;
+    try {
+        points = getPointsFromSequence(obj);
+    }
+    catch (const Py::Exception&) {
+        PyErr_SetString(PyExc_TypeError,
+                        "either expect\n"
+                        "-- [Vector,...] \n"
+                        "-- [(x,y,z),...]");
+        return nullptr;
+    }
+
+    PY_TRY
+    {
+        PointsGrid grid(*getPointKernelPtr());
+        std::vector<unsigned long> indices;
+        unsigned long row = grid.SearchNearest(points, count, indices);
+
+        Py::List result;
+        for (std::size_t i = 0; i < points.size(); i++) {
+            Py::Tuple tuple(row);
+            for (unsigned long j = 0; j < row; j++) {
+                tuple.setItem(j, Py::Long(indices[i * row + j]));
+            }
+            result.append(tuple);
+        }
+        return Py::new_reference_to(result);
+    }
+    PY_CATCH;
+}
+
+PyObject* PointsPy::searchRadius(PyObject* args)
+{
+    PyObject* obj;
+    double radius;
+    if (!PyArg_ParseTuple(args, "Od", &obj, &radius)) {
+        return nullptr;
+    }
+
+    std::vector<Base::Vector3d> points;
+    try {
+        points = getPointsFromSequence(obj);
+    }
+    catch (const Py::Exception&) {
+        PyErr_SetString(PyExc_TypeError,
+                        "either expect\n"
+                        "-- [Vector,...] \n"
+                        "-- [(x,y,z),...]");
+        return nullptr;
+    }
+
+    PY_TRY
+    {
+        PointsGrid grid(*getPointKernelPtr());
+        std::vector<unsigned long> offsets;
+        std::vector<unsigned long> indices;
+        grid.SearchRadius(points, radius, offsets, indices);
+
+        Py::List result;
+        for (std::size_t i = 0; i < points.size(); i++) {
+            Py::Tuple tuple(offsets[i + 1] - offsets[i]);
+            for (unsigned long j = offsets[i]; j < offsets[i + 1]; j++) {
+                tuple.setItem(j - offsets[i], Py::Long(indices[j]));
+            }
+            result.append(tuple);
+        }
+        return Py::new_reference_to(result);
+    }
+    PY_CATCH;
+}
+
 Py::Long PointsPy::getCountPoints() const
 {
     return Py::Long((long)getPointKernelPtr()->size());
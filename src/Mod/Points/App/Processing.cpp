@@ -0,0 +1,376 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#endif
+
+#include <Eigen/Eigenvalues>
+#include <boost/functional/hash.hpp>
+
+#include <Base/Parallel.h>
+
+#include "Points.h"
+#include "PointsGrid.h"
+#include "Processing.h"
+#include "Properties.h"
+
+
+using namespace Points;
+
+NormalEstimation::NormalEstimation(const PointKernel& pts)
+    : myPoints(pts)
+{}
+
+void NormalEstimation::setNumberOfNeighbours(unsigned long num)
+{
+    myNeighbours = std::max<unsigned long>(num, 3);
+}
+
+void NormalEstimation::setViewPoint(const Base::Vector3d& pnt)
+{
+    myViewPoint = pnt;
+    hasViewPoint = true;
+}
+
+void NormalEstimation::perform(std::vector<Base::Vector3f>& normals) const
+{
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    normals.resize(points.size());
+    if (points.empty()) {
+        return;
+    }
+
+    PointsGrid grid(myPoints);
+    std::vector<unsigned long> neighbours;
+    unsigned long row = grid.SearchNearest(myNeighbours, neighbours);
+
+    // The covariance is computed from the untransformed points and the normal is rotated
+    // afterwards into the global coordinate system
+    Base::Matrix4D rot = myPoints.getTransform();
+    rot.setCol(3, Base::Vector3d());
+
+    Base::parallelForRange(points.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const unsigned long* nb = neighbours.data() + i * row;
+            Eigen::Vector3d center = Eigen::Vector3d::Zero();
+            for (unsigned long j = 0; j < row; j++) {
+                const PointKernel::value_type& p = points[nb[j]];
+                center += Eigen::Vector3d(p.x, p.y, p.z);
+            }
+            center /= double(row);
+
+            Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+            for (unsigned long j = 0; j < row; j++) {
+                const PointKernel::value_type& p = points[nb[j]];
+                Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - center;
+                cov.selfadjointView<Eigen::Lower>().rankUpdate(d);
+            }
+
+            // the eigenvector of the smallest eigenvalue is the normal of the fitted plane
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+            solver.computeDirect(cov);
+            Eigen::Vector3d n = solver.eigenvectors().col(0);
+            Base::Vector3d normal = rot * Base::Vector3d(n.x(), n.y(), n.z());
+            normal.Normalize();
+            normals[i] = Base::toVector<float>(normal);
+        }
+    });
+
+    if (hasViewPoint) {
+        orientToViewPoint(normals);
+    }
+    else {
+        orientConsistently(neighbours, row, normals);
+    }
+}
+
+void NormalEstimation::perform(PropertyNormalList& prop) const
+{
+    std::vector<Base::Vector3f> normals;
+    perform(normals);
+    prop.setValues(std::move(normals));
+}
+
+void NormalEstimation::orientToViewPoint(std::vector<Base::Vector3f>& normals) const
+{
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    Base::Matrix4D mat = myPoints.getTransform();
+    Base::parallelForRange(points.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Base::Vector3d pnt = mat * Base::toVector<double>(points[i]);
+            if ((myViewPoint - pnt) * Base::toVector<double>(normals[i]) < 0.0) {
+                normals[i] = -normals[i];
+            }
+        }
+    });
+}
+
+void NormalEstimation::orientConsistently(const std::vector<unsigned long>& neighbours,
+                                          unsigned long row,
+                                          std::vector<Base::Vector3f>& normals) const
+{
+    // Propagate the orientation along a minimum spanning tree of the neighbourhood graph where
+    // the weight of an edge is small if the two normals are nearly parallel. Each connected
+    // component is seeded with its highest point whose normal is oriented upwards.
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+
+    // The k-nearest-neighbour relation isn't symmetric, e.g. a point off a dense patch has it as
+    // its neighbours but isn't a neighbour of any of them. Make the graph undirected so that
+    // such points are reached from the patch, stored as adjacency lists in flat arrays.
+    std::vector<std::size_t> adjacencyStart(points.size() + 1, 0);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const unsigned long* nb = neighbours.data() + i * row;
+        for (unsigned long j = 0; j < row; j++) {
+            if (nb[j] != i) {
+                adjacencyStart[i + 1]++;
+                adjacencyStart[nb[j] + 1]++;
+            }
+        }
+    }
+    std::partial_sum(adjacencyStart.begin(), adjacencyStart.end(), adjacencyStart.begin());
+    std::vector<unsigned long> adjacency(adjacencyStart.back());
+    std::vector<std::size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const unsigned long* nb = neighbours.data() + i * row;
+        for (unsigned long j = 0; j < row; j++) {
+            if (nb[j] != i) {
+                adjacency[fill[i]++] = nb[j];
+                adjacency[fill[nb[j]]++] = static_cast<unsigned long>(i);
+            }
+        }
+    }
+
+    Base::Matrix4D mat = myPoints.getTransform();
+    std::vector<double> height(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        height[i] = (mat * Base::toVector<double>(points[i])).z;
+    }
+
+    std::vector<unsigned long> seeds(points.size());
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::sort(seeds.begin(), seeds.end(), [&height](unsigned long a, unsigned long b) {
+        return height[a] > height[b];
+    });
+
+    // weight, source and target of an edge
+    using Edge = std::tuple<float, unsigned long, unsigned long>;
+    std::priority_queue<Edge, std::vector<Edge>, std::greater<>> queue;
+    std::vector<bool> visited(points.size(), false);
+
+    auto visit = [&](unsigned long index) {
+        visited[index] = true;
+        const Base::Vector3f& normal = normals[index];
+        for (std::size_t e = adjacencyStart[index]; e < adjacencyStart[index + 1]; e++) {
+            unsigned long target = adjacency[e];
+            if (!visited[target]) {
+                float weight = 1.0F - std::fabs(normal * normals[target]);
+                queue.emplace(weight, index, target);
+            }
+        }
+    };
+
+    for (unsigned long seed : seeds) {
+        if (visited[seed]) {
+            continue;
+        }
+        if (normals[seed].z < 0.0F) {
+            normals[seed] = -normals[seed];
+        }
+        visit(seed);
+
+        while (!queue.empty()) {
+            unsigned long source = std::get<1>(queue.top());
+            unsigned long target = std::get<2>(queue.top());
+            queue.pop();
+            if (visited[target]) {
+                continue;
+            }
+            if (normals[source] * normals[target] < 0.0F) {
+                normals[target] = -normals[target];
+            }
+            visit(target);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+OutlierRemoval::OutlierRemoval(const PointKernel& pts)
+    : myPoints(pts)
+{}
+
+void OutlierRemoval::setNumberOfNeighbours(unsigned long num)
+{
+    myNeighbours = std::max<unsigned long>(num, 1);
+}
+
+void OutlierRemoval::setStandardDeviationFactor(double factor)
+{
+    myFactor = factor;
+}
+
+std::vector<unsigned long> OutlierRemoval::perform() const
+{
+    std::vector<unsigned long> outliers;
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    if (points.size() < 2) {
+        return outliers;
+    }
+
+    PointsGrid grid(myPoints);
+    std::vector<unsigned long> neighbours;
+    unsigned long row = grid.SearchNearest(myNeighbours + 1, neighbours);
+
+    // mean distance of each point to its neighbours, not counting the point itself
+    std::vector<double> distance(points.size());
+    Base::parallelForRange(points.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const unsigned long* nb = neighbours.data() + i * row;
+            double sum = 0.0;
+            unsigned long count = 0;
+            for (unsigned long j = 0; j < row && count < row - 1; j++) {
+                if (nb[j] != i) {
+                    sum += Base::Distance(points[i], points[nb[j]]);
+                    count++;
+                }
+            }
+            distance[i] = sum / double(count);
+        }
+    });
+
+    double mean = std::accumulate(distance.begin(), distance.end(), 0.0) / double(points.size());
+    double variance = 0.0;
+    for (double d : distance) {
+        variance += (d - mean) * (d - mean);
+    }
+    double stddev = std::sqrt(variance / double(points.size() - 1));
+    double threshold = mean + myFactor * stddev;
+
+    for (std::size_t i = 0; i < distance.size(); i++) {
+        if (distance[i] > threshold) {
+            outliers.push_back(i);
+        }
+    }
+
+    return outliers;
+}
+
+// ----------------------------------------------------------------------------
+
+VoxelGrid::VoxelGrid(const PointKernel& pts)
+    : myPoints(pts)
+{}
+
+void VoxelGrid::setVoxelSize(double size)
+{
+    mySize = size;
+}
+
+void VoxelGrid::perform(PointKernel& out) const
+{
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    std::vector<PointKernel::value_type> result;
+    if (points.empty() || !(mySize > 0.0) || !std::isfinite(mySize)) {
+        result = points;
+        out.swap(result);
+        out.setTransform(myPoints.getTransform());
+        return;
+    }
+
+    auto isFinite = [](const PointKernel::value_type& pnt) {
+        return std::isfinite(pnt.x) && std::isfinite(pnt.y) && std::isfinite(pnt.z);
+    };
+
+    // The voxels are built in the local coordinate system so that the placement is kept.
+    // Points with non-finite coordinates don't belong to any voxel and are dropped.
+    Base::BoundBox3d box;
+    for (const auto& pnt : points) {
+        if (isFinite(pnt)) {
+            box.Add(Base::toVector<double>(pnt));
+        }
+    }
+
+    // The voxel indices are kept separately instead of being packed into one integer which
+    // overflows for small voxels. They are clamped so that the conversion is defined even
+    // if the voxel is too small to be resolved with doubles.
+    using VoxelKey = std::array<std::uint64_t, 3>;
+    struct VoxelKeyHash
+    {
+        std::size_t operator()(const VoxelKey& key) const
+        {
+            return boost::hash_range(key.begin(), key.end());
+        }
+    };
+    auto index = [this](double value, double minValue) {
+        constexpr double maxIndex = 9.0e18;
+        double cell = std::floor((value - minValue) / mySize);
+        return static_cast<std::uint64_t>(std::min(cell, maxIndex));
+    };
+
+    std::vector<VoxelKey> keys(points.size());
+    std::vector<char> valid(points.size());
+    Base::parallelForRange(points.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const PointKernel::value_type& pnt = points[i];
+            valid[i] = isFinite(pnt);
+            if (valid[i]) {
+                keys[i] = {index(pnt.x, box.MinX), index(pnt.y, box.MinY), index(pnt.z, box.MinZ)};
+            }
+        }
+    });
+
+    // Voxels are numbered in the order of their first point to get a deterministic result
+    std::unordered_map<VoxelKey, std::size_t, VoxelKeyHash> voxels;
+    std::vector<Base::Vector3d> sum;
+    std::vector<std::size_t> count;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (!valid[i]) {
+            continue;
+        }
+        auto it = voxels.emplace(keys[i], sum.size());
+        if (it.second) {
+            sum.emplace_back();
+            count.push_back(0);
+        }
+        sum[it.first->second] += Base::toVector<double>(points[i]);
+        count[it.first->second]++;
+    }
+
+    result.reserve(sum.size());
+    for (std::size_t i = 0; i < sum.size(); i++) {
+        result.push_back(Base::toVector<float>(sum[i] / double(count[i])));
+    }
+
+    out.swap(result);
+    out.setTransform(myPoints.getTransform());
+}
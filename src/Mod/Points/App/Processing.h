@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2023 The FreeCAD Project Association                     *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef POINTS_PROCESSING_H
+#define POINTS_PROCESSING_H
+
+#include <vector>
+
+#include <Base/Vector3D.h>
+#include <Mod/Points/PointsGlobal.h>
+
+
+namespace Points
+{
+
+class PointKernel;
+class PropertyNormalList;
+
+/*! Estimates the normals of a point cloud from the covariance of the k nearest neighbours of
+ * each point. The normals are either oriented towards a view point or, if none is set,
+ * consistently oriented by propagating along a minimum spanning tree of the neighbourhood graph.
+ */
+class PointsExport NormalEstimation
+{
+public:
+    explicit NormalEstimation(const PointKernel&);
+
+    void setNumberOfNeighbours(unsigned long);
+    /// Orients all normals towards the given point instead of propagating the orientation
+    void setViewPoint(const Base::Vector3d&);
+
+    void perform(std::vector<Base::Vector3f>& normals) const;
+    void perform(PropertyNormalList& normals) const;
+
+private:
+    void orientToViewPoint(std::vector<Base::Vector3f>& normals) const;
+    void orientConsistently(const std::vector<unsigned long>& neighbours,
+                            unsigned long row,
+                            std::vector<Base::Vector3f>& normals) const;
+
+private:
+    const PointKernel& myPoints;
+    unsigned long myNeighbours {10};
+    Base::Vector3d myViewPoint;
+    bool hasViewPoint {false};
+};
+
+/*! Statistical outlier removal: for each point the mean distance to its k nearest neighbours is
+ * computed. Points whose mean distance exceeds the global mean by more than the given multiple
+ * of the standard deviation are reported as outliers.
+ */
+class PointsExport OutlierRemoval
+{
+public:
+    explicit OutlierRemoval(const PointKernel&);
+
+    void setNumberOfNeighbours(unsigned long);
+    void setStandardDeviationFactor(double);
+
+    /// Returns the sorted indices of the outliers, suitable for removeIndices()
+    std::vector<unsigned long> perform() const;
+
+private:
+    const PointKernel& myPoints;
+    unsigned long myNeighbours {10};
+    double myFactor {1.0};
+};
+
+/*! Reduces a point cloud by replacing all points inside a cubic voxel by their centroid.
+ * Points with non-finite coordinates are dropped.
+ */
+class PointsExport VoxelGrid
+{
+public:
+    explicit VoxelGrid(const PointKernel&);
+
+    void setVoxelSize(double);
+
+    /// Writes the reduced points into \a out which gets the same placement as the input
+    void perform(PointKernel& out) const;
+
+private:
+    const PointKernel& myPoints;
+    double mySize {1.0};
+};
+
+}  // namespace Points
+
+
+#endif  // POINTS_PROCESSING_H
@@ -254,6 +254,13 @@ void PropertyNormalList::setValues(const std::vector<Base::Vector3f>& values)
     hasSetValue();
 }
 
+void PropertyNormalList::setValues(std::vector<Base::Vector3f>&& values)
+{
+    aboutToSetValue();
+    _lValueList = std::move(values);
+    hasSetValue();
+}
+
 PyObject* PropertyNormalList::getPyObject()
 {
     PyObject* list = PyList_New(getSize());
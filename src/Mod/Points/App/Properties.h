@@ -123,6 +123,7 @@ public:
     }
 
     void setValues(const std::vector<Base::Vector3f>& values);
+    void setValues(std::vector<Base::Vector3f>&& values);
 
     const std::vector<Base::Vector3f>& getValues() const
     {
@@ -26,6 +26,7 @@
 
 #include <App/DocumentObject.h>
 #include <algorithm>
+#include <vector>
 
 namespace Points
 {
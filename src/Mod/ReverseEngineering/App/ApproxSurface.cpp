@@ -22,25 +22,23 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
-#include <QFuture>
-#include <QFutureWatcher>
+#include <QThread>
 #include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include <Geom_BSplineSurface.hxx>
 #include <Precision.hxx>
-#include <math_Gauss.hxx>
-#include <math_Householder.hxx>
 #endif
 
 #include <Base/Sequencer.h>
-#include <Base/Tools.h>
 #include <Mod/Mesh/App/Core/Approximation.h>
 
 #include "ApproxSurface.h"
 
 
 using namespace Reen;
-namespace sp = std::placeholders;
 
 // SplineBasisfunction
 
@@ -935,6 +933,7 @@ void BSplineParameterCorrection::SetUKnots(const std::vector<double>& afKnots)
 
     // Set the B-spline basic functions
     _clUSpline.SetKnots(_vUKnots, _vUMults, _usUOrder);
+    _vBasisParam.clear();
 }
 
 void BSplineParameterCorrection::SetVKnots(const std::vector<double>& afKnots)
@@ -956,6 +955,7 @@ void BSplineParameterCorrection::SetVKnots(const std::vector<double>& afKnots)
 
     // Set the B-spline basic functions
     _clVSpline.SetKnots(_vVKnots, _vVMults, _usVOrder);
+    _vBasisParam.clear();
 }
 
 void BSplineParameterCorrection::DoParameterCorrection(int iIter)
@@ -1035,230 +1035,332 @@ void BSplineParameterCorrection::DoParameterCorrection(int iIter)
     } while (i < iIter && fMaxDiff > Precision::Confusion() && fMaxScalar < 0.99);
 }
 
-bool BSplineParameterCorrection::SolveWithoutSmoothing()
+namespace
+{
+// Symmetric positive definite band matrix of which only the lower band is stored
+class BandMatrix
 {
-    unsigned ulSize = _pvcPoints->Length();
-    unsigned ulDim = _usUCtrlpoints * _usVCtrlpoints;
-    math_Matrix M(0, ulSize - 1, 0, ulDim - 1);
-    math_Matrix Xx(0, ulDim - 1, 0, 0);
-    math_Matrix Xy(0, ulDim - 1, 0, 0);
-    math_Matrix Xz(0, ulDim - 1, 0, 0);
-    math_Vector bx(0, ulSize - 1);
-    math_Vector by(0, ulSize - 1);
-    math_Vector bz(0, ulSize - 1);
-
-    // Determining the coefficient matrix of the overdetermined LGS
-    for (unsigned i = 0; i < ulSize; i++) {
-        const gp_Pnt2d& uvValue = (*_pvcUVParam)(i);
-        double fU = uvValue.X();
-        double fV = uvValue.Y();
-        unsigned ulIdx = 0;
-
-        // Pre-calculation of the values of the base functions
-        std::vector<double> basisU(_usUCtrlpoints);
-        for (unsigned j = 0; j < _usUCtrlpoints; j++) {
-            basisU[j] = _clUSpline.BasisFunction(j, fU);
+public:
+    BandMatrix(int size, int bandwidth)
+        : size(size)
+        , width(bandwidth + 1)
+        , values(static_cast<std::size_t>(size) * static_cast<std::size_t>(width), 0.0)
+    {}
+    // Only valid for j <= i && i - j < width
+    double& operator()(int i, int j)
+    {
+        return values[static_cast<std::size_t>(i) * width + (i - j)];
+    }
+    int Size() const
+    {
+        return size;
+    }
+    int Width() const
+    {
+        return width;
+    }
+    BandMatrix& operator+=(const BandMatrix& mat)
+    {
+        for (std::size_t i = 0; i < values.size(); i++) {
+            values[i] += mat.values[i];
         }
-        std::vector<double> basisV(_usVCtrlpoints);
-        for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-            basisV[k] = _clVSpline.BasisFunction(k, fV);
+        return *this;
+    }
+    double MaxDiagonal() const
+    {
+        double value = 0.0;
+        for (int i = 0; i < size; i++) {
+            value = std::max(value, values[static_cast<std::size_t>(i) * width]);
         }
-
-        for (unsigned j = 0; j < _usUCtrlpoints; j++) {
-            double valueU = basisU[j];
-            if (valueU == 0.0) {
-                for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-                    M(i, ulIdx) = 0.0;
-                    ulIdx++;
+        return value;
+    }
+    // In-place decomposition into L * L^T. Fails if a pivot drops below 'tolerance' times the
+    // largest diagonal element, i.e. if the matrix is singular or nearly so.
+    bool Cholesky(double tolerance)
+    {
+        double minPivot = tolerance * MaxDiagonal();
+        for (int i = 0; i < size; i++) {
+            for (int j = std::max(0, i - width + 1); j <= i; j++) {
+                double sum = (*this)(i, j);
+                for (int k = std::max(0, i - width + 1); k < j; k++) {
+                    sum -= (*this)(i, k) * (*this)(j, k);
                 }
-            }
-            else {
-                for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-                    M(i, ulIdx) = valueU * basisV[k];
-                    ulIdx++;
+                if (i == j) {
+                    if (!(sum > minPivot)) {
+                        return false;
+                    }
+                    (*this)(i, i) = std::sqrt(sum);
+                }
+                else {
+                    (*this)(i, j) = sum / (*this)(j, j);
                 }
             }
         }
+        return true;
     }
-
-    // Determine the right side
-    for (int ii = _pvcPoints->Lower(); ii <= _pvcPoints->Upper(); ii++) {
-        const gp_Pnt& pnt = (*_pvcPoints)(ii);
-        bx(ii) = pnt.X();
-        by(ii) = pnt.Y();
-        bz(ii) = pnt.Z();
+    // Solves L * L^T * x = b after Cholesky()
+    void Solve(std::vector<double>& b)
+    {
+        for (int i = 0; i < size; i++) {
+            double sum = b[i];
+            for (int k = std::max(0, i - width + 1); k < i; k++) {
+                sum -= (*this)(i, k) * b[k];
+            }
+            b[i] = sum / (*this)(i, i);
+        }
+        for (int i = size - 1; i >= 0; i--) {
+            double sum = b[i];
+            for (int k = i + 1; k < std::min(size, i + width); k++) {
+                sum -= (*this)(k, i) * b[k];
+            }
+            b[i] = sum / (*this)(i, i);
+        }
     }
 
-    // Solve the over-determined LGS with Householder-Transformation
-    math_Householder hhX(M, bx);
-    math_Householder hhY(M, by);
-    math_Householder hhZ(M, bz);
+private:
+    int size;
+    int width;
+    std::vector<double> values;
+};
 
-    if (!(hhX.IsDone() && hhY.IsDone() && hhZ.IsDone())) {
-        // LGS could not be solved
-        return false;
-    }
-    Xx = hhX.AllValues();
-    Xy = hhY.AllValues();
-    Xz = hhZ.AllValues();
+// Part of the normal equations accumulated from a range of points
+struct NormalEquations
+{
+    NormalEquations(int begin, int end, int size, int bandwidth)
+        : begin(begin)
+        , end(end)
+        , mat(size, bandwidth)
+        , bx(size, 0.0)
+        , by(size, 0.0)
+        , bz(size, 0.0)
+    {}
+    int begin;
+    int end;
+    BandMatrix mat;
+    std::vector<double> bx, by, bz;
+};
 
-    unsigned ulIdx = 0;
-    for (unsigned j = 0; j < _usUCtrlpoints; j++) {
-        for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-            _vCtrlPntsOfSurf(j, k) = gp_Pnt(Xx(ulIdx, 0), Xy(ulIdx, 0), Xz(ulIdx, 0));
-            ulIdx++;
+// Adds weight * D^T * D to the matrix where D takes the differences of neighbouring control points
+// in u and in v. Second differences are used where the bandwidth allows it, they vanish for a
+// planar control net.
+void addDifferencePenalty(BandMatrix& mat,
+                          int numU,
+                          int numV,
+                          int uOrder,
+                          int vOrder,
+                          double weight)
+{
+    auto addStencil = [&](int first, int step, int length) {
+        static const double firstDiff[] = {1.0, -1.0};
+        static const double secondDiff[] = {1.0, -2.0, 1.0};
+        const double* coeff = length == 3 ? secondDiff : firstDiff;
+        for (int a = 0; a < length; a++) {
+            for (int b = 0; b <= a; b++) {
+                mat(first + a * step, first + b * step) += weight * coeff[a] * coeff[b];
+            }
         }
-    }
+    };
 
-    return true;
+    int lengthU = std::min(3, uOrder);
+    for (int i = 0; i + lengthU <= numU; i++) {
+        for (int j = 0; j < numV; j++) {
+            addStencil(i * numV + j, numV, lengthU);
+        }
+    }
+    int lengthV = std::min(3, vOrder);
+    for (int i = 0; i < numU; i++) {
+        for (int j = 0; j + lengthV <= numV; j++) {
+            addStencil(i * numV + j, 1, lengthV);
+        }
+    }
 }
 
-namespace Reen
+// Splits [0, count) into one range per thread, but not into ranges smaller than 'minSize'
+std::vector<std::pair<int, int>> splitRange(int count, int minSize)
 {
-class ScalarProduct
+    int parts = std::max(1, std::min(QThread::idealThreadCount(), count / minSize));
+    std::vector<std::pair<int, int>> ranges;
+    for (int i = 0; i < parts; i++) {
+        ranges.emplace_back(count * i / parts, count * (i + 1) / parts);
+    }
+    return ranges;
+}
+
+// Integrals of the products of the r-th and s-th derivatives of all pairs of basis functions.
+// Functions without overlapping support give zero and are skipped.
+std::vector<double> integralTable(BSplineBasis& basis, int num, unsigned order, int r, int s)
 {
-public:
-    explicit ScalarProduct(const math_Matrix& mat)
-        : mat(mat)
-    {}
-    std::vector<double> multiply(int col) const
-    {
-        math_Vector vec = mat.Col(col);
-        std::vector<double> out(mat.ColNumber());
-        for (int n = mat.LowerCol(); n <= mat.UpperCol(); n++) {
-            out[n] = vec * mat.Col(n);
+    int width = static_cast<int>(order);
+    std::vector<double> table(static_cast<std::size_t>(num) * num, 0.0);
+    for (int i = 0; i < num; i++) {
+        for (int k = std::max(0, i - width + 1); k < std::min(num, i + width); k++) {
+            table[i * num + k] = basis.GetIntegralOfProductOfBSplines(i, k, r, s);
         }
-        return out;
     }
+    return table;
+}
+}  // namespace
 
-private:
-    const math_Matrix& mat;
-};
-}  // namespace Reen
-
-bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
+void BSplineParameterCorrection::CalcBasisFunctions()
 {
-    unsigned ulSize = _pvcPoints->Length();
-    unsigned ulDim = _usUCtrlpoints * _usVCtrlpoints;
-    math_Matrix M(0, ulSize - 1, 0, ulDim - 1);
-    math_Vector Xx(0, ulDim - 1);
-    math_Vector Xy(0, ulDim - 1);
-    math_Vector Xz(0, ulDim - 1);
-    math_Vector bx(0, ulSize - 1);
-    math_Vector by(0, ulSize - 1);
-    math_Vector bz(0, ulSize - 1);
-    math_Vector Mbx(0, ulDim - 1);
-    math_Vector Mby(0, ulDim - 1);
-    math_Vector Mbz(0, ulDim - 1);
-
-    // Determining the coefficient matrix of the overdetermined LGS
-    for (unsigned i = 0; i < ulSize; i++) {
-        const gp_Pnt2d& uvValue = (*_pvcUVParam)(i);
-        double fU = uvValue.X();
-        double fV = uvValue.Y();
-        int ulIdx = 0;
-
-        // Pre-calculation of the values of the basis functions
-        std::vector<double> basisU(_usUCtrlpoints);
-        for (unsigned j = 0; j < _usUCtrlpoints; j++) {
-            basisU[j] = _clUSpline.BasisFunction(j, fU);
-        }
-        std::vector<double> basisV(_usVCtrlpoints);
-        for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-            basisV[k] = _clVSpline.BasisFunction(k, fV);
+    int numPoints = _pvcUVParam->Length();
+    int lower = _pvcUVParam->Lower();
+    int uOrder = static_cast<int>(_usUOrder);
+    int vOrder = static_cast<int>(_usVOrder);
+    int stride = uOrder + vOrder;
+
+    if (_vBasisParam.size() != static_cast<std::size_t>(numPoints)) {
+        // NaN never compares equal so that all points are evaluated
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        _vBasisParam.assign(numPoints, gp_Pnt2d(nan, nan));
+        _vBasisSpan.resize(2 * numPoints);
+        _vBasisValues.resize(static_cast<std::size_t>(stride) * numPoints);
+    }
+
+    double uMin = _vUKnots(_vUKnots.Lower());
+    double uMax = _vUKnots(_vUKnots.Upper());
+    double vMin = _vVKnots(_vVKnots.Lower());
+    double vMax = _vVKnots(_vVKnots.Upper());
+
+    std::vector<std::pair<int, int>> ranges = splitRange(numPoints, 1024);
+    QtConcurrent::blockingMap(ranges, [&](const std::pair<int, int>& range) {
+        TColStd_Array1OfReal valuesU(0, uOrder - 1);
+        TColStd_Array1OfReal valuesV(0, vOrder - 1);
+        for (int i = range.first; i < range.second; i++) {
+            const gp_Pnt2d& uvValue = (*_pvcUVParam)(lower + i);
+            gp_Pnt2d& cached = _vBasisParam[i];
+            if (uvValue.X() == cached.X() && uvValue.Y() == cached.Y()) {
+                continue;
+            }
+
+            double* values = &_vBasisValues[static_cast<std::size_t>(stride) * i];
+            cached = uvValue;
+            if (uvValue.X() < uMin || uvValue.X() > uMax || uvValue.Y() < vMin
+                || uvValue.Y() > vMax) {
+                // all basis functions vanish outside the domain
+                _vBasisSpan[2 * i] = 0;
+                _vBasisSpan[2 * i + 1] = 0;
+                std::fill(values, values + stride, 0.0);
+                continue;
+            }
+
+            // Only the 'order' basis functions ending at the knot span are non-zero
+            _clUSpline.AllBasisFunctions(uvValue.X(), valuesU);
+            _clVSpline.AllBasisFunctions(uvValue.Y(), valuesV);
+            _vBasisSpan[2 * i] = _clUSpline.FindSpan(uvValue.X()) - uOrder + 1;
+            _vBasisSpan[2 * i + 1] = _clVSpline.FindSpan(uvValue.Y()) - vOrder + 1;
+            for (int j = 0; j < uOrder; j++) {
+                values[j] = valuesU(j);
+            }
+            for (int k = 0; k < vOrder; k++) {
+                values[uOrder + k] = valuesV(k);
+            }
         }
+    });
+}
 
-        for (unsigned j = 0; j < _usUCtrlpoints; j++) {
-            double valueU = basisU[j];
-            if (valueU == 0.0) {
-                for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-                    M(i, ulIdx) = 0.0;
-                    ulIdx++;
+bool BSplineParameterCorrection::SolveNormalEquations(double fWeight)
+{
+    CalcBasisFunctions();
+
+    int numPoints = _pvcPoints->Length();
+    int lower = _pvcPoints->Lower();
+    int uOrder = static_cast<int>(_usUOrder);
+    int vOrder = static_cast<int>(_usVOrder);
+    int numV = static_cast<int>(_usVCtrlpoints);
+    int ulDim = static_cast<int>(_usUCtrlpoints * _usVCtrlpoints);
+    int stride = uOrder + vOrder;
+
+    // With the control points ordered row by row two basis functions can only overlap
+    // if their indices differ by at most this value
+    int bandwidth = (uOrder - 1) * numV + vOrder - 1;
+
+    // Each thread accumulates M^T * M and M^T * b for its points
+    std::vector<NormalEquations> parts;
+    for (const auto& range : splitRange(numPoints, 4096)) {
+        parts.emplace_back(range.first, range.second, ulDim, bandwidth);
+    }
+
+    QtConcurrent::blockingMap(parts, [&](NormalEquations& part) {
+        std::vector<int> index(uOrder * vOrder);
+        std::vector<double> value(uOrder * vOrder);
+        for (int i = part.begin; i < part.end; i++) {
+            int spanU = _vBasisSpan[2 * i];
+            int spanV = _vBasisSpan[2 * i + 1];
+            const double* basis = &_vBasisValues[static_cast<std::size_t>(stride) * i];
+            int num = 0;
+            for (int j = 0; j < uOrder; j++) {
+                for (int k = 0; k < vOrder; k++) {
+                    index[num] = (spanU + j) * numV + spanV + k;
+                    value[num] = basis[j] * basis[uOrder + k];
+                    num++;
                 }
             }
-            else {
-                for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-                    M(i, ulIdx) = valueU * basisV[k];
-                    ulIdx++;
+
+            // the indices are increasing
+            const gp_Pnt& pnt = (*_pvcPoints)(lower + i);
+            for (int m = 0; m < num; m++) {
+                double vm = value[m];
+                for (int n = 0; n <= m; n++) {
+                    part.mat(index[m], index[n]) += vm * value[n];
                 }
+                part.bx[index[m]] += vm * pnt.X();
+                part.by[index[m]] += vm * pnt.Y();
+                part.bz[index[m]] += vm * pnt.Z();
             }
         }
-    }
-
-    // The product of its transform and itself results in the quadratic
-    // system matrix (slowly)
-#if 0
-    math_Matrix MTM = M.TMultiply(M);
-#elif 0
-    math_Matrix MTM(0, ulDim - 1, 0, ulDim - 1);
-    for (unsigned m = 0; m < ulDim; m++) {
-        math_Vector Mm = M.Col(m);
-        for (unsigned n = m; n < ulDim; n++) {
-            MTM(m, n) = MTM(n, m) = Mm * M.Col(n);
-        }
-    }
-#else  // multi-threaded
-    std::vector<int> columns(ulDim);
-    std::generate(columns.begin(), columns.end(), Base::iotaGen<int>(0));
-    ScalarProduct scalar(M);
-    // NOLINTBEGIN
-    QFuture<std::vector<double>> future =
-        QtConcurrent::mapped(columns, std::bind(&ScalarProduct::multiply, &scalar, sp::_1));
-    // NOLINTEND
-    QFutureWatcher<std::vector<double>> watcher;
-    watcher.setFuture(future);
-    watcher.waitForFinished();
-
-    math_Matrix MTM(0, ulDim - 1, 0, ulDim - 1);
-    int rowIndex = 0;
-    for (const auto& it : future) {
-        int colIndex = 0;
-        for (std::vector<double>::const_iterator jt = it.begin(); jt != it.end();
-             ++jt, colIndex++) {
-            MTM(rowIndex, colIndex) = *jt;
+    });
+
+    NormalEquations& sum = parts.front();
+    for (std::size_t p = 1; p < parts.size(); p++) {
+        sum.mat += parts[p].mat;
+        for (int i = 0; i < ulDim; i++) {
+            sum.bx[i] += parts[p].bx[i];
+            sum.by[i] += parts[p].by[i];
+            sum.bz[i] += parts[p].bz[i];
         }
-        rowIndex++;
-    }
-#endif
-
-    // Determine the right side
-    for (int ii = _pvcPoints->Lower(); ii <= _pvcPoints->Upper(); ii++) {
-        const gp_Pnt& pnt = (*_pvcPoints)(ii);
-        bx(ii) = pnt.X();
-        by(ii) = pnt.Y();
-        bz(ii) = pnt.Z();
     }
-    for (unsigned i = 0; i < ulDim; i++) {
-        math_Vector Mi = M.Col(i);
-        Mbx(i) = Mi * bx;
-        Mby(i) = Mi * by;
-        Mbz(i) = Mi * bz;
-    }
-
-    // Solve the LGS with the LU decomposition
-    math_Gauss mgGaussX(MTM + fWeight * _clSmoothMatrix);
-    math_Gauss mgGaussY(MTM + fWeight * _clSmoothMatrix);
-    math_Gauss mgGaussZ(MTM + fWeight * _clSmoothMatrix);
 
-    mgGaussX.Solve(Mbx, Xx);
-    if (!mgGaussX.IsDone()) {
-        return false;
+    // The smoothing functionals are integrals over products of basis functions and therefore
+    // vanish outside the band, too
+    if (fWeight > 0.0) {
+        for (int i = 0; i < ulDim; i++) {
+            for (int j = std::max(0, i - bandwidth); j <= i; j++) {
+                sum.mat(i, j) += fWeight * _clSmoothMatrix(i, j);
+            }
+        }
     }
 
-    mgGaussY.Solve(Mby, Xy);
-    if (!mgGaussY.IsDone()) {
-        return false;
+    // Forming the normal equations squares the condition number, so a decomposition with
+    // tiny pivots is rejected. This happens if some control points have no or hardly any
+    // points in the support of their basis functions. Then a small penalty on the bending of
+    // the control net is added which determines these control points from their neighbours
+    // and leaves the others practically unchanged.
+    const double pivotTolerance = 1.0e-12;
+    const double penalty = 1.0e-6;
+    BandMatrix mat = sum.mat;
+    if (!mat.Cholesky(pivotTolerance)) {
+        mat = sum.mat;
+        addDifferencePenalty(mat,
+                             static_cast<int>(_usUCtrlpoints),
+                             numV,
+                             uOrder,
+                             vOrder,
+                             penalty * sum.mat.MaxDiagonal());
+        if (!mat.Cholesky(pivotTolerance)) {
+            // LGS could not be solved
+            return false;
+        }
     }
 
-    mgGaussZ.Solve(Mbz, Xz);
-    if (!mgGaussZ.IsDone()) {
-        return false;
-    }
+    mat.Solve(sum.bx);
+    mat.Solve(sum.by);
+    mat.Solve(sum.bz);
 
     unsigned ulIdx = 0;
     for (unsigned j = 0; j < _usUCtrlpoints; j++) {
         for (unsigned k = 0; k < _usVCtrlpoints; k++) {
-            _vCtrlPntsOfSurf(j, k) = gp_Pnt(Xx(ulIdx), Xy(ulIdx), Xz(ulIdx));
+            _vCtrlPntsOfSurf(j, k) = gp_Pnt(sum.bx[ulIdx], sum.by[ulIdx], sum.bz[ulIdx]);
             ulIdx++;
         }
     }
@@ -1266,6 +1368,16 @@ bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
     return true;
 }
 
+bool BSplineParameterCorrection::SolveWithoutSmoothing()
+{
+    return SolveNormalEquations(0.0);
+}
+
+bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
+{
+    return SolveNormalEquations(fWeight);
+}
+
 void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc,
                                                     double fFirst,
                                                     double fSecond,
@@ -1285,17 +1397,23 @@ void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc,
 
 void BSplineParameterCorrection::CalcFirstSmoothMatrix(Base::SequencerLauncher& seq)
 {
+    int numU = static_cast<int>(_usUCtrlpoints);
+    int numV = static_cast<int>(_usVCtrlpoints);
+    std::vector<double> u00 = integralTable(_clUSpline, numU, _usUOrder, 0, 0);
+    std::vector<double> u11 = integralTable(_clUSpline, numU, _usUOrder, 1, 1);
+    std::vector<double> v00 = integralTable(_clVSpline, numV, _usVOrder, 0, 0);
+    std::vector<double> v11 = integralTable(_clVSpline, numV, _usVOrder, 1, 1);
+
     unsigned m = 0;
-    for (unsigned k = 0; k < _usUCtrlpoints; k++) {
-        for (unsigned l = 0; l < _usVCtrlpoints; l++) {
+    for (int k = 0; k < numU; k++) {
+        for (int l = 0; l < numV; l++) {
             unsigned n = 0;
 
-            for (unsigned i = 0; i < _usUCtrlpoints; i++) {
-                for (unsigned j = 0; j < _usVCtrlpoints; j++) {
-                    _clFirstMatrix(m, n) = _clUSpline.GetIntegralOfProductOfBSplines(i, k, 1, 1)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 0, 0)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 0, 0)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 1, 1);
+            for (int i = 0; i < numU; i++) {
+                for (int j = 0; j < numV; j++) {
+                    int ik = i * numU + k;
+                    int jl = j * numV + l;
+                    _clFirstMatrix(m, n) = u11[ik] * v00[jl] + u00[ik] * v11[jl];
                     seq.next();
                     n++;
                 }
@@ -1307,19 +1425,26 @@ void BSplineParameterCorrection::CalcFirstSmoothMatrix(Base::SequencerLauncher&
 
 void BSplineParameterCorrection::CalcSecondSmoothMatrix(Base::SequencerLauncher& seq)
 {
+    int numU = static_cast<int>(_usUCtrlpoints);
+    int numV = static_cast<int>(_usVCtrlpoints);
+    std::vector<double> u00 = integralTable(_clUSpline, numU, _usUOrder, 0, 0);
+    std::vector<double> u11 = integralTable(_clUSpline, numU, _usUOrder, 1, 1);
+    std::vector<double> u22 = integralTable(_clUSpline, numU, _usUOrder, 2, 2);
+    std::vector<double> v00 = integralTable(_clVSpline, numV, _usVOrder, 0, 0);
+    std::vector<double> v11 = integralTable(_clVSpline, numV, _usVOrder, 1, 1);
+    std::vector<double> v22 = integralTable(_clVSpline, numV, _usVOrder, 2, 2);
+
     unsigned m = 0;
-    for (unsigned k = 0; k < _usUCtrlpoints; k++) {
-        for (unsigned l = 0; l < _usVCtrlpoints; l++) {
+    for (int k = 0; k < numU; k++) {
+        for (int l = 0; l < numV; l++) {
             unsigned n = 0;
 
-            for (unsigned i = 0; i < _usUCtrlpoints; i++) {
-                for (unsigned j = 0; j < _usVCtrlpoints; j++) {
-                    _clSecondMatrix(m, n) = _clUSpline.GetIntegralOfProductOfBSplines(i, k, 2, 2)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 0, 0)
-                        + 2 * _clUSpline.GetIntegralOfProductOfBSplines(i, k, 1, 1)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 1, 1)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 0, 0)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 2, 2);
+            for (int i = 0; i < numU; i++) {
+                for (int j = 0; j < numV; j++) {
+                    int ik = i * numU + k;
+                    int jl = j * numV + l;
+                    _clSecondMatrix(m, n) =
+                        u22[ik] * v00[jl] + 2 * u11[ik] * v11[jl] + u00[ik] * v22[jl];
                     seq.next();
                     n++;
                 }
@@ -1331,29 +1456,37 @@ void BSplineParameterCorrection::CalcSecondSmoothMatrix(Base::SequencerLauncher&
 
 void BSplineParameterCorrection::CalcThirdSmoothMatrix(Base::SequencerLauncher& seq)
 {
+    int numU = static_cast<int>(_usUCtrlpoints);
+    int numV = static_cast<int>(_usVCtrlpoints);
+    std::vector<double> u00 = integralTable(_clUSpline, numU, _usUOrder, 0, 0);
+    std::vector<double> u02 = integralTable(_clUSpline, numU, _usUOrder, 0, 2);
+    std::vector<double> u11 = integralTable(_clUSpline, numU, _usUOrder, 1, 1);
+    std::vector<double> u13 = integralTable(_clUSpline, numU, _usUOrder, 1, 3);
+    std::vector<double> u20 = integralTable(_clUSpline, numU, _usUOrder, 2, 0);
+    std::vector<double> u22 = integralTable(_clUSpline, numU, _usUOrder, 2, 2);
+    std::vector<double> u31 = integralTable(_clUSpline, numU, _usUOrder, 3, 1);
+    std::vector<double> u33 = integralTable(_clUSpline, numU, _usUOrder, 3, 3);
+    std::vector<double> v00 = integralTable(_clVSpline, numV, _usVOrder, 0, 0);
+    std::vector<double> v02 = integralTable(_clVSpline, numV, _usVOrder, 0, 2);
+    std::vector<double> v11 = integralTable(_clVSpline, numV, _usVOrder, 1, 1);
+    std::vector<double> v13 = integralTable(_clVSpline, numV, _usVOrder, 1, 3);
+    std::vector<double> v20 = integralTable(_clVSpline, numV, _usVOrder, 2, 0);
+    std::vector<double> v22 = integralTable(_clVSpline, numV, _usVOrder, 2, 2);
+    std::vector<double> v31 = integralTable(_clVSpline, numV, _usVOrder, 3, 1);
+    std::vector<double> v33 = integralTable(_clVSpline, numV, _usVOrder, 3, 3);
+
     unsigned m = 0;
-    for (unsigned k = 0; k < _usUCtrlpoints; k++) {
-        for (unsigned l = 0; l < _usVCtrlpoints; l++) {
+    for (int k = 0; k < numU; k++) {
+        for (int l = 0; l < numV; l++) {
             unsigned n = 0;
 
-            for (unsigned i = 0; i < _usUCtrlpoints; i++) {
-                for (unsigned j = 0; j < _usVCtrlpoints; j++) {
-                    _clThirdMatrix(m, n) = _clUSpline.GetIntegralOfProductOfBSplines(i, k, 3, 3)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 0, 0)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 3, 1)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 0, 2)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 1, 3)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 2, 0)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 1, 1)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 2, 2)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 2, 2)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 1, 1)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 0, 2)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 3, 1)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 2, 0)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 1, 3)
-                        + _clUSpline.GetIntegralOfProductOfBSplines(i, k, 0, 0)
-                            * _clVSpline.GetIntegralOfProductOfBSplines(j, l, 3, 3);
+            for (int i = 0; i < numU; i++) {
+                for (int j = 0; j < numV; j++) {
+                    int ik = i * numU + k;
+                    int jl = j * numV + l;
+                    _clThirdMatrix(m, n) = u33[ik] * v00[jl] + u31[ik] * v02[jl]
+                        + u13[ik] * v20[jl] + u11[ik] * v22[jl] + u22[ik] * v11[jl]
+                        + u02[ik] * v31[jl] + u20[ik] * v13[jl] + u00[ik] * v33[jl];
                     seq.next();
                     n++;
                 }
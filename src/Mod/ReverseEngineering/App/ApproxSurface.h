@@ -30,6 +30,7 @@
 #include <TColgp_Array1OfPnt2d.hxx>
 #include <TColgp_Array2OfPnt.hxx>
 #include <math_Matrix.hxx>
+#include <vector>
 
 #include <Base/Vector3D.h>
 #include <Mod/ReverseEngineering/ReverseEngineeringGlobal.h>
@@ -404,16 +405,32 @@ protected:
     void DoParameterCorrection(int iIter) override;
 
     /**
-     * Solve an overdetermined LGS with the help of the Householder-Tansformation
+     * Solve an overdetermined LGS in the least-squares sense by its normal equations.
+     * If they are (nearly) singular because some control points aren't determined by
+     * the points, a small bending penalty on the control net is added.
      */
     bool SolveWithoutSmoothing() override;
 
     /**
-     * Solve a regular system of equations by LU decomposition. Depending on the weighting,
+     * Solve the normal equations with additional smoothing terms. Depending on the weighting,
      * smoothing terms are included
      */
     bool SolveWithSmoothing(double fWeight) override;
 
+    /**
+     * Evaluates the non-zero basis functions at the (u,v) parameters of all points.
+     * Only the points whose parameters have changed since the last call are re-evaluated.
+     */
+    void CalcBasisFunctions();
+
+    /**
+     * Assembles the banded normal equations in parallel and solves them by a band Cholesky
+     * decomposition. If \a fWeight is positive the smoothing terms are added. If the
+     * decomposition fails or is ill-conditioned it is repeated with a small penalty on the
+     * second differences of the control net.
+     */
+    bool SolveNormalEquations(double fWeight);
+
 public:
     /**
      * Setting the knot vector
@@ -497,6 +514,9 @@ protected:
     math_Matrix _clFirstMatrix;   //! Matrix of the 1st smoothing functionals
     math_Matrix _clSecondMatrix;  //! Matrix of the 2nd smoothing functionals
     math_Matrix _clThirdMatrix;   //! Matrix of the 3rd smoothing functionals
+    std::vector<gp_Pnt2d> _vBasisParam;  //! Parameters of the cached basis functions
+    std::vector<int> _vBasisSpan;        //! Index of the first non-zero function in u and v
+    std::vector<double> _vBasisValues;   //! Values of the non-zero functions in u and v
 };
 
 }  // namespace Reen
@@ -569,6 +569,7 @@ void Cell::setAlias(const std::string& n)
         PropertySheet::AtomicPropertyChange signaller(*owner);
 
         owner->revAliasProp.erase(alias);
+        App::ObjectIdentifier::touchResolveRevision();
 
         // Update owner
         if (!n.empty()) {
@@ -806,6 +806,7 @@ void PropertySheet::clearAlias(CellAddress address)
     if (j != aliasProp.end()) {
         revAliasProp.erase(j->second);
         aliasProp.erase(j);
+        App::ObjectIdentifier::touchResolveRevision();
     }
 }
 
@@ -845,6 +846,7 @@ void PropertySheet::moveAlias(CellAddress currPos, CellAddress newPos)
         aliasProp[newPos] = j->second;
         revAliasProp[j->second] = newPos;
         aliasProp.erase(currPos);
+        App::ObjectIdentifier::touchResolveRevision();
     }
 }
 
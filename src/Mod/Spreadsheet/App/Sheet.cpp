@@ -27,6 +27,8 @@
 #include <deque>
 #include <memory>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 #endif
 
 #include <App/Application.h>
@@ -576,6 +578,10 @@ Property* Sheet::setFloatProperty(CellAddress key, double value)
     }
     else {
         floatProp = static_cast<PropertyFloat*>(prop);
+        if (floatProp->getValue() == value) {
+            // Unchanged, avoid dirtying cells of other sheets referring to it
+            return floatProp;
+        }
     }
 
     propAddress[floatProp] = key;
@@ -604,6 +610,9 @@ Property* Sheet::setIntegerProperty(CellAddress key, long value)
     }
     else {
         intProp = static_cast<PropertyInteger*>(prop);
+        if (intProp->getValue() == value) {
+            return intProp;
+        }
     }
 
     propAddress[intProp] = key;
@@ -644,6 +653,10 @@ Property* Sheet::setQuantityProperty(CellAddress key, double value, const Base::
     }
     else {
         quantityProp = static_cast<PropertySpreadsheetQuantity*>(prop);
+        if (quantityProp->getValue() == value && quantityProp->getUnit() == unit) {
+            cells.setComputedUnit(key, unit);
+            return quantityProp;
+        }
     }
 
     propAddress[quantityProp] = key;
@@ -671,6 +684,9 @@ Property* Sheet::setStringProperty(CellAddress key, const std::string& value)
     Property* prop = props.getDynamicPropertyByName(name.c_str());
     PropertyString* stringProp = freecad_dynamic_cast<PropertyString>(prop);
 
+    if (stringProp && value == stringProp->getValue()) {
+        return stringProp;
+    }
     if (!stringProp) {
         if (prop) {
             this->removeDynamicProperty(name.c_str());
@@ -1026,56 +1042,76 @@ DocumentObjectExecReturn* Sheet::execute()
         dirtyCells.insert(cellError);
     }
 
-    DependencyList graph;
-    std::map<CellAddress, Vertex> VertexList;
-    std::map<Vertex, CellAddress> VertexIndexList;
-    std::deque<CellAddress> workQueue(dirtyCells.begin(), dirtyCells.end());
-    while (!workQueue.empty()) {
-        CellAddress currPos = workQueue.front();
-        workQueue.pop_front();
-
-        // Insert into map of CellPos -> Index, if it doesn't exist already
-        auto res = VertexList.emplace(currPos, Vertex());
-        if (res.second) {
-            res.first->second = add_vertex(graph);
-            VertexIndexList[res.first->second] = currPos;
+    // Collect the dirty cells and every cell depending on them. Cells are
+    // numbered in discovery order, and the dependency edges are kept in flat
+    // adjacency arrays indexed by these numbers.
+    const std::string prefix = getFullName() + ".";
+    std::vector<CellAddress> nodes(dirtyCells.begin(), dirtyCells.end());
+    std::unordered_map<unsigned int, std::size_t> nodeIndex;
+    nodeIndex.reserve(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodeIndex.emplace(nodes[i].asInt(), i);
+    }
+    std::vector<std::size_t> edgeStart;
+    std::vector<std::size_t> edges;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        edgeStart.push_back(edges.size());
+        // Process cells that depend on the current cell
+        for (const auto& dep : cells.getDeps(prefix + nodes[i].toString())) {
+            auto res = nodeIndex.emplace(dep.asInt(), nodes.size());
+            if (res.second) {
+                nodes.push_back(dep);
+                dirtyCells.insert(dep);
+            }
+            edges.push_back(res.first->second);
         }
+    }
+    edgeStart.push_back(edges.size());
 
-        // Process cells that depend on the current cell
-        for (auto& dep : providesTo(currPos)) {
-            auto resDep = VertexList.emplace(dep, Vertex());
-            if (resDep.second) {
-                resDep.first->second = add_vertex(graph);
-                VertexIndexList[resDep.first->second] = dep;
-                if (dirtyCells.insert(dep).second) {
-                    workQueue.push_back(dep);
-                }
+    // Sort topologically to find the evaluation order
+    std::vector<std::size_t> inDegree(nodes.size(), 0);
+    for (auto target : edges) {
+        ++inDegree[target];
+    }
+    std::vector<std::size_t> makeOrder;
+    makeOrder.reserve(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (inDegree[i] == 0) {
+            makeOrder.push_back(i);
+        }
+    }
+    for (std::size_t k = 0; k < makeOrder.size(); ++k) {
+        std::size_t i = makeOrder[k];
+        for (std::size_t e = edgeStart[i]; e < edgeStart[i + 1]; ++e) {
+            if (--inDegree[edges[e]] == 0) {
+                makeOrder.push_back(edges[e]);
             }
-            // Add edge to graph to signal dependency
-            add_edge(res.first->second, resDep.first->second, graph);
         }
     }
-    // Compute cells
-    std::list<Vertex> make_order;
-    // Sort graph topologically to find evaluation order
-    try {
-        boost::topological_sort(graph, std::front_inserter(make_order));
-        // Recompute cells
-        FC_LOG("recomputing " << getFullName());
-        for (auto& pos : make_order) {
-            const auto& addr = VertexIndexList[pos];
-            FC_TRACE(addr.toString());
-            recomputeCell(addr);
+
+    bool acyclic = makeOrder.size() == nodes.size();
+    if (acyclic) {
+        try {
+            // Recompute cells
+            FC_LOG("recomputing " << getFullName());
+            for (auto i : makeOrder) {
+                FC_TRACE(nodes[i].toString());
+                recomputeCell(nodes[i]);
+            }
+        }
+        catch (std::exception&) {
+            acyclic = false;
         }
     }
-    catch (std::exception&) {
-        for (auto& v : VertexList) {
-            Cell* cell = cells.getValue(v.first);
+
+    if (!acyclic) {
+        for (const auto& addr : nodes) {
+            Cell* cell = cells.getValue(addr);
             // Mark as erroneous
             if (cell) {
-                cellErrors.insert(v.first);
+                cellErrors.insert(addr);
                 cell->setException("Pending computation due to cyclic dependency", true);
-                cellUpdated(v.first);
+                cellUpdated(addr);
             }
         }
 
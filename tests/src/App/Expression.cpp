@@ -1,7 +1,10 @@
 #include "gtest/gtest.h"
 
+#include "App/Application.h"
+#include "App/Document.h"
 #include "App/ExpressionParser.h"
 #include "App/ExpressionTokenizer.h"
+#include "App/FeatureTest.h"
 
 // clang-format off
 TEST(Expression, tokenize)
@@ -49,4 +52,178 @@ TEST(Expression, test_e_rad)
     EXPECT_EQ(op->toString(), "e rad");
     op.release();
 }
+
+TEST(Expression, nativeIntegerArithmetic)
+{
+    App::OperatorExpression op{nullptr,
+        new App::NumberExpression(nullptr, Base::Quantity(2.0)),
+        App::OperatorExpression::ADD,
+        new App::NumberExpression(nullptr, Base::Quantity(3.0))};
+    auto value = op.getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(long));
+    EXPECT_EQ(App::any_cast<long>(value), 5);
+}
+
+TEST(Expression, nativeTrueDivision)
+{
+    App::OperatorExpression op{nullptr,
+        new App::NumberExpression(nullptr, Base::Quantity(7.0)),
+        App::OperatorExpression::DIV,
+        new App::NumberExpression(nullptr, Base::Quantity(2.0))};
+    auto value = op.getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(double));
+    EXPECT_DOUBLE_EQ(App::any_cast<double>(value), 3.5);
+}
+
+TEST(Expression, nativeQuantityArithmetic)
+{
+    App::OperatorExpression op{nullptr,
+        new App::OperatorExpression{nullptr,
+            new App::NumberExpression(nullptr, Base::Quantity(2.0)),
+            App::OperatorExpression::UNIT,
+            new App::UnitExpression(nullptr, Base::Quantity(1.0, Base::Unit::Length), "mm")},
+        App::OperatorExpression::MUL,
+        new App::NumberExpression(nullptr, Base::Quantity(1.5))};
+    auto value = op.getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(Base::Quantity));
+    EXPECT_EQ(App::any_cast<Base::Quantity>(value), Base::Quantity(3.0, Base::Unit::Length));
+
+    std::unique_ptr<App::Expression> result(op.eval());
+    auto number = Base::freecad_dynamic_cast<App::NumberExpression>(result.get());
+    ASSERT_NE(number, nullptr);
+    EXPECT_EQ(number->getQuantity(), Base::Quantity(3.0, Base::Unit::Length));
+}
+
+class ExpressionNativeTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        if (App::Application::GetARGC() == 0) {
+            int argc = 1;
+            char* argv[] = {"FreeCAD"};
+            App::Application::Config()["ExeName"] = "FreeCAD";
+            App::Application::init(argc, argv);
+        }
+    }
+
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _source = static_cast<App::FeatureTest*>(_doc->addObject("App::FeatureTest", "Source"));
+        _owner = static_cast<App::FeatureTest*>(_doc->addObject("App::FeatureTest", "Owner"));
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    std::unique_ptr<App::Expression> parse(const char* expr)
+    {
+        return std::unique_ptr<App::Expression>(App::Expression::parse(_owner, expr));
+    }
+
+    std::string _docName;
+    App::Document* _doc {};
+    App::FeatureTest* _source {};
+    App::FeatureTest* _owner {};
+};
+
+TEST_F(ExpressionNativeTest, propertyReference)
+{
+    _source->Integer.setValue(3);
+    _source->Float.setValue(0.5);
+    _source->QuantityLength.setValue(2.0);
+
+    auto value = parse("Source.Integer * 2")->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(long));
+    EXPECT_EQ(App::any_cast<long>(value), 6);
+
+    auto expr = parse("Source.Float + Integer");
+    value = expr->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(double));
+    EXPECT_DOUBLE_EQ(App::any_cast<double>(value), 4711.5);
+
+    // values are read on each evaluation
+    _source->Float.setValue(1.5);
+    EXPECT_DOUBLE_EQ(App::any_cast<double>(expr->getValueAsAny()), 4712.5);
+
+    value = parse("Source.QuantityLength * 3 + 1 mm")->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(Base::Quantity));
+    EXPECT_EQ(App::any_cast<Base::Quantity>(value), Base::Quantity(7.0, Base::Unit::Length));
+}
+
+TEST_F(ExpressionNativeTest, unitMismatch)
+{
+    // the interpreter reports the error
+    EXPECT_THROW(parse("Source.QuantityLength + 1 s")->getValueAsAny(), Base::Exception);
+    EXPECT_THROW(parse("sin(Source.QuantityLength)")->getValueAsAny(), Base::Exception);
+    EXPECT_THROW(parse("Source.Integer / 0")->getValueAsAny(), Base::Exception);
+}
+
+TEST_F(ExpressionNativeTest, interpreterFallback)
+{
+    // string property
+    auto value = parse("Source.String")->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(std::string));
+    EXPECT_EQ(App::any_cast<std::string>(value), "4711");
+
+    // sub path of a property
+    _source->Placement.setValue(Base::Placement(Base::Vector3d(1, 2, 3), Base::Rotation()));
+    value = parse("Source.Placement.Base.y * 2")->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(Base::Quantity));
+    EXPECT_DOUBLE_EQ(App::any_cast<Base::Quantity>(value).getValue(), 4.0);
+
+    // integer overflow continues with Python integers
+    value = parse("2 ^ 62 * 4 / 8")->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(double));
+    EXPECT_DOUBLE_EQ(App::any_cast<double>(value), 2305843009213693952.0);
+}
+
+TEST_F(ExpressionNativeTest, removedProperty)
+{
+    auto prop = static_cast<App::PropertyFloat*>(
+        _source->addDynamicProperty("App::PropertyFloat", "Extra"));
+    prop->setValue(2.0);
+    auto expr = parse("Source.Extra + 1");
+    EXPECT_DOUBLE_EQ(App::any_cast<double>(expr->getValueAsAny()), 3.0);
+
+    _source->removeDynamicProperty("Extra");
+    EXPECT_THROW(expr->getValueAsAny(), Base::Exception);
+
+    // a new property with the same name is picked up
+    auto intProp = static_cast<App::PropertyInteger*>(
+        _source->addDynamicProperty("App::PropertyInteger", "Extra"));
+    intProp->setValue(5);
+    auto value = expr->getValueAsAny();
+    ASSERT_TRUE(value.type() == typeid(long));
+    EXPECT_EQ(App::any_cast<long>(value), 6);
+}
+
+TEST_F(ExpressionNativeTest, relabeledObject)
+{
+    auto other = static_cast<App::FeatureTest*>(_doc->addObject("App::FeatureTest", "Other"));
+    _source->Label.setValue("Part");
+    _source->Integer.setValue(1);
+    other->Integer.setValue(2);
+
+    auto expr = parse("<<Part>>.Integer");
+    EXPECT_EQ(App::any_cast<long>(expr->getValueAsAny()), 1);
+
+    // the label now refers to the other object
+    _source->Label.setValue("Old");
+    other->Label.setValue("Part");
+    EXPECT_EQ(App::any_cast<long>(expr->getValueAsAny()), 2);
+}
+
+TEST_F(ExpressionNativeTest, removedObject)
+{
+    auto expr = parse("Source.Integer + 1");
+    EXPECT_EQ(App::any_cast<long>(expr->getValueAsAny()), 4712);
+
+    _doc->removeObject("Source");
+    EXPECT_THROW(expr->getValueAsAny(), Base::Exception);
+}
 // clang-format on
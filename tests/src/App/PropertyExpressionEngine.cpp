@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/Expression.h>
+#include <App/FeatureTest.h>
+#include <App/ObjectIdentifier.h>
+#include <Base/Exception.h>
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+class PropertyExpressionEngineTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        if (App::Application::GetARGC() == 0) {
+            int argc = 1;
+            char* argv[] = {"FreeCAD"};
+            App::Application::Config()["ExeName"] = "FreeCAD";
+            App::Application::init(argc, argv);
+        }
+    }
+
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _source = static_cast<App::FeatureTest*>(_doc->addObject("App::FeatureTest", "Source"));
+        _owner = static_cast<App::FeatureTest*>(_doc->addObject("App::FeatureTest", "Owner"));
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    void setExpression(App::Property& prop, const char* expr)
+    {
+        _owner->setExpression(App::ObjectIdentifier(prop),
+                              std::shared_ptr<App::Expression>(App::Expression::parse(_owner, expr)));
+    }
+
+    std::string _docName;
+    App::Document* _doc {};
+    App::FeatureTest* _source {};
+    App::FeatureTest* _owner {};
+};
+
+TEST_F(PropertyExpressionEngineTest, evaluationOrder)
+{
+    // Float is bound first, but depends on Integer
+    setExpression(_owner->Float, "Integer + 1");
+    setExpression(_owner->Integer, "Source.Integer * 2");
+
+    _source->Integer.setValue(1);
+    _owner->ExpressionEngine.execute();
+    EXPECT_EQ(_owner->Integer.getValue(), 2);
+    EXPECT_DOUBLE_EQ(_owner->Float.getValue(), 3.0);
+
+    // the cached order is used again
+    _source->Integer.setValue(5);
+    _owner->ExpressionEngine.execute();
+    EXPECT_EQ(_owner->Integer.getValue(), 10);
+    EXPECT_DOUBLE_EQ(_owner->Float.getValue(), 11.0);
+
+    // a changed expression updates the order
+    setExpression(_owner->Integer, "Source.Integer * 3");
+    _owner->ExpressionEngine.execute();
+    EXPECT_EQ(_owner->Integer.getValue(), 15);
+    EXPECT_DOUBLE_EQ(_owner->Float.getValue(), 16.0);
+}
+
+TEST_F(PropertyExpressionEngineTest, cycleDetection)
+{
+    setExpression(_owner->Float, "Integer + 1");
+    setExpression(_owner->QuantityLength, "Float * 1 mm");
+    EXPECT_THROW(setExpression(_owner->Integer, "QuantityLength / 1 mm"), Base::RuntimeError);
+
+    // the rejected expression doesn't change the cached order
+    _owner->Integer.setValue(1);
+    _owner->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(_owner->Float.getValue(), 2.0);
+    EXPECT_DOUBLE_EQ(_owner->QuantityLength.getValue(), 2.0);
+}
+
+TEST_F(PropertyExpressionEngineTest, relabeledObject)
+{
+    // Float doesn't depend on Integer as long as no object is labeled Part
+    setExpression(_owner->Float, "Source.Float > 0 ? <<Part>>.Integer + 1 : 0");
+    setExpression(_owner->Integer, "Source.Integer * 2");
+
+    _source->Float.setValue(0);
+    _source->Integer.setValue(1);
+    _owner->ExpressionEngine.execute();
+    EXPECT_EQ(_owner->Integer.getValue(), 2);
+    EXPECT_DOUBLE_EQ(_owner->Float.getValue(), 0.0);
+
+    // now the expression refers to the owner, without being modified
+    _owner->Label.setValue("Part");
+    _source->Float.setValue(1);
+    _source->Integer.setValue(5);
+    _owner->ExpressionEngine.execute();
+    EXPECT_EQ(_owner->Integer.getValue(), 10);
+    EXPECT_DOUBLE_EQ(_owner->Float.getValue(), 11.0);
+}
+
+// NOLINTEND(readability-magic-numbers)
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include <Base/BatchTransform.h>
+#include <Base/Rotation.h>
+#include <random>
+#include <string>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+// A point type with additional data like MeshCore::MeshPoint
+struct FlaggedPoint: public Base::Vector3f
+{
+    FlaggedPoint() = default;
+    FlaggedPoint(float x, float y, float z)
+        : Base::Vector3f(x, y, z)
+    {}
+    unsigned char flag {0xab};
+    unsigned long prop {0xdeadbeef};
+};
+
+Base::Matrix4D makeTransform()
+{
+    Base::Matrix4D mat;
+    mat.rotX(0.3);
+    mat.rotY(-1.2);
+    mat.rotZ(2.1);
+    mat.scale(1.5, 0.5, 2.0);
+    mat.move(Base::Vector3d(10.0, -20.0, 30.0));
+    return mat;
+}
+
+template<typename T>
+std::vector<T> makePoints(std::size_t count)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-100.0F, 100.0F);
+    std::vector<T> points;
+    points.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        points.emplace_back(dist(gen), dist(gen), dist(gen));
+    }
+    return points;
+}
+
+// Runs a test with each instruction set this machine supports
+class BatchTransformTest: public ::testing::TestWithParam<const char*>
+{
+protected:
+    void SetUp() override
+    {
+        if (!Base::setBatchInstructionSet(GetParam())) {
+            GTEST_SKIP() << GetParam() << " isn't supported";
+        }
+    }
+
+    void TearDown() override
+    {
+        Base::setBatchInstructionSet(nullptr);
+    }
+};
+}  // namespace
+
+TEST(BatchTransform, TestInstructionSet)
+{
+    std::string automatic = Base::batchInstructionSet();
+    EXPECT_TRUE(Base::setBatchInstructionSet("Scalar"));
+    EXPECT_STREQ(Base::batchInstructionSet(), "Scalar");
+    EXPECT_FALSE(Base::setBatchInstructionSet("MMX"));
+    EXPECT_STREQ(Base::batchInstructionSet(), "Scalar");
+    EXPECT_TRUE(Base::setBatchInstructionSet(nullptr));
+    EXPECT_EQ(Base::batchInstructionSet(), automatic);
+}
+
+TEST_P(BatchTransformTest, TestTransformMatchesMatrix)
+{
+    Base::Matrix4D mat = makeTransform();
+    for (std::size_t count : {0, 1, 2, 3, 1001}) {
+        auto points = makePoints<Base::Vector3f>(count);
+        auto expected = points;
+        Base::BoundBox3f expectedBox;
+        for (auto& it : expected) {
+            it = mat * it;
+            expectedBox.Add(it);
+        }
+
+        Base::BoundBox3f box;
+        Base::transformPoints(mat, points, &box);
+        for (std::size_t i = 0; i < count; i++) {
+            EXPECT_FLOAT_EQ(points[i].x, expected[i].x);
+            EXPECT_FLOAT_EQ(points[i].y, expected[i].y);
+            EXPECT_FLOAT_EQ(points[i].z, expected[i].z);
+        }
+        EXPECT_EQ(box.IsValid(), expectedBox.IsValid());
+        if (box.IsValid()) {
+            EXPECT_FLOAT_EQ(box.MinX, expectedBox.MinX);
+            EXPECT_FLOAT_EQ(box.MinY, expectedBox.MinY);
+            EXPECT_FLOAT_EQ(box.MinZ, expectedBox.MinZ);
+            EXPECT_FLOAT_EQ(box.MaxX, expectedBox.MaxX);
+            EXPECT_FLOAT_EQ(box.MaxY, expectedBox.MaxY);
+            EXPECT_FLOAT_EQ(box.MaxZ, expectedBox.MaxZ);
+        }
+    }
+}
+
+TEST_P(BatchTransformTest, TestTransformWithStride)
+{
+    Base::Matrix4D mat = makeTransform();
+    auto points = makePoints<FlaggedPoint>(257);
+    auto expected = points;
+
+    Base::transformPoints(mat, points);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        Base::Vector3f pnt = mat * static_cast<const Base::Vector3f&>(expected[i]);
+        EXPECT_FLOAT_EQ(points[i].x, pnt.x);
+        EXPECT_FLOAT_EQ(points[i].y, pnt.y);
+        EXPECT_FLOAT_EQ(points[i].z, pnt.z);
+        // the additional data must be left untouched
+        EXPECT_EQ(points[i].flag, 0xab);
+        EXPECT_EQ(points[i].prop, 0xdeadbeef);
+    }
+}
+
+TEST_P(BatchTransformTest, TestBoundBox)
+{
+    auto points = makePoints<FlaggedPoint>(333);
+    Base::BoundBox3f expected;
+    for (const auto& it : points) {
+        expected.Add(it);
+    }
+
+    Base::BoundBox3f box = Base::boundBoxOfPoints(points);
+    EXPECT_EQ(box.MinX, expected.MinX);
+    EXPECT_EQ(box.MinY, expected.MinY);
+    EXPECT_EQ(box.MinZ, expected.MinZ);
+    EXPECT_EQ(box.MaxX, expected.MaxX);
+    EXPECT_EQ(box.MaxY, expected.MaxY);
+    EXPECT_EQ(box.MaxZ, expected.MaxZ);
+
+    EXPECT_FALSE(Base::boundBoxOfPoints(std::vector<Base::Vector3f>()).IsValid());
+}
+
+TEST_P(BatchTransformTest, TestTransformedBoundBox)
+{
+    Base::Matrix4D mat = makeTransform();
+    auto points = makePoints<Base::Vector3f>(777);
+    Base::BoundBox3d expected;
+    for (const auto& it : points) {
+        expected.Add(mat * Base::Vector3d(it.x, it.y, it.z));
+    }
+
+    Base::BoundBox3d box = Base::boundBoxOfPoints(mat, points);
+    EXPECT_DOUBLE_EQ(box.MinX, expected.MinX);
+    EXPECT_DOUBLE_EQ(box.MinY, expected.MinY);
+    EXPECT_DOUBLE_EQ(box.MinZ, expected.MinZ);
+    EXPECT_DOUBLE_EQ(box.MaxX, expected.MaxX);
+    EXPECT_DOUBLE_EQ(box.MaxY, expected.MaxY);
+    EXPECT_DOUBLE_EQ(box.MaxZ, expected.MaxZ);
+
+    // the input is left unchanged
+    EXPECT_EQ(points, makePoints<Base::Vector3f>(777));
+}
+
+INSTANTIATE_TEST_SUITE_P(InstructionSets,
+                         BatchTransformTest,
+                         ::testing::Values("Scalar", "SSE2", "AVX", "AVX-512"));
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include <Base/Console.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class RecordingLogger: public Base::ILogger
+{
+public:
+    void SendLog(const std::string& notifiername,
+                 const std::string& msg,
+                 Base::LogStyle level,
+                 Base::IntendedRecipient recipient,
+                 Base::ContentType content) override
+    {
+        (void)level;
+        (void)recipient;
+        (void)content;
+        std::lock_guard<std::mutex> lock(mutex);
+        messages[notifiername].push_back(std::stoi(msg));
+    }
+
+    std::mutex mutex;
+    std::map<std::string, std::vector<int>> messages;
+};
+
+class ConsoleAsync: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Base::Console().AttachObserver(&logger);
+    }
+
+    void TearDown() override
+    {
+        Base::Console().SetConnectionMode(Base::ConsoleSingleton::Direct);
+        Base::Console().DetachObserver(&logger);
+    }
+
+    RecordingLogger logger;
+};
+
+TEST_F(ConsoleAsync, TestAsyncDeliversAllInOrder)
+{
+    // more messages than fit into the buffer, from several threads
+    const int threadCount = 4;
+    const int messageCount = 10000;
+    Base::Console().SetConnectionMode(Base::ConsoleSingleton::Async);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t] {
+            std::string notifier = "thread" + std::to_string(t);
+            for (int i = 0; i < messageCount; ++i) {
+                Base::Console().Message(notifier, "%d", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Base::Console().Flush();
+
+    std::lock_guard<std::mutex> lock(logger.mutex);
+    ASSERT_EQ(logger.messages.size(), static_cast<std::size_t>(threadCount));
+    for (const auto& it : logger.messages) {
+        ASSERT_EQ(it.second.size(), static_cast<std::size_t>(messageCount)) << it.first;
+        for (int i = 0; i < messageCount; ++i) {
+            EXPECT_EQ(it.second[i], i) << it.first;
+        }
+    }
+}
+
+TEST_F(ConsoleAsync, TestLeavingAsyncDeliversPending)
+{
+    Base::Console().SetConnectionMode(Base::ConsoleSingleton::Async);
+    for (int i = 0; i < 100; ++i) {
+        Base::Console().Message("main", "%d", i);
+    }
+    // switching back delivers what is left before any direct message
+    Base::Console().SetConnectionMode(Base::ConsoleSingleton::Direct);
+    Base::Console().Message("main", "%d", 100);
+
+    std::lock_guard<std::mutex> lock(logger.mutex);
+    const std::vector<int>& messages = logger.messages["main"];
+    ASSERT_EQ(messages.size(), 101U);
+    for (int i = 0; i <= 100; ++i) {
+        EXPECT_EQ(messages[i], i);
+    }
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include <Base/Parallel.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+TEST(Parallel, TestEveryIndexOnce)
+{
+    for (std::size_t count : {0, 1, 1023, 1024, 1025, 10000}) {
+        std::vector<int> visits(count, 0);
+        Base::parallelFor(count, [&visits](std::size_t i) {
+            visits[i]++;
+        });
+        EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), static_cast<long>(count));
+    }
+}
+
+TEST(Parallel, TestBlocks)
+{
+    std::vector<std::size_t> blockOf(1000, 0);
+    Base::parallelForRange(
+        blockOf.size(),
+        [&blockOf](std::size_t begin, std::size_t end) {
+            EXPECT_LT(begin, end);
+            EXPECT_LE(end - begin, 300);
+            for (std::size_t i = begin; i < end; i++) {
+                blockOf[i] = begin;
+            }
+        },
+        300);
+    for (std::size_t i = 0; i < blockOf.size(); i++) {
+        EXPECT_EQ(blockOf[i], i / 300 * 300);
+    }
+}
+
+TEST(Parallel, TestSingleBlockInCallingThread)
+{
+    std::thread::id caller = std::this_thread::get_id();
+    std::vector<std::thread::id> ids(10);
+    Base::parallelFor(
+        ids.size(),
+        [&ids](std::size_t i) {
+            ids[i] = std::this_thread::get_id();
+        },
+        ids.size());
+    for (const auto& id : ids) {
+        EXPECT_EQ(id, caller);
+    }
+}
+
+TEST(Parallel, TestFirstExceptionIsRethrown)
+{
+    auto func = [](std::size_t i) {
+        if (i == 1500 || i == 4000) {
+            throw std::runtime_error(std::to_string(i));
+        }
+    };
+    for (int run = 0; run < 10; run++) {
+        try {
+            Base::parallelFor(5000, func);
+            FAIL() << "no exception";
+        }
+        catch (const std::runtime_error& e) {
+            EXPECT_STREQ(e.what(), "1500");
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include <Base/Type.h>
+
+class TypeTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        if (Base::Type::getNumTypes() == 0) {
+            Base::Type::init();
+        }
+        root = Base::Type::createType(Base::Type::badType(), "TypeTest::Root");
+        child = Base::Type::createType(root, "TypeTest::Child");
+        sibling = Base::Type::createType(root, "TypeTest::Sibling");
+        grandChild = Base::Type::createType(child, "TypeTest::GrandChild");
+    }
+
+    static Base::Type root;
+    static Base::Type child;
+    static Base::Type sibling;
+    static Base::Type grandChild;
+};
+
+Base::Type TypeTest::root;
+Base::Type TypeTest::child;
+Base::Type TypeTest::sibling;
+Base::Type TypeTest::grandChild;
+
+TEST_F(TypeTest, fromName)
+{
+    EXPECT_EQ(Base::Type::fromName("TypeTest::Child"), child);
+    EXPECT_TRUE(Base::Type::fromName("TypeTest::Unknown").isBad());
+}
+
+TEST_F(TypeTest, isDerivedFromSelfAndAncestors)
+{
+    EXPECT_TRUE(root.isDerivedFrom(root));
+    EXPECT_TRUE(child.isDerivedFrom(root));
+    EXPECT_TRUE(grandChild.isDerivedFrom(child));
+    EXPECT_TRUE(grandChild.isDerivedFrom(root));
+}
+
+TEST_F(TypeTest, isDerivedFromUnrelated)
+{
+    EXPECT_FALSE(root.isDerivedFrom(child));
+    EXPECT_FALSE(sibling.isDerivedFrom(child));
+    EXPECT_FALSE(grandChild.isDerivedFrom(sibling));
+    EXPECT_FALSE(child.isDerivedFrom(grandChild));
+}
+
+TEST_F(TypeTest, isDerivedFromBadType)
+{
+    EXPECT_FALSE(root.isDerivedFrom(Base::Type::badType()));
+    EXPECT_FALSE(Base::Type::badType().isDerivedFrom(root));
+    EXPECT_TRUE(Base::Type::badType().isDerivedFrom(Base::Type::badType()));
+}
+
+TEST_F(TypeTest, getAllDerivedFrom)
+{
+    std::vector<Base::Type> types;
+    EXPECT_EQ(Base::Type::getAllDerivedFrom(child, types), 2);
+    EXPECT_EQ(types, (std::vector<Base::Type> {child, grandChild}));
+}
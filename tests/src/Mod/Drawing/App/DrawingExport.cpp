@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <string>
+
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Circ.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+#include <Mod/Drawing/App/DrawingExport.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+
+std::string printfG(double value)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%g", value);
+    return buf;
+}
+
+TopoDS_Edge makeCircle(double x, double y, double radius)
+{
+    gp_Circ circ(gp_Ax2(gp_Pnt(x, y, 0), gp_Dir(0, 0, 1)), radius);
+    return BRepBuilderAPI_MakeEdge(circ).Edge();
+}
+
+}  // namespace
+
+TEST(DrawingExport, testSVGNumbersMatchPrintf)
+{
+    // values that need rounding, an exponent or trailing zeros removed
+    const double x = 1.0 / 3.0;
+    const double y = 123456789.0;
+    const double r = 2.5e-5;
+
+    Drawing::SVGOutput output;
+    std::string svg = output.exportEdges(makeCircle(x, y, r));
+
+    std::string expected = "<circle cx =\"" + printfG(x) + "\" cy =\"" + printfG(y) + "\" r =\""
+        + printfG(r) + "\" />";
+    EXPECT_EQ(svg, expected);
+}
+
+TEST(DrawingExport, testDXFNumbersMatchPrintf)
+{
+    const double x = -0.000123456789;
+    const double y = 1.5e+12;
+    const double r = 7.0;
+
+    Drawing::DXFOutput output;
+    std::string dxf = output.exportEdges(makeCircle(x, y, r));
+
+    EXPECT_NE(dxf.find("\n10\n" + printfG(x) + "\n"), std::string::npos) << dxf;
+    EXPECT_NE(dxf.find("\n20\n" + printfG(y) + "\n"), std::string::npos) << dxf;
+    EXPECT_NE(dxf.find("\n40\n" + printfG(r) + "\n"), std::string::npos) << dxf;
+}
+
+TEST(DrawingExport, testEdgeOrderIsKept)
+{
+    // more edges than threads, joined in the order of the explorer
+    BRep_Builder builder;
+    TopoDS_Compound comp;
+    builder.MakeCompound(comp);
+    std::string expected;
+    for (int i = 0; i < 50; i++) {
+        builder.Add(comp, makeCircle(i, 0, 0.5));
+        expected += "<circle cx =\"" + printfG(i) + "\" cy =\"0\" r =\"0.5\" />";
+    }
+
+    Drawing::SVGOutput output;
+    EXPECT_EQ(output.exportEdges(comp), expected);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Mod/Drawing/App/ProjectionAlgos.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class BatchProjectionTest: public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        for (const auto& it : files) {
+            Base::FileInfo fi(it);
+            if (fi.exists()) {
+                fi.deleteFile();
+            }
+        }
+    }
+
+    std::string tempFile(const char* extension)
+    {
+        std::string name = Base::FileInfo::getTempFileName("BatchProjection");
+        Base::FileInfo(name).deleteFile();
+        name += extension;
+        files.push_back(name);
+        return name;
+    }
+
+    static std::string readFile(const std::string& name)
+    {
+        std::ifstream str(name.c_str());
+        std::stringstream buf;
+        buf << str.rdbuf();
+        return buf.str();
+    }
+
+    std::vector<std::string> files;
+};
+
+TEST_F(BatchProjectionTest, testSharedShapes)
+{
+    // placed copies of the same box share their topology and geometry
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(10, 20, 30).Shape();
+    std::vector<TopoDS_Shape> shapes;
+    std::vector<std::string> names;
+    for (int i = 0; i < 8; i++) {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(i * 50.0, 0, 0));
+        shapes.push_back(box.Moved(TopLoc_Location(trsf)));
+        names.push_back(tempFile(i % 2 ? ".svg" : ".dxf"));
+    }
+    shapes.push_back(box);
+    names.push_back(tempFile(".svg"));
+    shapes.push_back(box);
+    names.push_back(tempFile(".svg"));
+
+    Drawing::BatchProjection batch(Base::Vector3d(0, 0, 1), Drawing::ProjectionAlgos::Plain, 0.1);
+    std::vector<Drawing::BatchProjection::Result> results = batch.exportFiles(shapes, names);
+
+    ASSERT_EQ(results.size(), shapes.size());
+    for (std::size_t i = 0; i < results.size(); i++) {
+        EXPECT_TRUE(results[i].error.empty()) << results[i].error;
+        std::string content = readFile(names[i]);
+        if (i % 2 == 1 || i >= 8) {
+            EXPECT_EQ(content.compare(0, 4, "<svg"), 0);
+            EXPECT_NE(content.find("</svg>"), std::string::npos);
+        }
+        else {
+            // a header declares the version the subclass markers belong to
+            EXPECT_EQ(content.find("0\nSECTION\n2\nHEADER\n9\n$ACADVER\n1\nAC1015\n"), 0);
+            EXPECT_NE(content.find("0\nSECTION\n2\nENTITIES\n"), std::string::npos);
+            EXPECT_NE(content.find("AcDbLine"), std::string::npos);
+            std::string end = "0\nENDSEC\n0\nEOF\n";
+            ASSERT_GT(content.size(), end.size());
+            EXPECT_EQ(content.compare(content.size() - end.size(), end.size(), end), 0);
+        }
+    }
+
+    // identical input gives identical output
+    EXPECT_FALSE(readFile(names[8]).empty());
+    EXPECT_EQ(readFile(names[8]), readFile(names[9]));
+}
+
+TEST_F(BatchProjectionTest, testErrorsPerShape)
+{
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(10, 20, 30).Shape();
+    std::string missing = Base::FileInfo::getTempPath() + "no_such_directory/box.svg";
+    std::vector<TopoDS_Shape> shapes = {box, box};
+    std::vector<std::string> names = {missing, tempFile(".svg")};
+
+    Drawing::BatchProjection batch(Base::Vector3d(0, 0, 1), Drawing::ProjectionAlgos::Plain, 0.1);
+    std::vector<Drawing::BatchProjection::Result> results = batch.exportFiles(shapes, names);
+
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_FALSE(results[0].error.empty());
+    EXPECT_TRUE(results[1].error.empty()) << results[1].error;
+}
+
+TEST_F(BatchProjectionTest, testSizeMismatch)
+{
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(10, 20, 30).Shape();
+    Drawing::BatchProjection batch(Base::Vector3d(0, 0, 1), Drawing::ProjectionAlgos::Plain, 0.1);
+    EXPECT_THROW(batch.exportFiles({box}, {}), Base::ValueError);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
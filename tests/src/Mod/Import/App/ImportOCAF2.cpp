@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <cmath>
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include <Mod/Import/App/ImportOCAF2.h>
+#include <Mod/Part/App/PartFeature.h>
+
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <Bnd_Box.hxx>
+#include <TDocStd_Document.hxx>
+#include <XCAFApp_Application.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Trsf.hxx>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class ImportOCAF2Test: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        if (App::Application::GetARGC() == 0) {
+            int argc = 1;
+            char* argv[] = {"FreeCAD"};
+            App::Application::Config()["ExeName"] = "FreeCAD";
+            App::Application::init(argc, argv);
+        }
+    }
+
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        XCAFApp_Application::GetApplication()->NewDocument(TCollection_ExtendedString("MDTV-CAF"),
+                                                          _hDoc);
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    static Bnd_Box boundBox(const TopoDS_Shape& shape)
+    {
+        Bnd_Box box;
+        BRepBndLib::AddOptimal(shape, box, false, false);
+        return box;
+    }
+
+    std::string _docName;
+    App::Document* _doc {nullptr};
+    Handle(TDocStd_Document) _hDoc;
+};
+
+TEST_F(ImportOCAF2Test, TestRepeatedSolidInstances)
+{
+    // The second part is the first one built again in another orientation, so it isn't
+    // instanced by the file but shared by the import. It is used twice in the assembly.
+    gp_Trsf rotation;
+    rotation.SetRotation(gp_Ax1(gp_Pnt(), gp_Dir(0, 0, 1)), M_PI / 2);
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(10.0, 20.0, 30.0).Shape();
+    TopoDS_Shape copy =
+        BRepBuilderAPI_Transform(BRepPrimAPI_MakeBox(10.0, 20.0, 30.0).Shape(), rotation, true)
+            .Shape();
+
+    Handle(XCAFDoc_ShapeTool) tool = XCAFDoc_DocumentTool::ShapeTool(_hDoc->Main());
+    TDF_Label boxLabel = tool->AddShape(box, false);
+    TDF_Label copyLabel = tool->AddShape(copy, false);
+    TDF_Label assembly = tool->NewShape();
+    gp_Trsf move1, move2;
+    move1.SetTranslation(gp_Vec(100.0, 0.0, 0.0));
+    move2.SetTranslation(gp_Vec(0.0, 100.0, 0.0));
+    tool->AddComponent(assembly, boxLabel, TopLoc_Location());
+    tool->AddComponent(assembly, copyLabel, TopLoc_Location(move1));
+    tool->AddComponent(assembly, copyLabel, TopLoc_Location(move2));
+    tool->UpdateAssemblies();
+
+    Import::ImportOCAF2 importer(_hDoc, _doc, "test");
+    Import::ImportOCAFOptions options;
+    options.useLinkGroup = true;
+    options.dedupSolids = true;
+    importer.setImportOptions(options);
+    App::DocumentObject* root = importer.loadShapes();
+    ASSERT_TRUE(root);
+
+    // only the first box is a feature, the repeated ones link to it
+    EXPECT_EQ(_doc->getObjectsOfType(Part::Feature::getClassTypeId()).size(), 1);
+
+    Bnd_Box expected = boundBox(tool->GetShape(assembly));
+    Bnd_Box imported = boundBox(Part::Feature::getShape(root));
+    ASSERT_FALSE(imported.IsVoid());
+    double xmin1, ymin1, zmin1, xmax1, ymax1, zmax1;
+    double xmin2, ymin2, zmin2, xmax2, ymax2, zmax2;
+    expected.Get(xmin1, ymin1, zmin1, xmax1, ymax1, zmax1);
+    imported.Get(xmin2, ymin2, zmin2, xmax2, ymax2, zmax2);
+    EXPECT_NEAR(xmin1, xmin2, 1e-6);
+    EXPECT_NEAR(ymin1, ymin2, 1e-6);
+    EXPECT_NEAR(zmin1, zmin2, 1e-6);
+    EXPECT_NEAR(xmax1, xmax2, 1e-6);
+    EXPECT_NEAR(ymax1, ymax2, 1e-6);
+    EXPECT_NEAR(zmax1, zmax2, 1e-6);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
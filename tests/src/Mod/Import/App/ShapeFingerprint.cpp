@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <Mod/Import/App/ShapeFingerprint.h>
+
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepFilletAPI_MakeChamfer.hxx>
+#include <BRepFilletAPI_MakeFillet.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRep_Tool.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class ShapeFingerprintTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        box = BRepPrimAPI_MakeBox(10.0, 20.0, 30.0).Shape();
+        TopExp_Explorer xp(box, TopAbs_EDGE);
+        edge = TopoDS::Edge(xp.Current());
+    }
+
+    void TearDown() override
+    {}
+
+    TopoDS_Shape makeFillet() const
+    {
+        BRepFilletAPI_MakeFillet fillet(box);
+        fillet.Add(2.0, edge);
+        return fillet.Shape();
+    }
+
+    TopoDS_Shape makeChamfer() const
+    {
+        BRepFilletAPI_MakeChamfer chamfer(box);
+        chamfer.Add(2.0, edge);
+        return chamfer.Shape();
+    }
+
+    static gp_Trsf makeMotion()
+    {
+        gp_Trsf trsf;
+        trsf.SetRotation(gp_Ax1(gp_Pnt(), gp_Dir(1.0, 1.0, 1.0)), 0.7);
+        trsf.SetTranslationPart(gp_Vec(5.0, -6.0, 7.0));
+        return trsf;
+    }
+
+    TopoDS_Shape box;
+    TopoDS_Edge edge;
+};
+
+TEST_F(ShapeFingerprintTest, TestInvalid)
+{
+    EXPECT_FALSE(Import::ShapeFingerprint(TopoDS_Shape()).isValid());
+    // no solid
+    EXPECT_FALSE(Import::ShapeFingerprint(edge).isValid());
+    EXPECT_TRUE(Import::ShapeFingerprint(box).isValid());
+}
+
+TEST_F(ShapeFingerprintTest, TestMovedCopy)
+{
+    TopoDS_Shape fillet = makeFillet();
+    // transform the geometry, not only the location
+    TopoDS_Shape moved = BRepBuilderAPI_Transform(fillet, makeMotion(), Standard_True).Shape();
+
+    Import::ShapeFingerprint fp1(fillet);
+    Import::ShapeFingerprint fp2(moved);
+    EXPECT_EQ(fp1.hash(), fp2.hash());
+    EXPECT_TRUE(fp1.matches(fp2));
+
+    gp_Trsf trsf;
+    ASSERT_TRUE(fp1.findTransform(fp2, trsf));
+    EXPECT_TRUE(fp1.verify(fp2, trsf));
+    for (TopExp_Explorer xp(fillet, TopAbs_VERTEX); xp.More(); xp.Next()) {
+        gp_Pnt pnt = BRep_Tool::Pnt(TopoDS::Vertex(xp.Current()));
+        EXPECT_LT(pnt.Transformed(trsf).Distance(pnt.Transformed(makeMotion())), 1e-6);
+    }
+}
+
+TEST_F(ShapeFingerprintTest, TestMovedLocation)
+{
+    TopoDS_Shape moved = box.Moved(TopLoc_Location(makeMotion()));
+    Import::ShapeFingerprint fp1(box);
+    Import::ShapeFingerprint fp2(moved);
+    // the location is ignored
+    gp_Trsf trsf;
+    ASSERT_TRUE(fp1.findTransform(fp2, trsf));
+    EXPECT_LT(trsf.TranslationPart().Modulus(), 1e-6);
+}
+
+TEST_F(ShapeFingerprintTest, TestFilletIsNotChamfer)
+{
+    // a fillet and a chamfer of the same size have the same vertices
+    Import::ShapeFingerprint fillet(makeFillet());
+    Import::ShapeFingerprint chamfer(makeChamfer());
+    ASSERT_TRUE(fillet.isValid());
+    ASSERT_TRUE(chamfer.isValid());
+
+    EXPECT_FALSE(fillet.verify(chamfer, gp_Trsf()));
+    EXPECT_FALSE(chamfer.verify(fillet, gp_Trsf()));
+    EXPECT_TRUE(fillet.verify(fillet, gp_Trsf()));
+
+    gp_Trsf trsf;
+    EXPECT_FALSE(fillet.findTransform(chamfer, trsf));
+}
+
+TEST_F(ShapeFingerprintTest, TestDifferentSize)
+{
+    Import::ShapeFingerprint fp1(box);
+    Import::ShapeFingerprint fp2(BRepPrimAPI_MakeBox(10.0, 20.0, 31.0).Shape());
+    EXPECT_FALSE(fp1.matches(fp2));
+    gp_Trsf trsf;
+    EXPECT_FALSE(fp1.findTransform(fp2, trsf));
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
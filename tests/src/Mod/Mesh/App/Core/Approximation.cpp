@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include <Mod/Mesh/App/Core/Approximation.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class ApproximationTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // points on the plane z = 1000 + 0.5 * x far away from the origin
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 10; j++) {
+                plane.emplace_back(1000.0F + float(i), 1000.0F + float(j), 1500.0F + 0.5F * float(i));
+            }
+        }
+        outliers.emplace_back(1005.0F, 1005.0F, 1600.0F);
+        outliers.emplace_back(1002.0F, 1007.0F, 1400.0F);
+    }
+
+    std::vector<Base::Vector3f> plane;
+    std::vector<Base::Vector3f> outliers;
+};
+
+TEST_F(ApproximationTest, testMomentsAddRemove)
+{
+    MeshCore::PointMoments moments;
+    for (const auto& pnt : plane) {
+        moments.Add(pnt);
+    }
+    for (const auto& pnt : outliers) {
+        moments.Add(pnt);
+    }
+    for (const auto& pnt : outliers) {
+        moments.Remove(pnt);
+    }
+
+    MeshCore::PointMoments reference;
+    for (const auto& pnt : plane) {
+        reference.Add(pnt);
+    }
+
+    EXPECT_EQ(moments.Count(), plane.size());
+    EXPECT_NEAR(Base::Distance(moments.GetMean(), reference.GetMean()), 0.0, 1e-9);
+    Wm4::Matrix3<double> m1 = moments.GetScatter();
+    Wm4::Matrix3<double> m2 = reference.GetScatter();
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(m1(i, j), m2(i, j), 1e-7);
+        }
+    }
+}
+
+TEST_F(ApproximationTest, testPlaneFitAfterRemovingPoints)
+{
+    MeshCore::PlaneFit fit;
+    fit.AddPoints(plane);
+    fit.AddPoints(outliers);
+    fit.RemovePoints(outliers);
+    EXPECT_FALSE(fit.Done());
+    EXPECT_EQ(fit.CountPoints(), plane.size());
+
+    float sigma = fit.Fit();
+    EXPECT_LT(sigma, 1e-3F);
+
+    Base::Vector3f normal = fit.GetNormal();
+    normal.Normalize();
+    Base::Vector3f expected(-0.5F, 0.0F, 1.0F);
+    expected.Normalize();
+    EXPECT_NEAR(std::fabs(normal * expected), 1.0F, 1e-5F);
+    EXPECT_NEAR(fit.GetGravity().x, 1004.5F, 1e-3F);
+}
+
+TEST_F(ApproximationTest, testRemovePoint)
+{
+    MeshCore::PlaneFit fit;
+    fit.AddPoints(plane);
+    EXPECT_TRUE(fit.RemovePoint(plane.back()));
+    EXPECT_FALSE(fit.RemovePoint(outliers.front()));
+    EXPECT_EQ(fit.CountPoints(), plane.size() - 1);
+    EXPECT_EQ(fit.GetMoments().Count(), plane.size() - 1);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <random>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class BVHTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a cloud of random facets
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<float> pos(-10.0F, 10.0F);
+        std::uniform_real_distribution<float> ext(-1.0F, 1.0F);
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        for (int i = 0; i < 2000; i++) {
+            Base::Vector3f c(pos(gen), pos(gen), pos(gen));
+            Base::Vector3f p1 = c + Base::Vector3f(ext(gen), ext(gen), ext(gen));
+            Base::Vector3f p2 = c + Base::Vector3f(ext(gen), ext(gen), ext(gen));
+            Base::Vector3f p3 = c + Base::Vector3f(ext(gen), ext(gen), ext(gen));
+            facets.emplace_back(p1, p2, p3);
+        }
+        kernel = facets;
+
+        std::uniform_real_distribution<float> dir(-1.0F, 1.0F);
+        for (int i = 0; i < 1001; i++) {
+            Base::Vector3f pnt(pos(gen), pos(gen), pos(gen));
+            rays.push_back({2.0F * pnt, Base::Vector3f(dir(gen), dir(gen), dir(gen)) - pnt});
+        }
+    }
+
+    void TearDown() override
+    {}
+
+    // Tests all facets for the nearest hit in direction of the ray
+    bool BruteForce(const MeshCore::MeshFacetBVH::Ray& ray,
+                    Base::Vector3f& res,
+                    MeshCore::FacetIndex& index) const
+    {
+        bool found = false;
+        float minDist = 0.0F;
+        for (MeshCore::FacetIndex i = 0; i < kernel.CountFacets(); i++) {
+            Base::Vector3f pnt;
+            if (kernel.GetFacet(i).Foraminate(ray.pnt, ray.dir, pnt)) {
+                if ((pnt - ray.pnt) * ray.dir < 0.0F) {
+                    continue;
+                }
+                float dist = Base::Distance(pnt, ray.pnt);
+                if (!found || dist < minDist) {
+                    found = true;
+                    minDist = dist;
+                    res = pnt;
+                    index = i;
+                }
+            }
+        }
+        return found;
+    }
+
+    MeshCore::MeshKernel kernel;
+    std::vector<MeshCore::MeshFacetBVH::Ray> rays;
+};
+
+TEST_F(BVHTest, TestEmpty)
+{
+    MeshCore::MeshKernel empty;
+    MeshCore::MeshFacetBVH bvh(empty);
+    EXPECT_EQ(bvh.CountNodes(), 0);
+
+    Base::Vector3f res;
+    MeshCore::FacetIndex index;
+    EXPECT_FALSE(bvh.NearestFacetOnRay(Base::Vector3f(), Base::Vector3f(0, 0, 1), res, index));
+}
+
+TEST_F(BVHTest, TestSingleFacet)
+{
+    MeshCore::MeshKernel single;
+    single.AddFacet(MeshCore::MeshGeomFacet(Base::Vector3f(0, 0, 0),
+                                            Base::Vector3f(1, 0, 0),
+                                            Base::Vector3f(0, 1, 0)));
+    MeshCore::MeshFacetBVH bvh(single);
+
+    Base::Vector3f res;
+    MeshCore::FacetIndex index = MeshCore::FACET_INDEX_MAX;
+    EXPECT_TRUE(bvh.NearestFacetOnRay(Base::Vector3f(0.25F, 0.25F, 1.0F),
+                                      Base::Vector3f(0, 0, -2),
+                                      res,
+                                      index));
+    EXPECT_EQ(index, 0);
+    EXPECT_FLOAT_EQ(res.x, 0.25F);
+    EXPECT_FLOAT_EQ(res.y, 0.25F);
+    EXPECT_FLOAT_EQ(res.z, 0.0F);
+
+    // the facet is behind the ray
+    EXPECT_FALSE(bvh.NearestFacetOnRay(Base::Vector3f(0.25F, 0.25F, 1.0F),
+                                       Base::Vector3f(0, 0, 1),
+                                       res,
+                                       index));
+    // the ray misses the facet
+    EXPECT_FALSE(bvh.NearestFacetOnRay(Base::Vector3f(1.0F, 1.0F, 1.0F),
+                                       Base::Vector3f(0, 0, -1),
+                                       res,
+                                       index));
+    // the ray is parallel to the facet
+    EXPECT_FALSE(bvh.NearestFacetOnRay(Base::Vector3f(-1.0F, 0.25F, 0.0F),
+                                       Base::Vector3f(1, 0, 0),
+                                       res,
+                                       index));
+}
+
+TEST_F(BVHTest, TestCompareWithBruteForce)
+{
+    MeshCore::MeshFacetBVH bvh(kernel);
+    EXPECT_GT(bvh.CountNodes(), 0);
+
+    int numHits = 0;
+    for (const auto& ray : rays) {
+        Base::Vector3f res1, res2;
+        MeshCore::FacetIndex index1 = 0, index2 = 0;
+        bool hit1 = bvh.NearestFacetOnRay(ray.pnt, ray.dir, res1, index1);
+        bool hit2 = BruteForce(ray, res2, index2);
+        EXPECT_EQ(hit1, hit2);
+        if (hit1 && hit2) {
+            numHits++;
+            EXPECT_EQ(index1, index2);
+            EXPECT_NEAR(Base::Distance(res1, res2), 0.0F, 1e-4F);
+        }
+    }
+
+    // make sure the test is meaningful
+    EXPECT_GT(numHits, 100);
+}
+
+TEST_F(BVHTest, TestBatch)
+{
+    MeshCore::MeshFacetBVH bvh(kernel);
+    std::vector<MeshCore::MeshFacetBVH::Hit> hits = bvh.NearestFacetsOnRays(rays);
+    ASSERT_EQ(hits.size(), rays.size());
+
+    for (std::size_t i = 0; i < rays.size(); i++) {
+        Base::Vector3f res;
+        MeshCore::FacetIndex index = MeshCore::FACET_INDEX_MAX;
+        bool hit = bvh.NearestFacetOnRay(rays[i].pnt, rays[i].dir, res, index);
+        EXPECT_EQ(hits[i].isValid(), hit);
+        if (hit) {
+            EXPECT_EQ(hits[i].facet, index);
+            EXPECT_EQ(hits[i].point, res);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/MeshPart/App/CurveProjector.h>
+
+#include <TopoDS_Shape.hxx>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class CurveProjectorTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a wavy surface over [0, 10] x [0, 10]
+        const int num = 30;
+        auto point = [](int i, int j) {
+            float x = 10.0F * float(i) / float(num);
+            float y = 10.0F * float(j) / float(num);
+            return Base::Vector3f(x, y, std::sin(x) * std::cos(y));
+        };
+
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        for (int i = 0; i < num; i++) {
+            for (int j = 0; j < num; j++) {
+                facets.emplace_back(point(i, j), point(i + 1, j), point(i + 1, j + 1));
+                facets.emplace_back(point(i, j), point(i + 1, j + 1), point(i, j + 1));
+            }
+        }
+        mesh = facets;
+    }
+
+    TopoDS_Shape shape;
+    MeshCore::MeshKernel mesh;
+};
+
+TEST_F(CurveProjectorTest, TestGridSearchMatchesFullScan)
+{
+    // An empty shape, so that there are no curves to project
+    MeshPart::CurveProjectorShape projector(shape, mesh);
+    // For any other mesh all facets are tested
+    MeshCore::MeshKernel copy(mesh);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> xy(-5.0F, 15.0F);
+    std::uniform_real_distribution<float> z(-3.0F, 3.0F);
+    std::vector<Base::Vector3f> points;
+    for (int i = 0; i < 500; i++) {
+        points.emplace_back(xy(gen), xy(gen), z(gen));
+    }
+    // points on a grid line and far away from the mesh
+    points.emplace_back(5.0F, 5.0F, 2.0F);
+    points.emplace_back(100.0F, 100.0F, 50.0F);
+    points.emplace_back(1.0e6F, -1.0e6F, 1.0e6F);
+
+    int hits = 0;
+    for (const auto& pnt : points) {
+        Base::Vector3f gridPnt, scanPnt;
+        MeshCore::FacetIndex gridIndex = MeshCore::FACET_INDEX_MAX;
+        MeshCore::FacetIndex scanIndex = MeshCore::FACET_INDEX_MAX;
+        bool gridHit = projector.findStartPoint(mesh, pnt, gridPnt, gridIndex);
+        bool scanHit = projector.findStartPoint(copy, pnt, scanPnt, scanIndex);
+        ASSERT_EQ(gridHit, scanHit);
+        if (gridHit) {
+            EXPECT_EQ(gridIndex, scanIndex);
+            EXPECT_EQ(gridPnt, scanPnt);
+            hits++;
+        }
+    }
+    // a quarter of the points lies above or below the mesh
+    EXPECT_GT(hits, 50);
+}
+
+TEST_F(CurveProjectorTest, TestNonFinitePoint)
+{
+    MeshPart::CurveProjectorShape projector(shape, mesh);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+
+    Base::Vector3f rslt;
+    MeshCore::FacetIndex index = MeshCore::FACET_INDEX_MAX;
+    EXPECT_FALSE(projector.findStartPoint(mesh, Base::Vector3f(nan, 5.0F, 1.0F), rslt, index));
+    EXPECT_FALSE(projector.findStartPoint(mesh, Base::Vector3f(5.0F, inf, 1.0F), rslt, index));
+    EXPECT_FALSE(projector.findStartPoint(mesh, Base::Vector3f(5.0F, 5.0F, -inf), rslt, index));
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+#include <cmath>
+
+#include <QThreadPool>
+
+#include <Mod/MeshPart/App/MeshFlatteningLscmRelax.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class LscmRelaxTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a doubly curved patch with enough triangles to be assembled in several blocks
+        const int num = 40;
+        vertices.resize(3, num * num);
+        triangles.resize(3, 2 * (num - 1) * (num - 1));
+        for (int i = 0; i < num; i++) {
+            for (int j = 0; j < num; j++) {
+                double u = double(i) / (num - 1);
+                double v = double(j) / (num - 1);
+                vertices.col(i * num + j) << 100.0 * u, 100.0 * v,
+                    15.0 * std::sin(M_PI * u) * std::sin(M_PI * v) + 5.0 * u * v;
+            }
+        }
+        long index = 0;
+        for (int i = 0; i < num - 1; i++) {
+            for (int j = 0; j < num - 1; j++) {
+                long a = i * num + j;
+                long b = i * num + j + 1;
+                long c = (i + 1) * num + j + 1;
+                long d = (i + 1) * num + j;
+                triangles.col(index++) << a, b, c;
+                triangles.col(index++) << a, c, d;
+            }
+        }
+    }
+
+    RowMat<double, 2> flatten(bool warmStart) const
+    {
+        lscmrelax::LscmRelax flattener(vertices, triangles, {});
+        flattener.warm_start = warmStart;
+        flattener.lscm();
+        for (int i = 0; i < 3; i++) {
+            flattener.relax(0.95);
+        }
+        return flattener.flat_vertices;
+    }
+
+    static double maxDeviation(const RowMat<double, 2>& m1, const RowMat<double, 2>& m2)
+    {
+        return (m1 - m2).cwiseAbs().maxCoeff();
+    }
+
+    RowMat<double, 3> vertices;
+    RowMat<long, 3> triangles;
+};
+
+TEST_F(LscmRelaxTest, TestSerialAndParallelAssembly)
+{
+    // with a single thread the blocks of the assembly run one after the other
+    QThreadPool* pool = QThreadPool::globalInstance();
+    int threads = pool->maxThreadCount();
+    pool->setMaxThreadCount(1);
+    RowMat<double, 2> serial = flatten(true);
+    pool->setMaxThreadCount(threads);
+    RowMat<double, 2> parallel = flatten(true);
+
+    ASSERT_EQ(serial.cols(), parallel.cols());
+    EXPECT_LT(maxDeviation(serial, parallel), 1e-9);
+}
+
+TEST_F(LscmRelaxTest, TestWarmAndColdStart)
+{
+    RowMat<double, 2> warm = flatten(true);
+    RowMat<double, 2> cold = flatten(false);
+
+    ASSERT_EQ(warm.cols(), cold.cols());
+    EXPECT_LT(maxDeviation(warm, cold), 1e-6);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include <Mod/Mesh/App/Mesh.h>
+#include <Mod/MeshPart/App/Mesher.h>
+
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRep_Builder.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Trsf.hxx>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class BatchMesherTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        box = BRepPrimAPI_MakeBox(10.0, 20.0, 30.0).Shape();
+        cylinder = BRepPrimAPI_MakeCylinder(5.0, 10.0).Shape();
+    }
+
+    void TearDown() override
+    {}
+
+    MeshPart::Mesher makeSettings(bool relative = false) const
+    {
+        MeshPart::Mesher settings(nullShape);
+        settings.setMethod(MeshPart::Mesher::Standard);
+        settings.setDeflection(relative ? 0.01 : 0.1);
+        settings.setAngularDeflection(0.2);
+        settings.setRelative(relative);
+        settings.setRegular(true);
+        return settings;
+    }
+
+    // Meshes the shape on its own with the same settings
+    unsigned long countFacets(const TopoDS_Shape& shape, bool relative = false) const
+    {
+        MeshPart::Mesher mesher(makeSettings(relative), shape);
+        std::unique_ptr<Mesh::MeshObject> mesh(mesher.createMesh());
+        return mesh->countFacets();
+    }
+
+    // A compound with its children, copies that only differ in placement and the single
+    // faces of the box all share the same faces
+    std::vector<TopoDS_Shape> makeSharedShapes() const
+    {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(100.0, 0.0, 0.0));
+        TopoDS_Shape moved = box.Moved(TopLoc_Location(trsf));
+
+        TopoDS_Compound compound;
+        BRep_Builder builder;
+        builder.MakeCompound(compound);
+        builder.Add(compound, box);
+        builder.Add(compound, cylinder);
+
+        std::vector<TopoDS_Shape> shapes {compound, box, moved, cylinder};
+        for (TopExp_Explorer xp(box, TopAbs_FACE); xp.More(); xp.Next()) {
+            shapes.push_back(xp.Current());
+        }
+        // many copies to make concurrent processing likely
+        for (int i = 0; i < 20; i++) {
+            shapes.push_back(compound);
+        }
+        return shapes;
+    }
+
+    TopoDS_Shape nullShape;
+    TopoDS_Shape box;
+    TopoDS_Shape cylinder;
+};
+
+TEST_F(BatchMesherTest, TestEmpty)
+{
+    MeshPart::BatchMesher batch(makeSettings());
+    EXPECT_TRUE(batch.createMeshes({}).empty());
+}
+
+TEST_F(BatchMesherTest, TestSharedFaces)
+{
+    std::vector<TopoDS_Shape> shapes = makeSharedShapes();
+    MeshPart::BatchMesher batch(makeSettings());
+    std::vector<MeshPart::BatchMesher::Result> results = batch.createMeshes(shapes);
+    ASSERT_EQ(results.size(), shapes.size());
+
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        ASSERT_TRUE(results[i].isValid()) << results[i].error;
+        EXPECT_TRUE(results[i].error.empty());
+        EXPECT_EQ(results[i].mesh->countFacets(), countFacets(shapes[i]));
+    }
+
+    EXPECT_EQ(results[0].mesh->countFacets(),
+              results[1].mesh->countFacets() + results[3].mesh->countFacets());
+    EXPECT_EQ(results[1].mesh->countFacets(), results[2].mesh->countFacets());
+}
+
+TEST_F(BatchMesherTest, TestSharedFacesRelative)
+{
+    // with a relative deflection the triangulation of a shared face depends on the shape
+    // that is meshed, but every mesh must be the same as if the shape was meshed on its own
+    std::vector<TopoDS_Shape> shapes = makeSharedShapes();
+    MeshPart::BatchMesher batch(makeSettings(true));
+    std::vector<MeshPart::BatchMesher::Result> results = batch.createMeshes(shapes);
+    ASSERT_EQ(results.size(), shapes.size());
+
+    std::vector<unsigned long> facets;
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        ASSERT_TRUE(results[i].isValid()) << results[i].error;
+        facets.push_back(results[i].mesh->countFacets());
+    }
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        EXPECT_EQ(facets[i], countFacets(shapes[i], true)) << "shape " << i;
+    }
+    EXPECT_EQ(facets[1], facets[2]);
+}
+
+TEST_F(BatchMesherTest, TestSettingsOutliveMesher)
+{
+    // the batch mesher must not refer to a temporary mesher
+    MeshPart::BatchMesher batch(makeSettings());
+    std::vector<MeshPart::BatchMesher::Result> results = batch.createMeshes({box});
+    ASSERT_EQ(results.size(), 1);
+    ASSERT_TRUE(results[0].isValid());
+    EXPECT_EQ(results[0].mesh->countFacets(), countFacets(box));
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
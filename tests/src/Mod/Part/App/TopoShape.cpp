@@ -3,6 +3,11 @@
 #include "gtest/gtest.h"
 #include <Mod/Part/App/TopoShape.h>
 
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <thread>
+
 // clang-format off
 TEST(TopoShape, TestElementTypeFace1)
 {
@@ -87,4 +92,110 @@ TEST(TopoShape, TestTypeNull)
     EXPECT_EQ(Part::TopoShape::getTypeAndIndex(nullptr),
               std::make_pair(std::string(), 0UL));
 }
+
+TEST(TopoShape, TestSubShapeIndex)
+{
+    Part::TopoShape box(BRepPrimAPI_MakeBox(1.0, 2.0, 3.0).Shape());
+    EXPECT_EQ(box.countSubShapes(TopAbs_FACE), 6UL);
+    EXPECT_EQ(box.countSubShapes(TopAbs_EDGE), 12UL);
+    for (int i = 1; i <= 6; ++i) {
+        TopoDS_Shape face = box.getSubShape(TopAbs_FACE, i);
+        EXPECT_EQ(box.findShape(face), i);
+    }
+    EXPECT_EQ(box.findShape(TopoDS_Shape()), 0);
+    EXPECT_EQ(box.findShape(BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Face()), 0);
+}
+
+TEST(TopoShape, TestSubShapeAncestors)
+{
+    Part::TopoShape box(BRepPrimAPI_MakeBox(1.0, 2.0, 3.0).Shape());
+    TopoDS_Shape edge = box.getSubShape(TopAbs_EDGE, 1);
+    auto faces = box.findAncestorsShapes(edge, TopAbs_FACE);
+    EXPECT_EQ(faces.size(), 2UL);
+    for (const auto& face : faces) {
+        EXPECT_GT(box.findShape(face), 0);
+    }
+}
+
+TEST(TopoShape, TestSubShapeIndexAfterChange)
+{
+    Part::TopoShape shape(BRepPrimAPI_MakeBox(1.0, 2.0, 3.0).Shape());
+    EXPECT_EQ(shape.countSubShapes(TopAbs_FACE), 6UL);
+
+    TopoDS_Compound comp;
+    BRep_Builder builder;
+    builder.MakeCompound(comp);
+    builder.Add(comp, BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape());
+    builder.Add(comp, BRepPrimAPI_MakeBox(2.0, 2.0, 2.0).Shape());
+    shape.setShape(comp);
+    EXPECT_EQ(shape.countSubShapes(TopAbs_FACE), 12UL);
+
+    Part::TopoShape copy(shape);
+    EXPECT_EQ(copy.countSubShapes(TopAbs_SOLID), 2UL);
+}
+
+TEST(TopoShape, TestSubShapeIndexStaleAfterSetShape)
+{
+    TopoDS_Compound comp;
+    BRep_Builder builder;
+    builder.MakeCompound(comp);
+    builder.Add(comp, BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape());
+
+    Part::TopoShape shape(comp);
+    EXPECT_EQ(shape.countSubShapes(TopAbs_SOLID), 1UL);
+    Part::TopoShape copy(shape);
+    EXPECT_EQ(copy.countSubShapes(TopAbs_SOLID), 1UL);
+
+    // modify the compound in place, location and orientation are kept
+    builder.Add(comp, BRepPrimAPI_MakeBox(2.0, 2.0, 2.0).Shape());
+    EXPECT_EQ(shape.countSubShapes(TopAbs_SOLID), 2UL);
+    EXPECT_EQ(copy.countSubShapes(TopAbs_SOLID), 2UL);
+
+    shape.setShape(comp);
+    EXPECT_EQ(shape.countSubShapes(TopAbs_FACE), 12UL);
+    EXPECT_EQ(shape.findShape(shape.getSubShape(TopAbs_FACE, 12)), 12);
+}
+
+TEST(TopoShape, TestSubShapeIndexConcurrentAccess)
+{
+    TopoDS_Compound comp;
+    BRep_Builder builder;
+    builder.MakeCompound(comp);
+    for (int i = 1; i <= 10; i++) {
+        builder.Add(comp, BRepPrimAPI_MakeBox(i, i, i).Shape());
+    }
+    const Part::TopoShape shape(comp);
+    // the expected results, computed without a cache
+    Part::TopoShape reference(comp);
+    std::vector<TopoDS_Shape> edges = reference.getSubShapes(TopAbs_EDGE);
+
+    // threads use the same object and copies that share its cache
+    std::vector<std::thread> threads;
+    std::vector<int> errors(8, 0);
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&, t]() {
+            Part::TopoShape copy(shape);
+            const Part::TopoShape& obj = (t % 2) ? copy : shape;
+            for (int pass = 0; pass < 5; pass++) {
+                if (obj.countSubShapes(TopAbs_FACE) != 60UL) {
+                    errors[t]++;
+                }
+                for (std::size_t i = 0; i < edges.size(); i++) {
+                    if (obj.findShape(edges[i]) != int(i + 1)) {
+                        errors[t]++;
+                    }
+                    if (obj.findAncestorsShapes(edges[i], TopAbs_FACE).size() != 2) {
+                        errors[t]++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int count : errors) {
+        EXPECT_EQ(count, 0);
+    }
+}
 // clang-format on
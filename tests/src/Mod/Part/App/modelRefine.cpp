@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <Mod/Part/App/modelRefine.h>
+
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakePolygon.hxx>
+#include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRep_Builder.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+// clang-format off
+namespace
+{
+TopoDS_Shell makeShell(const std::vector<TopoDS_Face>& faces)
+{
+    BRep_Builder builder;
+    TopoDS_Shell shell;
+    builder.MakeShell(shell);
+    for (const auto& face : faces) {
+        builder.Add(shell, face);
+    }
+    return shell;
+}
+
+TopoDS_Face makeTriangle(const TopoDS_Vertex& v1, const TopoDS_Vertex& v2, const TopoDS_Vertex& v3)
+{
+    BRepBuilderAPI_MakePolygon polygon(v1, v2, v3, Standard_True);
+    return BRepBuilderAPI_MakeFace(polygon.Wire()).Face();
+}
+
+TopoDS_Vertex makeVertex(double x, double y, double z)
+{
+    return BRepBuilderAPI_MakeVertex(gp_Pnt(x, y, z)).Vertex();
+}
+}
+
+TEST(ModelRefine, TestNoSharedSubShapes)
+{
+    TopoDS_Shape box1 = BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape();
+    TopoDS_Shape box2 = BRepPrimAPI_MakeBox(gp_Pnt(1.0, 1.0, 1.0), 1.0, 1.0, 1.0).Shape();
+    TopExp_Explorer xp1(box1, TopAbs_SHELL);
+    TopExp_Explorer xp2(box2, TopAbs_SHELL);
+    std::vector<TopoDS_Shell> shells {TopoDS::Shell(xp1.Current()), TopoDS::Shell(xp2.Current())};
+    EXPECT_FALSE(ModelRefine::haveSharedSubShapes(shells));
+    EXPECT_FALSE(ModelRefine::haveSharedSubShapes({}));
+}
+
+TEST(ModelRefine, TestSharedEdge)
+{
+    // two adjacent faces of a box share an edge
+    TopoDS_Shape box = BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape();
+    std::vector<TopoDS_Face> faces;
+    for (TopExp_Explorer xp(box, TopAbs_FACE); xp.More(); xp.Next()) {
+        faces.push_back(TopoDS::Face(xp.Current()));
+    }
+    // the first two faces of a box are opposite to each other, the third is adjacent
+    EXPECT_FALSE(ModelRefine::haveSharedSubShapes({makeShell({faces[0]}), makeShell({faces[1]})}));
+    EXPECT_TRUE(ModelRefine::haveSharedSubShapes({makeShell({faces[0]}), makeShell({faces[2]})}));
+}
+
+TEST(ModelRefine, TestSharedVertex)
+{
+    // the triangles only touch at one vertex
+    TopoDS_Vertex shared = makeVertex(0.0, 0.0, 0.0);
+    TopoDS_Face tria1 = makeTriangle(shared, makeVertex(1.0, 0.0, 0.0), makeVertex(1.0, 1.0, 0.0));
+    TopoDS_Face tria2 = makeTriangle(shared, makeVertex(-1.0, 0.0, 0.0), makeVertex(-1.0, -1.0, 0.0));
+    EXPECT_TRUE(ModelRefine::haveSharedSubShapes({makeShell({tria1}), makeShell({tria2})}));
+
+    // the same faces in one shell are not shared
+    EXPECT_FALSE(ModelRefine::haveSharedSubShapes({makeShell({tria1, tria2})}));
+}
+// clang-format on
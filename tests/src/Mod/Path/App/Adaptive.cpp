@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <Mod/Path/libarea/Adaptive.hpp>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+
+AdaptivePath::DPath square(double x, double y, double size)
+{
+    return {{x, y}, {x + size, y}, {x + size, y + size}, {x, y + size}};
+}
+
+std::list<AdaptivePath::AdaptiveOutput> clearPockets(int threads)
+{
+    AdaptivePath::Adaptive2d adaptive;
+    adaptive.toolDiameter = 4;
+    adaptive.stepOverFactor = 0.3;
+    adaptive.tolerance = 0.1;
+    adaptive.maxThreads = threads;
+
+    // separate pockets are cleared as separate regions
+    AdaptivePath::DPaths paths;
+    for (int i = 0; i < 4; ++i) {
+        paths.push_back(square(i * 40.0, 0, 25));
+    }
+    AdaptivePath::DPaths stock {square(-10, -10, 200)};
+    return adaptive.Execute(stock, paths, [](AdaptivePath::TPaths) {
+        return false;
+    });
+}
+
+void expectEqual(const std::list<AdaptivePath::AdaptiveOutput>& out1,
+                 const std::list<AdaptivePath::AdaptiveOutput>& out2)
+{
+    ASSERT_EQ(out1.size(), out2.size());
+    auto it = out2.begin();
+    for (const auto& output : out1) {
+        EXPECT_EQ(output.HelixCenterPoint, it->HelixCenterPoint);
+        EXPECT_EQ(output.StartPoint, it->StartPoint);
+        EXPECT_EQ(output.ReturnMotionType, it->ReturnMotionType);
+        EXPECT_TRUE(output.AdaptivePaths == it->AdaptivePaths);
+        ++it;
+    }
+}
+
+}  // namespace
+
+TEST(Adaptive2d, TestParallelMatchesSerial)
+{
+    auto serial = clearPockets(1);
+    auto parallel = clearPockets(4);
+    EXPECT_EQ(serial.size(), 4);
+    expectEqual(serial, parallel);
+}
+
+TEST(Adaptive2d, TestRepeatable)
+{
+    expectEqual(clearPockets(1), clearPockets(1));
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
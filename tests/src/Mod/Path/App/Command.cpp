@@ -0,0 +1,319 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <Mod/Path/App/Command.h>
+#include <Mod/Path/App/Path.h>
+
+#include <boost/algorithm/string.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+
+// The parser before the string_view tokenizer, kept as reference
+void legacyCommandFromGCode(Path::Command& cmd, const std::string& str)
+{
+    cmd.Parameters.clear();
+    std::string mode = "none";
+    std::string key;
+    std::string value;
+    for (unsigned int i = 0; i < str.size(); i++) {
+        if ((isdigit(str[i])) || (str[i] == '-') || (str[i] == '.')) {
+            value += str[i];
+        }
+        else if (isalpha(str[i])) {
+            if (mode == "command") {
+                if (!key.empty() && !value.empty()) {
+                    std::string name = key + value;
+                    boost::to_upper(name);
+                    cmd.Name = name;
+                    key = "";
+                    value = "";
+                }
+                else {
+                    throw Base::BadFormatError("Badly formatted GCode command");
+                }
+                mode = "argument";
+            }
+            else if (mode == "none") {
+                mode = "command";
+            }
+            else if (mode == "argument") {
+                if (!key.empty() && !value.empty()) {
+                    double val = std::atof(value.c_str());
+                    boost::to_upper(key);
+                    cmd.Parameters[key] = val;
+                    key = "";
+                    value = "";
+                }
+                else {
+                    throw Base::BadFormatError("Badly formatted GCode argument");
+                }
+            }
+            else if (mode == "comment") {
+                value += str[i];
+            }
+            key = str[i];
+        }
+        else if (str[i] == '(') {
+            mode = "comment";
+        }
+        else if (str[i] == ')') {
+            key = "(";
+            value += ")";
+        }
+        else if (mode == "comment") {
+            value += str[i];
+        }
+    }
+    if (!key.empty() && !value.empty()) {
+        if ((mode == "command") || (mode == "comment")) {
+            std::string name = key + value;
+            if (mode == "command") {
+                boost::to_upper(name);
+            }
+            cmd.Name = name;
+        }
+        else {
+            double val = std::atof(value.c_str());
+            boost::to_upper(key);
+            cmd.Parameters[key] = val;
+        }
+    }
+    else {
+        throw Base::BadFormatError("Badly formatted GCode argument");
+    }
+}
+
+void legacyAddCommand(const std::string& str, std::vector<Path::Command>& commands, bool& inches)
+{
+    Path::Command cmd;
+    legacyCommandFromGCode(cmd, str);
+    if ("G20" == cmd.Name) {
+        inches = true;
+    }
+    else if ("G21" == cmd.Name) {
+        inches = false;
+    }
+    else {
+        if (inches) {
+            cmd.scaleBy(25.4);
+        }
+        commands.push_back(cmd);
+    }
+}
+
+std::vector<Path::Command> legacyToolpathFromGCode(const std::string& str)
+{
+    std::vector<Path::Command> commands;
+    std::string mode = "command";
+    std::size_t found = str.find_first_of("(gGmM");
+    int last = -1;
+    bool inches = false;
+    while (found != std::string::npos) {
+        if (str[found] == '(') {
+            if ((last > -1) && (mode == "command")) {
+                legacyAddCommand(str.substr(last, found - last), commands, inches);
+            }
+            mode = "comment";
+            last = found;
+            found = str.find_first_of(')', found + 1);
+        }
+        else if (str[found] == ')') {
+            legacyAddCommand(str.substr(last, found - last + 1), commands, inches);
+            last = -1;
+            found = str.find_first_of("(gGmM", found + 1);
+            mode = "command";
+        }
+        else if (mode == "command") {
+            if (last > -1) {
+                legacyAddCommand(str.substr(last, found - last), commands, inches);
+            }
+            last = found;
+            found = str.find_first_of("(gGmM", found + 1);
+        }
+    }
+    if (last > -1 && mode == "command") {
+        legacyAddCommand(str.substr(last, std::string::npos), commands, inches);
+    }
+    return commands;
+}
+
+void expectSameCommand(const Path::Command& cmd, const Path::Command& ref)
+{
+    EXPECT_EQ(cmd.Name, ref.Name);
+    ASSERT_EQ(cmd.Parameters.size(), ref.Parameters.size());
+    auto it = ref.Parameters.begin();
+    for (const auto& param : cmd.Parameters) {
+        EXPECT_EQ(param.first, it->first);
+        // bitwise equal, including the sign of zero
+        EXPECT_EQ(std::signbit(param.second), std::signbit(it->second));
+        EXPECT_EQ(param.second, it->second);
+        ++it;
+    }
+}
+
+std::string randomNumber(std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> kind(0, 5);
+    std::uniform_real_distribution<double> real(-1000.0, 1000.0);
+    std::ostringstream str;
+    switch (kind(gen)) {
+        case 0:
+            str << std::uniform_int_distribution<int>(-100, 100)(gen);
+            break;
+        case 1:
+            str.precision(17);
+            str << std::fixed << real(gen);
+            break;
+        case 2:
+            return "-.5";
+        case 3:
+            return "1.2.3";
+        case 4:
+            return "0.00000000000000000000000001";
+        default:
+            str.precision(4);
+            str << std::fixed << real(gen);
+            break;
+    }
+    return str.str();
+}
+
+std::string randomProgram(std::mt19937& gen, int lines)
+{
+    static const char* names[] = {"G0", "G1", "g1", "G2", "G3", "G20", "G21", "M3", "G81"};
+    static const char* axes = "XYZIJKFRQxyz";
+    std::uniform_int_distribution<int> name(0, 8);
+    std::uniform_int_distribution<int> axis(0, 11);
+    std::uniform_int_distribution<int> count(0, 4);
+    std::uniform_int_distribution<int> extra(0, 19);
+    std::string program;
+    for (int i = 0; i < lines; ++i) {
+        if (extra(gen) == 0) {
+            program += "(comment 12 (x) y)\n";
+        }
+        program += names[name(gen)];
+        for (int j = count(gen); j > 0; --j) {
+            program += ' ';
+            program += axes[axis(gen)];
+            program += randomNumber(gen);
+        }
+        program += '\n';
+    }
+    return program;
+}
+
+}  // namespace
+
+TEST(Command, TestSetFromGCode)
+{
+    Path::Command cmd;
+    cmd.setFromGCode("g1 x1.5 Y-2 z.25");
+    EXPECT_EQ(cmd.Name, "G1");
+    EXPECT_EQ(cmd.Parameters.size(), 3);
+    EXPECT_DOUBLE_EQ(cmd.getParam("X"), 1.5);
+    EXPECT_DOUBLE_EQ(cmd.getParam("Y"), -2.0);
+    EXPECT_DOUBLE_EQ(cmd.getParam("Z"), 0.25);
+}
+
+TEST(Command, TestSetFromGCodeComment)
+{
+    Path::Command cmd;
+    cmd.setFromGCode("(Tool 1, 6mm)");
+    EXPECT_EQ(cmd.Name, "(Tool 1, 6mm)");
+    EXPECT_TRUE(cmd.Parameters.empty());
+}
+
+TEST(Command, TestSetFromGCodeBadFormat)
+{
+    Path::Command cmd;
+    EXPECT_THROW(cmd.setFromGCode("G1 X"), Base::BadFormatError);
+    EXPECT_THROW(cmd.setFromGCode("GX1"), Base::BadFormatError);
+}
+
+TEST(Command, TestSetFromGCodeLegacy)
+{
+    std::mt19937 gen(42);
+    for (int i = 0; i < 2000; ++i) {
+        std::string line = randomProgram(gen, 1);
+        Path::Command cmd;
+        Path::Command ref;
+        bool failed = false;
+        try {
+            legacyCommandFromGCode(ref, line);
+        }
+        catch (const Base::BadFormatError&) {
+            failed = true;
+        }
+        if (failed) {
+            EXPECT_THROW(cmd.setFromGCode(line), Base::BadFormatError);
+        }
+        else {
+            cmd.setFromGCode(line);
+            expectSameCommand(cmd, ref);
+        }
+    }
+}
+
+TEST(Toolpath, TestSetFromGCodeLegacy)
+{
+    std::mt19937 gen(7);
+    // large enough to be parsed in several blocks
+    std::string program = randomProgram(gen, 20000);
+    program += "G1 X1 (unterminated";
+
+    Path::Toolpath path;
+    path.setFromGCode(program);
+    auto ref = legacyToolpathFromGCode(program);
+    ASSERT_EQ(path.getSize(), ref.size());
+    for (unsigned int i = 0; i < path.getSize(); ++i) {
+        expectSameCommand(path.getCommand(i), ref[i]);
+    }
+}
+
+TEST(Toolpath, TestSetFromGCodeUnits)
+{
+    Path::Toolpath path;
+    path.setFromGCode("G20\nG1 X1\nG21\nG1 X1");
+    ASSERT_EQ(path.getSize(), 2);
+    EXPECT_DOUBLE_EQ(path.getCommand(0).getParam("X"), 25.4);
+    EXPECT_DOUBLE_EQ(path.getCommand(1).getParam("X"), 1.0);
+}
+
+TEST(Toolpath, TestSetFromGCodeError)
+{
+    Path::Toolpath path;
+    EXPECT_THROW(path.setFromGCode("G1 X1\nG1 Y\nG1 Z1"), Base::BadFormatError);
+    // the commands before the bad one are kept
+    EXPECT_EQ(path.getSize(), 1);
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(Toolpath, DISABLED_BenchmarkSetFromGCode)
+{
+    std::mt19937 gen(1);
+    std::string program = randomProgram(gen, 1000000);
+
+    auto start = std::chrono::steady_clock::now();
+    auto ref = legacyToolpathFromGCode(program);
+    auto legacy = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    Path::Toolpath path;
+    path.setFromGCode(program);
+    auto current = std::chrono::steady_clock::now() - start;
+
+    using ms = std::chrono::milliseconds;
+    std::cout << "legacy parser: " << std::chrono::duration_cast<ms>(legacy).count() << " ms, "
+              << "parser: " << std::chrono::duration_cast<ms>(current).count() << " ms, "
+              << program.size() << " bytes" << std::endl;
+    EXPECT_EQ(path.getSize(), ref.size());
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
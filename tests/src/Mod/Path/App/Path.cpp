@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <Base/Exception.h>
+#include <Base/Reader.h>
+#include <Base/Writer.h>
+#include <Mod/Path/App/Command.h>
+#include <Mod/Path/App/Path.h>
+
+#include <cstring>
+#include <sstream>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+
+std::string saveBinary(const Path::Toolpath& path)
+{
+    Base::StringWriter writer;
+    path.SaveDocFile(writer);
+    return writer.getString();
+}
+
+void restore(Path::Toolpath& path, const std::string& data)
+{
+    std::istringstream str(data);
+    Base::Reader reader(str, "Path.bin", 1);
+    path.RestoreDocFile(reader);
+}
+
+Path::Toolpath makePath(int count)
+{
+    Path::Toolpath path;
+    for (int i = 0; i < count; ++i) {
+        Path::Command cmd;
+        cmd.Name = (i % 3) ? "G1" : "G0";
+        cmd.Parameters["X"] = 0.001 * i;
+        cmd.Parameters["Y"] = -2.5 * (i % 17);
+        // not a multiple of 1e-6, stored as raw double
+        cmd.Parameters["Z"] = 1.0 / (i + 3);
+        if (i % 5 == 0) {
+            cmd.Parameters["F"] = 1200.0;
+        }
+        path.addCommand(cmd);
+    }
+    return path;
+}
+
+void expectEqual(const Path::Toolpath& path1, const Path::Toolpath& path2)
+{
+    ASSERT_EQ(path1.getSize(), path2.getSize());
+    for (unsigned int i = 0; i < path1.getSize(); ++i) {
+        EXPECT_EQ(path1.getCommand(i).Name, path2.getCommand(i).Name);
+        EXPECT_TRUE(path1.getCommand(i).Parameters == path2.getCommand(i).Parameters);
+    }
+}
+
+}  // namespace
+
+TEST(Toolpath, TestBinaryEmpty)
+{
+    Path::Toolpath path;
+    std::string data = saveBinary(path);
+    EXPECT_EQ(data.compare(0, 4, "FCTP"), 0);
+
+    Path::Toolpath restored = makePath(3);
+    restore(restored, data);
+    EXPECT_EQ(restored.getSize(), 0);
+}
+
+TEST(Toolpath, TestBinaryRoundTrip)
+{
+    // spans several chunks
+    Path::Toolpath path = makePath(10000);
+    Path::Toolpath restored;
+    restore(restored, saveBinary(path));
+    expectEqual(path, restored);
+}
+
+TEST(Toolpath, TestBinaryMatchesGCode)
+{
+    Path::Toolpath path = makePath(100);
+    Path::Toolpath binary;
+    restore(binary, saveBinary(path));
+    EXPECT_EQ(binary.toGCode(), path.toGCode());
+}
+
+TEST(Toolpath, TestRestoreGCode)
+{
+    Path::Toolpath path = makePath(10);
+    Path::Toolpath restored;
+    restore(restored, path.toGCode());
+    EXPECT_EQ(restored.getSize(), path.getSize());
+    EXPECT_EQ(restored.toGCode(), path.toGCode());
+}
+
+TEST(Toolpath, TestBinaryTruncated)
+{
+    std::string data = saveBinary(makePath(100));
+    for (std::size_t size = 4; size < data.size(); ++size) {
+        Path::Toolpath restored;
+        EXPECT_THROW(restore(restored, data.substr(0, size)), Base::BadFormatError) << size;
+    }
+}
+
+TEST(Toolpath, TestBinaryHugeCount)
+{
+    // a name count that doesn't fit into the data must not be allocated
+    std::string data = saveBinary(Path::Toolpath());
+    uint32_t count = 0xffffffff;
+    std::memcpy(&data[8], &count, sizeof(count));
+    Path::Toolpath restored;
+    EXPECT_THROW(restore(restored, data), Base::BadFormatError);
+
+    // same for the chunk count
+    data = saveBinary(Path::Toolpath());
+    std::memcpy(&data[12], &count, sizeof(count));
+    EXPECT_THROW(restore(restored, data), Base::BadFormatError);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <Mod/Points/App/PointsGrid.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class PointsGridTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a regular lattice of 10 x 10 x 10 points with spacing 1
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 10; j++) {
+                for (int k = 0; k < 10; k++) {
+                    kernel.push_back(Base::Vector3d(i, j, k));
+                }
+            }
+        }
+    }
+
+    std::vector<unsigned long> bruteForceRadius(const Base::Vector3d& pnt, double radius) const
+    {
+        std::vector<unsigned long> indices;
+        for (unsigned long i = 0; i < kernel.size(); i++) {
+            if (Base::Distance(kernel.getPoint(i), pnt) <= radius) {
+                indices.push_back(i);
+            }
+        }
+        return indices;
+    }
+
+    Points::PointKernel kernel;
+};
+
+TEST_F(PointsGridTest, searchNearest)
+{
+    Points::PointsGrid grid(kernel);
+    std::vector<unsigned long> indices;
+    EXPECT_EQ(grid.SearchNearest(Base::Vector3d(2.1, 3.0, 4.0), 2, indices), 2);
+    EXPECT_EQ(indices[0], 234);
+    EXPECT_EQ(indices[1], 334);
+}
+
+TEST_F(PointsGridTest, searchNearestOutside)
+{
+    Points::PointsGrid grid(kernel);
+    std::vector<unsigned long> indices;
+    EXPECT_EQ(grid.SearchNearest(Base::Vector3d(-20.0, -20.0, -20.0), 1, indices), 1);
+    EXPECT_EQ(indices[0], 0);
+}
+
+TEST_F(PointsGridTest, searchNearestMoreThanAvailable)
+{
+    Points::PointsGrid grid(kernel);
+    std::vector<unsigned long> indices;
+    EXPECT_EQ(grid.SearchNearest(Base::Vector3d(5.0, 5.0, 5.0), 2000, indices), 1000);
+}
+
+TEST_F(PointsGridTest, searchNearestBatch)
+{
+    Points::PointsGrid grid(kernel);
+    std::vector<Base::Vector3d> points {Base::Vector3d(0.1, 0.0, 0.0),
+                                        Base::Vector3d(9.0, 9.0, 8.9)};
+    std::vector<unsigned long> indices;
+    EXPECT_EQ(grid.SearchNearest(points, 1, indices), 1);
+    EXPECT_EQ(indices, (std::vector<unsigned long> {0, 999}));
+}
+
+TEST_F(PointsGridTest, searchRadius)
+{
+    Points::PointsGrid grid(kernel);
+    Base::Vector3d pnt(4.5, 4.5, 4.5);
+    std::vector<unsigned long> indices;
+    grid.SearchRadius(pnt, 1.5, indices);
+    std::sort(indices.begin(), indices.end());
+    EXPECT_EQ(indices, bruteForceRadius(pnt, 1.5));
+}
+
+TEST_F(PointsGridTest, searchRadiusBatch)
+{
+    Points::PointsGrid grid(kernel);
+    std::vector<Base::Vector3d> points {Base::Vector3d(0.0, 0.0, 0.0),
+                                        Base::Vector3d(20.0, 20.0, 20.0),
+                                        Base::Vector3d(5.0, 5.0, 5.0)};
+    std::vector<unsigned long> offsets;
+    std::vector<unsigned long> indices;
+    grid.SearchRadius(points, 1.0, offsets, indices);
+    ASSERT_EQ(offsets.size(), 4);
+    EXPECT_EQ(offsets[1] - offsets[0], 4);
+    EXPECT_EQ(offsets[2] - offsets[1], 0);
+    EXPECT_EQ(offsets[3] - offsets[2], 7);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,158 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <limits>
+#include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/Processing.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+class PointsProcessingTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a regular lattice of 10 x 10 x 10 points with spacing 1
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 10; j++) {
+                for (int k = 0; k < 10; k++) {
+                    lattice.push_back(Base::Vector3d(i, j, k));
+                }
+            }
+        }
+    }
+
+    Points::PointKernel lattice;
+};
+
+TEST_F(PointsProcessingTest, testNormalsOfPlane)
+{
+    Points::PointKernel plane;
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) {
+            plane.push_back(Base::Vector3d(i, j, 0.01 * ((i + j) % 2)));
+        }
+    }
+
+    std::vector<Base::Vector3f> normals;
+    Points::NormalEstimation estimation(plane);
+    estimation.setNumberOfNeighbours(8);
+    estimation.perform(normals);
+
+    ASSERT_EQ(normals.size(), plane.size());
+    for (const auto& normal : normals) {
+        EXPECT_GT(normal.z, 0.99F);
+    }
+}
+
+TEST_F(PointsProcessingTest, testNormalsOfSphereAreOrientedConsistently)
+{
+    // evenly distributed points on the unit sphere
+    Points::PointKernel sphere;
+    const int num = 2000;
+    const double golden = M_PI * (3.0 - std::sqrt(5.0));
+    for (int i = 0; i < num; i++) {
+        double z = 1.0 - 2.0 * (i + 0.5) / num;
+        double r = std::sqrt(1.0 - z * z);
+        sphere.push_back(Base::Vector3d(r * std::cos(golden * i), r * std::sin(golden * i), z));
+    }
+
+    std::vector<Base::Vector3f> normals;
+    Points::NormalEstimation estimation(sphere);
+    estimation.perform(normals);
+
+    // the highest point gets an upward normal, so all normals must point outwards
+    for (std::size_t i = 0; i < normals.size(); i++) {
+        Base::Vector3d pnt = sphere.getPoint(i);
+        EXPECT_GT(pnt * Base::toVector<double>(normals[i]), 0.9);
+    }
+}
+
+TEST_F(PointsProcessingTest, testNormalOfPointOutsideNeighbourhoods)
+{
+    Points::PointKernel sphere;
+    const int num = 2000;
+    const double golden = M_PI * (3.0 - std::sqrt(5.0));
+    for (int i = 0; i < num; i++) {
+        double z = 1.0 - 2.0 * (i + 0.5) / num;
+        double r = std::sqrt(1.0 - z * z);
+        sphere.push_back(Base::Vector3d(r * std::cos(golden * i), r * std::sin(golden * i), z));
+    }
+    // below the sphere: its neighbours are sphere points, but it's no neighbour of any of them
+    sphere.push_back(Base::Vector3d(0, 0, -1.15));
+
+    std::vector<Base::Vector3f> normals;
+    Points::NormalEstimation estimation(sphere);
+    estimation.perform(normals);
+
+    // it's oriented like the bottom of the sphere rather than on its own
+    EXPECT_LT(normals.back().z, -0.9F);
+}
+
+TEST_F(PointsProcessingTest, testNormalsTowardsViewPoint)
+{
+    std::vector<Base::Vector3f> normals;
+    Points::NormalEstimation estimation(lattice);
+    estimation.setViewPoint(Base::Vector3d(-100, -100, -100));
+    estimation.perform(normals);
+
+    for (std::size_t i = 0; i < normals.size(); i++) {
+        Base::Vector3d dir = Base::Vector3d(-100, -100, -100) - lattice.getPoint(i);
+        EXPECT_GE(dir * Base::toVector<double>(normals[i]), 0.0);
+    }
+}
+
+TEST_F(PointsProcessingTest, testOutlierRemoval)
+{
+    lattice.push_back(Base::Vector3d(30, 30, 30));
+    lattice.push_back(Base::Vector3d(-20, 5, 5));
+
+    Points::OutlierRemoval removal(lattice);
+    removal.setNumberOfNeighbours(6);
+    removal.setStandardDeviationFactor(1.0);
+    std::vector<unsigned long> outliers = removal.perform();
+
+    std::vector<unsigned long> expected = {1000, 1001};
+    EXPECT_EQ(outliers, expected);
+}
+
+TEST_F(PointsProcessingTest, testVoxelGrid)
+{
+    Points::PointKernel reduced;
+    Points::VoxelGrid voxel(lattice);
+    voxel.setVoxelSize(2.0);
+    voxel.perform(reduced);
+
+    ASSERT_EQ(reduced.size(), 125);
+    // each voxel holds eight points whose centroid lies at an odd half coordinate
+    for (const auto& pnt : reduced.getBasicPoints()) {
+        EXPECT_FLOAT_EQ(std::fmod(pnt.x, 2.0F), 0.5F);
+        EXPECT_FLOAT_EQ(std::fmod(pnt.y, 2.0F), 0.5F);
+        EXPECT_FLOAT_EQ(std::fmod(pnt.z, 2.0F), 0.5F);
+    }
+}
+TEST_F(PointsProcessingTest, testVoxelGridSkipsNonFinitePoints)
+{
+    lattice.push_back(Base::Vector3d(std::nan(""), 0, 0));
+    lattice.push_back(Base::Vector3d(0, std::numeric_limits<double>::infinity(), 0));
+
+    Points::PointKernel reduced;
+    Points::VoxelGrid voxel(lattice);
+    voxel.setVoxelSize(2.0);
+    voxel.perform(reduced);
+
+    ASSERT_EQ(reduced.size(), 125);
+    for (const auto& pnt : reduced.getBasicPoints()) {
+        EXPECT_TRUE(std::isfinite(pnt.x) && std::isfinite(pnt.y) && std::isfinite(pnt.z));
+    }
+}
+
+TEST_F(PointsProcessingTest, testVoxelGridSmallVoxels)
+{
+    // far more voxels than fit into a single 64-bit index
+    Points::PointKernel reduced;
+    Points::VoxelGrid voxel(lattice);
+    voxel.setVoxelSize(1.0e-12);
+    voxel.perform(reduced);
+
+    EXPECT_EQ(reduced.size(), lattice.size());
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
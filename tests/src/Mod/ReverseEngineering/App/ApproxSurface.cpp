@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+
+#include <GeomAPI_ProjectPointOnSurf.hxx>
+#include <Geom_BSplineSurface.hxx>
+#include <TColgp_Array1OfPnt.hxx>
+#include <Mod/ReverseEngineering/App/ApproxSurface.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+
+// Samples z = f(x, y) on a grid over [0, 10] x [0, 10], optionally only at two opposite corners
+template<typename Func>
+TColgp_Array1OfPnt sample(Func func, bool corners)
+{
+    std::vector<gp_Pnt> pnts;
+    for (int i = 0; i <= 40; i++) {
+        for (int j = 0; j <= 40; j++) {
+            double x = 0.25 * i;
+            double y = 0.25 * j;
+            bool lower = x <= 2.0 && y <= 2.0;
+            bool upper = x >= 8.0 && y >= 8.0;
+            if (!corners || lower || upper) {
+                pnts.emplace_back(x, y, func(x, y));
+            }
+        }
+    }
+
+    TColgp_Array1OfPnt array(0, static_cast<int>(pnts.size()) - 1);
+    for (std::size_t i = 0; i < pnts.size(); i++) {
+        array(static_cast<int>(i)) = pnts[i];
+    }
+    return array;
+}
+
+Handle(Geom_BSplineSurface) fit(const TColgp_Array1OfPnt& pnts, unsigned poles)
+{
+    Reen::BSplineParameterCorrection pc(4, 4, poles, poles);
+    pc.SetUV(Base::Vector3d(1, 0, 0), Base::Vector3d(0, 1, 0));
+    return pc.CreateSurface(pnts, 0, false, 1.0);
+}
+
+double maxDistance(const Handle(Geom_BSplineSurface)& surf, const TColgp_Array1OfPnt& pnts)
+{
+    double dist = 0.0;
+    for (int i = pnts.Lower(); i <= pnts.Upper(); i++) {
+        GeomAPI_ProjectPointOnSurf proj(pnts(i), surf);
+        dist = std::max(dist, proj.LowerDistance());
+    }
+    return dist;
+}
+
+}  // namespace
+
+TEST(ApproxSurface, testWellPosedFit)
+{
+    // a bicubic surface reproduces a bilinear function exactly
+    TColgp_Array1OfPnt pnts = sample(
+        [](double x, double y) {
+            return 0.5 * x + 0.2 * y + 0.05 * x * y;
+        },
+        false);
+    Handle(Geom_BSplineSurface) surf = fit(pnts, 6);
+    ASSERT_FALSE(surf.IsNull());
+    EXPECT_LT(maxDistance(surf, pnts), 1.0e-6);
+}
+
+TEST(ApproxSurface, testSparseDataFit)
+{
+    // Most of the control points have no data in the support of their basis functions,
+    // the normal equations are singular
+    TColgp_Array1OfPnt pnts = sample(
+        [](double x, double y) {
+            return 0.5 * x + 0.2 * y;
+        },
+        true);
+    Handle(Geom_BSplineSurface) surf = fit(pnts, 10);
+    ASSERT_FALSE(surf.IsNull());
+    EXPECT_LT(maxDistance(surf, pnts), 1.0e-3);
+
+    // the undetermined control points stay in the range of the data
+    for (int i = 1; i <= surf->NbUPoles(); i++) {
+        for (int j = 1; j <= surf->NbVPoles(); j++) {
+            const gp_Pnt& pole = surf->Pole(i, j);
+            ASSERT_TRUE(std::isfinite(pole.Z()));
+            EXPECT_GT(pole.Z(), -1.0);
+            EXPECT_LT(pole.Z(), 8.0);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/PropertyStandard.h>
+#include <App/PropertyUnits.h>
+#include <App/Range.h>
+#include <Mod/Spreadsheet/App/Cell.h>
+#include <Mod/Spreadsheet/App/Sheet.h>
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+class SheetTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        if (App::Application::GetARGC() == 0) {
+            int argc = 1;
+            char* argv[] = {"FreeCAD"};
+            App::Application::Config()["ExeName"] = "FreeCAD";
+            App::Application::init(argc, argv);
+        }
+    }
+
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _sheet = static_cast<Spreadsheet::Sheet*>(_doc->addObject("Spreadsheet::Sheet"));
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    double cellValue(const char* address) const
+    {
+        auto prop = _sheet->getPropertyByName(address);
+        if (auto intProp = Base::freecad_dynamic_cast<App::PropertyInteger>(prop)) {
+            return static_cast<double>(intProp->getValue());
+        }
+        if (auto floatProp = Base::freecad_dynamic_cast<App::PropertyFloat>(prop)) {
+            return floatProp->getValue();
+        }
+        if (auto quantityProp = Base::freecad_dynamic_cast<App::PropertyQuantity>(prop)) {
+            return quantityProp->getValue();
+        }
+        ADD_FAILURE() << "no numeric value in " << address;
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    bool hasException(const char* address, const char* message) const
+    {
+        auto cell = _sheet->getCell(App::CellAddress(address));
+        return cell && cell->hasException()
+            && cell->getException().find(message) != std::string::npos;
+    }
+
+    std::string _docName;
+    App::Document* _doc {};
+    Spreadsheet::Sheet* _sheet {};
+};
+
+TEST_F(SheetTest, recomputeOrder)
+{
+    // Set in reverse order, so that the order of the dirty cells doesn't
+    // match the evaluation order
+    _sheet->setCell("A3", "=A2 * 2");
+    _sheet->setCell("B1", "=A3 + A1");
+    _sheet->setCell("A2", "=A1 + 1");
+    _sheet->setCell("A1", "1");
+    _doc->recompute();
+    EXPECT_DOUBLE_EQ(cellValue("A2"), 2.0);
+    EXPECT_DOUBLE_EQ(cellValue("A3"), 4.0);
+    EXPECT_DOUBLE_EQ(cellValue("B1"), 5.0);
+
+    // only A1 is dirty, its dependents are recomputed after it
+    _sheet->setCell("A1", "4");
+    _doc->recompute();
+    EXPECT_DOUBLE_EQ(cellValue("A2"), 5.0);
+    EXPECT_DOUBLE_EQ(cellValue("A3"), 10.0);
+    EXPECT_DOUBLE_EQ(cellValue("B1"), 14.0);
+}
+
+TEST_F(SheetTest, recomputeLongChain)
+{
+    for (int row = 20; row > 1; --row) {
+        std::string address = "C" + std::to_string(row);
+        std::string expr = "=C" + std::to_string(row - 1) + " + 1";
+        _sheet->setCell(address.c_str(), expr.c_str());
+    }
+    _sheet->setCell("C1", "1");
+    _doc->recompute();
+    EXPECT_DOUBLE_EQ(cellValue("C20"), 20.0);
+
+    _sheet->setCell("C1", "11");
+    _doc->recompute();
+    EXPECT_DOUBLE_EQ(cellValue("C20"), 30.0);
+}
+
+TEST_F(SheetTest, cycleDetection)
+{
+    _sheet->setCell("A1", "=A2 + 1");
+    _sheet->setCell("A2", "=A3 + 1");
+    _sheet->setCell("A3", "=A1 + 1");
+    _doc->recompute();
+    // cells in the loop are flagged, the message names the loop
+    EXPECT_TRUE(hasException("A1", "yclic dependency"));
+    EXPECT_TRUE(hasException("A2", "yclic dependency"));
+    EXPECT_TRUE(hasException("A3", "yclic dependency"));
+
+    // breaking the cycle recovers all cells
+    _sheet->setCell("A3", "1");
+    _doc->recompute();
+    EXPECT_FALSE(_sheet->getCell(App::CellAddress("A1"))->hasException());
+    EXPECT_FALSE(_sheet->getCell(App::CellAddress("A2"))->hasException());
+    EXPECT_DOUBLE_EQ(cellValue("A2"), 2.0);
+    EXPECT_DOUBLE_EQ(cellValue("A1"), 3.0);
+}
+
+TEST_F(SheetTest, unchangedValueNotNotified)
+{
+    _sheet->setCell("A1", "=1 + 1");
+    _sheet->setCell("A2", "=2 mm");
+    _sheet->setCell("A3", "=<<text>>");
+    _doc->recompute();
+
+    std::vector<std::string> changed;
+    boost::signals2::scoped_connection connection = _doc->signalChangedObject.connect(
+        [&](const App::DocumentObject& obj, const App::Property& prop) {
+            if (&obj == _sheet && prop.getName()) {
+                changed.emplace_back(prop.getName());
+            }
+        });
+
+    // recomputing the same values must not notify anyone
+    _sheet->recomputeCells(App::Range("A1:A3"));
+    EXPECT_EQ(std::count(changed.begin(), changed.end(), "A1"), 0);
+    EXPECT_EQ(std::count(changed.begin(), changed.end(), "A2"), 0);
+    EXPECT_EQ(std::count(changed.begin(), changed.end(), "A3"), 0);
+
+    // a changed value still is
+    _sheet->setCell("A1", "=1 + 2");
+    _sheet->recomputeCells(App::Range("A1:A1"));
+    EXPECT_EQ(std::count(changed.begin(), changed.end(), "A1"), 1);
+    EXPECT_DOUBLE_EQ(cellValue("A1"), 3.0);
+}
+
+// NOLINTEND(readability-magic-numbers)